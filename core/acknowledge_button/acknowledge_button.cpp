@@ -7,58 +7,50 @@
 #include <acknowledge_button.h>
 #include <button_debouncer.h>
 #include <ArduinoLog.h>
-#include <state.h>
+#include <state_access.h>
 #include <pin_configuration.h>
 #include <led_patterns.h>
-#include <not_blocking_time_handler.h>
 #include <led_array.h>
 #include "../log_controller/log_controller.h"
 
 namespace AcknowledgeButton {
-    constexpr unsigned long INDICATION_SEQUENCE_DELAY_MS = 100UL;
-
-    /**
-     * @brief   Indicates acknowledgment through LED pattern.
-     * @details This function outputs a predefined LED indication sequence
-     *          to acknowledge the warning. It utilizes a non-blocking delay
-     *          between the LED outputs to ensure a fluid sequence pattern.
-     */
-    void indicate_acknowledge();
+    volatile bool is_press_pending = false; ///< True, if the interrupt accepted a press that is not handled yet.
 
     void initialize() {
-        pinMode(DIGITAL_PIN, INPUT);
-        attachInterrupt(
-            digitalPinToInterrupt(DIGITAL_PIN),
-            acknowledge_warning, RISING);
+        ButtonPin::set_input();
+        ButtonPin::attach_interrupt(acknowledge_warning, RISING);
     }
 
     void acknowledge_warning() {
-        Log.infoln(LogController::ACKNOWLEDGE_BUTTON_PRESSED);
-        static unsigned long last_button_press_detected_ms = 0UL;
-        ///< Timestamp of last interrupt initialized with static to persist until next function call.
-        TRACE_LN_u(last_button_press_detected_ms);
-        if (!ButtonDebouncer::is_button_debounced(last_button_press_detected_ms, true)) {
+        const uint16_t start_cycles = StateAccess::read_cycle_counter(); ///< Cycle counter at the start of the ISR.
+        static SystemTime::TimePoint last_button_press_detected;
+        ///< Time point of last interrupt initialized with static to persist until next function call.
+        if (ButtonDebouncer::is_button_debounced(last_button_press_detected, true)) {
             ///< use a long debounce delay to reduce sensitivity to rapit consecutive button presses.
-            Log.verboseln(LogController::ACKNOWLEDGE_BUTTON_DEBOUNCED);
-            return;
+            const unsigned long current_time_ms = millis();
+            StateAccess::write([current_time_ms](AirQualityMeter::State &state) {
+                state.last_co2_below_threshold_time_ms = current_time_ms;
+                state.warning_counter = 0;
+            });
+            is_press_pending = true;
         }
+        StateAccess::record_critical_section(static_cast<uint16_t>(StateAccess::read_cycle_counter() - start_cycles));
+    }
 
-        noInterrupts(); // Temporarily disable interrupts while updating system state
-        AirQualityMeter::state.last_co2_below_threshold_time_ms = millis();
-        AirQualityMeter::state.warning_counter = 0;
-        interrupts(); // Re-enable interrupts
+    void handle_press() {
+        if (!is_press_pending) {
+            return;
+        }
+        is_press_pending = false; // the next press is debounced for a second, so it cannot be lost in between
+        Log.infoln(LogController::ACKNOWLEDGE_BUTTON_PRESSED);
 
         indicate_acknowledge();
 
         Log.verboseln(LogController::STATE_UPDATED);
         LogController::log_current_state();
-
     }
 
     void indicate_acknowledge() {
-        for (const auto i: LedInfoPattern::INFO_PATTERN_SEQUENCE) {
-            LedArray::output(i);
-            NotBlockingTimeHandler::wait_ms(INDICATION_SEQUENCE_DELAY_MS);
-        }
+        LedArray::play(LedInfoPattern::ACKNOWLEDGE);
     }
 }
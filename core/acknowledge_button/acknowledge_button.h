@@ -16,10 +16,25 @@ namespace AcknowledgeButton {
 
     /**
      * @brief   Resets last_co2_below_threshold_time_s and warning_counter.
-     * @details Resets the timestamp of the last CO2 measurement that was below the threshold
-     *          and the counter for consecutive warnings.
+     * @details Interrupt service routine of the acknowledge button. Resets the timestamp of the last CO2 measurement
+     *          that was below the threshold and the counter for consecutive warnings, and marks the press as pending.
+     *          It does not log and does not drive outputs, the rest is done by `handle_press` from the loop.
      */
     void acknowledge_warning();
+
+    /**
+     * @brief   Handles a press accepted by the interrupt service routine (indication and logging).
+     * @details Called from the loop. Does nothing, if no press is pending.
+     */
+    void handle_press();
+
+    /**
+     * @brief   Indicates acknowledgment through LED pattern.
+     * @details This function starts a predefined LED animation to acknowledge
+     *          the warning. The animation is played in the background by the
+     *          LED array, so the function returns at once.
+     */
+    void indicate_acknowledge();
 }
 
 
@@ -0,0 +1,158 @@
+/**
+ * @file boot_sequence.cpp
+ * @brief Implementation of the dependency-ordered initialization of all modules.
+ */
+
+#include <Arduino.h>
+#include <boot_sequence.h>
+#include <boot_timeline.h>
+#include <log_controller.h>
+#include <not_blocking_time_handler.h>
+#include <watchdog.h>
+#include <history_log.h>
+#include <system_time.h>
+#include <state_access.h>
+#include <display_controller.h>
+#include <display_pages.h>
+#include <co2_sensor_controller.h>
+#include <led_array.h>
+#include <audio_controller.h>
+#include <mute_indicator.h>
+#include <acknowledge_button.h>
+#include <mute_button.h>
+#include <page_button.h>
+
+namespace BootSequence {
+    /**
+     * @enum    StepId
+     * @brief   Identifiers of the initialization steps, in the order of the `STEPS` table.
+     */
+    enum StepId : uint8_t {
+        LOG_STEP,
+        SYSTEM_TIME_STEP,
+        STATE_ACCESS_STEP,
+        WATCHDOG_STEP,
+        HISTORY_LOG_STEP,
+        DISPLAY_STEP,
+        WELCOME_MESSAGE_STEP,
+        SENSOR_STEP,
+        SENSOR_WARM_UP_STEP,
+        LED_ARRAY_STEP,
+        AUDIO_STEP,
+        MUTE_INDICATOR_STEP,
+        ACKNOWLEDGE_BUTTON_STEP,
+        MUTE_BUTTON_STEP,
+        DISPLAY_PAGES_STEP,
+        PAGE_BUTTON_STEP,
+        NUMBER_OF_STEPS
+    };
+
+    /**
+     * @enum    StepState
+     * @brief   State of an initialization step.
+     */
+    enum StepState : uint8_t {
+        PENDING, ///< Waiting for the steps it depends on.
+        RUNNING, ///< Started, but not yet completed.
+        COMPLETED ///< Completed.
+    };
+
+    /**
+     * @struct  Step
+     * @brief   An initialization step.
+     */
+    struct Step {
+        const char *name; ///< Name of the step (logged and recorded in the boot timeline).
+        uint16_t dependencies; ///< Bit mask of the steps that have to be completed before this step starts.
+        void (*start)(); ///< Starts the step, `nullptr` if there is nothing to start.
+        bool (*is_completed)(); ///< Polls a running step, `nullptr` if the step is completed by `start`.
+    };
+
+    /**
+     * @brief   Returns the bit of a step in a bit mask of steps.
+     */
+    constexpr uint16_t after(const StepId step) {
+        return static_cast<uint16_t>(1U << step);
+    }
+
+    constexpr uint16_t ALL_STEPS = static_cast<uint16_t>((1U << NUMBER_OF_STEPS) - 1U); ///< Bit mask of all steps.
+    constexpr unsigned long POLL_INTERVAL_MS = 10UL; ///< Time between two polls of the running steps.
+    constexpr unsigned long WELCOME_MESSAGE_TIME_MS = 2000UL; ///< Display duration of the welcome message.
+
+    uint8_t log_level = 0; ///< Log level of the system.
+    bool is_warm_restart = false; ///< True, if the welcome message and the sensor warm-up are skipped.
+    unsigned long welcome_message_time_stamp_ms = 0UL; ///< Time (in ms) the welcome message was shown.
+
+    void start_log_controller() {
+        LogController::initialize(log_level);
+        LogController::log_welcome_message();
+        LogController::log_reset_cause();
+    }
+
+    void show_welcome_message() {
+        welcome_message_time_stamp_ms = millis();
+        if (!is_warm_restart) {
+            DisplayController::show_welcome_message();
+        }
+    }
+
+    bool is_welcome_message_shown() {
+        return is_warm_restart || millis() - welcome_message_time_stamp_ms >= WELCOME_MESSAGE_TIME_MS;
+    }
+
+    void start_sensor_controller() {
+        Co2SensorController::initialize(is_warm_restart);
+    }
+
+    const Step STEPS[NUMBER_OF_STEPS] = {
+        {LogController::LOG_CONTROLLER, 0, start_log_controller, nullptr},
+        {LogController::SYSTEM_TIME, after(LOG_STEP), SystemTime::initialize, nullptr},
+        {LogController::STATE_ACCESS, after(LOG_STEP), StateAccess::initialize, nullptr},
+        {LogController::WATCHDOG, after(LOG_STEP), Watchdog::initialize, nullptr},
+        {LogController::HISTORY_LOG, after(LOG_STEP), HistoryLog::initialize, nullptr},
+        {LogController::DISPLAY_CONTROLLER, after(LOG_STEP), DisplayController::initialize, nullptr},
+        {LogController::BOOT_WELCOME_MESSAGE, after(DISPLAY_STEP), show_welcome_message, is_welcome_message_shown},
+        {LogController::SENSOR_CONTROLLER, after(LOG_STEP), start_sensor_controller, nullptr},
+        {
+            LogController::SENSOR_WARM_UP, after(SENSOR_STEP) | after(WELCOME_MESSAGE_STEP), nullptr,
+            Co2SensorController::is_warmed_up
+        },
+        {LogController::LED_ARRAY, after(LOG_STEP), LedArray::initialize, nullptr},
+        {LogController::AUDIO_CONTROLLER, after(LOG_STEP), AudioController::initialize, nullptr},
+        {LogController::MUTE_INDICATOR, after(LOG_STEP), MuteIndicator::initialize, nullptr},
+        {LogController::ACKNOWLEDGE_BUTTON, after(LED_ARRAY_STEP), AcknowledgeButton::initialize, nullptr},
+        {LogController::MUTE_BUTTON, after(MUTE_INDICATOR_STEP), MuteButton::initialize, nullptr},
+        {LogController::DISPLAY_PAGES, after(DISPLAY_STEP), DisplayPages::initialize, nullptr},
+        {LogController::PAGE_BUTTON, after(DISPLAY_PAGES_STEP), PageButton::initialize, nullptr},
+    }; ///< All initialization steps. A step may only depend on steps above it.
+
+    void run(const uint8_t level, const bool is_warm) {
+        log_level = level;
+        is_warm_restart = is_warm;
+        StepState states[NUMBER_OF_STEPS] = {}; ///< Current state of each step.
+        uint8_t phases[NUMBER_OF_STEPS]; ///< Boot timeline phase of each started step.
+        uint16_t completed_steps = 0; ///< Bit mask of the completed steps.
+        while (completed_steps != ALL_STEPS) {
+            // The table is in dependency order, so all steps without waiting are done in the first pass.
+            for (uint8_t i = 0; i < NUMBER_OF_STEPS; i++) {
+                const Step &step = STEPS[i];
+                if (states[i] == PENDING && (step.dependencies & completed_steps) == step.dependencies) {
+                    phases[i] = BootTimeline::begin_phase(step.name);
+                    if (step.start != nullptr) {
+                        step.start();
+                    }
+                    states[i] = RUNNING;
+                }
+                if (states[i] == RUNNING && (step.is_completed == nullptr || step.is_completed())) {
+                    BootTimeline::end_phase(phases[i]);
+                    LogController::log_initialization(step.name);
+                    states[i] = COMPLETED;
+                    completed_steps |= after(static_cast<StepId>(i));
+                }
+            }
+            if (completed_steps != ALL_STEPS) {
+                NotBlockingTimeHandler::wait_ms(POLL_INTERVAL_MS); // the MCU sleeps, the display is rendered
+            }
+        }
+    }
+}
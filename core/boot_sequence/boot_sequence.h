@@ -0,0 +1,25 @@
+/**
+ * @file boot_sequence.h
+ * @brief Header file for the dependency-ordered initialization of all modules.
+ * @details The initialization is a state machine of steps. A step starts as soon as all steps it depends on are
+ *          completed, and may take time (e.g. the welcome message or the preheating of the sensor). While such steps
+ *          are running, the independent steps (LEDs, audio volume, mute indicator, button interrupts) are done, and
+ *          the MCU sleeps in between. This keeps the time-to-first-reading at the mandatory sensor warm-up.
+ *          Each step is recorded as a phase of the boot timeline (see `BootTimeline`).
+ */
+
+#ifndef BOOT_SEQUENCE_H
+#define BOOT_SEQUENCE_H
+
+#include <Arduino.h>
+
+namespace BootSequence {
+    /**
+     * @brief   Initializes all modules and returns when all steps are completed.
+     * @param   log_level Log level of the system (0-6).
+     * @param   is_warm_restart True after a warm restart: the welcome message and the sensor warm-up are skipped.
+     */
+    void run(uint8_t log_level, bool is_warm_restart);
+}
+
+#endif //BOOT_SEQUENCE_H
@@ -0,0 +1,65 @@
+/**
+ * @file boot_timeline.cpp
+ * @brief Implementation of the boot timeline profiler.
+ */
+
+#include <boot_timeline.h>
+
+namespace BootTimeline {
+    /**
+     * @struct  Phase
+     * @brief   A recorded initialization phase.
+     */
+    struct Phase {
+        const char *name; ///< Name of the phase.
+        unsigned long start_time_us; ///< Start of the phase in µs since start-up.
+        unsigned long duration_us; ///< Duration of the phase in µs.
+    };
+
+    Phase phases[MAX_NUMBER_OF_PHASES] = {}; ///< Recorded phases in the order of their start.
+    uint8_t number_of_phases = 0; ///< Number of recorded phases.
+    unsigned long time_to_first_reading_ms = 0UL; ///< Time of the first valid reading in ms, 0 before.
+
+    uint8_t begin_phase(const char *name) {
+        if (number_of_phases >= MAX_NUMBER_OF_PHASES) {
+            return NO_PHASE;
+        }
+        phases[number_of_phases] = {name, micros(), 0UL};
+        return number_of_phases++;
+    }
+
+    void end_phase(const uint8_t phase) {
+        if (phase < number_of_phases) {
+            phases[phase].duration_us = micros() - phases[phase].start_time_us;
+        }
+    }
+
+    uint8_t get_number_of_phases() {
+        return number_of_phases;
+    }
+
+    const char *get_phase_name(const uint8_t phase) {
+        return phases[phase].name;
+    }
+
+    unsigned long get_phase_start_time_us(const uint8_t phase) {
+        return phases[phase].start_time_us;
+    }
+
+    unsigned long get_phase_duration_us(const uint8_t phase) {
+        return phases[phase].duration_us;
+    }
+
+    bool mark_first_reading() {
+        if (time_to_first_reading_ms != 0UL) {
+            return false;
+        }
+        const unsigned long current_time_ms = millis();
+        time_to_first_reading_ms = current_time_ms > 0UL ? current_time_ms : 1UL; // 0 means "no reading yet"
+        return true;
+    }
+
+    unsigned long get_time_to_first_reading_ms() {
+        return time_to_first_reading_ms;
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * @file boot_timeline.h
+ * @brief Header file for the boot timeline profiler.
+ * @details Records the start time and duration of each initialization phase, and the time from the reset to the first
+ *          valid CO2 reading (time-to-first-reading). The timeline is logged when the system is ready, the
+ *          time-to-first-reading is also sent in the telemetry frames, so it can be tracked across releases.
+ *          Phases can overlap, e.g. the initialization of the LEDs and buttons during the preheating of the sensor.
+ *          Times are taken from `micros()`, i.e. since the start of the firmware (without the bootloader).
+ */
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <Arduino.h>
+
+namespace BootTimeline {
+    constexpr uint8_t MAX_NUMBER_OF_PHASES = 16; ///< Maximum number of recorded phases.
+    constexpr uint8_t NO_PHASE = 0xFF; ///< Returned by `begin_phase`, if no further phase can be recorded.
+
+    /**
+     * @brief   Records the start of a phase.
+     * @param   name Name of the phase (has to stay valid, e.g. a string literal).
+     * @return  Handle of the phase for `end_phase`, or `NO_PHASE` if `MAX_NUMBER_OF_PHASES` are recorded.
+     */
+    uint8_t begin_phase(const char *name);
+
+    /**
+     * @brief   Records the end of a phase.
+     * @param   phase Handle returned by `begin_phase` (`NO_PHASE` is ignored).
+     */
+    void end_phase(uint8_t phase);
+
+    /**
+     * @brief   Returns the number of recorded phases.
+     */
+    uint8_t get_number_of_phases();
+
+    /**
+     * @brief   Returns the name of a recorded phase.
+     */
+    const char *get_phase_name(uint8_t phase);
+
+    /**
+     * @brief   Returns the start time of a recorded phase in µs since start-up.
+     */
+    unsigned long get_phase_start_time_us(uint8_t phase);
+
+    /**
+     * @brief   Returns the duration of a recorded phase in µs (0 while the phase is running).
+     */
+    unsigned long get_phase_duration_us(uint8_t phase);
+
+    /**
+     * @brief   Records the time of the first valid reading. Later calls are ignored, so it can be called every loop.
+     * @return  True, if this was the first reading.
+     */
+    bool mark_first_reading();
+
+    /**
+     * @brief   Returns the time from start-up to the first valid reading in ms, or 0 if there was no reading yet.
+     */
+    unsigned long get_time_to_first_reading_ms();
+}
+
+#endif //BOOT_TIMELINE_H
@@ -7,17 +7,19 @@
 #include <Arduino.h>
 
 namespace ButtonDebouncer {
-    constexpr unsigned long LONG_DEBOUNCE_DELAY_MS = 1000UL; ///< Time between two button presses to debounce.
-    constexpr unsigned long DEFAULT_DEBOUNCE_DELAY_MS = 100UL; ///< Time between two button presses to debounce.
+    constexpr SystemTime::Duration LONG_DEBOUNCE_DELAY = SystemTime::milliseconds(1000);
+    ///< Time between two button presses to debounce.
+    constexpr SystemTime::Duration DEFAULT_DEBOUNCE_DELAY = SystemTime::milliseconds(100);
+    ///< Time between two button presses to debounce.
 
-    bool is_button_debounced(unsigned long &last_button_press_detected_ms, const bool is_long_delay_used) {
-        const unsigned long current_time = millis();
-        const unsigned long time_delta_between_detected_button_press_ms = current_time - last_button_press_detected_ms;
-        const unsigned long debounce_delay_ms = is_long_delay_used ? LONG_DEBOUNCE_DELAY_MS : DEFAULT_DEBOUNCE_DELAY_MS;
-        if (time_delta_between_detected_button_press_ms < debounce_delay_ms) {
+    bool is_button_debounced(SystemTime::TimePoint &last_button_press_detected, const bool is_long_delay_used) {
+        const SystemTime::TimePoint current_time = SystemTime::now();
+        const SystemTime::Duration time_delta_between_detected_button_press = current_time - last_button_press_detected;
+        const SystemTime::Duration debounce_delay = is_long_delay_used ? LONG_DEBOUNCE_DELAY : DEFAULT_DEBOUNCE_DELAY;
+        if (time_delta_between_detected_button_press < debounce_delay) {
             return false;
         }
-        last_button_press_detected_ms = current_time;
+        last_button_press_detected = current_time;
         return true;
     }
 }
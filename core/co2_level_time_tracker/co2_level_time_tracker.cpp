@@ -6,13 +6,23 @@
  */
 
 #include <Arduino.h>
-#include <state.h>
+#include <co2_level_time_tracker.h>
+#include <state_access.h>
 
 namespace Co2LevelTimeTracker {
 
-    unsigned long get_time_since_co2_level_not_acceptable_ms() {
-        const unsigned long current_time = millis();
-        return current_time - AirQualityMeter::state.last_co2_below_threshold_time_ms;
-        ///< Time since the last acceptable CO2 level, adjusted for overflow.
+    SystemTime::Duration get_time_since_co2_level_not_acceptable() {
+        const unsigned long last_co2_below_threshold_time_ms = StateAccess::read().last_co2_below_threshold_time_ms;
+        return get_time_since_co2_level_not_acceptable(last_co2_below_threshold_time_ms, millis());
+    }
+
+    SystemTime::Duration get_time_since_co2_level_not_acceptable(const unsigned long last_co2_below_threshold_time_ms,
+                                                                 const unsigned long current_time_ms) {
+        const SystemTime::TimePoint last_co2_below_threshold(last_co2_below_threshold_time_ms);
+        const SystemTime::TimePoint current_time(current_time_ms);
+        if (current_time.is_before(last_co2_below_threshold)) {
+            return SystemTime::milliseconds(0);
+        }
+        return current_time - last_co2_below_threshold;
     }
 }
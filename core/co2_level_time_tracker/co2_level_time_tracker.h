@@ -7,18 +7,30 @@
 #ifndef CO2_LEVEL_TIME_TRACKER_H
 #define CO2_LEVEL_TIME_TRACKER_H
 
+#include <system_time.h>
+
 namespace Co2LevelTimeTracker {
     /**
      * @brief Computes the time elapsed since the CO2 level was last acceptable.
-     * @details This function calculates the time difference between `current_time_s` and a
-     *          previously stored timestamp (`last_co2_below_threshold_time_s`) that records
-     *          the last acceptable CO2 level time. The implementation ensures correctness, even
-     *          when millis() overflow occurs.
-     *          For details about unsigned arithmetic overflow, check the C++ standard documentation.
-     * @return Elapsed time in milliseconds (unsigned long) since the CO2 level was last below the threshold.
-     * @see https://en.cppreference.com/w/cpp/language/operator_arithmetic#:~:text=conversions%20are%20applied.-,Overflows,-Unsigned%20integer%20arithmetic
+     * @details This function calculates the time difference between the current time and a
+     *          previously stored timestamp (`last_co2_below_threshold_time_ms`) that records
+     *          the last acceptable CO2 level time. The difference of `SystemTime::TimePoint`s ensures correctness,
+     *          even when millis() overflow occurs.
+     * @return Elapsed time since the CO2 level was last below the threshold.
+     */
+    SystemTime::Duration get_time_since_co2_level_not_acceptable();
+
+    /**
+     * @brief Computes the time elapsed since the CO2 level was last acceptable (for host tools with recorded data).
+     * @details After a warning, the stored time point is moved forward by the waiting period between warnings, so it
+     *          can lie in the future (waiting period longer than the time above the threshold). The elapsed time is
+     *          then 0, as the difference would wrap around to a huge value and trigger the next warning at once.
+     * @param last_co2_below_threshold_time_ms Stored time point (see `AirQualityMeter::State`).
+     * @param current_time_ms Current time in milliseconds.
+     * @return Elapsed time since the CO2 level was last below the threshold, 0 if the time point is in the future.
      */
-    unsigned long get_time_since_co2_level_not_acceptable_ms();
+    SystemTime::Duration get_time_since_co2_level_not_acceptable(unsigned long last_co2_below_threshold_time_ms,
+                                                                 unsigned long current_time_ms);
 }
 
 #endif //CO2_LEVEL_TIME_TRACKER_H
@@ -9,16 +9,107 @@
 #include <pin_configuration.h>
 #include <../display_controller/display_controller.h>
 #include <MHZ.h>
-#include <state.h>
+#include <state_access.h>
 #include <ArduinoLog.h>
 #include "../log_controller/log_controller.h"
 #include <error_messages.h>
 #include <../led_array/led_array.h>
 #include <led_patterns.h>
 #include <not_blocking_time_handler.h>
+#include <measurement_aggregator.h>
+#include <text_formatter.h>
+#include <system_time.h>
 
 
 namespace Co2SensorController {
+    /**
+     * @enum    Interface
+     * @brief   Interface used to read the CO2 value from a sensor.
+     */
+    enum Interface : uint8_t {
+        PWM, ///< CO2 value is read from the PWM output of the sensor.
+        UART ///< CO2 value is read from the serial interface of the sensor.
+    };
+
+    /**
+     * @struct  Sensor
+     * @brief   Entry of the sensor registry.
+     * @details Holds the driver instance and configuration of one CO2 sensor, together with its own cycle timing and
+     *          validity state.
+     */
+    struct Sensor {
+        uint8_t pwm_pin; ///< PWM pin the sensor is connected to.
+        MHZ device; ///< Driver instance of the sensor.
+        Interface interface; ///< Interface used to read the sensor.
+        SystemTime::Duration cycle_time; ///< Minimum time between two readings of this sensor.
+        uint8_t weight; ///< Weight of this sensor, when the readings are combined as a weighted average.
+        SystemTime::TimePoint last_used_time_stamp; ///< Last time this sensor was read.
+        int last_valid_measurement_ppm; ///< Latest valid reading or `MEASUREMENT_NOT_VALID_ERROR`.
+        uint8_t consecutive_faulty_measurements; ///< Number of faulty readings since the last valid one.
+        SensorHealth health; ///< Health counters and PWM timing gauges.
+        SystemTime::TimePoint last_valid_time_stamp; ///< Time of the last valid reading.
+        unsigned long last_rising_edge_us; ///< Start of the last PWM pulse, 0 if none yet.
+    };
+
+    /**
+     * @brief   Reads the CO2 value from the PWM output of a sensor and updates its PWM timing gauges.
+     * @details Replaces `MHZ::readCO2PWM`, which retries forever, if the sensor sends no pulse, and counts the pulse
+     *          length in CPU cycles, which the timer interrupt of the LED array shortens. `pulseInLong` measures with
+     *          `micros()` and gives up after `PWM_TIMEOUT_US`.
+     *          The PWM cycle period is measured from the start of the pulse to the start of the previous pulse (a
+     *          whole number of cycles apart), and the reading is decoded with the measured period, as the sensor
+     *          scales the pulse with its own clock.
+     * @param   sensor The registry entry of the sensor to read.
+     * @return  The CO2 reading in ppm or `NO_READING`, if no pulse was received.
+     */
+    int read_pwm_sensor(Sensor &sensor);
+
+    /**
+     * @brief   Decodes the length of a PWM pulse into a CO2 value (as per the datasheet, for the 5000 ppm range).
+     * @param   high_time_us Length of the pulse.
+     * @param   period_us Length of the PWM cycle.
+     * @return  The CO2 value in ppm.
+     */
+    int decode_pwm(unsigned long high_time_us, unsigned long period_us);
+
+    /**
+     * @brief   Updates the measured PWM cycle period of a sensor with the start of a new pulse.
+     * @details The period is only updated, if the previous pulse is at most `MAX_PWM_CYCLES_BETWEEN_PULSES` cycles
+     *          back, otherwise the error of the nominal period would dominate the rounding to whole cycles.
+     * @param   sensor The registry entry of the sensor.
+     * @param   rising_edge_us Start of the new pulse.
+     */
+    void update_pwm_period(Sensor &sensor, unsigned long rising_edge_us);
+
+    /**
+     * @brief   Reads the given sensor once and updates its validity state.
+     * @param   sensor The registry entry of the sensor to read.
+     * @return  true if the reading was valid, false otherwise.
+     */
+    bool read_sensor(Sensor &sensor);
+
+    /**
+     * @brief   Checks whether the latest reading of a sensor may be used for the room value.
+     * @details A sensor contributes as long as it delivered a valid reading and has not failed
+     *          `MAX_FAULTY_MEASUREMENT_ATTEMPTS` times in a row since.
+     * @param   sensor The registry entry of the sensor.
+     * @return  true if the sensor is considered valid.
+     */
+    bool is_sensor_valid(const Sensor &sensor);
+
+    /**
+     * @brief   Checks whether any sensor of the registry is still preheating.
+     * @details Each driver instance is asked, so a UART sensor with its own preheating state is waited for as well.
+     * @return  true if at least one sensor is preheating.
+     */
+    bool is_any_sensor_preheating();
+
+    /**
+     * @brief   Combines the latest readings of all valid sensors into one room value.
+     * @return  The room value in ppm or `MEASUREMENT_NOT_VALID_ERROR`, if no sensor is valid.
+     */
+    int get_room_measurement_in_ppm();
+
     /**
      * @brief   Sets the timestamp for the last sensor use.
      * @details Updates the global state with the current time, ensuring accurate tracking for timing-related operations.
@@ -28,41 +119,30 @@ namespace Co2SensorController {
     /**
      * @brief   Waits until a specific time has elapsed.
      * @details This function blocks the execution of the program until the required time interval has passed.
-     * @param   time_stamp_since_time_has_to_pass_ms The starting timestamp to measure the interval.
-     * @param   time_to_pass_ms The duration (in milliseconds) that must elapse.
+     * @param   time_stamp_since_time_has_to_pass The starting time point to measure the interval.
+     * @param   time_to_pass The duration that must elapse.
      */
-    void wait_until_time_passed(unsigned long time_stamp_since_time_has_to_pass_ms, unsigned long time_to_pass_ms);
+    void wait_until_time_passed(SystemTime::TimePoint time_stamp_since_time_has_to_pass,
+                                SystemTime::Duration time_to_pass);
 
     /**
-     * @brief   Combines two strings into a single buffer with a space separating them.
-     * @param   buffer The destination buffer to hold the concatenated string.
-     * @param   buffer_size The size of the buffer (to avoid overflows).
-     * @param   string_1 The first string to concatenate.
-     * @param   string_2 The second string to concatenate.
-     * @note    If the buffer size is insufficient, the contents may be truncated.
+     * @brief   Waits (running the background tasks) until shortly before the next expected PWM pulse of a sensor.
+     * @details The pulses start on a grid of PWM cycles, known from the start of the last pulse and the measured
+     *          period. `pulseInLong` then only blocks for the pulse itself, instead of up to a whole cycle for its
+     *          start. Does nothing for a UART sensor, or if the last pulse was not measured within
+     *          `MAX_PWM_CYCLES_BETWEEN_PULSES` cycles.
+     * @param   sensor The registry entry of the sensor to read next.
      */
-    void concat_strings(char *buffer, size_t buffer_size, const char *string_1, const char *string_2);
+    void wait_until_next_pwm_pulse(const Sensor &sensor);
 
     /**
-     * @brief   Handles the preheating process of the CO2 sensor.
-     * @details Preheats the sensor as per the manufacturer's recommendations. During this process:
-     *          - A progress bar is displayed on the screen to indicate preheating progress.
-     *          - The function ensures the sensor is ready before proceeding.
-     * @note    This function will block execution while waiting for the sensor to complete preheating.
+     * @brief   Shows the warm-up status of the sensor on the display.
+     * @details Shows the initialization message during the initial wait, and a progress bar while the sensor is
+     *          preheating. The bar grows by one symbol per completed unit of preheating time (counted from the
+     *          start-up, like the preheating of the sensor). The display is only updated when the content changes.
+     * @param   is_preheating True while the sensor is preheating, false during the initial wait.
      */
-    void preheat_sensor();
-
-    /**
-     * @brief   Renders a progress bar for the sensor preheating process.
-     * @details Updates the display to show the progress of the sensor preheating, adding a symbol for each completed
-     *          unit of preheating time.
-     * @param   row_1 The first row text to display on the screen.
-     * @param   row_2_buffer A buffer that holds the second-row progress bar text.
-     * @param   bar_with The width of the progress bar (usually corresponds to the display's width in characters).
-     * @param   progress_bar_counter A pointer to the counter that tracks completed progress bar steps.
-     */
-    void display_preheat_progress_bar(const char *row_1, char *row_2_buffer, uint8_t bar_with,
-                                      int *progress_bar_counter);
+    void display_warm_up_status(bool is_preheating);
 
     /**
      * @brief   Handles errors related to invalid sensor measurements.
@@ -78,19 +158,11 @@ namespace Co2SensorController {
     constexpr char INIT[] = "Initializing"; ///< Status message for the sensor initialization process
     constexpr char PREHEAT[] = "Preheating"; ///< Status message displayed during sensor preheating.
     constexpr char PROGRESS_BAR_SYMBOL[] = "#"; ///< Symbol used to display progress in the preheating progress bar.
-    constexpr char PREHEAT_COMPLETE[] = "Preheating complete.";
-    ///< Message shown after the sensor has completed preheating.
-    constexpr size_t SENSOR_NAME_LENGTH = sizeof(SENSOR_NAME) - 1;
-    ///< Length of the sensor's name, excluding the null-terminator.
-    constexpr size_t INIT_LENGTH = sizeof(INIT) - 1;
-    ///< Length of the initialization message, excluding the null-terminator.
-    constexpr size_t PREHEAT_LENGTH = sizeof(PREHEAT) - 1;
-    ///< Length of the preheating message, excluding the null-terminator.
-    constexpr size_t INIT_MESSAGE_LENGTH = SENSOR_NAME_LENGTH + INIT_LENGTH + 1;
-    ///< Combined length of the sensor name and initialization message, including a space.
-    constexpr size_t PREHEAT_MESSAGE_LENGTH = SENSOR_NAME_LENGTH + PREHEAT_LENGTH + 1;
-    ///< Combined length of the sensor name and preheating message, including a space.
-    constexpr unsigned long WAIT_BETWEEN_TWO_SENSOR_READINGS_TIME_MS = 2000UL;
+    constexpr auto INIT_MESSAGE = TextFormatter::concatenate(SENSOR_NAME, ' ', INIT);
+    ///< Sensor name and initialization message, separated by a space (concatenated at compile time).
+    constexpr auto PREHEAT_MESSAGE = TextFormatter::concatenate(SENSOR_NAME, ' ', PREHEAT);
+    ///< Sensor name and preheating message, separated by a space (concatenated at compile time).
+    constexpr SystemTime::Duration WAIT_BETWEEN_TWO_SENSOR_READINGS_TIME = SystemTime::seconds(2);
     ///< Waiting period between readings
     constexpr unsigned long PREHEATING_TIME_MS = 180000UL;
     ///< Preheating duration for MH-Z19B sensor in milliseconds (3 minutes as per the datasheet).
@@ -100,113 +172,311 @@ namespace Co2SensorController {
             PREHEATING_TIME_MS / DisplayController::DISPLAY_WIDTH;
     ///< Duration (in milliseconds) for one step in the preheating progress bar.
     constexpr uint8_t MAX_FAULTY_MEASUREMENT_ATTEMPTS = 3;
-    ///< Maximum number of retries allowed for sensor CO2 measurements before declaring an invalid result.
+    ///< Number of consecutive faulty readings after which a sensor is no longer considered valid.
     constexpr int MIN_VALID_CO2_VALUE_PPM = 400;
     ///< The minimum acceptable CO2 measurement value for MH-Z19B sensor in ppm (400 as per the datasheet).
     constexpr int MAX_VALID_CO2_VALUE_PPM = 5000;
     ///< The maximum acceptable CO2 measurement value for MH-Z19B sensor in ppm (5'000 as per the used library).
+    constexpr int NO_READING = -2; ///< Reading of a sensor, that sent no PWM pulse or no UART response.
+    constexpr unsigned long NOMINAL_PWM_PERIOD_US = 1004000UL; ///< PWM cycle of the MH-Z19B (as per the datasheet).
+    constexpr unsigned long PWM_RANGE_PPM = 5000UL; ///< CO2 value of a pulse over the whole PWM cycle.
+    constexpr unsigned long PWM_MARGIN_US = 2000UL; ///< Minimum high and low time of a PWM cycle (2 ms).
+    constexpr unsigned long PWM_TIMEOUT_US = 2 * NOMINAL_PWM_PERIOD_US + 100000UL;
+    ///< Time to wait for a PWM pulse: the rest of a pulse just missed and a whole 5000 ppm cycle, plus 100 ms.
+    constexpr unsigned long MAX_PWM_CYCLES_BETWEEN_PULSES = 8UL;
+    ///< Most PWM cycles between two pulses to measure the period from (rounds correctly up to a clock error of 6 %).
+    constexpr unsigned long PWM_EDGE_MARGIN_US = 20000UL;
+    ///< Time before the expected start of a PWM pulse, at which the blocking measurement starts (20 ms).
+    constexpr unsigned long PWM_DECODE_RESOLUTION_US = 10UL;
+    ///< Resolution of the PWM decoding, which keeps the calculation within 32 bits.
+    constexpr MeasurementAggregator::Strategy AGGREGATION_STRATEGY = MeasurementAggregator::MAXIMUM;
+    ///< Strategy to combine the readings of several sensors into one room value.
 
+    Sensor sensors[] = {
+        {
+            PWM_PIN, MHZ(PWM_PIN, MHZ::MHZ19B), PWM, WAIT_BETWEEN_TWO_SENSOR_READINGS_TIME, 1,
+            SystemTime::TimePoint(), MEASUREMENT_NOT_VALID_ERROR, 0, SensorHealth(), SystemTime::TimePoint(), 0UL
+        },
+        // Further sensors are registered here, e.g. a sensor on another PWM pin:
+        // {OTHER_PWM_PIN, MHZ(OTHER_PWM_PIN, MHZ::MHZ19B), PWM, WAIT_BETWEEN_TWO_SENSOR_READINGS_TIME, 1, SystemTime::TimePoint(), MEASUREMENT_NOT_VALID_ERROR, 0, SensorHealth(), SystemTime::TimePoint(), 0UL},
+        // or a sensor connected via UART:
+        // {OTHER_PWM_PIN, MHZ(RX_PIN, TX_PIN, OTHER_PWM_PIN, MHZ::MHZ19B), UART, WAIT_BETWEEN_TWO_SENSOR_READINGS_TIME, 1, SystemTime::TimePoint(), MEASUREMENT_NOT_VALID_ERROR, 0, SensorHealth(), SystemTime::TimePoint(), 0UL},
+    }; ///< Registry of all CO2 sensors, polled round-robin.
+    constexpr uint8_t NUMBER_OF_SENSORS = sizeof(sensors) / sizeof(sensors[0]); ///< Number of registered sensors.
+    static_assert(NUMBER_OF_SENSORS <= MeasurementAggregator::MAX_NUMBER_OF_MEASUREMENTS,
+                  "Too many sensors registered to combine their readings.");
+    uint8_t next_sensor_index = 0; ///< Index of the sensor to read in the next call of `get_measurement_in_ppm`.
+    SystemTime::TimePoint initialization_time_stamp; ///< Time the sensor controller was initialized.
+    bool is_sensor_warmed_up = false; ///< True, when the initial wait and the preheating are completed.
+    constexpr int8_t NO_WARM_UP_STATUS = -2; ///< Warm-up status: nothing shown yet.
+    constexpr int8_t INIT_MESSAGE_STATUS = -1; ///< Warm-up status: initialization message shown.
+    int8_t shown_warm_up_status = NO_WARM_UP_STATUS;
+    ///< Warm-up status on the display: the length of the preheating progress bar, or one of the states above.
+    unsigned long invalid_measurement_count = 0UL; ///< Number of invalid readings (of all sensors) since start-up.
+    unsigned long preheating_duration_ms = 0UL; ///< Time from start-up until the warm-up was completed.
 
-    MHZ co2_sensor(PWM_PIN, MHZ::MHZ19B);
-    ///< The CO2 sensor object instance initialized with the appropriate pin and sensor type.
-
-    void initialize() {
-        pinMode(PWM_PIN, INPUT); // Set pin Mode for sensor.
+    void initialize(const bool is_sensor_warm) {
+        for (const Sensor &sensor: sensors) {
+            pinMode(sensor.pwm_pin, INPUT); // Set pin Mode for sensor.
+        }
         set_sensor_use_time_stamp(); // Set time stamp, for sensor use.
-        char init_message[INIT_MESSAGE_LENGTH] = "";
-        ///< Buffer to store the initialization message that combines the sensor name and status.
-        concat_strings(init_message, INIT_MESSAGE_LENGTH, SENSOR_NAME, INIT);
-        TRACE_LN_s(init_message);
-        DisplayController::output(init_message, ""); // Display init message.
-        wait_until_time_passed(AirQualityMeter::state.last_co2_sensor_used_time_stamp_ms, WAIT_BETWEEN_TWO_SENSOR_READINGS_TIME_MS);
-        preheat_sensor();
+        initialization_time_stamp = SystemTime::TimePoint(StateAccess::read().last_co2_sensor_used_time_stamp_ms);
+        is_sensor_warmed_up = is_sensor_warm;
+        if (is_sensor_warm) {
+            for (Sensor &sensor: sensors) {
+                sensor.last_used_time_stamp = SystemTime::now() - sensor.cycle_time; // the first reading is due now
+            }
+        }
+    }
+
+    bool is_warmed_up() {
+        if (is_sensor_warmed_up) {
+            return true;
+        }
+        if (!SystemTime::has_elapsed(initialization_time_stamp, WAIT_BETWEEN_TWO_SENSOR_READINGS_TIME)) {
+            display_warm_up_status(false);
+            return false;
+        }
+        if (is_any_sensor_preheating()) {
+            display_warm_up_status(true);
+            return false;
+        }
+        // The sensor was not read yet, so the first reading is due at once.
+        for (Sensor &sensor: sensors) {
+            sensor.last_used_time_stamp = SystemTime::now() - sensor.cycle_time;
+        }
+        set_sensor_use_time_stamp();
+        is_sensor_warmed_up = true;
+        preheating_duration_ms = millis();
+        TRACE_LN_u(preheating_duration_ms);
+        return true;
     }
 
     int get_measurement_in_ppm() {
-        for (int attempt = 0; attempt < MAX_FAULTY_MEASUREMENT_ATTEMPTS; attempt++) {
-            ///< `attempt` is the current retry count for fetching a valid measurement from the sensor.
-            TRACE_LN_d(attempt);
-
-            // Wait for the minimum cycle time to ensure valid readings
-            wait_until_time_passed(AirQualityMeter::state.last_co2_sensor_used_time_stamp_ms, WAIT_BETWEEN_TWO_SENSOR_READINGS_TIME_MS);
-
-            // Read CO2 value through PWM and return if valid, otherwise retry
-            const int ppm_pwm = co2_sensor.readCO2PWM();
-            ///< The CO2 reading in ppm retrieved using the PWM interface of the sensor.
-            set_sensor_use_time_stamp();
-            if (ppm_pwm >= MIN_VALID_CO2_VALUE_PPM && ppm_pwm <= MAX_VALID_CO2_VALUE_PPM) {
-                return ppm_pwm; // Return valid value.
+        Sensor &sensor = sensors[next_sensor_index]; ///< Sensor to read in this call (round-robin).
+        TRACE_LN_d(next_sensor_index);
+        next_sensor_index = (next_sensor_index + 1) % NUMBER_OF_SENSORS;
+
+        // Wait for the minimum cycle time of this sensor to ensure valid readings. With several sensors, the other
+        // sensors have been read in the meantime, so this wait shrinks as sensors are added. Both waits run the
+        // background tasks, only the PWM pulse itself is measured blocking (pin 4 has no pin change interrupt).
+        wait_until_time_passed(sensor.last_used_time_stamp, sensor.cycle_time);
+        wait_until_next_pwm_pulse(sensor);
+
+        const bool is_reading_valid = read_sensor(sensor);
+        const int room_measurement_ppm = get_room_measurement_in_ppm();
+        ///< Combined value of all valid sensors, including the reading just taken.
+        if (room_measurement_ppm == MEASUREMENT_NOT_VALID_ERROR &&
+            sensor.consecutive_faulty_measurements >= MAX_FAULTY_MEASUREMENT_ATTEMPTS) {
+            invalid_measurement_error_handler();
+        }
+        // The room value of a faulty reading only repeats the latest valid readings, it is no new sample.
+        return !is_reading_valid && room_measurement_ppm != MEASUREMENT_NOT_VALID_ERROR
+                   ? NO_NEW_MEASUREMENT
+                   : room_measurement_ppm;
+    }
+
+    unsigned long get_invalid_measurement_count() {
+        return invalid_measurement_count;
+    }
+
+    uint8_t get_number_of_sensors() {
+        return NUMBER_OF_SENSORS;
+    }
+
+    SensorHealth get_sensor_health(const uint8_t sensor_index) {
+        const Sensor &sensor = sensors[sensor_index < NUMBER_OF_SENSORS ? sensor_index : 0];
+        SensorHealth health = sensor.health; ///< Counters and gauges, completed with the age of the last reading.
+        health.time_since_last_valid_reading_ms = sensor.last_valid_measurement_ppm == MEASUREMENT_NOT_VALID_ERROR
+                                                      ? NO_VALID_READING
+                                                      : SystemTime::elapsed_since(sensor.last_valid_time_stamp).
+                                                      to_milliseconds();
+        return health;
+    }
+
+    unsigned long get_preheating_duration_ms() {
+        return preheating_duration_ms;
+    }
+
+    bool read_sensor(Sensor &sensor) {
+        const int measurement_ppm = sensor.interface == UART ? sensor.device.readCO2UART() : read_pwm_sensor(sensor);
+        ///< The CO2 reading in ppm retrieved from the sensor.
+        sensor.last_used_time_stamp = SystemTime::now();
+        set_sensor_use_time_stamp();
+        TRACE_LN_d(measurement_ppm);
+        sensor.health.number_of_readings++;
+        if (measurement_ppm >= MIN_VALID_CO2_VALUE_PPM && measurement_ppm <= MAX_VALID_CO2_VALUE_PPM) {
+            sensor.last_valid_measurement_ppm = measurement_ppm;
+            sensor.last_valid_time_stamp = sensor.last_used_time_stamp;
+            sensor.consecutive_faulty_measurements = 0;
+            return true;
+        }
+        invalid_measurement_count++;
+        if (measurement_ppm < 0) {
+            sensor.health.number_of_missing_readings++; // no pulse, or an error status of the UART driver
+        } else {
+            sensor.health.number_of_out_of_range_readings++;
+        }
+        if (sensor.consecutive_faulty_measurements < UINT8_MAX) {
+            sensor.consecutive_faulty_measurements++;
+        }
+        if (sensor.consecutive_faulty_measurements > sensor.health.max_consecutive_faulty_readings) {
+            sensor.health.max_consecutive_faulty_readings = sensor.consecutive_faulty_measurements;
+        }
+        return false;
+    }
+
+    int read_pwm_sensor(Sensor &sensor) {
+        const unsigned long high_time_us = pulseInLong(sensor.pwm_pin, HIGH, PWM_TIMEOUT_US);
+        ///< Length of the PWM pulse, 0 on a timeout.
+        const unsigned long falling_edge_us = micros(); ///< End of the PWM pulse.
+        TRACE_LN_u(high_time_us);
+        if (high_time_us == 0) {
+            return NO_READING;
+        }
+        update_pwm_period(sensor, falling_edge_us - high_time_us);
+        const unsigned long period_us = sensor.health.pwm_period_us != 0
+                                            ? sensor.health.pwm_period_us
+                                            : NOMINAL_PWM_PERIOD_US;
+        ///< PWM cycle to decode the pulse with: the measured one, as soon as it is known.
+        const int measurement_ppm = decode_pwm(high_time_us, period_us);
+        sensor.health.pwm_duty_drift_ppm = measurement_ppm - decode_pwm(high_time_us, NOMINAL_PWM_PERIOD_US);
+        return measurement_ppm;
+    }
+
+    int decode_pwm(const unsigned long high_time_us, const unsigned long period_us) {
+        if (high_time_us < PWM_MARGIN_US || period_us <= 2 * PWM_MARGIN_US) {
+            return 0;
+        }
+        return static_cast<int>(PWM_RANGE_PPM *
+                                ((high_time_us - PWM_MARGIN_US) / PWM_DECODE_RESOLUTION_US) /
+                                ((period_us - 2 * PWM_MARGIN_US) / PWM_DECODE_RESOLUTION_US));
+    }
+
+    void update_pwm_period(Sensor &sensor, const unsigned long rising_edge_us) {
+        const unsigned long time_since_last_pulse_us = rising_edge_us - sensor.last_rising_edge_us;
+        ///< Time between the starts of the previous and the new pulse.
+        const bool has_last_pulse = sensor.last_rising_edge_us != 0; ///< True, if a previous pulse was measured.
+        sensor.last_rising_edge_us = rising_edge_us;
+        if (!has_last_pulse) {
+            return;
+        }
+        const unsigned long number_of_cycles = (time_since_last_pulse_us + NOMINAL_PWM_PERIOD_US / 2) /
+                                               NOMINAL_PWM_PERIOD_US;
+        ///< Whole PWM cycles between the two pulses.
+        if (number_of_cycles == 0 || number_of_cycles > MAX_PWM_CYCLES_BETWEEN_PULSES) {
+            return;
+        }
+        sensor.health.pwm_period_us = time_since_last_pulse_us / number_of_cycles;
+        TRACE_LN_u(sensor.health.pwm_period_us);
+    }
+
+    bool is_sensor_valid(const Sensor &sensor) {
+        return sensor.last_valid_measurement_ppm != MEASUREMENT_NOT_VALID_ERROR &&
+               sensor.consecutive_faulty_measurements < MAX_FAULTY_MEASUREMENT_ATTEMPTS;
+    }
+
+    bool is_any_sensor_preheating() {
+        for (Sensor &sensor: sensors) {
+            if (sensor.device.isPreHeating()) {
+                return true;
             }
-            TRACE_LN_d(ppm_pwm);
         }
-        invalid_measurement_error_handler();
-        return MEASUREMENT_NOT_VALID_ERROR; // Return error code, if no valid value was measured.
+        return false;
+    }
+
+    int get_room_measurement_in_ppm() {
+        int valid_measurements_ppm[NUMBER_OF_SENSORS]; ///< Latest readings of all valid sensors.
+        uint8_t weights[NUMBER_OF_SENSORS]; ///< Weights of all valid sensors.
+        uint8_t number_of_valid_sensors = 0;
+        for (const Sensor &sensor: sensors) {
+            if (is_sensor_valid(sensor)) {
+                valid_measurements_ppm[number_of_valid_sensors] = sensor.last_valid_measurement_ppm;
+                weights[number_of_valid_sensors] = sensor.weight;
+                number_of_valid_sensors++;
+            }
+        }
+        TRACE_LN_d(number_of_valid_sensors);
+        if (number_of_valid_sensors == 0) {
+            return MEASUREMENT_NOT_VALID_ERROR;
+        }
+        return MeasurementAggregator::combine(valid_measurements_ppm, weights, number_of_valid_sensors,
+                                              AGGREGATION_STRATEGY);
     }
 
     void set_sensor_use_time_stamp() {
-        AirQualityMeter::state.last_co2_sensor_used_time_stamp_ms = millis();
-        TRACE_LN_u(AirQualityMeter::state.last_co2_sensor_used_time_stamp_ms);
-    }
-
-    void wait_until_time_passed(const unsigned long time_stamp_since_time_has_to_pass_ms,
-                                const unsigned long time_to_pass_ms) {
-        const unsigned long current_time = millis(); ///< Current time in milliseconds since the system started.
-        const unsigned long time_passed_ms = current_time - time_stamp_since_time_has_to_pass_ms;
-        ///< Time elapsed since the specified timestamp.
-        TRACE_LN_u(time_passed_ms);
-        TRACE_LN_u(time_to_pass_ms);
-        if (time_passed_ms < time_to_pass_ms) {
-            const unsigned long time_to_wait_ms = time_to_pass_ms - time_passed_ms;
-            ///< Remaining time to wait (in milliseconds) if the required interval has not yet passed.
-            Log.traceln("%s%u", LogController::DELAY_TIME, time_to_wait_ms);
-            NotBlockingTimeHandler::wait_ms(time_to_wait_ms);
-        }
-    }
-
-    void concat_strings(char *buffer, const size_t buffer_size, const char *string_1,
-                        const char *string_2) {
-        snprintf(buffer, buffer_size, "%s %s", string_1, string_2);
-    }
-
-    void preheat_sensor() {
-        if (co2_sensor.isPreHeating()) {
-            set_sensor_use_time_stamp();
-            char preheat_message[PREHEAT_MESSAGE_LENGTH];
-            ///< Buffer to store the preheating status message displayed to the user.
-            concat_strings(preheat_message, PREHEAT_MESSAGE_LENGTH, SENSOR_NAME, PREHEAT);
-            TRACE_LN_s(preheat_message);
-            int progress_bar_counter = 0; ///< Counter to track the progress bar's current position during preheating.
-            char display_row_2[DisplayController::DISPLAY_WIDTH + 1] = "";
-            ///< Buffer to hold the content of the second row of the display (progress bar).
-            do {
-                set_sensor_use_time_stamp();
-                display_preheat_progress_bar(preheat_message, display_row_2, DisplayController::DISPLAY_WIDTH,
-                                             &progress_bar_counter);
-                wait_until_time_passed(AirQualityMeter::state.last_co2_sensor_used_time_stamp_ms,
-                                       PREHEAT_PROGRESS_BAR_UNIT_PROGRESS_MS);
-            } while (co2_sensor.isPreHeating());
-            set_sensor_use_time_stamp();
-        }
-    }
-
-    void display_preheat_progress_bar(const char *row_1, char *row_2_buffer, const uint8_t bar_with,
-                                      int *progress_bar_counter) {
-        TRACE_LN_d(*progress_bar_counter);
-        if (*progress_bar_counter > 0 && *progress_bar_counter <= bar_with) {
-            ///< Start showing progress only, when there is a progress (> 0)
-            ///< Show progress until progress bar is 'full' (<= bar_with)
-            row_2_buffer[*progress_bar_counter - 1] = *PROGRESS_BAR_SYMBOL;
-            ///< Updates the progress bar buffer with the next progress symbol.
-        }
-        (*progress_bar_counter)++; ///< Increments the progress bar counter by one for the next step.
-        DisplayController::output(row_1, row_2_buffer);
-        TRACE_LN_s(row_1);
-        TRACE_LN_s(row_2_buffer);
+        const unsigned long last_co2_sensor_used_time_stamp_ms = millis();
+        StateAccess::write([last_co2_sensor_used_time_stamp_ms](AirQualityMeter::State &state) {
+            state.last_co2_sensor_used_time_stamp_ms = last_co2_sensor_used_time_stamp_ms;
+        });
+        TRACE_LN_u(last_co2_sensor_used_time_stamp_ms);
+    }
+
+    void wait_until_time_passed(const SystemTime::TimePoint time_stamp_since_time_has_to_pass,
+                                const SystemTime::Duration time_to_pass) {
+        const SystemTime::Duration time_passed = SystemTime::elapsed_since(time_stamp_since_time_has_to_pass);
+        ///< Time elapsed since the specified time point.
+        TRACE_LN_u(time_passed.to_milliseconds());
+        TRACE_LN_u(time_to_pass.to_milliseconds());
+        if (time_passed < time_to_pass) {
+            const SystemTime::Duration time_to_wait = time_to_pass - time_passed;
+            ///< Remaining time to wait if the required interval has not yet passed.
+            Log.traceln("%s%u", LogController::DELAY_TIME, time_to_wait.to_milliseconds());
+            NotBlockingTimeHandler::wait_ms(time_to_wait.to_milliseconds());
+        }
+    }
+
+    void wait_until_next_pwm_pulse(const Sensor &sensor) {
+        if (sensor.interface != PWM || sensor.last_rising_edge_us == 0) {
+            return;
+        }
+        const unsigned long period_us = sensor.health.pwm_period_us != 0
+                                            ? sensor.health.pwm_period_us
+                                            : NOMINAL_PWM_PERIOD_US;
+        ///< PWM cycle of the sensor: the measured one, as soon as it is known.
+        const unsigned long time_since_last_pulse_us = micros() - sensor.last_rising_edge_us;
+        ///< Time since the start of the last pulse.
+        if (time_since_last_pulse_us > MAX_PWM_CYCLES_BETWEEN_PULSES * period_us) {
+            return; // the grid of the pulses is not known precisely enough anymore
+        }
+        const unsigned long time_to_next_pulse_us = period_us - time_since_last_pulse_us % period_us;
+        ///< Time until the next pulse is expected to start.
+        if (time_to_next_pulse_us > PWM_EDGE_MARGIN_US) {
+            NotBlockingTimeHandler::wait_ms((time_to_next_pulse_us - PWM_EDGE_MARGIN_US) / 1000UL);
+        }
+    }
+
+    void display_warm_up_status(const bool is_preheating) {
+        const unsigned long completed_preheat_units = millis() / PREHEAT_PROGRESS_BAR_UNIT_PROGRESS_MS;
+        ///< Number of completed units of preheating time (the preheating is counted from the start-up).
+        const int8_t warm_up_status = !is_preheating
+                                          ? INIT_MESSAGE_STATUS
+                                          : completed_preheat_units < DisplayController::DISPLAY_WIDTH
+                                                ? static_cast<int8_t>(completed_preheat_units)
+                                                : static_cast<int8_t>(DisplayController::DISPLAY_WIDTH);
+        ///< Status to show: the length of the progress bar, or the initialization message.
+        if (warm_up_status == shown_warm_up_status) {
+            return;
+        }
+        shown_warm_up_status = warm_up_status;
+        if (warm_up_status == INIT_MESSAGE_STATUS) {
+            const char *init_message = INIT_MESSAGE.c_str(); ///< Sensor name and initialization message.
+            TRACE_LN_s(init_message);
+            DisplayController::output(init_message, "");
+            return;
+        }
+        char progress_bar[DisplayController::DISPLAY_WIDTH + 1]; ///< Second row of the display (progress bar).
+        memset(progress_bar, *PROGRESS_BAR_SYMBOL, warm_up_status);
+        progress_bar[warm_up_status] = '\0';
+        const char *preheat_message = PREHEAT_MESSAGE.c_str(); ///< Preheating status message displayed to the user.
+        TRACE_LN_s(preheat_message);
+        TRACE_LN_s(progress_bar);
+        DisplayController::output(preheat_message, progress_bar);
     }
 
     void invalid_measurement_error_handler() {
         Log.errorln(SensorError::MEASUREMENT_NOT_VALID);
-        LedArray::output(LedErrorPatterns::SENSOR_ERROR_MEASUREMENT_NOT_VALID);
+        LedArray::play(LedErrorPatterns::SENSOR_ERROR_MEASUREMENT_NOT_VALID);
         Log.verboseln(LogController::LED_UPDATED);
         DisplayController::output(GeneralError::ERROR_MESSAGE_ROW_ONE, SensorError::MEASUREMENT_NOT_VALID);
         Log.verboseln(LogController::DISPLAY_UPDATED);
@@ -8,28 +8,93 @@
 #ifndef CO2_SENSOR_CONTROLLER_H
 #define CO2_SENSOR_CONTROLLER_H
 
+#include <stdint.h>
+
 namespace Co2SensorController {
     /**
      * @enum    SensorErrorCode
      * @brief   Error codes generated by the CO2 sensor controller.
      */
     enum SensorErrorCode : int {
-        MEASUREMENT_NOT_VALID_ERROR = -1 ///< Measurement is outside the valid range
+        MEASUREMENT_NOT_VALID_ERROR = -1, ///< Measurement is outside the valid range
+        NO_NEW_MEASUREMENT = -3 ///< The sensor read in this call was faulty, the room value is unchanged
+    };
+
+    constexpr unsigned long NO_VALID_READING = 0xFFFFFFFFUL;
+    ///< Time since the last valid reading of a sensor, that has not delivered a valid reading yet.
+
+    /**
+     * @struct  SensorHealth
+     * @brief   Health counters and PWM timing gauges of one sensor.
+     * @details The counters accumulate since start-up. The PWM gauges stay 0 for a sensor read via UART.
+     */
+    struct SensorHealth {
+        unsigned long number_of_readings; ///< Readings since start-up.
+        unsigned long number_of_out_of_range_readings; ///< Readings outside the valid range.
+        unsigned long number_of_missing_readings; ///< Readings without a PWM pulse (timeout) or UART response.
+        uint8_t max_consecutive_faulty_readings; ///< Most faulty readings in a row (retries until a valid reading).
+        unsigned long pwm_period_us; ///< Measured PWM cycle period (in µs), 0 if not measured yet.
+        int pwm_duty_drift_ppm;
+        ///< Latest reading minus the same pulse decoded with the nominal PWM period (1004 ms).
+        unsigned long time_since_last_valid_reading_ms; ///< Age of the last valid reading or `NO_VALID_READING`.
     };
 
     /**
      * @brief   Initializes the CO2 sensor module.
-     * @details Sets up the MH-Z19B sensor by configuring pins, and preheating it.
+     * @details Configures the pins of the MH-Z19B sensors and starts the warm-up (initial wait and preheating), which
+     *          is completed by polling `is_warmed_up`. This function does not block.
+     *          After a warm restart (the sensor kept running during the reset), the warm-up is skipped and the
+     *          sensor can be read immediately.
+     * @param   is_sensor_warm True, if the sensor is already preheated.
      */
-    void initialize();
+    void initialize(bool is_sensor_warm = false);
+
+    /**
+     * @brief   Checks whether the sensor is ready for the first reading, and shows the warm-up status.
+     * @details The sensor needs an initial wait and a preheating of 3 minutes after power-on (as per the datasheet).
+     *          Meanwhile, the display shows the preheating progress. As soon as the sensor is ready, the first reading
+     *          is due at once. Call it periodically until it returns true, other initialization can run in between.
+     * @return  True, if the sensor is warmed up.
+     */
+    bool is_warmed_up();
 
     /**
      * @brief   Retrieves the current CO2 measurement in ppm.
-     * @details Fetches the CO2 value using the MH-Z19B sensor and ensures it's within a valid range.
-     * @return  The measured CO2 value in parts per million (ppm) if successful,
-     *          or a SensorErrorCode indicating failure.
+     * @details Reads the next registered MH-Z19B sensor (round-robin), so only one sensor is read per call,
+     *          independent of the number of sensors. The latest valid readings of all sensors are then combined into
+     *          one room value. A sensor that fails `MAX_FAULTY_MEASUREMENT_ATTEMPTS` times in a row is ignored until
+     *          it delivers a valid reading again. Until then, a faulty reading returns `NO_NEW_MEASUREMENT`, so the
+     *          unchanged room value is not processed again as a new sample.
+     *          The call waits for the cycle time of the sensor and, for a PWM sensor, until shortly before its next
+     *          pulse, running the background tasks (display, LEDs) meanwhile. Only the PWM pulse itself (at most 1 s,
+     *          about 160 ms at 800 ppm) is measured blocking, as the PWM pin has no pin change interrupt.
+     * @return  The combined CO2 value in parts per million (ppm) if successful, `NO_NEW_MEASUREMENT` if the reading
+     *          was faulty but a sensor is still valid, or `MEASUREMENT_NOT_VALID_ERROR` if no sensor is valid.
      */
     int get_measurement_in_ppm();
+
+    /**
+     * @brief   Returns the number of invalid sensor readings since start-up.
+     * @return  Number of readings outside the valid range (of all sensors).
+     */
+    unsigned long get_invalid_measurement_count();
+
+    /**
+     * @brief   Returns the number of registered sensors.
+     */
+    uint8_t get_number_of_sensors();
+
+    /**
+     * @brief   Returns the health counters and PWM timing gauges of a sensor.
+     * @param   sensor_index Index of the sensor in the registry (0 to `get_number_of_sensors()` - 1).
+     */
+    SensorHealth get_sensor_health(uint8_t sensor_index);
+
+    /**
+     * @brief   Returns the time from start-up until the warm-up (initial wait and preheating) was completed.
+     * @return  Duration in ms, or 0 while warming up and after a warm restart (no warm-up).
+     */
+    unsigned long get_preheating_duration_ms();
 }
 
 #endif // CO2_SENSOR_CONTROLLER_H
@@ -5,10 +5,16 @@
  *          display module, including the `initialize` and `output` functions.
  *          Used in the Air Quality Meter project for displaying messages such as status
  *          or air quality readings.
+ *          The display content is kept twice: the requested content and the content currently shown on the display.
+ *          `render` compares both and writes only the differing characters, a few per call. The custom glyphs are
+ *          handled in the same way: only changed pixel rows are uploaded to the CGRAM, before the characters.
  */
 
 #include <display_controller.h>
 #include <pin_configuration.h>
+#include <not_blocking_time_handler.h>
+#include <ArduinoLog.h>
+#include <log_controller.h>
 #include <LiquidCrystal.h> // lib for LCD
 
 namespace DisplayController {
@@ -33,37 +39,145 @@ namespace DisplayController {
         NUMBER_OF_ROWS ///< Total number of rows on the display.
     };
 
+    /**
+     * @brief   Copies a line into a row of the requested display content.
+     * @details Pads the row with spaces or cuts the line off at the display width.
+     */
+    void set_row(uint8_t row, const char *line);
+
+    /**
+     * @brief   Writes up to the given number of changed characters to the display.
+     * @param   max_bus_writes Maximum number of characters and cursor moves to write.
+     */
+    void render(uint8_t max_bus_writes);
+
     // Constants for welcoming messages
-    constexpr int WELCOME_MESSAGE_TIME_MS = 2000; ///< Display duration for the welcome message, in milliseconds.
     constexpr char WELCOME_MESSAGE[] = "Air Quality Meter"; ///< Welcome message displayed on the first line.
     constexpr char INITIALIZING_MESSAGE[] = "Initializing..."; ///< Initialization message displayed on the second line.
+    constexpr uint8_t NUMBER_OF_CELLS = NUMBER_OF_COLUMNS * NUMBER_OF_ROWS; ///< Number of characters on the display.
+    constexpr uint8_t UNKNOWN_CURSOR_POSITION = 0xFF; ///< Cursor position, if it has to be set before the next write.
+    constexpr uint8_t SET_CGRAM_ADDRESS_COMMAND = 0x40; ///< HD44780 command to select a CGRAM address.
+    constexpr uint8_t UNKNOWN_GLYPH_ROW = 0xFF; ///< Glyph row, which does not match any valid row (5 bits).
 
     LiquidCrystal lcd(RS_PIN, EN_PIN, D4_PIN, D5_PIN, D6_PIN, D7_PIN);
     ///< LiquidCrystal library object for interacting with the LCD1602 module.
 
+    char requested_content[NUMBER_OF_CELLS]; ///< Characters to display (row by row).
+    char shown_content[NUMBER_OF_CELLS]; ///< Characters currently shown on the display (row by row).
+    uint8_t requested_glyphs[NUMBER_OF_GLYPHS][GLYPH_HEIGHT] = {}; ///< Pixel rows of the custom glyphs to display.
+    uint8_t shown_glyphs[NUMBER_OF_GLYPHS][GLYPH_HEIGHT]; ///< Pixel rows currently loaded in the CGRAM.
+    uint8_t changed_glyphs = 0; ///< Bit mask of the glyphs, which may differ from the CGRAM content.
+    bool is_content_changed = false; ///< True, if characters may differ from the display content.
+    uint8_t cursor_position = UNKNOWN_CURSOR_POSITION; ///< Cell the LCD writes the next character to.
+    bool is_message_shown = false; ///< True, if a message holds the display (pages are not displayed).
+
     void initialize() {
         lcd.begin(NUMBER_OF_COLUMNS, NUMBER_OF_ROWS); // Initialisiere das LCD mit 16 Zeichen und 2 Zeilen
         lcd.clear(); // delete the display content
+        memset(shown_content, ' ', NUMBER_OF_CELLS);
+        memset(requested_content, ' ', NUMBER_OF_CELLS);
+        memset(shown_glyphs, UNKNOWN_GLYPH_ROW, sizeof(shown_glyphs)); // the CGRAM content is undefined after reset
 
-        // display Welcome message
-        lcd.setCursor(COLUMN_1, ROW_1); // first line
-        lcd.print(WELCOME_MESSAGE);
-        lcd.setCursor(COLUMN_1, ROW_2); // second line
-        lcd.print(INITIALIZING_MESSAGE);
+        output("", ""); // the display stays empty until the first message or measurement
+        if (!NotBlockingTimeHandler::register_background_task(render)) {
+            Log.errorln("%s %s", LogController::BACKGROUND_TASK_NOT_REGISTERED, LogController::DISPLAY_CONTROLLER);
+        }
+    }
 
-        delay(WELCOME_MESSAGE_TIME_MS); // show the message
-        lcd.clear(); // clear the display content
+    void show_welcome_message() {
+        output(WELCOME_MESSAGE, INITIALIZING_MESSAGE);
+        flush();
     }
 
     void output(const char *line_1, const char *line_2) {
-        lcd.clear(); // delete the display content
+        is_message_shown = true;
+        set_row(ROW_1, line_1);
+        set_row(ROW_2, line_2);
+    }
 
-        // display line 1
-        lcd.setCursor(COLUMN_1, ROW_1); // first line
-        lcd.print(line_1);
+    bool output_page(const char *line_1, const char *line_2) {
+        if (is_message_shown) {
+            return false;
+        }
+        set_row(ROW_1, line_1);
+        set_row(ROW_2, line_2);
+        return true;
+    }
+
+    void dismiss_message() {
+        is_message_shown = false;
+    }
+
+    void set_glyph(const uint8_t slot, const uint8_t *rows) {
+        memcpy(requested_glyphs[slot % NUMBER_OF_GLYPHS], rows, GLYPH_HEIGHT);
+        changed_glyphs |= 1 << slot % NUMBER_OF_GLYPHS;
+    }
+
+    void render() {
+        render(MAX_BUS_WRITES_PER_RENDER);
+    }
+
+    void flush() {
+        render(NUMBER_OF_GLYPHS * GLYPH_HEIGHT * 2 + NUMBER_OF_CELLS * 2);
+        // at most one address and one data write per glyph row and per cell
+    }
+
+    void set_row(const uint8_t row, const char *line) {
+        char *cell = requested_content + row * NUMBER_OF_COLUMNS; ///< First cell of the row.
+        for (uint8_t column = COLUMN_1; column < NUMBER_OF_COLUMNS; column++) {
+            const char character = *line != '\0' ? *line++ : ' '; ///< Character to display in this cell.
+            if (cell[column] != character) {
+                cell[column] = character;
+                is_content_changed = true;
+            }
+        }
+    }
 
-        // display line 2
-        lcd.setCursor(COLUMN_1, ROW_2); // second line
-        lcd.print(line_2);
+    void render(const uint8_t max_bus_writes) {
+        // Most calls have nothing to do, so they return without comparing the content.
+        uint8_t bus_writes = 0; ///< Number of characters, glyph rows and cursor moves written in this call.
+        for (uint8_t slot = 0; changed_glyphs != 0 && slot < NUMBER_OF_GLYPHS; slot++) {
+            if (!(changed_glyphs & 1 << slot)) {
+                continue;
+            }
+            for (uint8_t row = 0; row < GLYPH_HEIGHT; row++) {
+                if (requested_glyphs[slot][row] == shown_glyphs[slot][row]) {
+                    continue;
+                }
+                if (bus_writes + 2 > max_bus_writes) {
+                    return;
+                }
+                lcd.command(SET_CGRAM_ADDRESS_COMMAND | slot * GLYPH_HEIGHT | row);
+                lcd.write(requested_glyphs[slot][row]);
+                shown_glyphs[slot][row] = requested_glyphs[slot][row];
+                cursor_position = UNKNOWN_CURSOR_POSITION; // the address counter now points to the CGRAM
+                bus_writes += 2;
+            }
+            changed_glyphs &= ~(1 << slot);
+        }
+        if (!is_content_changed) {
+            return;
+        }
+        uint8_t position = 0; ///< Cell to compare next.
+        for (; position < NUMBER_OF_CELLS && bus_writes < max_bus_writes; position++) {
+            if (requested_content[position] == shown_content[position]) {
+                continue;
+            }
+            if (cursor_position != position) {
+                lcd.setCursor(position % NUMBER_OF_COLUMNS, position / NUMBER_OF_COLUMNS);
+                cursor_position = position;
+                if (++bus_writes >= max_bus_writes) {
+                    return;
+                }
+            }
+            lcd.write(static_cast<uint8_t>(requested_content[position]));
+            shown_content[position] = requested_content[position];
+            bus_writes++;
+            // The LCD address of the next row does not follow the last column, so the cursor has to be set again.
+            cursor_position = (position + 1) % NUMBER_OF_COLUMNS != 0 ? position + 1 : UNKNOWN_CURSOR_POSITION;
+        }
+        if (position == NUMBER_OF_CELLS) {
+            is_content_changed = false; // all cells compared (and written)
+        }
     }
 }
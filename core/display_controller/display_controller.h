@@ -9,28 +9,79 @@
 
 namespace DisplayController {
     constexpr uint8_t DISPLAY_WIDTH = 16;
+    constexpr uint8_t MAX_BUS_WRITES_PER_RENDER = 4;
+    ///< Maximum number of LCD bus writes (characters, glyph rows and cursor moves) per call of `render`, about 1 ms.
+    constexpr uint8_t NUMBER_OF_GLYPHS = 8; ///< Number of custom glyphs (CGRAM slots) of the HD44780.
+    constexpr uint8_t GLYPH_HEIGHT = 8; ///< Number of pixel rows of a glyph (5 pixels per row).
+    constexpr char FIRST_GLYPH_CHARACTER = 8;
+    ///< Character code of the first custom glyph. The codes 8-15 show the same glyphs as 0-7, but can be used in
+    ///< null-terminated strings.
+
     /**
      * @brief   Initializes the LCD1602 Module.
      * @details Prepares the connected LCD1602 display module for operation by configuring its
      *          dimensions (16 characters, 2 lines) and clearing any existing content.
-     *          Displays an initialization message to indicate system readiness.
      *          Display used: LCD1602 Module (with pin header).
+     *          Registers `render` as background task, so the display is updated while the system waits.
      *          This function should be called during the setup phase of the Arduino program.
      */
     void initialize();
 
+    /**
+     * @brief   Shows the welcome message at once.
+     * @details The message is shown until it is replaced by the next message or dismissed.
+     */
+    void show_welcome_message();
+
 
     /**
-     * @brief   Outputs text to the LCD1602 Module.
-     * @details Updates the connected display module to display the provided text on two lines.
-     *          Display used: LCD1602 Module (with pin header).
-     *          The function clears the display before writing new content to avoid residual text.
-     *          It accepts pointers to text as `const char*` parameters to improve performance by avoiding
-     *          unnecessary copying and to ensure immutability of the provided data.
+     * @brief   Outputs a message to the LCD1602 Module.
+     * @details Sets the text to display on the two lines. The text is not written immediately, but incrementally by
+     *          `render`, so an update never blocks the caller. Only the characters that differ from the current
+     *          display content are written, so the display does not flicker.
+     *          Lines shorter than the display width are padded with spaces, longer lines are cut off.
+     *          A message (e.g. initialization, preheating or error message) holds the display until it is
+     *          dismissed with `dismiss_message`; until then, `output_page` has no effect.
      * @param line_1 Reference to the text to display on the first line of the LCD1602 Module.
      * @param line_2 Reference to the text to display on the second line of the LCD1602 Module.
      */
     void output(const char *line_1, const char *line_2);
+
+    /**
+     * @brief   Outputs a page of the user interface to the LCD1602 Module.
+     * @details Like `output`, but only if no message holds the display.
+     * @param line_1 Reference to the text to display on the first line of the LCD1602 Module.
+     * @param line_2 Reference to the text to display on the second line of the LCD1602 Module.
+     * @return  True if the page is displayed, false if a message holds the display.
+     */
+    bool output_page(const char *line_1, const char *line_2);
+
+    /**
+     * @brief   Releases the display from the last message, so pages are displayed again.
+     */
+    void dismiss_message();
+
+    /**
+     * @brief   Sets the pixels of a custom glyph.
+     * @details Like the text, the glyph is uploaded by `render`, and only the pixel rows that differ from the glyph
+     *          currently loaded in the CGRAM are written. The glyph is shown by the character
+     *          `FIRST_GLYPH_CHARACTER + slot`. Characters already shown with this glyph change as well.
+     * @param slot Index of the CGRAM slot (0-7).
+     * @param rows The `GLYPH_HEIGHT` pixel rows (bits 4-0, from left to right).
+     */
+    void set_glyph(uint8_t slot, const uint8_t *rows);
+
+    /**
+     * @brief   Writes the next changed characters to the display.
+     * @details Writes at most `MAX_BUS_WRITES_PER_RENDER` characters or cursor moves, so the time per call is
+     *          bounded, no matter how much of the display content changed.
+     */
+    void render();
+
+    /**
+     * @brief   Writes all changed characters to the display (blocking).
+     */
+    void flush();
 }
 
 #endif //DISPLAY_CONTROLLER_H
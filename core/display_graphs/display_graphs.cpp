@@ -0,0 +1,124 @@
+/**
+ * @file display_graphs.cpp
+ * @brief Implementation of the graphs shown in a display row.
+ */
+
+#include <display_graphs.h>
+#include <glyph_cache.h>
+#include <thresholds.h>
+
+namespace DisplayGraphs {
+    /**
+     * @brief   Returns the glyph of a vertical bar with the given height (1-8 pixels).
+     */
+    GlyphCache::Glyph get_vertical_bar(uint8_t height);
+
+    /**
+     * @brief   Returns the glyph of a bar graph cell.
+     * @param   filled_columns Number of filled pixel columns from the left (0-5).
+     * @param   tick_column Pixel column of a threshold tick mark (0-4) or `NO_TICK`.
+     */
+    GlyphCache::Glyph get_bar_graph_cell(uint8_t filled_columns, uint8_t tick_column);
+
+    /**
+     * @brief   Converts a CO2 value into the pixel position in the bar graph (0 to `BAR_GRAPH_WIDTH`).
+     */
+    uint8_t get_bar_graph_position(int co2_measurement_ppm);
+
+    constexpr uint8_t WIDTH = DisplayController::DISPLAY_WIDTH; ///< Number of characters of a graph.
+    constexpr uint8_t HEIGHT = DisplayController::GLYPH_HEIGHT; ///< Pixel rows of a character.
+    constexpr uint8_t CELL_WIDTH = 5; ///< Pixel columns of a character.
+    constexpr uint8_t FULL_ROW = 0x1F; ///< Pixel row with all 5 pixels set.
+    constexpr uint8_t BAR_GRAPH_WIDTH = WIDTH * CELL_WIDTH; ///< Number of pixel columns of the bar graph.
+    constexpr uint8_t BAR_TOP_ROW = 2; ///< First pixel row of the bar (rows above and below show the tick marks).
+    constexpr uint8_t BAR_BOTTOM_ROW = 5; ///< Last pixel row of the bar.
+    constexpr uint8_t NO_TICK = 0xFF; ///< Cell without a tick mark.
+    constexpr int TICK_THRESHOLDS_PPM[] = {
+        CO2Thresholds::HIGH_QUALITY_PPM,
+        CO2Thresholds::MEDIUM_QUALITY_PPM,
+        CO2Thresholds::LOWER_MODERATE_QUALITY_PPM,
+        CO2Thresholds::UPPER_MODERATE_QUALITY_PPM
+    }; ///< Thresholds marked in the bar graph.
+
+    void format_sparkline(char *row, const int *values_ppm, uint8_t number_of_values) {
+        if (number_of_values > SPARKLINE_LENGTH) {
+            values_ppm += number_of_values - SPARKLINE_LENGTH;
+            number_of_values = SPARKLINE_LENGTH;
+        }
+        int minimum_ppm = number_of_values > 0 ? values_ppm[0] : 0; ///< Lowest reading.
+        int maximum_ppm = minimum_ppm; ///< Highest reading.
+        for (uint8_t i = 1; i < number_of_values; i++) {
+            minimum_ppm = values_ppm[i] < minimum_ppm ? values_ppm[i] : minimum_ppm;
+            maximum_ppm = values_ppm[i] > maximum_ppm ? values_ppm[i] : maximum_ppm;
+        }
+        const long span_ppm = maximum_ppm - minimum_ppm > MIN_SPARKLINE_SPAN_PPM
+                                  ? maximum_ppm - minimum_ppm
+                                  : MIN_SPARKLINE_SPAN_PPM; ///< Value range shown by the bar heights.
+
+        GlyphCache::begin_frame();
+        const uint8_t first_column = WIDTH - number_of_values; ///< Column of the oldest reading.
+        for (uint8_t column = 0; column < WIDTH; column++) {
+            if (column < first_column) {
+                row[column] = ' ';
+                continue;
+            }
+            const long offset_ppm = values_ppm[column - first_column] - minimum_ppm; ///< Height above the minimum.
+            const uint8_t height = static_cast<uint8_t>(1 + offset_ppm * (HEIGHT - 1) / span_ppm);
+            row[column] = GlyphCache::get_character(get_vertical_bar(height));
+        }
+        row[WIDTH] = '\0';
+    }
+
+    void format_bar_graph(char *row, const int co2_measurement_ppm) {
+        const uint8_t bar_end = get_bar_graph_position(co2_measurement_ppm); ///< Number of filled pixel columns.
+        GlyphCache::begin_frame();
+        for (uint8_t column = 0; column < WIDTH; column++) {
+            const uint8_t cell_start = column * CELL_WIDTH; ///< First pixel column of the cell.
+            const uint8_t filled_columns = bar_end <= cell_start
+                                               ? 0
+                                               : bar_end - cell_start >= CELL_WIDTH
+                                                     ? CELL_WIDTH
+                                                     : bar_end - cell_start;
+            uint8_t tick_column = NO_TICK; ///< Pixel column of a threshold in this cell.
+            for (const int threshold_ppm: TICK_THRESHOLDS_PPM) {
+                const uint8_t tick_position = get_bar_graph_position(threshold_ppm);
+                if (tick_position >= cell_start && tick_position < cell_start + CELL_WIDTH) {
+                    tick_column = tick_position - cell_start;
+                }
+            }
+            row[column] = filled_columns == 0 && tick_column == NO_TICK
+                              ? ' '
+                              : GlyphCache::get_character(get_bar_graph_cell(filled_columns, tick_column));
+        }
+        row[WIDTH] = '\0';
+    }
+
+    GlyphCache::Glyph get_vertical_bar(const uint8_t height) {
+        GlyphCache::Glyph glyph = {};
+        for (uint8_t pixel_row = HEIGHT - height; pixel_row < HEIGHT; pixel_row++) {
+            glyph.rows[pixel_row] = FULL_ROW;
+        }
+        return glyph;
+    }
+
+    GlyphCache::Glyph get_bar_graph_cell(const uint8_t filled_columns, const uint8_t tick_column) {
+        GlyphCache::Glyph glyph = {};
+        const uint8_t bar_row = FULL_ROW & ~(FULL_ROW >> filled_columns); ///< Filled pixels from the left.
+        const uint8_t tick_row = tick_column != NO_TICK ? 0x10 >> tick_column : 0; ///< Pixel of the tick mark.
+        for (uint8_t pixel_row = 0; pixel_row < HEIGHT; pixel_row++) {
+            glyph.rows[pixel_row] = pixel_row >= BAR_TOP_ROW && pixel_row <= BAR_BOTTOM_ROW ? bar_row : tick_row;
+        }
+        return glyph;
+    }
+
+    uint8_t get_bar_graph_position(const int co2_measurement_ppm) {
+        if (co2_measurement_ppm <= BAR_GRAPH_MIN_PPM) {
+            return 0;
+        }
+        if (co2_measurement_ppm >= BAR_GRAPH_MAX_PPM) {
+            return BAR_GRAPH_WIDTH;
+        }
+        return static_cast<uint8_t>(static_cast<long>(co2_measurement_ppm - BAR_GRAPH_MIN_PPM) * BAR_GRAPH_WIDTH /
+                                    (BAR_GRAPH_MAX_PPM - BAR_GRAPH_MIN_PPM));
+    }
+}
@@ -0,0 +1,41 @@
+/**
+ * @file display_graphs.h
+ * @brief Header file for the graphs shown in a display row.
+ * @details Graphs are drawn with the custom glyphs of the LCD (`GlyphCache`):
+ *           - Sparkline: one bar per reading, 8 heights scaled between the lowest and highest reading. The 8 bar
+ *             glyphs do not depend on the readings, so a shifting sparkline only rewrites changed characters and
+ *             never the CGRAM.
+ *           - Bar graph: horizontal bar of the CO2 value (80 pixels from `BAR_GRAPH_MIN_PPM` to `BAR_GRAPH_MAX_PPM`)
+ *             with tick marks at the thresholds of the air quality levels (`CO2Thresholds`).
+ */
+
+#ifndef DISPLAY_GRAPHS_H
+#define DISPLAY_GRAPHS_H
+
+#include <Arduino.h>
+#include <display_controller.h>
+
+namespace DisplayGraphs {
+    constexpr uint8_t SPARKLINE_LENGTH = DisplayController::DISPLAY_WIDTH; ///< Number of readings in a sparkline.
+    constexpr int MIN_SPARKLINE_SPAN_PPM = 100;
+    ///< Minimum value range of the sparkline, so sensor noise is not shown as large changes.
+    constexpr int BAR_GRAPH_MIN_PPM = 400; ///< CO2 value at the left end of the bar graph (outdoor air).
+    constexpr int BAR_GRAPH_MAX_PPM = 2000; ///< CO2 value at the right end of the bar graph.
+
+    /**
+     * @brief   Formats a sparkline of the given readings.
+     * @param   row Buffer of at least `DisplayController::DISPLAY_WIDTH + 1` bytes.
+     * @param   values_ppm Readings from the oldest to the newest (at most `SPARKLINE_LENGTH`).
+     * @param   number_of_values Number of readings; with fewer readings the sparkline is right-aligned.
+     */
+    void format_sparkline(char *row, const int *values_ppm, uint8_t number_of_values);
+
+    /**
+     * @brief   Formats a bar graph of the given CO2 value.
+     * @param   row Buffer of at least `DisplayController::DISPLAY_WIDTH + 1` bytes.
+     * @param   co2_measurement_ppm The CO2 value in ppm.
+     */
+    void format_bar_graph(char *row, int co2_measurement_ppm);
+}
+
+#endif //DISPLAY_GRAPHS_H
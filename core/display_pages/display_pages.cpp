@@ -0,0 +1,254 @@
+/**
+ * @file display_pages.cpp
+ * @brief Implementation of the pages of the display user interface.
+ */
+
+#include <display_pages.h>
+#include <display_controller.h>
+#include <display_row_formatter.h>
+#include <display_graphs.h>
+#include <text_formatter.h>
+#include <measurement_statistics.h>
+#include <ventilation_estimator.h>
+#include <co2_sensor_controller.h>
+#include <measurement_filter.h>
+#include <not_blocking_time_handler.h>
+#include <ArduinoLog.h>
+#include <log_controller.h>
+#include <system_time.h>
+
+#ifndef PAGE_ROTATION_TIME_MS
+#define PAGE_ROTATION_TIME_MS 5000UL
+#endif
+
+namespace DisplayPages {
+    /**
+     * @brief   Formats the rows of the given page and passes them to the display controller.
+     */
+    void show_page(Page page);
+
+    /**
+     * @brief   Formats a row `<prefix><value><suffix>`.
+     * @return  Position of the terminating '\0'.
+     */
+    char *format_value_row(char *row, const char *prefix, long value, const char *suffix);
+
+    /**
+     * @brief   Formats the uptime as `<days>d hh:mm:ss`.
+     */
+    void format_uptime_row(char *row, unsigned long uptime_seconds);
+
+    /**
+     * @brief   Formats the range of the recent readings as `<minimum>-<maximum> ppm` and their sparkline.
+     */
+    void format_history_rows(char *row_1, char *row_2);
+
+    /**
+     * @brief   Formats the air exchange rate as `<changes>.<hundredths> /h`, or the state of the measurement.
+     */
+    void format_air_exchange_row(char *row);
+
+    constexpr unsigned long ROTATION_TIME_MS = PAGE_ROTATION_TIME_MS; ///< Time each page is shown (0 = no rotation).
+    constexpr unsigned long PAGE_HOLD_TIME_MS = 30000UL; ///< Time a page selected with the button is shown.
+    constexpr unsigned long REFRESH_TIME_MS = 1000UL; ///< Time between two refreshes of the shown page.
+    constexpr long STEADY_TREND_PPM_PER_HOUR = 50L; ///< Trends within +/- this value are shown as steady.
+    constexpr uint8_t ROW_BUFFER_SIZE = DisplayController::DISPLAY_WIDTH + 1; ///< Size of a row buffer.
+
+    // Division constants
+    constexpr unsigned long SECS_PER_MIN = 60UL; ///< Number of seconds per minute.
+    constexpr unsigned long SECS_PER_HOUR = 3600UL; ///< Number of seconds per hour.
+    constexpr unsigned long SECS_PER_DAY = 86400UL; ///< Number of seconds per day.
+
+    // Page texts
+    constexpr char AVERAGE_TITLE[] = "Average (1 h)"; ///< First row of the average page.
+    constexpr char MINIMUM_PREFIX[] = "Min 1h: "; ///< Prefix of the minimum value.
+    constexpr char MAXIMUM_PREFIX[] = "Max 1h: "; ///< Prefix of the maximum value.
+    constexpr char PPM_SUFFIX[] = " ppm"; ///< Suffix for values in ppm.
+    constexpr char TREND_RISING[] = "Trend: rising"; ///< First row of the trend page (rising CO2 value).
+    constexpr char TREND_FALLING[] = "Trend: falling"; ///< First row of the trend page (falling CO2 value).
+    constexpr char TREND_STEADY[] = "Trend: steady"; ///< First row of the trend page (steady CO2 value).
+    constexpr char TREND_NOT_AVAILABLE[] = "Trend: --"; ///< First row of the trend page (not enough data).
+    constexpr char PPM_PER_HOUR_SUFFIX[] = " ppm/h"; ///< Suffix for the trend.
+    constexpr char AIR_EXCHANGE_TITLE[] = "Air exchange"; ///< First row of the air exchange page.
+    constexpr char AIR_EXCHANGE_MEASURING[] = "measuring"; ///< Second row, while the first decay is measured.
+    constexpr char AIR_EXCHANGE_NOT_AVAILABLE[] = "--"; ///< Second row, if no decay has been measured yet.
+    constexpr char PER_HOUR_SUFFIX[] = " /h"; ///< Suffix for the air exchange rate.
+    constexpr char UPTIME_TITLE[] = "Uptime"; ///< First row of the uptime page.
+    constexpr char RANGE_SEPARATOR[] = "-"; ///< Separator of the minimum and maximum of the recent readings.
+    constexpr char INVALID_PREFIX[] = "Invalid: "; ///< Prefix of the invalid sensor readings.
+    constexpr char OUTLIERS_PREFIX[] = "Outliers: "; ///< Prefix of the rejected outliers.
+
+    volatile bool is_next_page_requested = false; ///< Set by the page button, cleared when the page is switched.
+    Page current_page = CURRENT_VALUE; ///< Page currently shown.
+    bool is_page_held = false; ///< True, if the current page was selected with the button.
+    unsigned long last_page_change_time_ms = 0UL; ///< Time (in ms) the current page was selected.
+    unsigned long last_refresh_time_ms = 0UL; ///< Time (in ms) the current page was last formatted.
+    bool has_measurement = false; ///< True, after the first valid measurement.
+    int co2_measurement_ppm = 0; ///< Current CO2 value in ppm.
+    const char *air_quality_description = ""; ///< Description of the current air quality level.
+    int recent_measurements_ppm[DisplayGraphs::SPARKLINE_LENGTH] = {}; ///< Ring buffer of the recent readings.
+    uint8_t next_recent_measurement_index = 0; ///< Index of the oldest reading (replaced by the next reading).
+    uint8_t number_of_recent_measurements = 0; ///< Number of readings in the ring buffer.
+
+    void initialize() {
+        if (!NotBlockingTimeHandler::register_background_task(update)) {
+            Log.errorln("%s %s", LogController::BACKGROUND_TASK_NOT_REGISTERED, LogController::DISPLAY_PAGES);
+        }
+    }
+
+    void set_measurement(const int current_co2_measurement_ppm, const char *current_air_quality_description) {
+        co2_measurement_ppm = current_co2_measurement_ppm;
+        air_quality_description = current_air_quality_description;
+        recent_measurements_ppm[next_recent_measurement_index] = current_co2_measurement_ppm;
+        next_recent_measurement_index = (next_recent_measurement_index + 1) % DisplayGraphs::SPARKLINE_LENGTH;
+        if (number_of_recent_measurements < DisplayGraphs::SPARKLINE_LENGTH) {
+            number_of_recent_measurements++;
+        }
+        if (!has_measurement) {
+            has_measurement = true;
+            last_page_change_time_ms = millis();
+        }
+        DisplayController::dismiss_message();
+        show_page(current_page);
+    }
+
+    void request_next_page() {
+        is_next_page_requested = true;
+    }
+
+    void update() {
+        if (!has_measurement) {
+            return;
+        }
+        const unsigned long current_time_ms = millis();
+        const unsigned long page_time_ms = is_page_held ? PAGE_HOLD_TIME_MS : ROTATION_TIME_MS;
+        ///< Time the current page is shown before the next page is selected automatically.
+        const bool is_rotation_due = (ROTATION_TIME_MS > 0 || is_page_held) &&
+                                     current_time_ms - last_page_change_time_ms >= page_time_ms;
+        if (is_next_page_requested || is_rotation_due) {
+            // After the hold time the rotation continues with the next page; without rotation the page is kept.
+            if (is_next_page_requested || ROTATION_TIME_MS > 0) {
+                current_page = static_cast<Page>((current_page + 1) % NUMBER_OF_PAGES);
+            }
+            is_page_held = is_next_page_requested;
+            is_next_page_requested = false;
+            last_page_change_time_ms = current_time_ms;
+            show_page(current_page);
+        } else if (current_time_ms - last_refresh_time_ms >= REFRESH_TIME_MS) {
+            show_page(current_page);
+        }
+    }
+
+    void show_page(const Page page) {
+        last_refresh_time_ms = millis();
+        char row_1[ROW_BUFFER_SIZE]; ///< Text of the first row.
+        char row_2[ROW_BUFFER_SIZE] = ""; ///< Text of the second row.
+        const char *title = row_1; ///< Text shown in the first row (formatted or constant).
+        switch (page) {
+            default:
+            case CURRENT_VALUE:
+                DisplayRowFormatter::set_co2_display_row(row_1, co2_measurement_ppm);
+                TextFormatter::write_string(row_2, row_2 + ROW_BUFFER_SIZE, air_quality_description);
+                break;
+            case BAR_GRAPH:
+                DisplayRowFormatter::set_co2_display_row(row_1, co2_measurement_ppm);
+                DisplayGraphs::format_bar_graph(row_2, co2_measurement_ppm);
+                break;
+            case HISTORY:
+                format_history_rows(row_1, row_2);
+                break;
+            case AVERAGE:
+                title = AVERAGE_TITLE;
+                DisplayRowFormatter::set_co2_display_row(row_2, MeasurementStatistics::get_average_ppm());
+                break;
+            case MINIMUM_MAXIMUM:
+                format_value_row(row_1, MINIMUM_PREFIX, MeasurementStatistics::get_minimum_ppm(), PPM_SUFFIX);
+                format_value_row(row_2, MAXIMUM_PREFIX, MeasurementStatistics::get_maximum_ppm(), PPM_SUFFIX);
+                break;
+            case TREND: {
+                if (!MeasurementStatistics::is_trend_available()) {
+                    title = TREND_NOT_AVAILABLE;
+                    break;
+                }
+                const long trend_ppm_per_hour = MeasurementStatistics::get_trend_ppm_per_hour();
+                ///< Change of the CO2 value per hour.
+                title = trend_ppm_per_hour > STEADY_TREND_PPM_PER_HOUR
+                            ? TREND_RISING
+                            : trend_ppm_per_hour < -STEADY_TREND_PPM_PER_HOUR
+                                  ? TREND_FALLING
+                                  : TREND_STEADY;
+                format_value_row(row_2, trend_ppm_per_hour > 0 ? "+" : "", trend_ppm_per_hour, PPM_PER_HOUR_SUFFIX);
+                break;
+            }
+            case AIR_EXCHANGE:
+                title = AIR_EXCHANGE_TITLE;
+                format_air_exchange_row(row_2);
+                break;
+            case UPTIME:
+                title = UPTIME_TITLE;
+                format_uptime_row(row_2, SystemTime::get_uptime_seconds());
+                break;
+            case ERROR_COUNTERS:
+                format_value_row(row_1, INVALID_PREFIX,
+                                 static_cast<long>(Co2SensorController::get_invalid_measurement_count()), "");
+                format_value_row(row_2, OUTLIERS_PREFIX,
+                                 static_cast<long>(MeasurementFilter::get_rejected_measurement_count()), "");
+                break;
+        }
+        DisplayController::output_page(title, row_2);
+    }
+
+    char *format_value_row(char *row, const char *prefix, const long value, const char *suffix) {
+        const char *end = row + ROW_BUFFER_SIZE; ///< End of the row buffer.
+        char *position = TextFormatter::write_string(row, end, prefix);
+        position = TextFormatter::write_signed(position, end, value);
+        return TextFormatter::write_string(position, end, suffix);
+    }
+
+    void format_uptime_row(char *row, const unsigned long uptime_seconds) {
+        const unsigned long seconds_of_day = uptime_seconds % SECS_PER_DAY; ///< Seconds elapsed since midnight.
+        const char *end = row + ROW_BUFFER_SIZE; ///< End of the row buffer.
+        char *position = TextFormatter::write_unsigned(row, end, uptime_seconds / SECS_PER_DAY);
+        position = TextFormatter::write_string(position, end, "d ");
+        position = TextFormatter::write_unsigned(position, end, seconds_of_day / SECS_PER_HOUR, 2);
+        position = TextFormatter::write_string(position, end, ":");
+        position = TextFormatter::write_unsigned(position, end, seconds_of_day % SECS_PER_HOUR / SECS_PER_MIN, 2);
+        position = TextFormatter::write_string(position, end, ":");
+        TextFormatter::write_unsigned(position, end, seconds_of_day % SECS_PER_MIN, 2);
+    }
+
+    void format_air_exchange_row(char *row) {
+        const uint16_t air_changes_per_hour_centi = VentilationEstimator::get_air_changes_per_hour_centi();
+        ///< Rate of the last measured decay in 0.01 changes per hour.
+        const char *end = row + ROW_BUFFER_SIZE; ///< End of the row buffer.
+        if (air_changes_per_hour_centi == VentilationEstimator::NO_RATE) {
+            TextFormatter::write_string(row, end, VentilationEstimator::is_decay_in_progress()
+                                                      ? AIR_EXCHANGE_MEASURING
+                                                      : AIR_EXCHANGE_NOT_AVAILABLE);
+            return;
+        }
+        char *position = TextFormatter::write_unsigned(row, end, air_changes_per_hour_centi / 100U);
+        position = TextFormatter::write_string(position, end, ".");
+        position = TextFormatter::write_unsigned(position, end, air_changes_per_hour_centi % 100U, 2);
+        TextFormatter::write_string(position, end, PER_HOUR_SUFFIX);
+    }
+
+    void format_history_rows(char *row_1, char *row_2) {
+        int values_ppm[DisplayGraphs::SPARKLINE_LENGTH]; ///< Recent readings from the oldest to the newest.
+        int minimum_ppm = co2_measurement_ppm; ///< Lowest recent reading.
+        int maximum_ppm = co2_measurement_ppm; ///< Highest recent reading.
+        for (uint8_t i = 0; i < number_of_recent_measurements; i++) {
+            const uint8_t index = (next_recent_measurement_index + DisplayGraphs::SPARKLINE_LENGTH -
+                                   number_of_recent_measurements + i) % DisplayGraphs::SPARKLINE_LENGTH;
+            values_ppm[i] = recent_measurements_ppm[index];
+            minimum_ppm = values_ppm[i] < minimum_ppm ? values_ppm[i] : minimum_ppm;
+            maximum_ppm = values_ppm[i] > maximum_ppm ? values_ppm[i] : maximum_ppm;
+        }
+        const char *end = row_1 + ROW_BUFFER_SIZE; ///< End of the first row buffer.
+        char *position = TextFormatter::write_signed(row_1, end, minimum_ppm);
+        position = TextFormatter::write_string(position, end, RANGE_SEPARATOR);
+        position = TextFormatter::write_signed(position, end, maximum_ppm);
+        TextFormatter::write_string(position, end, PPM_SUFFIX);
+        DisplayGraphs::format_sparkline(row_2, values_ppm, number_of_recent_measurements);
+    }
+}
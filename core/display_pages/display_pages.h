@@ -0,0 +1,64 @@
+/**
+ * @file display_pages.h
+ * @brief Header file for the pages of the display user interface.
+ * @details The display shows one of several pages: the current value (as text and as bar graph), a sparkline of the
+ *          recent readings, the average, the minimum and maximum and the trend of the last hour, the air exchange rate
+ *          of the last ventilation, the uptime and the error counters. The pages rotate automatically and can be
+ *          selected with the page button. Pages are formatted here and rendered incrementally by the
+ *          `DisplayController`, so switching pages never blocks the main loop.
+ *
+ *          The rotation time can be configured with `-DPAGE_ROTATION_TIME_MS=<ms>` (default: 5 s, 0 disables the
+ *          rotation, so pages are only selected with the button).
+ */
+
+#ifndef DISPLAY_PAGES_H
+#define DISPLAY_PAGES_H
+
+#include <Arduino.h>
+
+namespace DisplayPages {
+    /**
+     * @enum    Page
+     * @brief   Pages of the display user interface (in the order they are shown).
+     */
+    enum Page : uint8_t {
+        CURRENT_VALUE, ///< Current CO2 value and air quality description.
+        BAR_GRAPH, ///< Current CO2 value and bar graph with the thresholds.
+        HISTORY, ///< Range and sparkline of the recent readings.
+        AVERAGE, ///< Average CO2 value of the last hour.
+        MINIMUM_MAXIMUM, ///< Lowest and highest CO2 value of the last hour.
+        TREND, ///< Change of the CO2 value per hour.
+        AIR_EXCHANGE, ///< Air changes per hour, measured from the last CO2 decay.
+        UPTIME, ///< Time since start-up.
+        ERROR_COUNTERS, ///< Invalid sensor readings and rejected outliers.
+        NUMBER_OF_PAGES ///< Number of pages.
+    };
+
+    /**
+     * @brief   Initializes the pages.
+     * @details Registers `update` as background task, so pages are switched and refreshed while the system waits.
+     *          Pages are shown after the first valid measurement.
+     */
+    void initialize();
+
+    /**
+     * @brief   Sets the current measurement and shows the current page.
+     * @details Dismisses any message (e.g. an error message) shown on the display.
+     * @param   co2_measurement_ppm The current (filtered) CO2 value in ppm.
+     * @param   air_quality_description Description of the current air quality level.
+     */
+    void set_measurement(int co2_measurement_ppm, const char *air_quality_description);
+
+    /**
+     * @brief   Requests to show the next page (can be called from an interrupt service routine).
+     * @details The automatic rotation pauses for `PAGE_HOLD_TIME_MS` after a page was selected.
+     */
+    void request_next_page();
+
+    /**
+     * @brief   Switches the page, if requested or the rotation time passed, and refreshes the shown page.
+     */
+    void update();
+}
+
+#endif //DISPLAY_PAGES_H
@@ -5,6 +5,7 @@
 
 #include <Arduino.h>
 #include <display_row_formatter.h>
+#include <text_formatter.h>
 
 
 namespace DisplayRowFormatter {
@@ -12,6 +13,9 @@ namespace DisplayRowFormatter {
         if (!buffer) {
             return; // no operation if buffer is null
         }
-        snprintf(buffer, BUFFER_SIZE, "%s%d%s", CO2_PREFIX, co2_measurement_ppm, PPM_SUFFIX);
+        const char *end = buffer + BUFFER_SIZE; ///< End of the buffer.
+        char *position = TextFormatter::write_string(buffer, end, CO2_PREFIX);
+        position = TextFormatter::write_signed(position, end, co2_measurement_ppm);
+        TextFormatter::write_string(position, end, PPM_SUFFIX);
     }
 }
@@ -0,0 +1,58 @@
+/**
+ * @file frame_codec.cpp
+ * @brief Implementation of the CRC16 checksum and the COBS encoding.
+ */
+
+#include <frame_codec.h>
+
+namespace FrameCodec {
+    constexpr uint16_t CRC16_POLYNOMIAL = 0x1021; ///< Generator polynomial of CRC16/CCITT.
+    constexpr uint8_t MAX_COBS_BLOCK_LENGTH = 0xFF; ///< Code byte of a COBS block with 254 non-zero bytes.
+
+    uint16_t crc16(const uint8_t *data, size_t length, uint16_t crc) {
+        while (length--) {
+            crc ^= static_cast<uint16_t>(*data++) << 8;
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                crc = crc & 0x8000 ? static_cast<uint16_t>(crc << 1) ^ CRC16_POLYNOMIAL : crc << 1;
+            }
+        }
+        return crc;
+    }
+
+    size_t cobs_encode(const uint8_t *data, const size_t length, uint8_t *encoded) {
+        size_t code_index = 0; ///< Position of the code byte of the current block.
+        size_t write_index = 1; ///< Position of the next data byte in the encoded buffer.
+        uint8_t code = 1; ///< Distance to the next zero byte (code byte of the current block).
+        for (size_t read_index = 0; read_index < length; read_index++) {
+            if (data[read_index] != 0) {
+                encoded[write_index++] = data[read_index];
+                code++;
+            }
+            if (data[read_index] == 0 || code == MAX_COBS_BLOCK_LENGTH) {
+                encoded[code_index] = code;
+                code = 1;
+                code_index = write_index++;
+            }
+        }
+        encoded[code_index] = code;
+        return write_index;
+    }
+
+    size_t cobs_decode(const uint8_t *encoded, const size_t length, uint8_t *decoded) {
+        size_t read_index = 0; ///< Position of the next byte in the encoded buffer.
+        size_t write_index = 0; ///< Position of the next byte in the decoded buffer.
+        while (read_index < length) {
+            const uint8_t code = encoded[read_index++];
+            if (code == 0 || read_index + code - 1 > length) {
+                return 0; // zero bytes are not allowed, and blocks must not exceed the frame
+            }
+            for (uint8_t i = 1; i < code; i++) {
+                decoded[write_index++] = encoded[read_index++];
+            }
+            if (code != MAX_COBS_BLOCK_LENGTH && read_index < length) {
+                decoded[write_index++] = 0;
+            }
+        }
+        return write_index;
+    }
+}
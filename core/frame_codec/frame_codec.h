@@ -0,0 +1,53 @@
+/**
+ * @file frame_codec.h
+ * @brief Header file for the framing of binary messages on a serial byte stream.
+ * @details Provides a CRC16 checksum and Consistent Overhead Byte Stuffing (COBS). A COBS encoded frame never
+ *          contains a zero byte, so frames can be delimited by 0x00 and found reliably, even if the stream also
+ *          carries human-readable log lines.
+ */
+
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <Arduino.h>
+
+namespace FrameCodec {
+    constexpr uint8_t FRAME_DELIMITER = 0x00; ///< Byte that separates two COBS encoded frames.
+    constexpr uint16_t CRC16_INITIAL_VALUE = 0xFFFF; ///< Initial value of the CRC16/CCITT-FALSE checksum.
+
+    /**
+     * @brief   Returns the maximum size of a COBS encoded frame (without delimiter) for a given payload size.
+     */
+    constexpr size_t get_max_encoded_size(const size_t payload_size) {
+        return payload_size + payload_size / 254 + 1;
+    }
+
+    /**
+     * @brief   Calculates the CRC16/CCITT-FALSE checksum (polynomial 0x1021) of the given data.
+     * @param   data Data to calculate the checksum for.
+     * @param   length Number of bytes.
+     * @param   crc Checksum to continue with (use `CRC16_INITIAL_VALUE` for a new calculation).
+     * @return  The checksum.
+     */
+    uint16_t crc16(const uint8_t *data, size_t length, uint16_t crc = CRC16_INITIAL_VALUE);
+
+    /**
+     * @brief   Encodes data with Consistent Overhead Byte Stuffing (COBS).
+     * @param   data Data to encode.
+     * @param   length Number of bytes to encode.
+     * @param   encoded Buffer for the encoded data (at least `get_max_encoded_size(length)` bytes).
+     * @return  Number of bytes written to `encoded` (without delimiter).
+     */
+    size_t cobs_encode(const uint8_t *data, size_t length, uint8_t *encoded);
+
+    /**
+     * @brief   Decodes data encoded with Consistent Overhead Byte Stuffing (COBS).
+     * @param   encoded Encoded data (without delimiter).
+     * @param   length Number of encoded bytes.
+     * @param   decoded Buffer for the decoded data (at least `length` bytes).
+     * @return  Number of decoded bytes, or 0 if the encoded data is malformed.
+     */
+    size_t cobs_decode(const uint8_t *encoded, size_t length, uint8_t *decoded);
+}
+
+#endif //FRAME_CODEC_H
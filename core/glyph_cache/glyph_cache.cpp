@@ -0,0 +1,68 @@
+/**
+ * @file glyph_cache.cpp
+ * @brief Implementation of the allocation of the custom LCD glyphs.
+ */
+
+#include <glyph_cache.h>
+
+namespace GlyphCache {
+    /**
+     * @brief   Returns the slot to load a new glyph into, or `NO_SLOT`.
+     * @details The least recently used slot, which is not used in the current frame.
+     */
+    uint8_t get_free_slot();
+
+    constexpr uint8_t NUMBER_OF_SLOTS = DisplayController::NUMBER_OF_GLYPHS; ///< Number of CGRAM slots.
+    constexpr uint8_t NO_SLOT = 0xFF; ///< Returned, if no slot is free.
+
+    Glyph loaded_glyphs[NUMBER_OF_SLOTS] = {}; ///< Glyphs loaded (or to be loaded) in the slots.
+    bool is_slot_loaded[NUMBER_OF_SLOTS] = {}; ///< True, if a glyph was loaded into the slot.
+    uint8_t last_used_frame[NUMBER_OF_SLOTS] = {}; ///< Frame number, in which the slot was used last.
+    uint8_t frame_number = 1; ///< Number of the current frame (wraps around).
+
+    void begin_frame() {
+        frame_number++;
+        if (frame_number == 0) {
+            // After the wrap-around, all slots are treated as equally old (0 is never a current frame number).
+            for (uint8_t &frame: last_used_frame) {
+                frame = 0;
+            }
+            frame_number = 1;
+        }
+    }
+
+    char get_character(const Glyph &glyph) {
+        uint8_t slot = NO_SLOT;
+        for (uint8_t i = 0; i < NUMBER_OF_SLOTS; i++) {
+            if (is_slot_loaded[i] && memcmp(loaded_glyphs[i].rows, glyph.rows, sizeof(glyph.rows)) == 0) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot == NO_SLOT) {
+            slot = get_free_slot();
+            if (slot == NO_SLOT) {
+                return NO_GLYPH_CHARACTER;
+            }
+            loaded_glyphs[slot] = glyph;
+            is_slot_loaded[slot] = true;
+            DisplayController::set_glyph(slot, glyph.rows);
+        }
+        last_used_frame[slot] = frame_number;
+        return static_cast<char>(DisplayController::FIRST_GLYPH_CHARACTER + slot);
+    }
+
+    uint8_t get_free_slot() {
+        uint8_t free_slot = NO_SLOT;
+        for (uint8_t i = 0; i < NUMBER_OF_SLOTS; i++) {
+            if (!is_slot_loaded[i]) {
+                return i;
+            }
+            if (last_used_frame[i] != frame_number &&
+                (free_slot == NO_SLOT || last_used_frame[i] < last_used_frame[free_slot])) {
+                free_slot = i;
+            }
+        }
+        return free_slot;
+    }
+}
@@ -0,0 +1,42 @@
+/**
+ * @file glyph_cache.h
+ * @brief Header file for the allocation of the custom LCD glyphs.
+ * @details The HD44780 has only eight custom glyphs (CGRAM slots). The glyph cache knows which glyph is loaded in
+ *          which slot and maps a requested glyph to a character: if the glyph is already loaded, its slot is reused,
+ *          otherwise it is loaded into the least recently used slot that is not needed for the current frame. Only
+ *          new glyphs are uploaded (row by row, by the `DisplayController`).
+ */
+
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <Arduino.h>
+#include <display_controller.h>
+
+namespace GlyphCache {
+    constexpr char NO_GLYPH_CHARACTER = '#'; ///< Shown instead of a glyph, if all slots are used in the frame.
+
+    /**
+     * @struct  Glyph
+     * @brief   Pixels of a custom glyph (5x8).
+     */
+    struct Glyph {
+        uint8_t rows[DisplayController::GLYPH_HEIGHT]; ///< Pixel rows from top to bottom (bits 4-0, left to right).
+    };
+
+    /**
+     * @brief   Starts a new frame (e.g. the formatting of a page).
+     * @details Glyphs of the previous frame stay loaded, but their slots can be reused for the new frame.
+     */
+    void begin_frame();
+
+    /**
+     * @brief   Returns the character that shows the given glyph, and loads the glyph if necessary.
+     * @param   glyph The glyph to show.
+     * @return  The character code (`DisplayController::FIRST_GLYPH_CHARACTER` + slot) or `NO_GLYPH_CHARACTER`, if
+     *          all slots are already used in the current frame.
+     */
+    char get_character(const Glyph &glyph);
+}
+
+#endif //GLYPH_CACHE_H
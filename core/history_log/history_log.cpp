@@ -0,0 +1,131 @@
+/**
+ * @file history_log.cpp
+ * @brief Implementation of the long-term history of the CO2 values in the EEPROM.
+ */
+
+#include <history_log.h>
+
+namespace HistoryLog {
+    /**
+     * @struct  Record
+     * @brief   Average CO2 value of one interval, as stored in the EEPROM.
+     */
+    struct Record {
+        uint16_t sequence; ///< Number of records written before this one (wraps around).
+        uint16_t co2_ppm; ///< Average CO2 value in ppm, `NO_VALUE` if the slot is erased.
+    };
+
+    /**
+     * @brief   Reads the record of the given slot from the EEPROM.
+     */
+    Record read_slot(uint16_t slot);
+
+    /**
+     * @brief   Writes the next record to the EEPROM.
+     */
+    void write(uint16_t co2_ppm, unsigned long time_stamp_ms);
+
+    static_assert(sizeof(Record) == RECORD_SIZE, "the record size has to match the capacity calculation");
+    static_assert(CAPACITY * static_cast<unsigned long>(sizeof(Record)) <= E2END + 1UL,
+                  "the ring does not fit into the EEPROM");
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "the capacity has to divide the range of the sequence numbers");
+
+    constexpr unsigned long MAX_CO2_PPM = NO_VALUE - 1UL; ///< Highest value that can be stored.
+
+    uint16_t next_sequence = 0; ///< Sequence number of the next record.
+    uint16_t number_of_records = 0; ///< Number of records in the ring.
+    unsigned long newest_record_time_stamp_ms = 0UL; ///< Time (in ms) the newest record was written (0 if before).
+    unsigned long interval_start_time_ms = 0UL; ///< Time (in ms) the current interval started.
+    unsigned long interval_sum_ppm = 0UL; ///< Sum of the measurements in the current interval.
+    uint16_t interval_count = 0; ///< Number of measurements in the current interval.
+    bool has_interval = false; ///< True, after the first measurement was added.
+
+    void initialize() {
+        number_of_records = 0;
+        next_sequence = 0;
+        for (uint16_t slot = 0; slot < CAPACITY; slot++) {
+            const Record record = read_slot(slot);
+            const Record following_record = read_slot((slot + 1) % CAPACITY);
+            if (record.co2_ppm != NO_VALUE &&
+                (following_record.co2_ppm == NO_VALUE ||
+                 following_record.sequence != static_cast<uint16_t>(record.sequence + 1))) {
+                next_sequence = record.sequence + 1; // the newest record: its successor was not written yet
+                break;
+            }
+        }
+        while (number_of_records < CAPACITY) {
+            const uint16_t sequence = next_sequence - 1 - number_of_records;
+            const Record record = read_slot(sequence % CAPACITY);
+            if (record.co2_ppm == NO_VALUE || record.sequence != sequence) {
+                break;
+            }
+            number_of_records++;
+        }
+    }
+
+    void add(const int co2_measurement_ppm, const unsigned long time_stamp_ms) {
+        if (!has_interval) {
+            has_interval = true;
+            interval_start_time_ms = time_stamp_ms;
+        }
+        if (time_stamp_ms - interval_start_time_ms >= RECORD_INTERVAL_MS) {
+            if (interval_count > 0) {
+                write(static_cast<uint16_t>(interval_sum_ppm / interval_count), time_stamp_ms);
+            }
+            interval_start_time_ms += RECORD_INTERVAL_MS;
+            if (time_stamp_ms - interval_start_time_ms >= RECORD_INTERVAL_MS) {
+                interval_start_time_ms = time_stamp_ms; // no valid measurement for a whole interval
+            }
+            interval_sum_ppm = 0UL;
+            interval_count = 0;
+        }
+        if (interval_count < UINT16_MAX) {
+            const unsigned long co2_ppm = co2_measurement_ppm < 0
+                                              ? 0UL
+                                              : static_cast<unsigned long>(co2_measurement_ppm);
+            interval_sum_ppm += co2_ppm > MAX_CO2_PPM ? MAX_CO2_PPM : co2_ppm;
+            interval_count++;
+        }
+    }
+
+    uint16_t get_number_of_records() {
+        return number_of_records;
+    }
+
+    uint16_t get_oldest_sequence() {
+        return next_sequence - number_of_records;
+    }
+
+    uint16_t get_next_sequence() {
+        return next_sequence;
+    }
+
+    uint16_t read(const uint16_t sequence) {
+        if (static_cast<uint16_t>(next_sequence - 1 - sequence) >= number_of_records) {
+            return NO_VALUE;
+        }
+        const Record record = read_slot(sequence % CAPACITY);
+        return record.sequence == sequence ? record.co2_ppm : NO_VALUE;
+    }
+
+    unsigned long get_time_since_newest_record_ms() {
+        return millis() - newest_record_time_stamp_ms;
+    }
+
+    Record read_slot(const uint16_t slot) {
+        Record record;
+        eeprom_read_block(&record, reinterpret_cast<const void *>(slot * sizeof(Record)), sizeof(record));
+        return record;
+    }
+
+    void write(const uint16_t co2_ppm, const unsigned long time_stamp_ms) {
+        const Record record = {next_sequence, co2_ppm};
+        eeprom_update_block(&record, reinterpret_cast<void *>((next_sequence % CAPACITY) * sizeof(Record)),
+                            sizeof(record));
+        next_sequence++;
+        if (number_of_records < CAPACITY) {
+            number_of_records++;
+        }
+        newest_record_time_stamp_ms = time_stamp_ms;
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file history_log.h
+ * @brief Header file for the long-term history of the CO2 values in the EEPROM.
+ * @details The average CO2 value of each 5-minute interval is stored as a record in a ring buffer in the EEPROM, so
+ *          the history survives every reset, including a power-on. A record holds a 16-bit sequence number and the
+ *          value; the sequence number counts every record ever written and selects the slot of the record (sequence
+ *          modulo capacity). At start-up, the ring is scanned for the newest record, so no separate write pointer has
+ *          to be kept (and worn out) in the EEPROM.
+ *
+ *          The capacity is the largest power of 2 that fits into the EEPROM of the board: 1024 records (3.5 days) on
+ *          the ATmega2560 and 64 records (5 hours) on the ATmega4809. Each slot is written once per round, so the
+ *          EEPROM endurance (100,000 writes) is not a concern. The device has no real-time clock: the time of a record
+ *          is only known relative to the newest one, records from before a power cycle appear without the gap.
+ */
+
+#ifndef HISTORY_LOG_H
+#define HISTORY_LOG_H
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+namespace HistoryLog {
+    constexpr uint16_t RECORD_SIZE = 4; ///< Size of a record in the EEPROM (sequence number and value).
+
+    /**
+     * @brief   Returns the largest power of 2 that is not greater than the given number (at least 1).
+     */
+    constexpr uint16_t get_largest_power_of_two(const unsigned long number, const uint16_t power = 1) {
+        return power >= 0x8000U || power * 2UL > number ? power : get_largest_power_of_two(number, power * 2);
+    }
+
+    constexpr uint16_t CAPACITY = get_largest_power_of_two((E2END + 1UL) / RECORD_SIZE);
+    ///< Number of records (a power of 2, so the slot follows the sequence number), as many as fit into the EEPROM.
+    constexpr unsigned long RECORD_INTERVAL_MS = 300000UL; ///< Time span averaged in one record (5 minutes).
+    constexpr uint16_t NO_VALUE = 0xFFFF; ///< Value of an erased record, returned for a record not in the ring.
+
+    /**
+     * @brief   Scans the EEPROM for the newest record.
+     */
+    void initialize();
+
+    /**
+     * @brief   Adds a measurement to the average of the current interval, and stores the average when it is complete.
+     * @param   co2_measurement_ppm The (filtered) CO2 value in ppm.
+     * @param   time_stamp_ms Time (in ms) of the measurement.
+     */
+    void add(int co2_measurement_ppm, unsigned long time_stamp_ms);
+
+    /**
+     * @brief   Returns the number of records in the ring (0 to `CAPACITY`).
+     */
+    uint16_t get_number_of_records();
+
+    /**
+     * @brief   Returns the sequence number of the oldest record (only valid if there is a record).
+     */
+    uint16_t get_oldest_sequence();
+
+    /**
+     * @brief   Returns the sequence number of the next record to be written (one after the newest record).
+     */
+    uint16_t get_next_sequence();
+
+    /**
+     * @brief   Reads a record.
+     * @param   sequence Sequence number of the record.
+     * @return  The average CO2 value in ppm, or `NO_VALUE` if the record was overwritten or not yet written.
+     */
+    uint16_t read(uint16_t sequence);
+
+    /**
+     * @brief   Returns the time (in ms) since the newest record was written, or since start-up if none was written
+     *          since then.
+     */
+    unsigned long get_time_since_newest_record_ms();
+}
+
+#endif //HISTORY_LOG_H
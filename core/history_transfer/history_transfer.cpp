@@ -0,0 +1,274 @@
+/**
+ * @file history_transfer.cpp
+ * @brief Implementation of the bulk download of the history over the serial link.
+ */
+
+#include <history_transfer.h>
+#include <history_log.h>
+#include <frame_codec.h>
+#include <log_controller.h>
+#include <not_blocking_time_handler.h>
+#include <watchdog.h>
+
+namespace HistoryTransfer {
+    /**
+     * @brief   Reads the received bytes up to the end of the next frame, and checks its checksum.
+     * @param   payload Buffer for the payload (`MAX_RECEIVED_ENCODED_SIZE` bytes).
+     * @param   payload_size Output: size of the payload (without checksum).
+     * @return  True, if a frame with a valid checksum was received.
+     */
+    bool receive_frame(uint8_t *payload, uint8_t &payload_size);
+
+    /**
+     * @brief   Appends the checksum to the payload, encodes and sends the frame.
+     * @param   frame Payload, followed by space for the checksum.
+     * @param   payload_size Size of the payload.
+     */
+    void send_frame(uint8_t *frame, uint8_t payload_size);
+
+    /**
+     * @brief   Answers a request, switches the baud rate, sends the records and switches back.
+     */
+    void run_transfer(unsigned long baud_rate, uint16_t requested_sequence, uint8_t flags);
+
+    /**
+     * @brief   Sends the records with go-back-N retransmission, until all are acknowledged or the host is gone.
+     * @param   first_sequence Sequence number of the first record.
+     * @param   number_of_records Number of records to send.
+     * @param   resent_frames Output: data frames sent again after a timeout.
+     * @return  Number of records acknowledged by the host.
+     */
+    uint16_t send_records(uint16_t first_sequence, uint16_t number_of_records, unsigned long &resent_frames);
+
+    /**
+     * @brief   Sends a data frame with the records from `sequence` on (at most `RECORDS_PER_FRAME`, not beyond `end`).
+     * @return  Sequence number after the last record sent.
+     */
+    uint16_t send_data_frame(uint16_t sequence, uint16_t end);
+
+    /**
+     * @brief   Returns true, if the baud rate is one of `SUPPORTED_BAUD_RATES`.
+     */
+    bool is_baud_rate_supported(unsigned long baud_rate);
+
+    /**
+     * @brief   Writes a 16 bit value in little-endian byte order.
+     * @return  Position after the written value.
+     */
+    uint8_t write_uint16(uint8_t *buffer, uint8_t position, uint16_t value);
+
+    /**
+     * @brief   Writes a 32 bit value in little-endian byte order.
+     * @return  Position after the written value.
+     */
+    uint8_t write_uint32(uint8_t *buffer, uint8_t position, uint32_t value);
+
+    /**
+     * @brief   Reads a 16 bit value in little-endian byte order.
+     */
+    uint16_t read_uint16(const uint8_t *buffer, uint8_t position);
+
+    /**
+     * @brief   Reads a 32 bit value in little-endian byte order.
+     */
+    uint32_t read_uint32(const uint8_t *buffer, uint8_t position);
+
+    constexpr uint8_t CHECKSUM_SIZE = sizeof(uint16_t); ///< Size of the CRC16 at the end of each frame.
+    constexpr uint8_t REQUEST_SIZE = 8; ///< Payload size of a request frame.
+    constexpr uint8_t ACK_SIZE = 3; ///< Payload size of an acknowledgement frame.
+    constexpr uint8_t ACCEPT_SIZE = 18; ///< Payload size of an accept frame.
+    constexpr uint8_t END_SIZE = 3; ///< Payload size of an end frame.
+    constexpr uint8_t DATA_HEADER_SIZE = 4; ///< Payload size of a data frame without records.
+    constexpr uint8_t MAX_SENT_FRAME_SIZE = DATA_HEADER_SIZE + RECORDS_PER_FRAME * sizeof(uint16_t) + CHECKSUM_SIZE;
+    ///< Size of a full data frame, the largest frame sent.
+    constexpr uint8_t MAX_RECEIVED_ENCODED_SIZE = FrameCodec::get_max_encoded_size(REQUEST_SIZE + CHECKSUM_SIZE);
+    ///< Size of the largest encoded frame a host sends (request), longer byte sequences are dropped.
+    constexpr uint16_t MAX_RECORDS_IN_FLIGHT = WINDOW_SIZE * RECORDS_PER_FRAME; ///< Records sent ahead of the host.
+    constexpr unsigned long READY_TIMEOUT_MS = 1000UL;
+    ///< Time the host has to send the first acknowledgement at the new baud rate.
+    constexpr unsigned long ACK_TIMEOUT_MS = 250UL;
+    ///< Time without acknowledged progress, after which the unacknowledged records are sent again.
+    constexpr uint8_t MAX_TIMEOUTS = 8; ///< Timeouts in a row, after which the host is considered gone.
+    constexpr unsigned long POLL_INTERVAL_MS = 1UL; ///< Time between two checks for acknowledgements.
+
+    uint8_t received_frame[MAX_RECEIVED_ENCODED_SIZE]; ///< Encoded bytes of the frame being received.
+    uint8_t received_length = 0; ///< Number of bytes in `received_frame`.
+    bool is_received_frame_too_long = false; ///< True, if the frame being received is dropped.
+
+    void poll() {
+        uint8_t payload[MAX_RECEIVED_ENCODED_SIZE]; ///< Decoded frame.
+        uint8_t payload_size = 0; ///< Size of the decoded frame.
+        while (receive_frame(payload, payload_size)) {
+            if (payload_size == REQUEST_SIZE && payload[0] == REQUEST &&
+                is_baud_rate_supported(read_uint32(payload, 1))) {
+                run_transfer(read_uint32(payload, 1), read_uint16(payload, 5), payload[7]);
+                return;
+            }
+        }
+    }
+
+    void run_transfer(const unsigned long baud_rate, const uint16_t requested_sequence, const uint8_t flags) {
+        const uint16_t oldest_sequence = HistoryLog::get_oldest_sequence();
+        const uint16_t next_sequence = HistoryLog::get_next_sequence();
+        const bool is_resumable = static_cast<uint16_t>(requested_sequence - oldest_sequence) <=
+                                  HistoryLog::get_number_of_records();
+        ///< True, if the requested record is still in the ring (or is the next one to be written).
+        const uint16_t first_sequence = (flags & RESUME_FLAG) && is_resumable ? requested_sequence : oldest_sequence;
+        const uint16_t number_of_records = next_sequence - first_sequence;
+
+        LogController::pause_output();
+        uint8_t frame[ACCEPT_SIZE + CHECKSUM_SIZE]; ///< Accept frame with checksum.
+        uint8_t position = 0; ///< Position of the next field in the frame.
+        frame[position++] = ACCEPT;
+        position = write_uint32(frame, position, baud_rate);
+        position = write_uint16(frame, position, first_sequence);
+        position = write_uint16(frame, position, number_of_records);
+        position = write_uint32(frame, position, HistoryLog::get_time_since_newest_record_ms());
+        position = write_uint32(frame, position, HistoryLog::RECORD_INTERVAL_MS);
+        frame[position] = RECORDS_PER_FRAME;
+        send_frame(frame, ACCEPT_SIZE);
+        Serial.flush();
+        Serial.begin(baud_rate); // the host switches, too, and acknowledges the first record at the new baud rate
+
+        unsigned long resent_frames = 0UL; ///< Data frames sent again after a timeout.
+        const uint16_t acknowledged_records = send_records(first_sequence, number_of_records, resent_frames);
+
+        Serial.flush();
+        Serial.begin(LogController::SERIAL_BAUD_RATE);
+        received_length = 0; // bytes received at the other baud rate are garbage
+        LogController::resume_output();
+        LogController::log_history_transfer(acknowledged_records, number_of_records, resent_frames);
+    }
+
+    uint16_t send_records(const uint16_t first_sequence, const uint16_t number_of_records,
+                          unsigned long &resent_frames) {
+        const uint16_t end = first_sequence + number_of_records; ///< Sequence number after the last record.
+        uint16_t acknowledged = first_sequence; ///< Sequence number of the oldest unacknowledged record.
+        uint16_t next = first_sequence; ///< Sequence number of the next record to send.
+        bool is_host_ready = false; ///< True, after the first acknowledgement at the new baud rate.
+        unsigned long progress_time_stamp_ms = millis(); ///< Time (in ms) of the last acknowledged progress.
+        uint8_t number_of_timeouts = 0; ///< Timeouts since the last acknowledged progress.
+        for (;;) {
+            Watchdog::feed();
+            if (is_host_ready) {
+                if (acknowledged == end) {
+                    uint8_t frame[END_SIZE + CHECKSUM_SIZE]; ///< End frame with checksum.
+                    frame[0] = END;
+                    write_uint16(frame, 1, end);
+                    send_frame(frame, END_SIZE);
+                    return number_of_records;
+                }
+                while (next != end && static_cast<uint16_t>(next - acknowledged) < MAX_RECORDS_IN_FLIGHT) {
+                    next = send_data_frame(next, end);
+                }
+            }
+            uint8_t payload[MAX_RECEIVED_ENCODED_SIZE]; ///< Decoded frame.
+            uint8_t payload_size = 0; ///< Size of the decoded frame.
+            bool is_frame_received = false; ///< True, if an acknowledgement was received in this pass.
+            while (receive_frame(payload, payload_size)) {
+                if (payload_size != ACK_SIZE || payload[0] != ACK) {
+                    continue;
+                }
+                is_frame_received = true;
+                const uint16_t sequence = read_uint16(payload, 1); ///< Next record expected by the host.
+                if (static_cast<uint16_t>(sequence - acknowledged) > static_cast<uint16_t>(next - acknowledged)) {
+                    continue; // outside the sent range: an acknowledgement of an earlier transfer
+                }
+                if (!is_host_ready || sequence != acknowledged) {
+                    is_host_ready = true;
+                    acknowledged = sequence;
+                    progress_time_stamp_ms = millis();
+                    number_of_timeouts = 0;
+                }
+            }
+            if (millis() - progress_time_stamp_ms >= (is_host_ready ? ACK_TIMEOUT_MS : READY_TIMEOUT_MS)) {
+                if (++number_of_timeouts > MAX_TIMEOUTS) {
+                    return acknowledged - first_sequence;
+                }
+                resent_frames += (static_cast<uint16_t>(next - acknowledged) + RECORDS_PER_FRAME - 1U) /
+                                 RECORDS_PER_FRAME;
+                next = acknowledged; // go back to the oldest unacknowledged record
+                progress_time_stamp_ms = millis();
+            }
+            if (!is_frame_received) {
+                NotBlockingTimeHandler::wait_ms(POLL_INTERVAL_MS); // the MCU sleeps until the next byte arrives
+            }
+        }
+    }
+
+    uint16_t send_data_frame(const uint16_t sequence, const uint16_t end) {
+        const uint8_t number_of_records = static_cast<uint8_t>(
+            static_cast<uint16_t>(end - sequence) < RECORDS_PER_FRAME ? end - sequence : RECORDS_PER_FRAME);
+        uint8_t frame[MAX_SENT_FRAME_SIZE]; ///< Data frame with checksum.
+        uint8_t position = 0; ///< Position of the next field in the frame.
+        frame[position++] = DATA;
+        position = write_uint16(frame, position, sequence);
+        frame[position++] = number_of_records;
+        for (uint8_t i = 0; i < number_of_records; i++) {
+            position = write_uint16(frame, position, HistoryLog::read(sequence + i));
+        }
+        send_frame(frame, position);
+        return sequence + number_of_records;
+    }
+
+    bool receive_frame(uint8_t *payload, uint8_t &payload_size) {
+        while (Serial.available() > 0) {
+            const uint8_t character = static_cast<uint8_t>(Serial.read());
+            if (character != FrameCodec::FRAME_DELIMITER) {
+                if (received_length < MAX_RECEIVED_ENCODED_SIZE) {
+                    received_frame[received_length++] = character;
+                } else {
+                    is_received_frame_too_long = true;
+                }
+                continue;
+            }
+            const bool is_complete = received_length > 0 && !is_received_frame_too_long;
+            const size_t size = is_complete ? FrameCodec::cobs_decode(received_frame, received_length, payload) : 0;
+            received_length = 0;
+            is_received_frame_too_long = false;
+            if (size > CHECKSUM_SIZE &&
+                FrameCodec::crc16(payload, size - CHECKSUM_SIZE) == read_uint16(payload, size - CHECKSUM_SIZE)) {
+                payload_size = static_cast<uint8_t>(size - CHECKSUM_SIZE);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void send_frame(uint8_t *frame, const uint8_t payload_size) {
+        write_uint16(frame, payload_size, FrameCodec::crc16(frame, payload_size));
+        uint8_t encoded_frame[FrameCodec::get_max_encoded_size(MAX_SENT_FRAME_SIZE)]; ///< COBS encoded frame.
+        const size_t encoded_frame_size = FrameCodec::cobs_encode(frame, payload_size + CHECKSUM_SIZE, encoded_frame);
+        Serial.write(FrameCodec::FRAME_DELIMITER); // terminate any partial log line for the receiver
+        Serial.write(encoded_frame, encoded_frame_size);
+        Serial.write(FrameCodec::FRAME_DELIMITER);
+    }
+
+    bool is_baud_rate_supported(const unsigned long baud_rate) {
+        for (const unsigned long supported_baud_rate: SUPPORTED_BAUD_RATES) {
+            if (baud_rate == supported_baud_rate) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint8_t write_uint16(uint8_t *buffer, uint8_t position, const uint16_t value) {
+        buffer[position++] = static_cast<uint8_t>(value);
+        buffer[position++] = static_cast<uint8_t>(value >> 8);
+        return position;
+    }
+
+    uint8_t write_uint32(uint8_t *buffer, uint8_t position, const uint32_t value) {
+        position = write_uint16(buffer, position, static_cast<uint16_t>(value));
+        return write_uint16(buffer, position, static_cast<uint16_t>(value >> 16));
+    }
+
+    uint16_t read_uint16(const uint8_t *buffer, const uint8_t position) {
+        return static_cast<uint16_t>(buffer[position] | buffer[position + 1] << 8);
+    }
+
+    uint32_t read_uint32(const uint8_t *buffer, const uint8_t position) {
+        return read_uint16(buffer, position) | static_cast<uint32_t>(read_uint16(buffer, position + 2)) << 16;
+    }
+}
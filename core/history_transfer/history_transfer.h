@@ -0,0 +1,59 @@
+/**
+ * @file history_transfer.h
+ * @brief Header file for the bulk download of the history (see history_log.h) over the serial link.
+ * @details A host starts a transfer with a request frame at 9600 baud. The device answers with an accept frame, pauses
+ *          the log output and switches to the requested baud rate, until the transfer ends. The records are sent in
+ *          data frames of `RECORDS_PER_FRAME` records; up to `WINDOW_SIZE` frames are sent ahead of the last
+ *          acknowledgement. The host acknowledges cumulatively with the sequence number of the next expected record;
+ *          if no progress is acknowledged in time, the device resends from the oldest unacknowledged record
+ *          (go-back-N). An end frame is sent when all records are acknowledged. A request can start at a given sequence
+ *          number, so an interrupted transfer is resumed after the last record the host stored.
+ *
+ *          All frames have the layout of the telemetry frames: a type byte, the fields in little-endian byte order and
+ *          a CRC16, COBS encoded and delimited by 0x00 (see frame_codec.h). So the host can tell them apart from the
+ *          log lines at 9600 baud, and corrupted frames are dropped.
+ *
+ *          Frames (fields after the type byte):
+ *           - `REQUEST` (host): baud rate (u32), first sequence number (u16), flags (u8, `RESUME_FLAG`: start at the
+ *             given sequence number instead of the oldest record).
+ *           - `ACCEPT`: baud rate (u32), sequence number of the first record sent (u16), number of records to send
+ *             (u16), time since the newest record in ms (u32), record interval in ms (u32), records per frame (u8).
+ *           - `DATA`: sequence number of the first record (u16), number of records (u8), CO2 values in ppm (u16 each).
+ *           - `ACK` (host): sequence number of the next expected record (u16).
+ *           - `END`: sequence number after the last record sent (u16).
+ */
+
+#ifndef HISTORY_TRANSFER_H
+#define HISTORY_TRANSFER_H
+
+#include <Arduino.h>
+
+namespace HistoryTransfer {
+    /**
+     * @enum    FrameType
+     * @brief   Type of a transfer frame (first byte of the payload), host frames below 0x80.
+     */
+    enum FrameType : uint8_t {
+        REQUEST = 0x01, ///< Starts a transfer (host).
+        ACK = 0x02, ///< Acknowledges the records before the given sequence number (host).
+        ACCEPT = 0x81, ///< Accepts a request, followed by the switch to the requested baud rate.
+        DATA = 0x82, ///< Consecutive records.
+        END = 0x83 ///< All records were acknowledged.
+    };
+
+    constexpr uint8_t RESUME_FLAG = 0x01; ///< Request flag: start at the requested sequence number.
+    constexpr uint8_t RECORDS_PER_FRAME = 16; ///< Records in a full data frame.
+    constexpr uint8_t WINDOW_SIZE = 4; ///< Data frames sent without acknowledgement.
+    constexpr unsigned long SUPPORTED_BAUD_RATES[] = {9600UL, 19200UL, 38400UL, 57600UL, 115200UL};
+    ///< Baud rates a host can request (all have an error of at most 2.1 % at 16 MHz).
+
+    /**
+     * @brief   Reads the frames received on the serial link, and runs a transfer if a valid request was received.
+     * @details Call it regularly from the task that owns the serial output (the main loop). A transfer blocks the
+     *          caller until it is complete or the host stops answering, the watchdog is fed and the background tasks
+     *          keep running in the meantime.
+     */
+    void poll();
+}
+
+#endif //HISTORY_TRANSFER_H
@@ -4,26 +4,312 @@
  */
 
 #include <Arduino.h>
+#include <util/atomic.h>
 #include <led_array.h>
 #include <led_patterns.h>
 #include <pin_configuration.h>
 
 namespace LedArray {
+    constexpr unsigned long TICK_FREQUENCY_HZ = 8000UL; ///< Frequency of the timer interrupt.
+    constexpr uint8_t PWM_STEPS = 32; ///< Duty cycle steps of the software PWM (PWM frequency 250 Hz).
+    constexpr uint8_t TICKS_PER_FRAME = 80; ///< Timer ticks per animation frame.
+    constexpr uint16_t FRAME_DURATION_MS = 10; ///< Duration of an animation frame.
+    constexpr uint8_t BRIGHTNESS_TO_INDEX_SHIFT = 3; ///< Brightness steps of 8 per entry of the gamma table.
+    constexpr uint8_t GAMMA_DUTY[] = {
+        0, 0, 0, 0, 0, 1, 1, 1, 2, 2, 3, 3, 4, 5, 6, 6, 7, 9, 10, 11, 12, 14, 15, 17, 18, 20, 22, 24, 26, 28, 30, 32
+    }; ///< Duty cycle (0 to `PWM_STEPS`) of a perceived brightness, `round(32 * (index / 31) ^ 2.2)`.
+    static_assert(sizeof(GAMMA_DUTY) == (LedPattern::MAX_BRIGHTNESS >> BRIGHTNESS_TO_INDEX_SHIFT) + 1,
+                  "The gamma table has to cover the whole brightness range.");
+    static_assert(GAMMA_DUTY[sizeof(GAMMA_DUTY) - 1] == PWM_STEPS, "Full brightness has to be a full duty cycle.");
+
+    volatile uint8_t duty[LedPattern::NUMBER_OF_LEDS] = {}; ///< Current duty cycle of each LED, output by the timer.
+    uint8_t base_duty[LedPattern::NUMBER_OF_LEDS] = {}; ///< Duty cycle of each LED without animation.
+    const LedPattern::Animation *volatile animation = nullptr; ///< Animation being played, `nullptr` if none.
+    volatile uint8_t keyframe_index = 0; ///< Keyframe of the animation being shown.
+    volatile uint8_t frames_left = 0; ///< Frames until the next keyframe of the animation.
+    volatile uint8_t pwm_phase = 0; ///< Position in the PWM period (0 to `PWM_STEPS` - 1).
+    volatile uint8_t frame_ticks = 0; ///< Timer ticks since the start of the current frame.
+
+    /**
+     * @brief   Returns the duty cycle of a perceived brightness (gamma correction).
+     */
+    uint8_t to_duty(uint8_t brightness);
+
+    /**
+     * @brief   Returns true, if the LED is driven by the animation being played.
+     */
+    bool is_animated(LedPattern::Led led);
+
+    /**
+     * @brief   Sets the duty cycle of the LEDs not driven by the animation to their base duty cycle.
+     */
+    void apply_base_duty();
+
+    /**
+     * @brief   Sets the duty cycle of the animated LEDs to the current keyframe. Interrupts have to be disabled.
+     */
+    void load_keyframe();
+
+    /**
+     * @brief   Advances the animation by one frame. Interrupts have to be disabled.
+     */
+    void advance_frame();
+
+    /**
+     * @brief   Starts the timer, if an animation is played or an LED is dimmed, otherwise stops it and writes the LEDs.
+     *          Interrupts have to be disabled.
+     */
+    void update_output();
+
+    /**
+     * @brief   Writes all LEDs for a position in the PWM period (on, if the position is below the duty cycle).
+     */
+    void write_pins(uint8_t phase);
+
+    /**
+     * @brief   One timer tick: writes the LEDs and advances the PWM period and the animation.
+     */
+    void tick();
+
+    /**
+     * @brief   Advances the animation by the frames elapsed since the last call. Only needed on the host, where no timer
+     *          interrupt exists: called whenever the LED array is used, so the waits of the loop stay as cheap as on
+     *          the device.
+     */
+    void advance_elapsed_frames();
+
+    void configure_timer();
+
+    void start_timer();
+
+    void stop_timer();
+
+#ifdef TIMER2_COMPA_vect
+    /**
+     * @brief   Timer2 compare match: one tick of the software PWM.
+     */
+    ISR(TIMER2_COMPA_vect) {
+        tick();
+    }
+
+    void configure_timer() {
+        constexpr unsigned long PRESCALER = 8UL; ///< Timer2 clock divider (2 MHz at 16 MHz).
+        static_assert(F_CPU / PRESCALER / TICK_FREQUENCY_HZ - 1 <= 0xFF, "The tick period exceeds Timer2.");
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            TCCR2A = _BV(WGM21); // clear timer on compare match
+            TCCR2B = _BV(CS21);
+            OCR2A = static_cast<uint8_t>(F_CPU / PRESCALER / TICK_FREQUENCY_HZ - 1);
+        }
+    }
+
+    void start_timer() {
+        TIMSK2 |= _BV(OCIE2A);
+    }
+
+    void stop_timer() {
+        TIMSK2 &= static_cast<uint8_t>(~_BV(OCIE2A));
+    }
+
+    void advance_elapsed_frames() {
+    }
+#elif defined(TCB2)
+    /**
+     * @brief   TCB2 capture (periodic interrupt mode): one tick of the software PWM.
+     * @details TCB2 is otherwise only used by `tone()` and the Servo library, which the system does not use.
+     */
+    ISR(TCB2_INT_vect) {
+        TCB2.INTFLAGS = TCB_CAPT_bm;
+        tick();
+    }
+
+    void configure_timer() {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            TCB2.CCMP = static_cast<uint16_t>(F_CPU / TICK_FREQUENCY_HZ - 1);
+            TCB2.CTRLB = TCB_CNTMODE_INT_gc;
+            TCB2.CTRLA = TCB_CLKSEL_CLKDIV1_gc | TCB_ENABLE_bm;
+        }
+    }
+
+    void start_timer() {
+        TCB2.INTCTRL = TCB_CAPT_bm;
+    }
+
+    void stop_timer() {
+        TCB2.INTCTRL = 0;
+    }
+
+    void advance_elapsed_frames() {
+    }
+#else
+    bool is_timer_running = false; ///< True, while the animation is advanced (host).
+    unsigned long last_frame_time_ms = 0UL; ///< Start of the current frame (host).
+
+    void advance_elapsed_frames() {
+        if (!is_timer_running) {
+            return;
+        }
+        const unsigned long current_time_ms = millis();
+        while (is_timer_running && current_time_ms - last_frame_time_ms >= FRAME_DURATION_MS) {
+            last_frame_time_ms += FRAME_DURATION_MS;
+            advance_frame();
+        }
+        write_pins(0);
+    }
+
+    void configure_timer() {
+    }
+
+    void start_timer() {
+        if (!is_timer_running) {
+            is_timer_running = true;
+            last_frame_time_ms = millis();
+        }
+        write_pins(0); // the host has no PWM, dimmed LEDs are shown as on
+    }
+
+    void stop_timer() {
+        is_timer_running = false;
+    }
+#endif
+
     void initialize() {
-        pinMode(GREEN_1_PIN, OUTPUT);
-        pinMode(GREEN_2_PIN, OUTPUT);
-        pinMode(YELLOW_1_PIN, OUTPUT);
-        pinMode(YELLOW_2_PIN, OUTPUT);
-        pinMode(RED_1_PIN, OUTPUT);
-        pinMode(RED_2_PIN, OUTPUT);
+        Green1Pin::set_output();
+        Green2Pin::set_output();
+        Yellow1Pin::set_output();
+        Yellow2Pin::set_output();
+        Red1Pin::set_output();
+        Red2Pin::set_output();
+        configure_timer();
     }
 
     void output(const LedPattern::Pattern pattern) {
-        digitalWrite(GREEN_1_PIN, pattern.is_green_led_1_on);
-        digitalWrite(GREEN_2_PIN, pattern.is_green_led_2_on);
-        digitalWrite(YELLOW_1_PIN, pattern.is_yellow_led_1_on);
-        digitalWrite(YELLOW_2_PIN, pattern.is_yellow_led_2_on);
-        digitalWrite(RED_1_PIN, pattern.is_red_led_1_on);
-        digitalWrite(RED_2_PIN, pattern.is_red_led_2_on);
+        advance_elapsed_frames();
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            base_duty[LedPattern::GREEN_LED_1] = pattern.is_green_led_1_on ? PWM_STEPS : 0;
+            base_duty[LedPattern::GREEN_LED_2] = pattern.is_green_led_2_on ? PWM_STEPS : 0;
+            base_duty[LedPattern::YELLOW_LED_1] = pattern.is_yellow_led_1_on ? PWM_STEPS : 0;
+            base_duty[LedPattern::YELLOW_LED_2] = pattern.is_yellow_led_2_on ? PWM_STEPS : 0;
+            base_duty[LedPattern::RED_LED_1] = pattern.is_red_led_1_on ? PWM_STEPS : 0;
+            base_duty[LedPattern::RED_LED_2] = pattern.is_red_led_2_on ? PWM_STEPS : 0;
+            if (animation != nullptr && animation->is_looped) {
+                animation = nullptr;
+            }
+            apply_base_duty();
+            update_output();
+        }
+    }
+
+    void set_brightness(const LedPattern::Led led, const uint8_t brightness) {
+        advance_elapsed_frames();
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            base_duty[led] = to_duty(brightness);
+            apply_base_duty();
+            update_output();
+        }
+    }
+
+    void play(const LedPattern::Animation &new_animation) {
+        advance_elapsed_frames();
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            animation = &new_animation;
+            keyframe_index = 0;
+            frame_ticks = 0;
+            apply_base_duty();
+            load_keyframe();
+            update_output();
+        }
+    }
+
+    void stop() {
+        advance_elapsed_frames();
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            animation = nullptr;
+            apply_base_duty();
+            update_output();
+        }
+    }
+
+    bool is_animation_playing() {
+        advance_elapsed_frames();
+        return animation != nullptr;
+    }
+
+    uint8_t to_duty(const uint8_t brightness) {
+        return GAMMA_DUTY[brightness >> BRIGHTNESS_TO_INDEX_SHIFT];
+    }
+
+    bool is_animated(const LedPattern::Led led) {
+        return animation != nullptr && (animation->led_mask & (1U << led)) != 0;
+    }
+
+    void apply_base_duty() {
+        for (uint8_t led = 0; led < LedPattern::NUMBER_OF_LEDS; led++) {
+            if (!is_animated(static_cast<LedPattern::Led>(led))) {
+                duty[led] = base_duty[led];
+            }
+        }
+    }
+
+    void load_keyframe() {
+        const LedPattern::Keyframe &keyframe = animation->keyframes[keyframe_index];
+        for (uint8_t led = 0; led < LedPattern::NUMBER_OF_LEDS; led++) {
+            if (is_animated(static_cast<LedPattern::Led>(led))) {
+                duty[led] = to_duty(keyframe.brightness[led]);
+            }
+        }
+        const uint16_t frames = keyframe.duration_ms / FRAME_DURATION_MS; ///< Frames the keyframe is shown.
+        frames_left = frames == 0 ? 1 : frames > 0xFF ? 0xFF : static_cast<uint8_t>(frames);
+    }
+
+    void advance_frame() {
+        if (animation == nullptr || --frames_left != 0) {
+            return;
+        }
+        if (++keyframe_index < animation->number_of_keyframes) {
+            load_keyframe();
+            return;
+        }
+        if (animation->is_looped) {
+            keyframe_index = 0;
+            load_keyframe();
+            return;
+        }
+        animation = nullptr;
+        apply_base_duty();
+        update_output();
+    }
+
+    void update_output() {
+        bool is_timer_needed = animation != nullptr; ///< True, if the LEDs change over time or are dimmed.
+        for (uint8_t led = 0; led < LedPattern::NUMBER_OF_LEDS && !is_timer_needed; led++) {
+            is_timer_needed = duty[led] != 0 && duty[led] != PWM_STEPS;
+        }
+        if (is_timer_needed) {
+            start_timer();
+            return;
+        }
+        stop_timer();
+        write_pins(0);
+    }
+
+    void write_pins(const uint8_t phase) {
+        Green1Pin::write(phase < duty[LedPattern::GREEN_LED_1]);
+        Green2Pin::write(phase < duty[LedPattern::GREEN_LED_2]);
+        Yellow1Pin::write(phase < duty[LedPattern::YELLOW_LED_1]);
+        Yellow2Pin::write(phase < duty[LedPattern::YELLOW_LED_2]);
+        Red1Pin::write(phase < duty[LedPattern::RED_LED_1]);
+        Red2Pin::write(phase < duty[LedPattern::RED_LED_2]);
+        MuteIndicator::BluePin::write(phase < duty[LedPattern::MUTE_LED]);
+    }
+
+    void tick() {
+        write_pins(pwm_phase);
+        if (++pwm_phase == PWM_STEPS) {
+            pwm_phase = 0;
+        }
+        if (++frame_ticks == TICKS_PER_FRAME) {
+            frame_ticks = 0;
+            advance_frame();
+        }
     }
 }
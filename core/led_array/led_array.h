@@ -1,6 +1,17 @@
 /**
  * @file    led_array.h
  * @brief   This file contains the function declarations for controlling the LEDs.
+ * @details The six air quality LEDs and the mute LED are driven by a timer interrupt (Timer2 on the Mega 2560,
+ *          TCB2 on the Nano Every) at 8 kHz:
+ *           - Software PWM with 32 duty steps (250 Hz), the brightness is gamma corrected.
+ *           - Keyframe animations (e.g. the acknowledgement, a blinking error) are played in the background, one frame
+ *             per 10 ms. The loop and the interrupt service routines only start or stop them.
+ *
+ *          Each tick costs the same (one compare and one single-instruction pin write per LED, plus loading the
+ *          brightness of a keyframe every 10 ms at most). The timer only runs while an animation is played or an LED is
+ *          dimmed; static patterns are written to the pins directly, so the MCU is not woken from idle sleep otherwise.
+ *          On the host, which has no timer, the animations are advanced whenever the LED array is used, and dimmed LEDs
+ *          are shown as on.
  */
 
 #ifndef LED_ARRAY_H
@@ -10,19 +21,41 @@
 
 namespace LedArray {
     /**
-     * @brief   Initialize LED PINs (Output)
+     * @brief   Initialize LED PINs (Output) and the timer of the software PWM
      */
     void initialize();
 
     /**
      * @brief   Controls the LED indicators.
-     * @details Activates LEDs according to the given parameters.
-     *          HIGH and LOW as second parameters for digitalWrite() are provided as booleans.
-     *          This is valid, because HIGH and LOW are the same as true and false, as well as 1 and 0.
-     * @see     https://reference.arduino.cc/reference/en/language/variables/constants/highlow/?_gl=1*12oo2pw*_up*MQ..*_ga*NTMxMjcxOTAwLjE3MzM5NTQ2Mzc.*_ga_NEXN8H46L5*MTczMzk1NDYzNi4xLjEuMTczMzk1NDcxNC4wLjAuMTM1MTQzNjcxNw..
+     * @details Activates LEDs according to the given parameters. A looped animation (e.g. the sensor error) is
+     *          stopped, a single animation (e.g. the acknowledgement) is played to its end before the pattern is shown.
      * @param pattern led pattern
      */
     void output(LedPattern::Pattern pattern);
+
+    /**
+     * @brief   Sets the brightness of a single LED (shown when no animation drives it).
+     * @param led LED to change
+     * @param brightness perceived brightness, 0 (off) to `LedPattern::MAX_BRIGHTNESS` (fully on)
+     */
+    void set_brightness(LedPattern::Led led, uint8_t brightness);
+
+    /**
+     * @brief   Starts an animation in the background, replacing the animation being played. Can be called from an
+     *          interrupt service routine.
+     * @param animation animation to play, has to stay valid while played (e.g. a constant of led_patterns.h)
+     */
+    void play(const LedPattern::Animation &animation);
+
+    /**
+     * @brief   Stops the animation being played, the LEDs show the pattern and the mute state again.
+     */
+    void stop();
+
+    /**
+     * @brief   Returns true, while an animation is played.
+     */
+    bool is_animation_playing();
 }
 
 #endif //LED_ARRAY_H
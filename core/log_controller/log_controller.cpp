@@ -9,7 +9,14 @@
 
 #include <ArduinoLog.h>
 #include <log_controller.h>
-#include <state.h>
+#include <state_access.h>
+#include <not_blocking_time_handler.h>
+#include <memory_monitor.h>
+#include <text_formatter.h>
+#include <watchdog.h>
+#include <warm_restart.h>
+#include <boot_timeline.h>
+#include <co2_sensor_controller.h>
 
 namespace LogController {
     /**
@@ -43,8 +50,15 @@ namespace LogController {
      */
     void print_suffix(Print *_log_output, int log_level);
 
-    constexpr unsigned int SERIAL_BAUD_RATE = 9600;
-    ///< Defines the baud rate used for serial communication during debugging.
+    void (*lock_output)() = nullptr; ///< Locks the log output before a line, `nullptr` if not locked.
+    void (*unlock_output)() = nullptr; ///< Unlocks the log output after a line.
+    int paused_log_level = LOG_LEVEL_SILENT; ///< Log level active before the output was paused.
+    void (*const LOOP_DIAGNOSTICS[])() = {
+        log_critical_sections, log_sensor_health, log_duty_cycle, log_memory_usage
+    }; ///< Diagnostic blocks, one of them is logged at the end of each loop.
+    constexpr uint8_t NUMBER_OF_LOOP_DIAGNOSTICS = sizeof(LOOP_DIAGNOSTICS) / sizeof(LOOP_DIAGNOSTICS[0]);
+    ///< Number of loops until all diagnostic blocks have been logged.
+    uint8_t next_loop_diagnostics_index = 0; ///< Diagnostic block to log at the end of the next loop.
 
     void initialize(const int log_level) {
         Serial.begin(SERIAL_BAUD_RATE);
@@ -56,63 +70,164 @@ namespace LogController {
         Log.setShowLevel(false);
     }
 
+    void set_output_lock(void (*lock)(), void (*unlock)()) {
+        lock_output = lock;
+        unlock_output = unlock;
+    }
+
+    void pause_output() {
+        if (lock_output != nullptr) {
+            lock_output();
+        }
+        paused_log_level = Log.getLevel();
+        Log.setLevel(LOG_LEVEL_SILENT);
+        if (unlock_output != nullptr) {
+            unlock_output();
+        }
+    }
+
+    void resume_output() {
+        Log.setLevel(paused_log_level);
+    }
+
     void log_welcome_message() {
         Log.noticeln(DIVIDING_LINE_WELCOME);
         Log.noticeln(WELCOME_MESSAGE);
         Log.noticeln(DIVIDING_LINE_WELCOME);
     }
 
+    void log_reset_cause() {
+        Log.noticeln("%s %s", RESET_CAUSE, Watchdog::get_reset_cause_name());
+        if (WarmRestart::is_warm_restart()) {
+            Log.noticeln(WARM_RESTART);
+        }
+    }
+
     void log_initialization(const char *module) {
-        char module_initialized[128];
-        sprintf(module_initialized, "%s %s", module, INIT);
-        Log.verboseln(module_initialized);
+        Log.verboseln("%s %s", module, INIT);
     }
 
     void log_current_state() {
         Log.traceln("%s", DIVIDING_LINE_STATE);
-        Log.traceln("%s", STATE);
-        TRACE_LN_u(AirQualityMeter::state.last_co2_below_threshold_time_ms);
-        TRACE_LN_d(AirQualityMeter::state.warning_counter);
-        TRACE_LN_u(AirQualityMeter::state.last_co2_sensor_used_time_stamp_ms);
-        TRACE_LN_T(AirQualityMeter::state.is_system_muted);
+        log_state_variables();
+        log_critical_sections();
+        log_sensor_health();
+        log_duty_cycle();
+        log_memory_usage();
         Log.traceln("%s", DIVIDING_LINE_STATE);
     }
 
+    void log_state_variables() {
+        Log.traceln("%s", STATE);
+        const AirQualityMeter::State state = StateAccess::read(); ///< Consistent copy of the system state.
+        TRACE_LN_u(state.last_co2_below_threshold_time_ms);
+        TRACE_LN_d(state.warning_counter);
+        TRACE_LN_u(state.last_co2_sensor_used_time_stamp_ms);
+        TRACE_LN_T(state.is_system_muted);
+    }
+
+    void log_duty_cycle() {
+        const unsigned long active_time_ms = NotBlockingTimeHandler::get_active_time_ms();
+        ///< Time (in ms) the MCU was running since start-up.
+        const unsigned long sleep_time_ms = NotBlockingTimeHandler::get_sleep_time_ms();
+        ///< Time (in ms) the MCU spent in idle sleep since start-up.
+        Log.traceln("%s", DUTY_CYCLE);
+        TRACE_LN_u(active_time_ms);
+        TRACE_LN_u(sleep_time_ms);
+    }
+
+    void log_critical_sections() {
+        const unsigned long number_of_writes = StateAccess::get_number_of_writes();
+        ///< Number of writes of the system state since start-up.
+        const unsigned long max_critical_section_cycles = StateAccess::get_max_critical_section_cycles();
+        ///< Longest interrupt-disabled window (in CPU cycles) of a write of the system state or a button interrupt.
+        Log.traceln("%s", CRITICAL_SECTIONS);
+        TRACE_LN_u(number_of_writes);
+        TRACE_LN_u(max_critical_section_cycles);
+    }
+
+    void log_sensor_health() {
+        const unsigned long preheating_duration_ms = Co2SensorController::get_preheating_duration_ms();
+        ///< Time from start-up until the sensor warm-up was completed.
+        Log.traceln("%s", SENSOR_HEALTH);
+        TRACE_LN_u(preheating_duration_ms);
+        for (uint8_t sensor_index = 0; sensor_index < Co2SensorController::get_number_of_sensors(); sensor_index++) {
+            const Co2SensorController::SensorHealth health = Co2SensorController::get_sensor_health(sensor_index);
+            ///< Counters and gauges of the sensor.
+            TRACE_LN_d(sensor_index);
+            TRACE_LN_u(health.number_of_readings);
+            TRACE_LN_u(health.number_of_out_of_range_readings);
+            TRACE_LN_u(health.number_of_missing_readings);
+            TRACE_LN_d(health.max_consecutive_faulty_readings);
+            TRACE_LN_u(health.pwm_period_us);
+            TRACE_LN_d(health.pwm_duty_drift_ppm);
+            TRACE_LN_u(health.time_since_last_valid_reading_ms);
+        }
+    }
+
+    void log_memory_usage() {
+        const unsigned long stack_high_water_mark_bytes = MemoryMonitor::get_stack_high_water_mark_bytes();
+        ///< Maximum stack usage (in bytes) since start-up.
+        const unsigned long unused_memory_bytes = MemoryMonitor::get_unused_memory_bytes();
+        ///< SRAM (in bytes) never used by the stack or the heap since start-up.
+        const unsigned long free_memory_bytes = MemoryMonitor::get_free_memory_bytes();
+        ///< Current gap (in bytes) between heap and stack.
+        const unsigned long data_size_bytes = MemoryMonitor::get_data_size_bytes();
+        ///< Size (in bytes) of the initialized static variables.
+        const unsigned long bss_size_bytes = MemoryMonitor::get_bss_size_bytes();
+        ///< Size (in bytes) of the zero-initialized static variables.
+        Log.traceln("%s", MEMORY_USAGE);
+        TRACE_LN_u(stack_high_water_mark_bytes);
+        TRACE_LN_u(unused_memory_bytes);
+        TRACE_LN_u(free_memory_bytes);
+        TRACE_LN_u(data_size_bytes);
+        TRACE_LN_u(bss_size_bytes);
+    }
+
+    void log_boot_timeline() {
+        Log.noticeln("%s", BOOT_TIMELINE);
+        for (uint8_t i = 0; i < BootTimeline::get_number_of_phases(); i++) {
+            Log.noticeln("  %s: %u, %u", BootTimeline::get_phase_name(i), BootTimeline::get_phase_start_time_us(i),
+                         BootTimeline::get_phase_duration_us(i));
+        }
+    }
+
+    void log_time_to_first_reading() {
+        Log.noticeln("%s %u", TIME_TO_FIRST_READING, BootTimeline::get_time_to_first_reading_ms());
+    }
+
+    void log_history_transfer(const unsigned long acknowledged_records, const unsigned long requested_records,
+                              const unsigned long resent_frames) {
+        // The %u of ArduinoLog reads an unsigned long, so all values are passed as unsigned long.
+        Log.noticeln("%s %u, %u, %u", HISTORY_TRANSFER, acknowledged_records, requested_records, resent_frames);
+    }
+
     void log_loop_start() {
         Log.traceln("%s", DIVIDING_LINE_LOOP);
         Log.traceln("%s", LOOP_START);
     }
 
     void log_loop_end() {
-        log_current_state();
+        Log.traceln("%s", DIVIDING_LINE_STATE);
+        log_state_variables();
+        LOOP_DIAGNOSTICS[next_loop_diagnostics_index]();
+        next_loop_diagnostics_index = static_cast<uint8_t>((next_loop_diagnostics_index + 1) %
+                                                           NUMBER_OF_LOOP_DIAGNOSTICS);
+        Log.traceln("%s", DIVIDING_LINE_STATE);
         Log.traceln(LOOP_END);
     }
 
     void print_prefix(Print *_log_output, const int log_level) {
+        if (lock_output != nullptr) {
+            lock_output();
+        }
         print_timestamp(_log_output);
         print_log_level(_log_output, log_level);
     }
 
     void print_timestamp(Print *_log_output) {
-        // Division constants
-        constexpr unsigned long MSECS_PER_SEC = 1000UL; ///< Number of milliseconds per second.
-        constexpr unsigned long SECS_PER_MIN = 60UL; ///< Number of seconds per minute.
-        constexpr unsigned long SECS_PER_HOUR = 3600UL; ///< Number of seconds per hour.
-        constexpr unsigned long SECS_PER_DAY = 86400UL; ///< Number of seconds per day.
-
-        // Total time
-        const unsigned long msecs = millis(); ///< Total milliseconds elapsed since the program started.
-        const unsigned long secs = msecs / MSECS_PER_SEC; ///< Total seconds elapsed since the program started.
-
-        // Time in components
-        const unsigned long milli_seconds = msecs % MSECS_PER_SEC; ///< Milliseconds component of the current time.
-        const unsigned long seconds = secs % SECS_PER_MIN; ///< Seconds component of the current time.
-        const unsigned long minutes = (secs / SECS_PER_MIN) % SECS_PER_MIN; ///< Minutes component of the current time.
-        const unsigned long hours = (secs % SECS_PER_DAY) / SECS_PER_HOUR; ///< Hours component of the current time.
-
-        // Time as string
-        char timestamp[20]; ///< Buffer to store the formatted timestamp.
-        sprintf(timestamp, "[%02lu:%02lu:%02lu.%03lu] ", hours, minutes, seconds, milli_seconds);
+        char timestamp[TextFormatter::TIMESTAMP_BUFFER_SIZE]; ///< Buffer to store the formatted timestamp.
+        TextFormatter::write_timestamp(timestamp, millis());
         _log_output->print(timestamp);
     }
 
@@ -137,5 +252,8 @@ namespace LogController {
 
     void print_suffix(Print *_log_output, const int log_level) {
         _log_output->print("");
+        if (unlock_output != nullptr) {
+            unlock_output();
+        }
     }
 }
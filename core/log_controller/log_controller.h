@@ -121,6 +121,9 @@ namespace LogController {
      */
 #define TRACE_LN_D(variable) Log.traceln("Variable: " #variable " == %D", variable)
 
+    constexpr unsigned int SERIAL_BAUD_RATE = 9600;
+    ///< Defines the baud rate used for serial communication during debugging.
+
     constexpr char WELCOME_MESSAGE[] = "*           Welcome to the Air Quality Meter!           *";
     ///< Message displayed during system startup.
 
@@ -130,14 +133,40 @@ namespace LogController {
     constexpr char DISPLAY_CONTROLLER[] = "Display controller"; ///< Label for the Display Controller module.
     constexpr char ACKNOWLEDGE_BUTTON[] = "Acknowledge button"; ///< Label for the Acknowledge Button in the system.
     constexpr char MUTE_BUTTON[] = "Mute button"; ///< Label for the Acknowledge Button in the system.
+    constexpr char PAGE_BUTTON[] = "Page button"; ///< Label for the Page Button in the system.
+    constexpr char DISPLAY_PAGES[] = "Display pages"; ///< Label for the Display Pages module.
     constexpr char SENSOR_CONTROLLER[] = "Sensor controller"; ///< Label for the Sensor Controller module.
     constexpr char LED_ARRAY[] = "LED array"; ///< Label for the LED Array module.
     constexpr char MUTE_INDICATOR[] = "Mute indicator"; ///< Label for the Mute indicator (LED).
     constexpr char AUDIO_CONTROLLER[] = "Audio controller"; ///< Label for the Audio Controller module.
-
+    constexpr char WATCHDOG[] = "Watchdog"; ///< Label for the Watchdog module.
+    constexpr char SYSTEM_TIME[] = "System time"; ///< Label for the System Time module (64-bit uptime).
+    constexpr char STATE_ACCESS[] = "State access"; ///< Label for the State Access module (critical section timer).
+    constexpr char BOOT_WELCOME_MESSAGE[] = "Welcome message"; ///< Label for the welcome message boot step.
+    constexpr char SENSOR_WARM_UP[] = "Sensor warm-up"; ///< Label for the warm-up (preheating) of the CO2 sensor.
+    constexpr char HISTORY_LOG[] = "History log"; ///< Label for the History Log module (EEPROM ring).
+
+    constexpr char BACKGROUND_TASK_NOT_REGISTERED[] = "Background task not registered (too many tasks):";
+    ///< Error logged, if a module could not register its background task.
     constexpr char SYSTEM_READY[] = "System ready"; ///< Message logged when the system is ready to operate.
+    constexpr char RESET_CAUSE[] = "Reset cause:"; ///< Label for the cause of the last reset.
+    constexpr char WARM_RESTART[] = "Warm restart: state restored, preheating skipped";
+    ///< Message logged when the system resumes from the snapshot taken before the reset.
 
     constexpr char STATE[] = "Current State:"; ///< Label for the current system state.
+    constexpr char DUTY_CYCLE[] = "Duty Cycle:"; ///< Label for the active and sleeping time of the MCU.
+    constexpr char CRITICAL_SECTIONS[] = "Critical Sections:";
+    ///< Label for the interrupt-disabled windows of the writes of the system state.
+    constexpr char TASK_LATENCIES[] = "Task Latencies:";
+    ///< Label for the end-to-end latencies of the tasks of the FreeRTOS variant.
+    constexpr char SENSOR_HEALTH[] = "Sensor Health:";
+    ///< Label for the health counters and PWM timing gauges of the CO2 sensors.
+    constexpr char MEMORY_USAGE[] = "Memory Usage:"; ///< Label for the SRAM usage (stack, free memory, statics).
+    constexpr char BOOT_TIMELINE[] = "Boot timeline (start, duration in us):"; ///< Label for the boot timeline.
+    constexpr char TIME_TO_FIRST_READING[] = "Time to first reading (ms):";
+    ///< Label for the time from start-up to the first valid reading.
+    constexpr char HISTORY_TRANSFER[] = "History transfer (records acknowledged, requested, frames resent):";
+    ///< Label for the result of a bulk download of the history.
 
     constexpr char LOOP_START[] = "Loop start"; ///< Message logged at the beginning of the main system loop.
     constexpr char LOOP_END[] = "Loop end"; ///< Message logged at the end of the main system loop.
@@ -148,14 +177,15 @@ namespace LogController {
     constexpr char DISPLAY_UPDATED[] = "Display updated"; ///< Message indicating the display module has been updated.
     constexpr char AUDIO_WARNING_ISSUED[] = "Audio warning issued"; ///< Message indicating an audio warning was issued.
     constexpr char STATE_UPDATED[] = "State updated"; ///< Message indicating the current state has been updated.
-    constexpr char ACKNOWLEDGE_BUTTON_DEBOUNCED[] = "Acknowledge button debounced";
-    ///< Message indicating the acknowledge button has been debounced.
     constexpr char ACKNOWLEDGE_BUTTON_PRESSED[] = "Acknowledge button pressed";
     ///< Message logged when the acknowledge button is pressed.
-    constexpr char MUTE_BUTTON_DEBOUNCED[] = "Mute button debounced";
-    ///< Message indicating the mute button has been debounced.
     constexpr char MUTE_BUTTON_PRESSED[] = "Mute button pressed";
     ///< Message logged when the mute button is pressed.
+    constexpr char PAGE_BUTTON_PRESSED[] = "Page button pressed";
+    ///< Message logged when the page button is pressed.
+
+    constexpr char MEASUREMENT_REJECTED[] = "Measurement rejected as outlier: ";
+    ///< Prefix for logging a CO2 reading rejected by the measurement filter.
 
     constexpr char DELAY_TIME[] = "Delay time: "; ///< Prefix for displaying the delay time.
 
@@ -173,11 +203,38 @@ namespace LogController {
      */
     void initialize(int log_level);
 
+    /**
+     * @brief Sets functions that lock and unlock the log output, so the lines of concurrent tasks are not mixed.
+     *
+     * The output is locked before the prefix of a line and unlocked after its suffix (the line break follows).
+     *
+     * @param lock Function locking the output (`nullptr`: no locking).
+     * @param unlock Function unlocking the output.
+     */
+    void set_output_lock(void (*lock)(), void (*unlock)());
+
+    /**
+     * @brief Suppresses all log output (e.g. while the serial link carries a history transfer).
+     *
+     * A line in progress in another task is completed first, if the output is locked (see `set_output_lock`).
+     */
+    void pause_output();
+
+    /**
+     * @brief Restores the log level active before `pause_output`.
+     */
+    void resume_output();
+
     /**
      * @brief Logs a welcome message at system startup.
      */
     void log_welcome_message();
 
+    /**
+     * @brief Logs the cause of the last reset, and whether the system resumes from a warm restart.
+     */
+    void log_reset_cause();
+
     /**
      * @brief Logs the initialization status of a specific module.
      *
@@ -186,17 +243,65 @@ namespace LogController {
     void log_initialization(const char *module);
 
     /**
-     * @brief Logs the system's current operational state.
+     * @brief Logs the system's current operational state, with all diagnostic blocks (duty cycle, critical sections,
+     *        sensor health and memory usage).
      */
     void log_current_state();
 
+    /**
+     * @brief Logs the system state (warning counter, mute state and time stamps) without the diagnostic blocks.
+     */
+    void log_state_variables();
+
+    /**
+     * @brief Logs the time the MCU was active and the time it spent in idle sleep since start-up.
+     */
+    void log_duty_cycle();
+
+    /**
+     * @brief Logs the number of writes of the system state and the longest interrupt-disabled window of a write.
+     */
+    void log_critical_sections();
+
+    /**
+     * @brief Logs the health counters and PWM timing gauges of each CO2 sensor, and the preheating duration.
+     */
+    void log_sensor_health();
+
+    /**
+     * @brief Logs the stack high-water mark, the free SRAM and the size of the static variables.
+     */
+    void log_memory_usage();
+
+    /**
+     * @brief Logs the start time and duration of all initialization phases.
+     */
+    void log_boot_timeline();
+
+    /**
+     * @brief Logs the time from start-up to the first valid reading.
+     */
+    void log_time_to_first_reading();
+
+    /**
+     * @brief Logs the result of a history transfer.
+     *
+     * @param acknowledged_records Number of records acknowledged by the host.
+     * @param requested_records Number of records to send.
+     * @param resent_frames Number of data frames sent again after a timeout.
+     */
+    void log_history_transfer(unsigned long acknowledged_records, unsigned long requested_records,
+                              unsigned long resent_frames);
+
     /**
      * @brief Logs the start of the system loop.
      */
     void log_loop_start();
 
     /**
-     * @brief Logs the end of the system loop.
+     * @brief Logs the system state with one of the diagnostic blocks, in turn, and the end of the system loop.
+     * @details The output of a loop has to fit into the watchdog timeout, even on a slowly draining serial link, so
+     *          each diagnostic block is only logged every fourth loop.
      */
     void log_loop_end();
 }
@@ -0,0 +1,87 @@
+/**
+ * @file measurement_aggregator.cpp
+ * @brief Implementation of the combination of several CO2 sensor readings.
+ */
+
+#include <measurement_aggregator.h>
+
+namespace MeasurementAggregator {
+    /**
+     * @brief   Returns the highest of the given readings.
+     */
+    int get_maximum(const int *measurements_ppm, uint8_t number_of_measurements);
+
+    /**
+     * @brief   Returns the median of the given readings.
+     * @details For an even number of readings, the mean of the two middle values is returned.
+     */
+    int get_median(const int *measurements_ppm, uint8_t number_of_measurements);
+
+    /**
+     * @brief   Returns the weighted mean of the given readings.
+     * @details Falls back to the unweighted mean if all weights are zero.
+     */
+    int get_weighted_average(const int *measurements_ppm, const uint8_t *weights, uint8_t number_of_measurements);
+
+    int combine(const int *measurements_ppm, const uint8_t *weights, uint8_t number_of_measurements,
+                const Strategy strategy) {
+        if (!measurements_ppm || number_of_measurements == 0) {
+            return NO_MEASUREMENT;
+        }
+        if (number_of_measurements > MAX_NUMBER_OF_MEASUREMENTS) {
+            number_of_measurements = MAX_NUMBER_OF_MEASUREMENTS;
+        }
+        switch (strategy) {
+            case MEDIAN:
+                return get_median(measurements_ppm, number_of_measurements);
+            case WEIGHTED_AVERAGE:
+                return get_weighted_average(measurements_ppm, weights, number_of_measurements);
+            case MAXIMUM:
+            default:
+                return get_maximum(measurements_ppm, number_of_measurements);
+        }
+    }
+
+    int get_maximum(const int *measurements_ppm, const uint8_t number_of_measurements) {
+        int maximum_ppm = measurements_ppm[0];
+        for (uint8_t i = 1; i < number_of_measurements; i++) {
+            if (measurements_ppm[i] > maximum_ppm) {
+                maximum_ppm = measurements_ppm[i];
+            }
+        }
+        return maximum_ppm;
+    }
+
+    int get_median(const int *measurements_ppm, const uint8_t number_of_measurements) {
+        int sorted_ppm[MAX_NUMBER_OF_MEASUREMENTS]; ///< Copy of the readings, sorted by insertion sort.
+        for (uint8_t i = 0; i < number_of_measurements; i++) {
+            const int measurement_ppm = measurements_ppm[i];
+            uint8_t position = i;
+            while (position > 0 && sorted_ppm[position - 1] > measurement_ppm) {
+                sorted_ppm[position] = sorted_ppm[position - 1];
+                position--;
+            }
+            sorted_ppm[position] = measurement_ppm;
+        }
+        const uint8_t middle = number_of_measurements / 2;
+        if (number_of_measurements % 2 == 1) {
+            return sorted_ppm[middle];
+        }
+        return (sorted_ppm[middle - 1] + sorted_ppm[middle]) / 2;
+    }
+
+    int get_weighted_average(const int *measurements_ppm, const uint8_t *weights,
+                             const uint8_t number_of_measurements) {
+        long weighted_sum_ppm = 0L;
+        long sum_of_weights = 0L;
+        for (uint8_t i = 0; i < number_of_measurements; i++) {
+            const uint8_t weight = weights ? weights[i] : 1;
+            weighted_sum_ppm += static_cast<long>(measurements_ppm[i]) * weight;
+            sum_of_weights += weight;
+        }
+        if (sum_of_weights == 0L) {
+            return get_weighted_average(measurements_ppm, nullptr, number_of_measurements);
+        }
+        return static_cast<int>(weighted_sum_ppm / sum_of_weights);
+    }
+}
@@ -0,0 +1,41 @@
+/**
+ * @file measurement_aggregator.h
+ * @brief Header file for combining the measurements of several CO2 sensors.
+ * @details This module reduces the latest valid readings of all registered CO2 sensors to a single room value,
+ *          which is then interpreted as if it came from a single sensor.
+ */
+
+#ifndef MEASUREMENT_AGGREGATOR_H
+#define MEASUREMENT_AGGREGATOR_H
+
+#include <Arduino.h>
+
+namespace MeasurementAggregator {
+    /**
+     * @enum    Strategy
+     * @brief   Strategies to combine several sensor readings into one room value.
+     */
+    enum Strategy : uint8_t {
+        MAXIMUM, ///< The highest reading is used (most conservative with respect to warnings).
+        MEDIAN, ///< The median of all readings is used (robust against a single faulty sensor).
+        WEIGHTED_AVERAGE ///< The readings are averaged according to the weight of each sensor.
+    };
+
+    constexpr uint8_t MAX_NUMBER_OF_MEASUREMENTS = 8; ///< Maximum number of readings that can be combined.
+    constexpr int NO_MEASUREMENT = -1; ///< Returned if there is no reading to combine.
+
+    /**
+     * @brief   Combines several CO2 readings into a single value.
+     * @details The calculation works on fixed-size local buffers, so its run time only depends on the number of
+     *          readings and not on heap usage.
+     * @param   measurements_ppm Array of valid CO2 readings in ppm.
+     * @param   weights Array with the weight of each reading (only used for `WEIGHTED_AVERAGE`).
+     * @param   number_of_measurements Number of entries in both arrays (at most `MAX_NUMBER_OF_MEASUREMENTS`).
+     * @param   strategy The strategy used to combine the readings.
+     * @return  The combined CO2 value in ppm, or `NO_MEASUREMENT` if there is nothing to combine.
+     */
+    int combine(const int *measurements_ppm, const uint8_t *weights, uint8_t number_of_measurements,
+                Strategy strategy);
+}
+
+#endif //MEASUREMENT_AGGREGATOR_H
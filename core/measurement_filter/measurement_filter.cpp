@@ -0,0 +1,110 @@
+/**
+ * @file measurement_filter.cpp
+ * @brief Implementation of the outlier rejection of CO2 measurements (Hampel filter with plausibility check).
+ */
+
+#include <measurement_filter.h>
+#include <ArduinoLog.h>
+#include <log_controller.h>
+
+namespace MeasurementFilter {
+    /**
+     * @brief   Returns the median of the given values.
+     * @details Sorts a local copy of the values with insertion sort (at most `WINDOW_SIZE` values).
+     */
+    int get_median(const int *values, uint8_t number_of_values);
+
+    /**
+     * @brief   Checks, whether a reading deviates too much from the window median (Hampel identifier).
+     */
+    bool is_hampel_outlier(int measurement_ppm, int median_ppm);
+
+    /**
+     * @brief   Checks, whether a reading changed faster than physically plausible since the last accepted value.
+     */
+    bool is_rate_of_change_implausible(int measurement_ppm, unsigned long time_stamp_ms);
+
+    constexpr uint8_t MIN_READINGS_FOR_REJECTION = 3;
+    ///< Minimum number of readings in the window before readings can be rejected.
+    constexpr long HAMPEL_THRESHOLD_PERMILLE = 4448L;
+    ///< Allowed deviation from the median as multiple of the MAD in permille (3 * 1.4826 scale factor).
+    constexpr int MIN_ALLOWED_DEVIATION_PPM = 50;
+    ///< Deviation from the median that is always accepted (accuracy of the MH-Z19B is ±50 ppm + 5 %).
+    constexpr unsigned long MAX_CHANGE_PPM_PER_SECOND = 50UL;
+    ///< Maximum plausible rate of change of the CO2 concentration in ppm per second.
+    constexpr unsigned long MSECS_PER_SEC = 1000UL; ///< Number of milliseconds per second.
+
+    int window_ppm[WINDOW_SIZE]; ///< Ring buffer of the most recent raw readings.
+    uint8_t window_index = 0; ///< Position of the next reading in the ring buffer.
+    uint8_t number_of_readings = 0; ///< Number of readings in the ring buffer.
+    int last_accepted_measurement_ppm = 0; ///< Last value returned by the filter.
+    unsigned long last_accepted_time_stamp_ms = 0UL; ///< Time (in ms) of the last value returned by the filter.
+    unsigned long rejected_measurement_count = 0UL; ///< Number of rejected readings since start-up.
+
+    int filter(const int measurement_ppm, const unsigned long time_stamp_ms) {
+        window_ppm[window_index] = measurement_ppm;
+        window_index = (window_index + 1) % WINDOW_SIZE;
+        if (number_of_readings < WINDOW_SIZE) {
+            number_of_readings++;
+        }
+
+        int filtered_measurement_ppm = measurement_ppm; ///< Value returned by the filter.
+        if (number_of_readings >= MIN_READINGS_FOR_REJECTION) {
+            const int median_ppm = get_median(window_ppm, number_of_readings);
+            if (is_hampel_outlier(measurement_ppm, median_ppm) &&
+                is_rate_of_change_implausible(measurement_ppm, time_stamp_ms)) {
+                rejected_measurement_count++;
+                Log.warningln("%s%d", LogController::MEASUREMENT_REJECTED, measurement_ppm);
+                filtered_measurement_ppm = median_ppm;
+            }
+        }
+        last_accepted_measurement_ppm = filtered_measurement_ppm;
+        last_accepted_time_stamp_ms = time_stamp_ms;
+        return filtered_measurement_ppm;
+    }
+
+    unsigned long get_rejected_measurement_count() {
+        return rejected_measurement_count;
+    }
+
+    void reset() {
+        window_index = 0;
+        number_of_readings = 0;
+    }
+
+    int get_median(const int *values, const uint8_t number_of_values) {
+        int sorted_values[WINDOW_SIZE]; ///< Sorted copy of the values.
+        for (uint8_t i = 0; i < number_of_values; i++) {
+            const int value = values[i];
+            uint8_t position = i;
+            while (position > 0 && sorted_values[position - 1] > value) {
+                sorted_values[position] = sorted_values[position - 1];
+                position--;
+            }
+            sorted_values[position] = value;
+        }
+        return sorted_values[number_of_values / 2];
+    }
+
+    bool is_hampel_outlier(const int measurement_ppm, const int median_ppm) {
+        int absolute_deviations_ppm[WINDOW_SIZE]; ///< Absolute deviations of the window readings from the median.
+        for (uint8_t i = 0; i < number_of_readings; i++) {
+            absolute_deviations_ppm[i] = abs(window_ppm[i] - median_ppm);
+        }
+        const long median_absolute_deviation_ppm = get_median(absolute_deviations_ppm, number_of_readings);
+        long allowed_deviation_ppm = median_absolute_deviation_ppm * HAMPEL_THRESHOLD_PERMILLE / 1000L;
+        if (allowed_deviation_ppm < MIN_ALLOWED_DEVIATION_PPM) {
+            allowed_deviation_ppm = MIN_ALLOWED_DEVIATION_PPM;
+        }
+        return abs(measurement_ppm - median_ppm) > allowed_deviation_ppm;
+    }
+
+    bool is_rate_of_change_implausible(const int measurement_ppm, const unsigned long time_stamp_ms) {
+        const unsigned long elapsed_time_ms = time_stamp_ms - last_accepted_time_stamp_ms;
+        const unsigned long max_change_ppm =
+                MIN_ALLOWED_DEVIATION_PPM + MAX_CHANGE_PPM_PER_SECOND * (elapsed_time_ms / MSECS_PER_SEC);
+        ///< Maximum plausible change for the elapsed time, including the sensor accuracy.
+        const unsigned long change_ppm = abs(measurement_ppm - last_accepted_measurement_ppm);
+        return change_ppm > max_change_ppm;
+    }
+}
@@ -0,0 +1,48 @@
+/**
+ * @file measurement_filter.h
+ * @brief Header file for the outlier rejection of CO2 measurements.
+ * @details This module is a streaming filter stage between the CO2 sensor controller and the measurement
+ *          interpreter. It rejects single spikes, so they neither flip the air quality level nor reset the warning
+ *          timers, without requesting additional readings from the sensor.
+ */
+
+#ifndef MEASUREMENT_FILTER_H
+#define MEASUREMENT_FILTER_H
+
+#include <Arduino.h>
+
+namespace MeasurementFilter {
+    constexpr uint8_t WINDOW_SIZE = 5; ///< Number of recent readings used to calculate the median (odd number).
+
+    /**
+     * @brief   Filters a new CO2 reading.
+     *
+     * @details The reading is stored in a fixed-size window of the most recent raw readings and checked with two
+     *          criteria:
+     *           - Hampel identifier: the deviation from the window median must not exceed a multiple of the scaled
+     *             median absolute deviation (MAD) of the window.
+     *           - Plausibility: the change compared to the last accepted value must not exceed the maximum rate of
+     *             change for the elapsed time.
+     *          If both criteria are exceeded, the reading is rejected and replaced by the window median.
+     *          Because the raw readings are kept in the window, a real and lasting change of the CO2 concentration
+     *          moves the median and is accepted after a few readings.
+     *          Memory usage is fixed and the run time is bounded by the window size.
+     *
+     * @param   measurement_ppm The valid CO2 reading in ppm.
+     * @param   time_stamp_ms Time (in ms) the reading was taken.
+     * @return  The filtered CO2 value in ppm.
+     */
+    int filter(int measurement_ppm, unsigned long time_stamp_ms);
+
+    /**
+     * @brief   Returns the number of readings rejected as outliers since start-up.
+     */
+    unsigned long get_rejected_measurement_count();
+
+    /**
+     * @brief   Clears the window, e.g. after the sensor could not deliver valid readings for a while.
+     */
+    void reset();
+}
+
+#endif //MEASUREMENT_FILTER_H
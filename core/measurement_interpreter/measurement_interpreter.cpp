@@ -10,6 +10,13 @@
 
 
 namespace MeasurementInterpreter {
+    static_assert(NUMBER_OF_LEVELS == 5 &&
+                  DEFAULT_THRESHOLDS.upper_threshold_ppm[0] == AirQuality::AIR_QUALITY_LEVELS[0].upper_threshold_ppm &&
+                  DEFAULT_THRESHOLDS.upper_threshold_ppm[1] == AirQuality::AIR_QUALITY_LEVELS[1].upper_threshold_ppm &&
+                  DEFAULT_THRESHOLDS.upper_threshold_ppm[2] == AirQuality::AIR_QUALITY_LEVELS[2].upper_threshold_ppm &&
+                  DEFAULT_THRESHOLDS.upper_threshold_ppm[3] == AirQuality::AIR_QUALITY_LEVELS[3].upper_threshold_ppm,
+                  "The default thresholds have to match the air quality levels.");
+
     AirQuality::Level get_air_quality_level(const int co2_measurement_ppm) {
         for (const AirQuality::Level &air_quality_level: AirQuality::AIR_QUALITY_LEVELS) {
             if (co2_measurement_ppm <= air_quality_level.upper_threshold_ppm) {
@@ -18,4 +25,22 @@ namespace MeasurementInterpreter {
         }
         return AirQuality::POOR_QUALITY;
     }
+
+    uint8_t get_air_quality_level_index(const int co2_measurement_ppm) {
+        for (uint8_t i = 0; i < NUMBER_OF_LEVELS; i++) {
+            if (co2_measurement_ppm <= AirQuality::AIR_QUALITY_LEVELS[i].upper_threshold_ppm) {
+                return i;
+            }
+        }
+        return NUMBER_OF_LEVELS - 1; // poor air quality
+    }
+
+    uint8_t get_air_quality_level_index(const int co2_measurement_ppm, const Thresholds &thresholds) {
+        for (uint8_t i = 0; i < NUMBER_OF_LEVELS - 1; i++) {
+            if (co2_measurement_ppm <= thresholds.upper_threshold_ppm[i]) {
+                return i;
+            }
+        }
+        return NUMBER_OF_LEVELS - 1; // poor air quality
+    }
 }
@@ -8,8 +8,31 @@
 #ifndef MEASUREMENT_INTERPRETER_H
 #define MEASUREMENT_INTERPRETER_H
 
+#include <stdint.h>
 #include <air_quality.h>
 namespace MeasurementInterpreter {
+    constexpr uint8_t NUMBER_OF_LEVELS = sizeof(AirQuality::AIR_QUALITY_LEVELS) / sizeof(AirQuality::Level);
+    ///< Number of predefined air quality levels.
+
+    /**
+     * @struct  Thresholds
+     * @brief   Upper CO2 thresholds of the air quality levels (all levels but the last one, which has no upper limit).
+     * @details The firmware uses `DEFAULT_THRESHOLDS` (the constants in thresholds.h). Host tools pass other thresholds
+     *          to evaluate them against recorded data.
+     */
+    struct Thresholds {
+        int upper_threshold_ppm[NUMBER_OF_LEVELS - 1]; ///< Upper threshold of each level (ascending).
+    };
+
+    constexpr Thresholds DEFAULT_THRESHOLDS = {
+        {
+            CO2Thresholds::HIGH_QUALITY_PPM,
+            CO2Thresholds::MEDIUM_QUALITY_PPM,
+            CO2Thresholds::LOWER_MODERATE_QUALITY_PPM,
+            CO2Thresholds::UPPER_MODERATE_QUALITY_PPM
+        }
+    }; ///< Thresholds of the firmware.
+
     /**
      * @brief   Determines the air quality level based on the provided CO2 measurement in ppm.
      *
@@ -22,6 +45,25 @@ namespace MeasurementInterpreter {
      * @return  The air quality level corresponding to the given CO2 measurement.
      */
     AirQuality::Level get_air_quality_level(int co2_measurement_ppm);
+
+    /**
+     * @brief   Determines the index of the air quality level based on the provided CO2 measurement in ppm.
+     *
+     * @param   co2_measurement_ppm The CO2 concentration measurement in parts per million (ppm).
+     *
+     * @return  The index of the corresponding level in `AirQuality::AIR_QUALITY_LEVELS`.
+     */
+    uint8_t get_air_quality_level_index(int co2_measurement_ppm);
+
+    /**
+     * @brief   Determines the index of the air quality level of a CO2 measurement with the given thresholds.
+     *
+     * @param   co2_measurement_ppm The CO2 concentration measurement in parts per million (ppm).
+     * @param   thresholds The upper thresholds of the air quality levels.
+     *
+     * @return  The index of the corresponding level in `AirQuality::AIR_QUALITY_LEVELS`.
+     */
+    uint8_t get_air_quality_level_index(int co2_measurement_ppm, const Thresholds &thresholds);
 }
 
 #endif //MEASUREMENT_INTERPRETER_H
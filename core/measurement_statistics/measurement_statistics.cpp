@@ -0,0 +1,139 @@
+/**
+ * @file measurement_statistics.cpp
+ * @brief Implementation of the statistics of the CO2 measurements of the last hour.
+ */
+
+#include <measurement_statistics.h>
+
+namespace MeasurementStatistics {
+    /**
+     * @struct  Bucket
+     * @brief   Summary of the measurements in one time span.
+     */
+    struct Bucket {
+        unsigned long sum_ppm; ///< Sum of all measurements.
+        uint16_t count; ///< Number of measurements.
+        int minimum_ppm; ///< Lowest measurement.
+        int maximum_ppm; ///< Highest measurement.
+    };
+
+    /**
+     * @brief   Moves to the bucket of the given time and clears all buckets skipped.
+     */
+    void advance_to(unsigned long time_stamp_ms);
+
+    /**
+     * @brief   Returns the bucket with the given age (0 = current bucket).
+     */
+    const Bucket &get_bucket(uint8_t age);
+
+    constexpr long BUCKETS_PER_HOUR = 3600000L / BUCKET_DURATION_MS; ///< Number of buckets per hour.
+
+    Bucket buckets[NUMBER_OF_BUCKETS] = {}; ///< Ring buffer of buckets.
+    uint8_t current_bucket_index = 0; ///< Index of the bucket new measurements are added to.
+    unsigned long current_bucket_start_time_ms = 0UL; ///< Time (in ms) the current bucket started.
+    bool has_measurements = false; ///< True, after the first measurement was added.
+
+    void add(const int co2_measurement_ppm, const unsigned long time_stamp_ms) {
+        if (!has_measurements) {
+            has_measurements = true;
+            current_bucket_start_time_ms = time_stamp_ms;
+        }
+        advance_to(time_stamp_ms);
+        Bucket &bucket = buckets[current_bucket_index];
+        if (bucket.count == 0 || co2_measurement_ppm < bucket.minimum_ppm) {
+            bucket.minimum_ppm = co2_measurement_ppm;
+        }
+        if (bucket.count == 0 || co2_measurement_ppm > bucket.maximum_ppm) {
+            bucket.maximum_ppm = co2_measurement_ppm;
+        }
+        if (bucket.count < UINT16_MAX) {
+            bucket.sum_ppm += co2_measurement_ppm;
+            bucket.count++;
+        }
+    }
+
+    int get_average_ppm() {
+        unsigned long sum_ppm = 0UL;
+        unsigned long count = 0UL;
+        for (const Bucket &bucket: buckets) {
+            sum_ppm += bucket.sum_ppm;
+            count += bucket.count;
+        }
+        return count > 0 ? static_cast<int>(sum_ppm / count) : NO_VALUE;
+    }
+
+    int get_minimum_ppm() {
+        int minimum_ppm = NO_VALUE;
+        for (const Bucket &bucket: buckets) {
+            if (bucket.count > 0 && (minimum_ppm == NO_VALUE || bucket.minimum_ppm < minimum_ppm)) {
+                minimum_ppm = bucket.minimum_ppm;
+            }
+        }
+        return minimum_ppm;
+    }
+
+    int get_maximum_ppm() {
+        int maximum_ppm = NO_VALUE;
+        for (const Bucket &bucket: buckets) {
+            if (bucket.count > 0 && bucket.maximum_ppm > maximum_ppm) {
+                maximum_ppm = bucket.maximum_ppm;
+            }
+        }
+        return maximum_ppm;
+    }
+
+    bool is_trend_available() {
+        uint8_t number_of_used_buckets = 0;
+        for (const Bucket &bucket: buckets) {
+            if (bucket.count > 0) {
+                number_of_used_buckets++;
+            }
+        }
+        return number_of_used_buckets >= 2;
+    }
+
+    long get_trend_ppm_per_hour() {
+        // Least squares fit of the bucket averages (y) over the bucket position in time (x).
+        long n = 0;
+        long sum_x = 0;
+        long sum_y = 0;
+        long sum_xy = 0;
+        long sum_xx = 0;
+        for (uint8_t x = 0; x < NUMBER_OF_BUCKETS; x++) {
+            const Bucket &bucket = get_bucket(NUMBER_OF_BUCKETS - 1 - x); // oldest bucket first
+            if (bucket.count == 0) {
+                continue;
+            }
+            const long y = static_cast<long>(bucket.sum_ppm / bucket.count); ///< Average of the bucket.
+            n++;
+            sum_x += x;
+            sum_y += y;
+            sum_xy += x * y;
+            sum_xx += static_cast<long>(x) * x;
+        }
+        const long denominator = n * sum_xx - sum_x * sum_x;
+        if (n < 2 || denominator == 0) {
+            return 0;
+        }
+        return (n * sum_xy - sum_x * sum_y) * BUCKETS_PER_HOUR / denominator;
+    }
+
+    void advance_to(const unsigned long time_stamp_ms) {
+        if (time_stamp_ms - current_bucket_start_time_ms >= NUMBER_OF_BUCKETS * BUCKET_DURATION_MS) {
+            // Nothing measured for an hour: start from scratch.
+            memset(buckets, 0, sizeof(buckets));
+            current_bucket_start_time_ms = time_stamp_ms;
+            return;
+        }
+        while (time_stamp_ms - current_bucket_start_time_ms >= BUCKET_DURATION_MS) {
+            current_bucket_index = (current_bucket_index + 1) % NUMBER_OF_BUCKETS;
+            buckets[current_bucket_index] = {};
+            current_bucket_start_time_ms += BUCKET_DURATION_MS;
+        }
+    }
+
+    const Bucket &get_bucket(const uint8_t age) {
+        return buckets[(current_bucket_index + NUMBER_OF_BUCKETS - age) % NUMBER_OF_BUCKETS];
+    }
+}
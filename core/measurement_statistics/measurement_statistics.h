@@ -0,0 +1,57 @@
+/**
+ * @file measurement_statistics.h
+ * @brief Header file for the statistics of the CO2 measurements of the last hour.
+ * @details The measurements are summarized in fixed time buckets (sum, count, minimum and maximum), so the
+ *          statistics of the last hour need a fixed and small amount of memory, independent of the measurement rate.
+ *          Old buckets are overwritten, i.e. the statistics cover the last 55 to 60 minutes.
+ */
+
+#ifndef MEASUREMENT_STATISTICS_H
+#define MEASUREMENT_STATISTICS_H
+
+#include <Arduino.h>
+
+namespace MeasurementStatistics {
+    constexpr uint8_t NUMBER_OF_BUCKETS = 12; ///< Number of time buckets.
+    constexpr unsigned long BUCKET_DURATION_MS = 300000UL; ///< Time span of a bucket (5 minutes).
+    constexpr int NO_VALUE = -1; ///< Returned, if there are no measurements in the last hour.
+
+    /**
+     * @brief   Adds a measurement to the statistics.
+     * @param   co2_measurement_ppm The (filtered) CO2 value in ppm.
+     * @param   time_stamp_ms Time (in ms) of the measurement.
+     */
+    void add(int co2_measurement_ppm, unsigned long time_stamp_ms);
+
+    /**
+     * @brief   Returns the average CO2 value of the last hour.
+     * @return  The average in ppm or `NO_VALUE`.
+     */
+    int get_average_ppm();
+
+    /**
+     * @brief   Returns the lowest CO2 value of the last hour.
+     * @return  The minimum in ppm or `NO_VALUE`.
+     */
+    int get_minimum_ppm();
+
+    /**
+     * @brief   Returns the highest CO2 value of the last hour.
+     * @return  The maximum in ppm or `NO_VALUE`.
+     */
+    int get_maximum_ppm();
+
+    /**
+     * @brief   Checks, if there are enough measurements for a trend (at least two buckets).
+     */
+    bool is_trend_available();
+
+    /**
+     * @brief   Returns the trend of the CO2 value in the last hour.
+     * @details Slope of the least squares line through the bucket averages.
+     * @return  The change in ppm per hour (0, if no trend is available).
+     */
+    long get_trend_ppm_per_hour();
+}
+
+#endif //MEASUREMENT_STATISTICS_H
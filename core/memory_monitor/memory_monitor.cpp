@@ -0,0 +1,107 @@
+/**
+ * @file memory_monitor.cpp
+ * @brief Implementation of the SRAM usage monitoring.
+ */
+
+#include <memory_monitor.h>
+
+#ifdef __AVR__
+extern uint8_t __data_start; ///< Start of the `.data` section (linker symbol).
+extern uint8_t __data_end; ///< End of the `.data` section (linker symbol).
+extern uint8_t __bss_start; ///< Start of the `.bss` section (linker symbol).
+extern uint8_t __bss_end; ///< End of the `.bss` section (linker symbol).
+extern uint8_t __heap_start; ///< Start of the heap, after all static variables (linker symbol).
+extern char *__brkval; ///< Current end of the heap (avr-libc malloc), `nullptr` if the heap was never used.
+
+namespace MemoryMonitor {
+    /**
+     * @brief   Fills the SRAM from the start of the heap up to the top of the stack with the canary pattern.
+     * @details Runs in the `.init3` section, i.e. after the stack pointer is set up and before the static variables
+     *          are initialized and the constructors are called. As a naked function without a stack frame it must
+     *          not use the stack, so it is written in assembler.
+     */
+    void paint_memory() __attribute__((naked, used, section(".init3")));
+
+    /**
+     * @brief   Returns the lowest address used by the heap or the stack since start-up.
+     */
+    const uint8_t *get_lowest_used_address();
+
+    /**
+     * @brief   Returns the current end of the heap.
+     */
+    const uint8_t *get_heap_end();
+
+    void paint_memory() {
+        __asm__ volatile(
+            "    ldi r30, lo8(__heap_start)\n"
+            "    ldi r31, hi8(__heap_start)\n"
+            "    ldi r24, %[canary]\n"
+            "    ldi r25, hi8(__stack)\n"
+            "    rjmp 2f\n"
+            "1:  st Z+, r24\n"
+            "2:  cpi r30, lo8(__stack)\n"
+            "    cpc r31, r25\n"
+            "    brlo 1b\n"
+            "    breq 1b\n"
+            :
+            : [canary] "i"(CANARY)
+        );
+    }
+
+    uint16_t get_stack_high_water_mark_bytes() {
+        return static_cast<uint16_t>(RAMEND + 1 - reinterpret_cast<uintptr_t>(get_lowest_used_address()));
+    }
+
+    uint16_t get_unused_memory_bytes() {
+        return static_cast<uint16_t>(get_lowest_used_address() - get_heap_end());
+    }
+
+    uint16_t get_free_memory_bytes() {
+        return static_cast<uint16_t>(SP - reinterpret_cast<uintptr_t>(get_heap_end()));
+    }
+
+    uint16_t get_data_size_bytes() {
+        return static_cast<uint16_t>(&__data_end - &__data_start);
+    }
+
+    uint16_t get_bss_size_bytes() {
+        return static_cast<uint16_t>(&__bss_end - &__bss_start);
+    }
+
+    const uint8_t *get_lowest_used_address() {
+        const uint8_t *address = get_heap_end(); ///< Current candidate for the lowest used address.
+        const uint8_t *stack_pointer = reinterpret_cast<const uint8_t *>(SP); ///< Current top of the stack.
+        while (address <= stack_pointer && *address == CANARY) {
+            address++;
+        }
+        return address;
+    }
+
+    const uint8_t *get_heap_end() {
+        return __brkval != nullptr ? reinterpret_cast<const uint8_t *>(__brkval) : &__heap_start;
+    }
+}
+#else
+namespace MemoryMonitor {
+    uint16_t get_stack_high_water_mark_bytes() {
+        return 0;
+    }
+
+    uint16_t get_unused_memory_bytes() {
+        return 0;
+    }
+
+    uint16_t get_free_memory_bytes() {
+        return 0;
+    }
+
+    uint16_t get_data_size_bytes() {
+        return 0;
+    }
+
+    uint16_t get_bss_size_bytes() {
+        return 0;
+    }
+}
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file memory_monitor.h
+ * @brief Header file for the SRAM usage monitoring.
+ * @details The memory monitor paints the unused SRAM between the heap and the stack with a canary pattern at start-up
+ *          (before any constructor runs). Later, the lowest overwritten address shows the deepest stack usage since
+ *          start-up (high-water mark). Together with the current gap between heap and stack and the size of the
+ *          static variables, this shows how much SRAM is left for new buffers.
+ *
+ *          The static SRAM usage per module is reported at build time by `tools/memory_report/memory_report.py`.
+ *          On the host (no AVR target), all values are 0.
+ */
+
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+
+namespace MemoryMonitor {
+    constexpr uint8_t CANARY = 0xC5; ///< Pattern written into the unused SRAM at start-up.
+
+    /**
+     * @brief   Returns the maximum stack usage since start-up.
+     * @details Scans the painted SRAM from the heap end upwards up to the first overwritten byte, so the run time grows
+     *          with the unused SRAM (about 1 ms per 3 KB on 16 MHz). Call it periodically, not in time critical code.
+     * @return  The stack high-water mark in bytes.
+     */
+    uint16_t get_stack_high_water_mark_bytes();
+
+    /**
+     * @brief   Returns the SRAM never used by the stack or the heap since start-up.
+     * @return  The number of painted bytes not yet overwritten.
+     */
+    uint16_t get_unused_memory_bytes();
+
+    /**
+     * @brief   Returns the current gap between the end of the heap and the stack pointer.
+     * @return  The currently free SRAM in bytes.
+     */
+    uint16_t get_free_memory_bytes();
+
+    /**
+     * @brief   Returns the size of the initialized static variables (`.data` section).
+     * @return  The size in bytes.
+     */
+    uint16_t get_data_size_bytes();
+
+    /**
+     * @brief   Returns the size of the zero-initialized static variables (`.bss` section).
+     * @return  The size in bytes.
+     */
+    uint16_t get_bss_size_bytes();
+}
+
+#endif //MEMORY_MONITOR_H
@@ -0,0 +1,352 @@
+/**
+ * @file modbus_slave.cpp
+ * @brief Implementation of the Modbus RTU slave interface.
+ */
+
+#include <modbus_slave.h>
+#include <pin_configuration.h>
+#include <state_access.h>
+#include <co2_sensor_controller.h>
+#include <measurement_filter.h>
+#include <measurement_statistics.h>
+#include <warm_restart.h>
+#include <system_time.h>
+#include <util/atomic.h>
+
+#if defined(ENABLE_MODBUS) && defined(__AVR__) && !defined(UDR1)
+#error "The Modbus slave needs the USART1 of the ATmega2560."
+#endif
+
+namespace ModbusSlave {
+    /**
+     * @brief   Writes the measurement, the system state and the statistics into the register table.
+     * @param   co2_register Value of the CO2 register.
+     * @param   air_quality_level_register Value of the air quality level register.
+     */
+    void write_registers(uint16_t co2_register, uint16_t air_quality_level_register);
+
+    /**
+     * @brief   Checks the received frame and writes the response (without CRC) into the response buffer.
+     * @return  True, if the frame is a request to this slave, that is to be answered.
+     */
+    bool build_response();
+
+    /**
+     * @brief   Writes an exception response into the response buffer.
+     * @return  True (the exception is to be sent).
+     */
+    bool build_exception(uint8_t function, uint8_t exception_code);
+
+    /**
+     * @brief   Returns the value of a register for a response.
+     */
+    uint16_t read_register(uint8_t address);
+
+    /**
+     * @brief   Updates a CRC16/MODBUS with one byte.
+     */
+    uint16_t update_crc(uint16_t crc, uint8_t character);
+
+    /**
+     * @brief   Limits a counter to the range of a register.
+     */
+    uint16_t saturate_uint16(unsigned long value);
+
+    /**
+     * @brief   Configures the USART and Timer4 (device only).
+     */
+    void configure_hardware();
+
+    /**
+     * @brief   Enables the data register empty interrupt, that sends the response (device only).
+     */
+    void start_transmitter();
+
+#ifdef ENABLE_MODBUS
+    constexpr bool IS_MODBUS_ENABLED = true; ///< The Modbus slave is started.
+#else
+    constexpr bool IS_MODBUS_ENABLED = false; ///< The Modbus slave is not started.
+#endif
+    constexpr uint16_t CRC16_POLYNOMIAL = 0xA001; ///< Generator polynomial of CRC16/MODBUS (0x8005, reflected).
+    constexpr uint16_t CRC16_INITIAL_VALUE = 0xFFFF; ///< Initial value of CRC16/MODBUS.
+    constexpr uint8_t MIN_FRAME_SIZE = 4; ///< Address, function and CRC.
+    constexpr uint8_t RESPONSE_HEADER_SIZE = 3; ///< Address, function and byte count of a read response.
+    constexpr uint8_t MAX_RESPONSE_SIZE = RESPONSE_HEADER_SIZE + 2 * NUMBER_OF_REGISTERS; ///< Without CRC.
+    constexpr uint8_t NUMBER_OF_MEASUREMENT_REGISTERS = ANSWERED_REQUESTS_REGISTER; ///< Updated by the loop.
+    constexpr uint8_t MUTED_FLAG = 0x01; ///< Flag set, if the system is muted.
+    constexpr uint8_t WARM_RESTART_FLAG = 0x02; ///< Flag set, if the system resumed from a warm restart.
+    constexpr long MAX_TREND_PPM_PER_HOUR = 0x7FFF; ///< Largest trend in the signed register.
+
+    uint16_t registers[NUMBER_OF_MEASUREMENT_REGISTERS]; ///< Register table, written by the loop, read by the ISRs.
+    uint8_t request[REQUEST_SIZE]; ///< First bytes of the frame being received.
+    uint16_t request_length = 0; ///< Bytes of the frame being received (only the first `REQUEST_SIZE` are stored).
+    uint16_t request_crc = CRC16_INITIAL_VALUE; ///< CRC of the received bytes, 0 after a valid CRC.
+    bool is_request_faulty = false; ///< True, if a byte of the frame had an error or came too late.
+    uint8_t response[MAX_RESPONSE_SIZE]; ///< Response being sent, without CRC.
+    uint8_t response_size = 0; ///< Size of the response without CRC.
+    uint8_t response_position = 0; ///< Position of the next byte to send, the CRC follows the response.
+    uint16_t response_crc = CRC16_INITIAL_VALUE; ///< CRC of the bytes sent so far.
+    volatile bool is_transmitting = false; ///< True, while the slave drives the bus.
+    uint16_t number_of_answered_requests = 0; ///< Requests answered since start-up (wrapping).
+    uint16_t number_of_dropped_frames = 0; ///< Frames dropped for a wrong CRC or a faulty byte (wrapping).
+
+#if defined(ENABLE_MODBUS) && defined(UDR1)
+    constexpr unsigned long TIMER_PRESCALER = 64UL; ///< Timer4 clock divider (250 kHz at 16 MHz).
+    constexpr uint16_t FRAME_SILENCE_TICKS = F_CPU / TIMER_PRESCALER * FRAME_SILENCE_US / 1000000UL;
+    ///< Timer4 ticks of t3.5.
+    constexpr unsigned long TIMER_TICK_US = TIMER_PRESCALER * 1000000UL / F_CPU; ///< Timer4 tick (4 µs at 16 MHz).
+    constexpr uint8_t TIMER_RUNNING = _BV(WGM42) | _BV(CS41) | _BV(CS40); ///< CTC mode with OCR4A, prescaler 64.
+    constexpr uint8_t RECEIVE_ERRORS = _BV(FE1) | _BV(DOR1) | _BV(UPE1); ///< Framing, overrun and parity error.
+
+    /**
+     * @brief   USART1 receive complete: one byte of a frame. Restarts the silence timer.
+     * @details Timer4 is not used otherwise (its PWM pins 6 to 8 are used as digital pins). The USART1 vectors are
+     *          free, as long as the firmware does not use `Serial1`.
+     */
+    ISR(USART1_RX_vect) {
+        const uint8_t status = UCSR1A; // the error flags are valid until UDR1 is read
+        const uint8_t character = UDR1;
+        if (TIFR4 & _BV(OCF4A)) {
+            TIFR4 = _BV(OCF4A); // the silence ended the previous frame just before this byte
+            on_frame_silence();
+        }
+        const unsigned long interval_us = TCNT4 * TIMER_TICK_US; ///< Only used inside a frame (timer running).
+        TCNT4 = 0;
+        TCCR4B = TIMER_RUNNING;
+        on_byte_received(character, (status & RECEIVE_ERRORS) != 0, interval_us);
+    }
+
+    /**
+     * @brief   Timer4 compare match: silence of t3.5 after the last byte, the frame is complete.
+     */
+    ISR(TIMER4_COMPA_vect) {
+        TCCR4B = 0;
+        on_frame_silence();
+    }
+
+    /**
+     * @brief   USART1 data register empty: sends the next byte of the response.
+     */
+    ISR(USART1_UDRE_vect) {
+        const int16_t character = get_next_byte_to_send();
+        if (character < 0) {
+            UCSR1B = static_cast<uint8_t>((UCSR1B & ~_BV(UDRIE1)) | _BV(TXCIE1));
+            return;
+        }
+        UDR1 = static_cast<uint8_t>(character);
+    }
+
+    /**
+     * @brief   USART1 transmit complete: the last stop bit of the response has been sent.
+     */
+    ISR(USART1_TX_vect) {
+        UCSR1B &= static_cast<uint8_t>(~_BV(TXCIE1));
+        on_transmission_complete();
+    }
+
+    void configure_hardware() {
+        static_assert(FRAME_SILENCE_TICKS > CHARACTER_SILENCE_US / TIMER_TICK_US, "t3.5 is not resolved by Timer4.");
+        static_assert(FRAME_SILENCE_US > MAX_CHARACTER_INTERVAL_US, "The silence timer ends a frame with a valid gap.");
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            TCCR4A = 0;
+            TCCR4B = 0;
+            OCR4A = FRAME_SILENCE_TICKS;
+            TIFR4 = _BV(OCF4A);
+            TIMSK4 = _BV(OCIE4A);
+            UCSR1A = _BV(U2X1); // double speed, as the Arduino core: smaller baud rate error at 57600 and 115200
+            UBRR1 = static_cast<uint16_t>((F_CPU / 4UL / BAUD_RATE - 1UL) / 2UL);
+            UCSR1C = _BV(UPM11) | _BV(UCSZ11) | _BV(UCSZ10); // 8 data bits, even parity, 1 stop bit
+            UCSR1B = _BV(RXCIE1) | _BV(RXEN1) | _BV(TXEN1);
+        }
+    }
+
+    void start_transmitter() {
+        UCSR1A |= _BV(TXC1); // clears a transmit complete flag of the last response
+        UCSR1B |= _BV(UDRIE1);
+    }
+#else
+    void configure_hardware() {
+    }
+
+    void start_transmitter() {
+    }
+#endif
+
+    void initialize() {
+        if (!IS_MODBUS_ENABLED) {
+            return;
+        }
+        set_measurement_not_valid();
+        DriverEnablePin::set_output();
+        DriverEnablePin::write(false);
+        configure_hardware();
+    }
+
+    void set_measurement(const int co2_measurement_ppm, const uint8_t air_quality_level_index) {
+        if (IS_MODBUS_ENABLED) {
+            write_registers(static_cast<uint16_t>(co2_measurement_ppm), air_quality_level_index);
+        }
+    }
+
+    void set_measurement_not_valid() {
+        if (IS_MODBUS_ENABLED) {
+            write_registers(NO_VALUE, NO_VALUE);
+        }
+    }
+
+    void write_registers(const uint16_t co2_register, const uint16_t air_quality_level_register) {
+        const AirQualityMeter::State state = StateAccess::read(); ///< Consistent copy of the system state.
+        const unsigned long uptime_s = SystemTime::get_uptime_seconds();
+        long trend_ppm_per_hour = MeasurementStatistics::get_trend_ppm_per_hour();
+        if (trend_ppm_per_hour > MAX_TREND_PPM_PER_HOUR) {
+            trend_ppm_per_hour = MAX_TREND_PPM_PER_HOUR;
+        } else if (trend_ppm_per_hour < -MAX_TREND_PPM_PER_HOUR) {
+            trend_ppm_per_hour = -MAX_TREND_PPM_PER_HOUR;
+        }
+        uint16_t values[NUMBER_OF_MEASUREMENT_REGISTERS]; ///< New register table, copied with interrupts disabled.
+        values[CO2_PPM_REGISTER] = co2_register;
+        values[AIR_QUALITY_LEVEL_REGISTER] = air_quality_level_register;
+        values[WARNING_COUNTER_REGISTER] = static_cast<uint16_t>(state.warning_counter);
+        values[FLAGS_REGISTER] = static_cast<uint16_t>((state.is_system_muted ? MUTED_FLAG : 0) |
+                                                       (WarmRestart::is_warm_restart() ? WARM_RESTART_FLAG : 0));
+        // `MeasurementStatistics::NO_VALUE` (-1) is sent as 0xFFFF (`NO_VALUE`).
+        values[AVERAGE_PPM_REGISTER] = static_cast<uint16_t>(MeasurementStatistics::get_average_ppm());
+        values[MINIMUM_PPM_REGISTER] = static_cast<uint16_t>(MeasurementStatistics::get_minimum_ppm());
+        values[MAXIMUM_PPM_REGISTER] = static_cast<uint16_t>(MeasurementStatistics::get_maximum_ppm());
+        values[TREND_REGISTER] = MeasurementStatistics::is_trend_available()
+                                     ? static_cast<uint16_t>(trend_ppm_per_hour)
+                                     : NO_TREND;
+        values[UPTIME_HIGH_REGISTER] = static_cast<uint16_t>(uptime_s >> 16);
+        values[UPTIME_LOW_REGISTER] = static_cast<uint16_t>(uptime_s);
+        values[INVALID_READINGS_REGISTER] = saturate_uint16(Co2SensorController::get_invalid_measurement_count());
+        values[REJECTED_READINGS_REGISTER] = saturate_uint16(MeasurementFilter::get_rejected_measurement_count());
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            for (uint8_t i = 0; i < NUMBER_OF_MEASUREMENT_REGISTERS; i++) {
+                registers[i] = values[i];
+            }
+        }
+    }
+
+    void on_byte_received(const uint8_t character, const bool has_receive_error, const unsigned long interval_us) {
+        if (is_transmitting) {
+            return; // half duplex: the transceiver does not receive while it drives the bus
+        }
+        const bool is_faulty = has_receive_error || (request_length > 0 && is_gap_too_long(interval_us));
+        if (request_length < REQUEST_SIZE) {
+            request[request_length] = character;
+        }
+        if (request_length < UINT16_MAX) {
+            request_length++;
+        }
+        request_crc = update_crc(request_crc, character);
+        is_request_faulty = is_request_faulty || is_faulty;
+    }
+
+    bool is_gap_too_long(const unsigned long interval_us) {
+        return interval_us > MAX_CHARACTER_INTERVAL_US;
+    }
+
+    void on_frame_silence() {
+        if (build_response()) {
+            response_position = 0;
+            response_crc = CRC16_INITIAL_VALUE;
+            is_transmitting = true;
+            DriverEnablePin::write(true);
+            start_transmitter();
+        }
+        request_length = 0;
+        request_crc = CRC16_INITIAL_VALUE;
+        is_request_faulty = false;
+    }
+
+    int16_t get_next_byte_to_send() {
+        if (response_position < response_size) {
+            const uint8_t character = response[response_position++];
+            response_crc = update_crc(response_crc, character);
+            return character;
+        }
+        if (response_position == response_size) {
+            response_position++;
+            return static_cast<uint8_t>(response_crc); // the CRC is sent low byte first
+        }
+        if (response_position == response_size + 1) {
+            response_position++;
+            return static_cast<uint8_t>(response_crc >> 8);
+        }
+        return -1;
+    }
+
+    void on_transmission_complete() {
+        DriverEnablePin::write(false);
+        is_transmitting = false;
+    }
+
+    bool build_response() {
+        if (request_length == 0) {
+            return false;
+        }
+        if (is_request_faulty || request_length < MIN_FRAME_SIZE || request_crc != 0) {
+            number_of_dropped_frames++;
+            return false;
+        }
+        if (request[0] != SLAVE_ADDRESS) {
+            return false; // a frame of another slave, or a broadcast (which is never answered)
+        }
+        number_of_answered_requests++;
+        const uint8_t function = request[1];
+        if (function != READ_HOLDING_REGISTERS && function != READ_INPUT_REGISTERS) {
+            return build_exception(function, ILLEGAL_FUNCTION);
+        }
+        if (request_length != REQUEST_SIZE) {
+            return build_exception(function, ILLEGAL_DATA_VALUE);
+        }
+        const uint16_t start_address = static_cast<uint16_t>(request[2] << 8 | request[3]);
+        const uint16_t quantity = static_cast<uint16_t>(request[4] << 8 | request[5]);
+        if (quantity == 0 || quantity > MAX_QUANTITY) {
+            return build_exception(function, ILLEGAL_DATA_VALUE);
+        }
+        if (start_address >= NUMBER_OF_REGISTERS || quantity > NUMBER_OF_REGISTERS - start_address) {
+            return build_exception(function, ILLEGAL_DATA_ADDRESS);
+        }
+        response[0] = SLAVE_ADDRESS;
+        response[1] = function;
+        response[2] = static_cast<uint8_t>(2 * quantity);
+        response_size = RESPONSE_HEADER_SIZE;
+        for (uint8_t address = static_cast<uint8_t>(start_address); address < start_address + quantity; address++) {
+            const uint16_t value = read_register(address);
+            response[response_size++] = static_cast<uint8_t>(value >> 8); // registers are sent high byte first
+            response[response_size++] = static_cast<uint8_t>(value);
+        }
+        return true;
+    }
+
+    bool build_exception(const uint8_t function, const uint8_t exception_code) {
+        response[0] = SLAVE_ADDRESS;
+        response[1] = static_cast<uint8_t>(function | EXCEPTION_FLAG);
+        response[2] = exception_code;
+        response_size = RESPONSE_HEADER_SIZE;
+        return true;
+    }
+
+    uint16_t read_register(const uint8_t address) {
+        if (address == ANSWERED_REQUESTS_REGISTER) {
+            return number_of_answered_requests;
+        }
+        if (address == DROPPED_FRAMES_REGISTER) {
+            return number_of_dropped_frames;
+        }
+        return registers[address];
+    }
+
+    uint16_t update_crc(uint16_t crc, const uint8_t character) {
+        crc ^= character;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = crc & 1U ? static_cast<uint16_t>(crc >> 1) ^ CRC16_POLYNOMIAL : crc >> 1;
+        }
+        return crc;
+    }
+
+    uint16_t saturate_uint16(const unsigned long value) {
+        return value > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(value);
+    }
+}
@@ -0,0 +1,171 @@
+/**
+ * @file modbus_slave.h
+ * @brief Header file for the Modbus RTU slave interface, polled by building-management systems.
+ * @details The slave uses the USART1 of the Mega 2560 (pin 18 TX1, pin 19 RX1) with an RS-485 transceiver, whose
+ *          driver enable (DE and /RE tied together) is `DriverEnablePin` of the board profile. The character format is
+ *          the Modbus default (8 data bits, even parity, 1 stop bit), the baud rate and the slave address are set with
+ *          the build flags `MODBUS_BAUD_RATE` (default 19200) and `MODBUS_ADDRESS` (default 1). The slave is only
+ *          started, if the firmware is built with `-DENABLE_MODBUS`.
+ *
+ *          The whole protocol runs in interrupt service routines, so a request is answered t3.5 after its end (2 ms at
+ *          19200 baud) plus a few µs, whatever the loop is doing (e.g. waiting up to 1 s for the PWM pulse):
+ *           - Receive interrupt: stores the byte and updates the CRC. A byte with a parity, framing or overrun error,
+ *             or after a silence longer than t1.5 inside a frame, marks the frame as faulty. Timer4 is restarted with
+ *             each byte, so it measures the time from the end of one byte to the end of the next: the silence plus
+ *             the character time.
+ *           - Timer4 compare match, after a silence of t3.5: ends the frame. Faulty frames and frames with a wrong CRC
+ *             are dropped (and counted), frames to other slaves and broadcasts are ignored. A read request is answered
+ *             from the register table, any other request with an exception response.
+ *           - Data register empty interrupt: sends the next byte of the response, the CRC is computed byte by byte.
+ *           - Transmit complete interrupt: releases the bus (driver enable low).
+ *
+ *          The loop only updates the register table once per measurement (`set_measurement`), a copy of 12 words with
+ *          interrupts disabled.
+ *
+ *          Registers (read with function 0x03 "read holding registers" or 0x04 "read input registers", same table):
+ *          | Address | Value                                                            |
+ *          |:--------|:-----------------------------------------------------------------|
+ *          | 0       | CO2 value in ppm (0xFFFF if not valid)                           |
+ *          | 1       | Air quality level index (0xFFFF if not valid)                    |
+ *          | 2       | Warning counter                                                  |
+ *          | 3       | Flags (bit 0: muted, bit 1: warm restart)                        |
+ *          | 4       | Average CO2 value of the last hour in ppm (0xFFFF if none)       |
+ *          | 5       | Minimum CO2 value of the last hour in ppm (0xFFFF if none)       |
+ *          | 6       | Maximum CO2 value of the last hour in ppm (0xFFFF if none)       |
+ *          | 7       | Trend in ppm per hour (signed, 0x8000 if not available)          |
+ *          | 8       | Uptime in s, high word                                           |
+ *          | 9       | Uptime in s, low word                                            |
+ *          | 10      | Invalid sensor readings (saturating)                             |
+ *          | 11      | Readings rejected as outliers (saturating)                       |
+ *          | 12      | Requests answered, including exception responses (wrapping)      |
+ *          | 13      | Frames dropped for a wrong CRC or a faulty byte (wrapping)       |
+ *
+ *          Registers 0 to 11 are updated with each measurement, 12 and 13 are read when the request is answered.
+ *          Exception codes: 0x01 (function not supported), 0x02 (range outside the table), 0x03 (quantity not in 1 to
+ *          125, or wrong length of the request).
+ *
+ *          The host has no USART: the host tool (tools/modbus_master) plays the UART and the timer, it calls the
+ *          interrupt handlers below at the times of the bus.
+ */
+
+#ifndef MODBUS_SLAVE_H
+#define MODBUS_SLAVE_H
+
+#include <Arduino.h>
+
+#ifndef MODBUS_ADDRESS
+#define MODBUS_ADDRESS 1
+#endif
+
+#ifndef MODBUS_BAUD_RATE
+#define MODBUS_BAUD_RATE 19200UL
+#endif
+
+namespace ModbusSlave {
+    constexpr uint8_t SLAVE_ADDRESS = MODBUS_ADDRESS; ///< Address of the slave on the bus (1 to 247).
+    constexpr unsigned long BAUD_RATE = MODBUS_BAUD_RATE; ///< Baud rate of the bus.
+    constexpr uint8_t BITS_PER_CHARACTER = 11; ///< Start bit, 8 data bits, parity bit and stop bit.
+    constexpr unsigned long FRAME_SILENCE_US = BAUD_RATE > 19200UL
+                                                   ? 1750UL
+                                                   : 35UL * BITS_PER_CHARACTER * 100000UL / BAUD_RATE;
+    ///< Silence, that ends a frame (t3.5, fixed above 19200 baud).
+    constexpr unsigned long CHARACTER_SILENCE_US = BAUD_RATE > 19200UL
+                                                       ? 750UL
+                                                       : 15UL * BITS_PER_CHARACTER * 100000UL / BAUD_RATE;
+    ///< Longest silence inside a frame (t1.5, fixed above 19200 baud).
+    constexpr unsigned long CHARACTER_TIME_US = (BITS_PER_CHARACTER * 1000000UL + BAUD_RATE - 1UL) / BAUD_RATE;
+    ///< Time of one byte on the bus (rounded up).
+    constexpr unsigned long MAX_CHARACTER_INTERVAL_US = CHARACTER_TIME_US + CHARACTER_SILENCE_US;
+    ///< Longest time from the end of one byte of a frame to the end of the next (character time and t1.5).
+    static_assert(SLAVE_ADDRESS >= 1 && SLAVE_ADDRESS <= 247, "MODBUS_ADDRESS must be a unicast address (1 to 247).");
+
+    /**
+     * @brief   Addresses of the registers.
+     */
+    enum Register : uint8_t {
+        CO2_PPM_REGISTER,
+        AIR_QUALITY_LEVEL_REGISTER,
+        WARNING_COUNTER_REGISTER,
+        FLAGS_REGISTER,
+        AVERAGE_PPM_REGISTER,
+        MINIMUM_PPM_REGISTER,
+        MAXIMUM_PPM_REGISTER,
+        TREND_REGISTER,
+        UPTIME_HIGH_REGISTER,
+        UPTIME_LOW_REGISTER,
+        INVALID_READINGS_REGISTER,
+        REJECTED_READINGS_REGISTER,
+        ANSWERED_REQUESTS_REGISTER,
+        DROPPED_FRAMES_REGISTER,
+        NUMBER_OF_REGISTERS
+    };
+
+    /**
+     * @brief   Function and exception codes.
+     */
+    enum Code : uint8_t {
+        READ_HOLDING_REGISTERS = 0x03,
+        READ_INPUT_REGISTERS = 0x04,
+        EXCEPTION_FLAG = 0x80, ///< Added to the function code in an exception response.
+        ILLEGAL_FUNCTION = 0x01,
+        ILLEGAL_DATA_ADDRESS = 0x02,
+        ILLEGAL_DATA_VALUE = 0x03
+    };
+
+    constexpr uint16_t NO_VALUE = 0xFFFF; ///< Register value, if there is no valid measurement or statistic.
+    constexpr uint16_t NO_TREND = 0x8000; ///< Trend register value, if the trend is not available.
+    constexpr uint16_t MAX_QUANTITY = 125; ///< Most registers of a read request (Modbus specification).
+    constexpr uint8_t REQUEST_SIZE = 8; ///< Size of a read request: address, function, start, quantity and CRC.
+
+    /**
+     * @brief   Configures the USART, Timer4 and the driver enable pin, if the Modbus slave is enabled.
+     */
+    void initialize();
+
+    /**
+     * @brief   Updates the register table with the current measurement, the system state and the statistics.
+     * @param   co2_measurement_ppm The current (filtered) CO2 value in ppm.
+     * @param   air_quality_level_index The index of the air quality level of the value.
+     */
+    void set_measurement(int co2_measurement_ppm, uint8_t air_quality_level_index);
+
+    /**
+     * @brief   Updates the register table after a reading, that was not valid.
+     */
+    void set_measurement_not_valid();
+
+    /**
+     * @brief   Handles a received byte (receive interrupt).
+     * @param   character The received byte.
+     * @param   has_receive_error True, if the byte had a parity, framing or overrun error.
+     * @param   interval_us Time from the end of the previous byte to the end of this one (ignored for the first byte
+     *          of a frame).
+     */
+    void on_byte_received(uint8_t character, bool has_receive_error, unsigned long interval_us);
+
+    /**
+     * @brief   Checks the time between two bytes of a frame.
+     * @param   interval_us Time from the end of the previous byte to the end of this one.
+     * @return  True, if the silence between the bytes was longer than t1.5.
+     */
+    bool is_gap_too_long(unsigned long interval_us);
+
+    /**
+     * @brief   Ends the frame after a silence of t3.5 (timer interrupt), and starts the response, if any.
+     */
+    void on_frame_silence();
+
+    /**
+     * @brief   Returns the next byte of the response (data register empty interrupt).
+     * @return  The byte, or -1 if the response has been sent completely.
+     */
+    int16_t get_next_byte_to_send();
+
+    /**
+     * @brief   Releases the bus after the last byte of the response has left the shift register (transmit complete
+     *          interrupt).
+     */
+    void on_transmission_complete();
+}
+
+#endif //MODBUS_SLAVE_H
@@ -7,37 +7,43 @@
 #include <mute_button.h>
 #include <button_debouncer.h>
 #include <ArduinoLog.h>
-#include <state.h>
+#include <state_access.h>
 #include <pin_configuration.h>
 #include <mute_indicator.h>
 
 #include "../log_controller/log_controller.h"
 
 namespace MuteButton {
+    volatile bool is_press_pending = false; ///< True, if the interrupt accepted a press that is not handled yet.
+
     void initialize() {
-        pinMode(DIGITAL_PIN, INPUT);
-        attachInterrupt(
-            digitalPinToInterrupt(DIGITAL_PIN),
-            toggle_mute_state, RISING);
+        ButtonPin::set_input();
+        ButtonPin::attach_interrupt(toggle_mute_state, RISING);
     }
 
     void toggle_mute_state() {
-        Log.infoln(LogController::MUTE_BUTTON_PRESSED);
-        static unsigned long last_interrupt_time_ms = 0UL;
-        ///< Timestamp of last interrupt initialized with static to persist until next function call.
-        TRACE_LN_u(last_interrupt_time_ms);
-        if (!ButtonDebouncer::is_button_debounced(last_interrupt_time_ms)) {
-            Log.verboseln(LogController::MUTE_BUTTON_DEBOUNCED);
+        const uint16_t start_cycles = StateAccess::read_cycle_counter(); ///< Cycle counter at the start of the ISR.
+        static SystemTime::TimePoint last_interrupt_time;
+        ///< Time point of last interrupt initialized with static to persist until next function call.
+        if (ButtonDebouncer::is_button_debounced(last_interrupt_time)) {
+            StateAccess::write([](AirQualityMeter::State &state) {
+                state.is_system_muted = !state.is_system_muted;
+            });
+            is_press_pending = true;
+        }
+        StateAccess::record_critical_section(static_cast<uint16_t>(StateAccess::read_cycle_counter() - start_cycles));
+    }
+
+    void handle_press() {
+        if (!is_press_pending) {
             return;
         }
+        is_press_pending = false; // cleared before reading the state, a press in between is handled next time
+        Log.infoln(LogController::MUTE_BUTTON_PRESSED);
 
-        noInterrupts(); // Temporarily disable interrupts while updating system state
-        AirQualityMeter::state.is_system_muted = !AirQualityMeter::state.is_system_muted;
-        MuteIndicator::indicate_system_mute(AirQualityMeter::state.is_system_muted);
-        interrupts(); // Re-enable interrupts
+        MuteIndicator::indicate_system_mute(StateAccess::read().is_system_muted);
 
         Log.verboseln(LogController::STATE_UPDATED);
         LogController::log_current_state();
-
     }
 }
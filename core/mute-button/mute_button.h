@@ -16,10 +16,17 @@ namespace MuteButton {
 
     /**
      * @brief    Toggles the mute state of the system.
-     * @details  This function switches the system's mute state
-     *           between muted and unmuted when called.
+     * @details  Interrupt service routine of the mute button. Switches the system's mute state between muted and
+     *           unmuted and marks the press as pending. It does not log and does not drive outputs, the mute
+     *           indicator is updated by `handle_press` from the loop.
      */
     void toggle_mute_state();
+
+    /**
+     * @brief    Handles a press accepted by the interrupt service routine (mute indicator and logging).
+     * @details  Called from the loop. Does nothing, if no press is pending.
+     */
+    void handle_press();
 }
 
 #endif //MUTE_BUTTON_H
@@ -10,16 +10,17 @@
 #include <Arduino.h>
 #include <mute_indicator.h>
 #include <pin_configuration.h>
+#include <led_array.h>
 #include <ArduinoLog.h>
 #include <log_controller.h>
 
 namespace MuteIndicator {
     void initialize() {
-        pinMode(BLUE_PIN, OUTPUT);
+        BluePin::set_output();
     }
 
     void indicate_system_mute(const bool is_mute) {
-        digitalWrite(BLUE_PIN, is_mute);
+        LedArray::set_brightness(LedPattern::MUTE_LED, is_mute ? LedPattern::MAX_BRIGHTNESS : 0);
         Log.verboseln(LogController::MUTE_INDICATOR_UPDATED);
     }
 }
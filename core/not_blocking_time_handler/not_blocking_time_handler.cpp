@@ -4,17 +4,80 @@
  *
  * This file contains the definition of the `wait_ms` function, 
  * which enables a non-blocking delay mechanism, allowing other tasks 
- * (like handling interrupts) to execute during the waiting period.
+ * (like handling interrupts and the registered background tasks) to execute during the waiting period.
+ * While waiting, the MCU is put into idle sleep and the time spent
+ * sleeping is accounted for duty-cycle statistics.
  */
 
 #include <Arduino.h>
+#include <avr/sleep.h>
 #include "not_blocking_time_handler.h"
+#include <system_time.h>
 
 namespace NotBlockingTimeHandler {
+    constexpr unsigned long MICROS_PER_MILLI = 1000UL; ///< Number of microseconds per millisecond.
+
+    unsigned long sleep_time_ms = 0UL; ///< Accumulated time (in ms) the MCU spent in idle sleep.
+    unsigned long sleep_time_remainder_us = 0UL;
+    ///< Accumulated sleeping time (in µs) that does not yet add up to a full millisecond.
+    BackgroundTask background_tasks[MAX_NUMBER_OF_BACKGROUND_TASKS] = {}; ///< Tasks run while waiting.
+    unsigned char number_of_background_tasks = 0; ///< Number of registered background tasks.
+    WaitFunction replaced_wait = nullptr; ///< Replacement of the waiting loop, `nullptr` if not replaced.
+
+    /**
+     * @brief   Puts the MCU into idle sleep until the next interrupt occurs.
+     * @details In idle mode, the CPU clock is halted while timers, the UART and the external interrupts keep running.
+     *          The MCU is therefore woken at the latest by the next Timer0 overflow (every ~1 ms, used by millis()),
+     *          or earlier by a button interrupt or by incoming serial data. The time spent sleeping is added to the
+     *          duty-cycle counters.
+     */
+    void sleep_until_next_interrupt();
+
     void wait_ms(const unsigned long waiting_time_ms) {
-        const unsigned long start_time_ms = millis();
-        const unsigned long end_time_ms = start_time_ms + waiting_time_ms;
-        while (millis() < end_time_ms) {
+        if (replaced_wait != nullptr) {
+            replaced_wait(waiting_time_ms);
+            return;
+        }
+        const SystemTime::TimePoint start_time = SystemTime::now();
+        const SystemTime::Duration waiting_time = SystemTime::milliseconds(waiting_time_ms);
+        while (!SystemTime::has_elapsed(start_time, waiting_time)) {
+            run_background_tasks();
+            sleep_until_next_interrupt();
+        }
+    }
+
+    bool register_background_task(const BackgroundTask task) {
+        if (number_of_background_tasks >= MAX_NUMBER_OF_BACKGROUND_TASKS) {
+            return false;
+        }
+        background_tasks[number_of_background_tasks++] = task;
+        return true;
+    }
+
+    void run_background_tasks() {
+        for (unsigned char i = 0; i < number_of_background_tasks; i++) {
+            background_tasks[i]();
         }
     }
+
+    void replace_wait(const WaitFunction wait_function) {
+        replaced_wait = wait_function;
+    }
+
+    unsigned long get_sleep_time_ms() {
+        return sleep_time_ms;
+    }
+
+    unsigned long get_active_time_ms() {
+        return millis() - sleep_time_ms;
+    }
+
+    void sleep_until_next_interrupt() {
+        const unsigned long sleep_start_us = micros();
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        sleep_mode(); // enables sleep, sleeps until the next interrupt, and disables sleep again
+        sleep_time_remainder_us += micros() - sleep_start_us;
+        sleep_time_ms += sleep_time_remainder_us / MICROS_PER_MILLI;
+        sleep_time_remainder_us %= MICROS_PER_MILLI;
+    }
 }
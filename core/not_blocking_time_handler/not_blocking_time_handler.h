@@ -10,15 +10,65 @@
 #define NOT_BLOCKING_TIME_HANDLER_H
 
 namespace NotBlockingTimeHandler {
+    using BackgroundTask = void (*)(); ///< Short function run repeatedly while waiting.
+    using WaitFunction = void (*)(unsigned long waiting_time_ms); ///< Replacement of the waiting loop.
+
+    constexpr unsigned char MAX_NUMBER_OF_BACKGROUND_TASKS = 6;
+    ///< Maximum number of registered background tasks (the firmware registers up to 4, 2 are spare).
+
     /**
      * @brief Waits for a specified time in milliseconds without blocking critical system tasks.
      *
      * This function pauses execution for the given duration in milliseconds by
-     * continuously monitoring elapsed time.
+     * continuously monitoring elapsed time. Between two checks the registered background
+     * tasks are run and the MCU enters idle sleep until it is woken by the next interrupt
+     * (timer, button or serial data). The elapsed time is calculated wrap-safe, so a wait across
+     * the millis() rollover (after 49.7 days) ends in time.
      *
      * @param waiting_time_ms The amount of time in milliseconds to wait.
      */
     void wait_ms(unsigned long waiting_time_ms);
+
+    /**
+     * @brief Registers a task to be run while waiting.
+     *
+     * The task is run about every millisecond during `wait_ms`, so it must return quickly
+     * (well below one millisecond) and must not call `wait_ms` itself.
+     *
+     * @param task The task to run.
+     * @return True if the task was registered, false if the maximum number of tasks is reached. The result must
+     *         be checked (the compiler warns otherwise), a task that is not registered never runs.
+     */
+    bool register_background_task(BackgroundTask task) __attribute__((warn_unused_result));
+
+    /**
+     * @brief Runs all registered background tasks once.
+     */
+    void run_background_tasks();
+
+    /**
+     * @brief Replaces the waiting loop of `wait_ms`, e.g. by a task delay of an RTOS.
+     *
+     * The background tasks are then not run by `wait_ms` anymore, the caller has to run them
+     * with `run_background_tasks`.
+     *
+     * @param wait_function Function waiting the given time, `nullptr` restores the waiting loop.
+     */
+    void replace_wait(WaitFunction wait_function);
+
+    /**
+     * @brief Returns the total time the MCU spent in idle sleep since start-up.
+     *
+     * @return Sleeping time in milliseconds.
+     */
+    unsigned long get_sleep_time_ms();
+
+    /**
+     * @brief Returns the total time the MCU was active (not sleeping) since start-up.
+     *
+     * @return Active time in milliseconds.
+     */
+    unsigned long get_active_time_ms();
 }
 
 #endif //NOT_BLOCKING_TIME_HANDLER_H
@@ -0,0 +1,42 @@
+/**
+ * @file page_button.cpp
+ * @brief Implementation for the page button functionality.
+ */
+
+#include <Arduino.h>
+#include <page_button.h>
+#include <button_debouncer.h>
+#include <ArduinoLog.h>
+#include <pin_configuration.h>
+#include <state_access.h>
+#include <display_pages.h>
+
+#include "../log_controller/log_controller.h"
+
+namespace PageButton {
+    volatile bool is_press_pending = false; ///< True, if the interrupt accepted a press that is not logged yet.
+
+    void initialize() {
+        ButtonPin::set_input();
+        ButtonPin::attach_interrupt(select_next_page, RISING);
+    }
+
+    void select_next_page() {
+        const uint16_t start_cycles = StateAccess::read_cycle_counter(); ///< Cycle counter at the start of the ISR.
+        static SystemTime::TimePoint last_interrupt_time;
+        ///< Time point of last interrupt initialized with static to persist until next function call.
+        if (ButtonDebouncer::is_button_debounced(last_interrupt_time)) {
+            DisplayPages::request_next_page();
+            is_press_pending = true;
+        }
+        StateAccess::record_critical_section(static_cast<uint16_t>(StateAccess::read_cycle_counter() - start_cycles));
+    }
+
+    void handle_press() {
+        if (!is_press_pending) {
+            return;
+        }
+        is_press_pending = false;
+        Log.infoln(LogController::PAGE_BUTTON_PRESSED);
+    }
+}
@@ -0,0 +1,31 @@
+/**
+ * @file    page_button.h
+ * @brief   Header file for the page button functionality.
+ */
+
+#ifndef PAGE_BUTTON_H
+#define PAGE_BUTTON_H
+
+namespace PageButton {
+    /**
+     * @brief    Initializes the page button functionality.
+     * @details  Sets up the required pin mode and interrupt to select the next display page when the button is
+     *           pressed. Does nothing on boards without a page button (the display pages rotate automatically).
+     */
+    void initialize();
+
+    /**
+     * @brief    Selects the next display page.
+     * @details  Interrupt service routine of the page button. Only debounces the button and requests the page change;
+     *           the page is formatted and rendered outside the interrupt, and the press is logged by `handle_press`.
+     */
+    void select_next_page();
+
+    /**
+     * @brief    Logs a press accepted by the interrupt service routine.
+     * @details  Called from the loop (the display task in the FreeRTOS variant). Does nothing, if no press is pending.
+     */
+    void handle_press();
+}
+
+#endif //PAGE_BUTTON_H
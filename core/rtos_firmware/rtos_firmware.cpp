@@ -0,0 +1,436 @@
+/**
+ * @file rtos_firmware.cpp
+ * @brief Implementation of the task-based variant of the firmware (FreeRTOS).
+ */
+
+#include <rtos_firmware.h>
+
+#ifdef ENABLE_FREERTOS
+
+#ifdef __AVR__
+#include <Arduino_FreeRTOS.h>
+#else
+#include <FreeRTOS.h>
+#include <task.h>
+#include <time.h>
+#endif
+#include <queue.h>
+#include <semphr.h>
+
+#include <ArduinoLog.h>
+#include <log_controller.h>
+#include <state_access.h>
+#include <pin_configuration.h>
+#include <not_blocking_time_handler.h>
+#include <button_debouncer.h>
+#include <co2_sensor_controller.h>
+#include <measurement_filter.h>
+#include <measurement_interpreter.h>
+#include <measurement_statistics.h>
+#include <ventilation_estimator.h>
+#include <history_log.h>
+#include <modbus_slave.h>
+#include <history_transfer.h>
+#include <display_pages.h>
+#include <led_array.h>
+#include <mute_indicator.h>
+#include <acknowledge_button.h>
+#include <page_button.h>
+#include <audio_controller.h>
+#include <warning_controller.h>
+#include <co2_level_time_tracker.h>
+#include <telemetry_controller.h>
+#include <warm_restart.h>
+#include <boot_timeline.h>
+
+namespace RtosFirmware {
+    /**
+     * @enum    EventType
+     * @brief   Types of the messages sent to the warning and the display task.
+     */
+    enum EventType : uint8_t {
+        MEASUREMENT_EVENT, ///< A new measurement.
+        ACKNOWLEDGE_EVENT, ///< The acknowledge button was pressed.
+        MUTE_EVENT ///< The mute button was pressed.
+    };
+
+    /**
+     * @struct  Event
+     * @brief   Message sent to the warning and the display task.
+     */
+    struct Event {
+        EventType type; ///< Type of the event.
+        int co2_measurement_ppm; ///< Filtered CO2 value in ppm (measurement events only).
+        uint32_t time_stamp_us; ///< Time of the sensor reading (latency clock, measurement events only).
+    };
+
+    /**
+     * @struct  LogRecord
+     * @brief   Message sent to the log task after the warning task processed a measurement.
+     */
+    struct LogRecord {
+        Event measurement; ///< The processed measurement.
+        AirQualityMeter::State state; ///< Copy of the system state after the measurement was processed.
+        bool is_audio_warning_issued; ///< True, if an audio warning was issued for this measurement.
+    };
+
+    constexpr UBaseType_t WARNING_TASK_PRIORITY = tskIDLE_PRIORITY + 3; ///< Priority of the warning task.
+    constexpr UBaseType_t DISPLAY_TASK_PRIORITY = tskIDLE_PRIORITY + 2; ///< Priority of the display task.
+    constexpr UBaseType_t SENSOR_TASK_PRIORITY = tskIDLE_PRIORITY + 1; ///< Priority of the sensor task (busy wait).
+    constexpr UBaseType_t LOG_TASK_PRIORITY = tskIDLE_PRIORITY + 1; ///< Priority of the log task.
+#ifdef __AVR__
+    constexpr uint16_t WARNING_TASK_STACK_SIZE = 256; ///< Stack of the warning task (bytes).
+    constexpr uint16_t SENSOR_TASK_STACK_SIZE = 320; ///< Stack of the sensor task (bytes).
+    constexpr uint16_t DISPLAY_TASK_STACK_SIZE = 320; ///< Stack of the display task (bytes).
+    constexpr uint16_t LOG_TASK_STACK_SIZE = 384; ///< Stack of the log task (bytes, formats the log lines).
+#else
+    // The POSIX port runs each task in a thread, which needs at least the minimal stack of the port.
+    constexpr uint16_t WARNING_TASK_STACK_SIZE = configMINIMAL_STACK_SIZE; ///< Stack of the warning task (words).
+    constexpr uint16_t SENSOR_TASK_STACK_SIZE = configMINIMAL_STACK_SIZE; ///< Stack of the sensor task (words).
+    constexpr uint16_t DISPLAY_TASK_STACK_SIZE = configMINIMAL_STACK_SIZE; ///< Stack of the display task (words).
+    constexpr uint16_t LOG_TASK_STACK_SIZE = configMINIMAL_STACK_SIZE; ///< Stack of the log task (words).
+#endif
+    constexpr UBaseType_t EVENT_QUEUE_LENGTH = 4; ///< Length of the queues of the warning and the display task.
+    constexpr UBaseType_t LOG_QUEUE_LENGTH = 2; ///< Length of the queue of the log task.
+    constexpr TickType_t BACKGROUND_TASK_PERIOD_TICKS = 1;
+    ///< Longest time the display task waits for a message before running the background tasks (rendering).
+    constexpr TickType_t HISTORY_POLL_PERIOD_TICKS = pdMS_TO_TICKS(100);
+    ///< Longest time the log task waits for a message before checking for a history download request.
+
+    QueueHandle_t warning_queue = nullptr; ///< Measurements and button events for the warning task.
+    QueueHandle_t display_queue = nullptr; ///< Measurements and acknowledge indications for the display task.
+    QueueHandle_t log_queue = nullptr; ///< Processed measurements for the log task.
+    SemaphoreHandle_t log_mutex = nullptr; ///< Keeps the log lines of the tasks apart.
+    TaskHandle_t task_handles[NUMBER_OF_CONSUMERS] = {}; ///< Handles of the consumer tasks.
+    Latency latencies[NUMBER_OF_CONSUMERS] = {}; ///< End-to-end latency of each consumer.
+    uint32_t number_of_measurements = 0; ///< Number of valid measurements sent by the sensor task.
+    uint32_t number_of_dropped_messages = 0; ///< Number of messages dropped, because a queue was full.
+
+    /**
+     * @brief   Returns the time of the latency clock in µs.
+     * @details On the host, the simulated time of the host HAL only advances with the RTOS tick, so the latency is
+     *          measured with the real time.
+     */
+    uint32_t read_latency_clock_us();
+
+    /**
+     * @brief   Adds the latency of a processed measurement to the statistics of a consumer.
+     */
+    void record_latency(Consumer consumer, uint32_t time_stamp_us);
+
+    /**
+     * @brief   Sends a message to a queue without waiting, counts the message if the queue is full.
+     */
+    void send(QueueHandle_t queue, const void *message);
+
+    /**
+     * @brief   Sends a button event to the warning task (from an interrupt service routine).
+     */
+    void send_from_interrupt(EventType type);
+
+    /**
+     * @brief   Waits with a task delay, replaces the waiting loop of `NotBlockingTimeHandler::wait_ms`.
+     */
+    void delay_task(unsigned long waiting_time_ms);
+
+    void lock_log_output();
+
+    void unlock_log_output();
+
+    /**
+     * @brief   Interrupt service routine of the acknowledge button.
+     */
+    void on_acknowledge_button();
+
+    /**
+     * @brief   Interrupt service routine of the mute button.
+     */
+    void on_mute_button();
+
+    /**
+     * @brief   Reads, filters and distributes the measurements.
+     */
+    void sensor_task(void *);
+
+    /**
+     * @brief   Decides on the audio warnings and handles the buttons, owns the system state.
+     */
+    void warning_task(void *);
+
+    /**
+     * @brief   Shows the measurements on the display pages and the LEDs, runs the background tasks.
+     */
+    void display_task(void *);
+
+    /**
+     * @brief   Logs the processed measurements, the latencies, sends the telemetry frames and serves history downloads.
+     */
+    void log_task(void *);
+
+    /**
+     * @brief   Processes a measurement in the warning task, as the second half of `loop()`.
+     * @return  True, if an audio warning was issued.
+     */
+    bool process_measurement(int co2_measurement_ppm);
+
+    void start() {
+        warning_queue = xQueueCreate(EVENT_QUEUE_LENGTH, sizeof(Event));
+        display_queue = xQueueCreate(EVENT_QUEUE_LENGTH, sizeof(Event));
+        log_queue = xQueueCreate(LOG_QUEUE_LENGTH, sizeof(LogRecord));
+        log_mutex = xSemaphoreCreateRecursiveMutex();
+        LogController::set_output_lock(lock_log_output, unlock_log_output);
+        NotBlockingTimeHandler::replace_wait(delay_task);
+
+        xTaskCreate(warning_task, "warning", WARNING_TASK_STACK_SIZE, nullptr, WARNING_TASK_PRIORITY,
+                    &task_handles[WARNING_CONSUMER]);
+        xTaskCreate(sensor_task, "sensor", SENSOR_TASK_STACK_SIZE, nullptr, SENSOR_TASK_PRIORITY, nullptr);
+        xTaskCreate(display_task, "display", DISPLAY_TASK_STACK_SIZE, nullptr, DISPLAY_TASK_PRIORITY,
+                    &task_handles[DISPLAY_CONSUMER]);
+        xTaskCreate(log_task, "log", LOG_TASK_STACK_SIZE, nullptr, LOG_TASK_PRIORITY, &task_handles[LOG_CONSUMER]);
+
+        // The buttons were connected to their own routines by the boot sequence, which change the state directly.
+        // The page button keeps its routine: it only requests the next page, its press is logged by the display task.
+        AcknowledgeButton::ButtonPin::attach_interrupt(on_acknowledge_button, RISING);
+        MuteButton::ButtonPin::attach_interrupt(on_mute_button, RISING);
+    }
+
+    Latency get_latency(const Consumer consumer) {
+        taskENTER_CRITICAL();
+        const Latency latency = latencies[consumer];
+        taskEXIT_CRITICAL();
+        return latency;
+    }
+
+    uint32_t get_number_of_measurements() {
+        taskENTER_CRITICAL();
+        const uint32_t measurements = number_of_measurements;
+        taskEXIT_CRITICAL();
+        return measurements;
+    }
+
+    uint32_t get_number_of_dropped_messages() {
+        taskENTER_CRITICAL();
+        const uint32_t dropped_messages = number_of_dropped_messages;
+        taskEXIT_CRITICAL();
+        return dropped_messages;
+    }
+
+    uint32_t read_latency_clock_us() {
+#ifdef __AVR__
+        return micros();
+#else
+        timespec now; ///< Current real time.
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint32_t>(now.tv_sec * 1000000LL + now.tv_nsec / 1000);
+#endif
+    }
+
+    void record_latency(const Consumer consumer, const uint32_t time_stamp_us) {
+        const uint32_t latency_us = read_latency_clock_us() - time_stamp_us;
+        taskENTER_CRITICAL();
+        Latency &latency = latencies[consumer];
+        if (latency_us > latency.max_latency_us) {
+            latency.max_latency_us = latency_us;
+        }
+        latency.total_latency_us += latency_us;
+        latency.number_of_measurements++;
+        taskEXIT_CRITICAL();
+    }
+
+    void send(const QueueHandle_t queue, const void *message) {
+        if (xQueueSend(queue, message, 0) != pdPASS) {
+            taskENTER_CRITICAL();
+            number_of_dropped_messages++;
+            taskEXIT_CRITICAL();
+        }
+    }
+
+    void send_from_interrupt(const EventType type) {
+        const Event event = {type, 0, 0};
+        // The warning task runs at the latest with the next tick, a button press needs no faster reaction.
+        if (xQueueSendFromISR(warning_queue, &event, nullptr) != pdPASS) {
+            number_of_dropped_messages++;
+        }
+    }
+
+    void delay_task(const unsigned long waiting_time_ms) {
+        vTaskDelay(pdMS_TO_TICKS(waiting_time_ms));
+    }
+
+    void lock_log_output() {
+        xSemaphoreTakeRecursive(log_mutex, portMAX_DELAY);
+    }
+
+    void unlock_log_output() {
+        xSemaphoreGiveRecursive(log_mutex);
+    }
+
+    void on_acknowledge_button() {
+        static SystemTime::TimePoint last_button_press_detected;
+        ///< Time point of last interrupt initialized with static to persist until next function call.
+        if (ButtonDebouncer::is_button_debounced(last_button_press_detected, true)) {
+            send_from_interrupt(ACKNOWLEDGE_EVENT);
+        }
+    }
+
+    void on_mute_button() {
+        static SystemTime::TimePoint last_interrupt_time;
+        ///< Time point of last interrupt initialized with static to persist until next function call.
+        if (ButtonDebouncer::is_button_debounced(last_interrupt_time)) {
+            send_from_interrupt(MUTE_EVENT);
+        }
+    }
+
+    void sensor_task(void *) {
+        for (;;) {
+            const int raw_co2_measurement_ppm = Co2SensorController::get_measurement_in_ppm(); // waits for the sensor
+            const uint32_t time_stamp_us = read_latency_clock_us(); ///< Time the reading was available.
+            if (raw_co2_measurement_ppm == Co2SensorController::MEASUREMENT_NOT_VALID_ERROR) {
+                MeasurementFilter::reset();
+                continue;
+            }
+            if (raw_co2_measurement_ppm == Co2SensorController::NO_NEW_MEASUREMENT) {
+                continue;
+            }
+            if (BootTimeline::mark_first_reading()) {
+                LogController::log_time_to_first_reading();
+            }
+            const Event event = {
+                MEASUREMENT_EVENT, MeasurementFilter::filter(raw_co2_measurement_ppm, millis()), time_stamp_us
+            };
+            taskENTER_CRITICAL();
+            number_of_measurements++;
+            taskEXIT_CRITICAL();
+            send(warning_queue, &event);
+            send(display_queue, &event);
+        }
+    }
+
+    void warning_task(void *) {
+        for (;;) {
+            Event event; ///< Next measurement or button event.
+            xQueueReceive(warning_queue, &event, portMAX_DELAY);
+            switch (event.type) {
+                case MEASUREMENT_EVENT: {
+                    const bool is_audio_warning_issued = process_measurement(event.co2_measurement_ppm);
+                    WarmRestart::save(event.co2_measurement_ppm);
+                    record_latency(WARNING_CONSUMER, event.time_stamp_us);
+                    const LogRecord record = {event, StateAccess::read(), is_audio_warning_issued};
+                    send(log_queue, &record);
+                    break;
+                }
+                case ACKNOWLEDGE_EVENT:
+                    Log.infoln(LogController::ACKNOWLEDGE_BUTTON_PRESSED);
+                    WarningController::reset();
+                    send(display_queue, &event); // the display task owns the LEDs
+                    break;
+                case MUTE_EVENT:
+                    Log.infoln(LogController::MUTE_BUTTON_PRESSED);
+                    StateAccess::write([](AirQualityMeter::State &state) {
+                        state.is_system_muted = !state.is_system_muted;
+                    });
+                    MuteIndicator::indicate_system_mute(StateAccess::read().is_system_muted);
+                    break;
+            }
+        }
+    }
+
+    bool process_measurement(const int co2_measurement_ppm) {
+        const AirQuality::Level air_quality_level = MeasurementInterpreter::get_air_quality_level(co2_measurement_ppm);
+        if (air_quality_level.is_acceptable) {
+            WarningController::reset();
+            return false;
+        }
+        const bool is_audio_warning_to_be_issued = WarningController::is_audio_warning_to_be_issued(
+            Co2LevelTimeTracker::get_time_since_co2_level_not_acceptable());
+        if (!is_audio_warning_to_be_issued || StateAccess::read().is_system_muted) {
+            return false;
+        }
+        AudioController::issue_warning();
+        Log.verboseln(LogController::AUDIO_WARNING_ISSUED);
+        WarningController::update_for_co2_level_not_acceptable();
+        return true;
+    }
+
+    void display_task(void *) {
+        for (;;) {
+            Event event; ///< Next measurement or acknowledge indication.
+            if (xQueueReceive(display_queue, &event, BACKGROUND_TASK_PERIOD_TICKS) == pdPASS) {
+                if (event.type == ACKNOWLEDGE_EVENT) {
+                    AcknowledgeButton::indicate_acknowledge();
+                } else {
+                    const AirQuality::Level air_quality_level =
+                            MeasurementInterpreter::get_air_quality_level(event.co2_measurement_ppm);
+                    MeasurementStatistics::add(event.co2_measurement_ppm, millis());
+                    VentilationEstimator::add(event.co2_measurement_ppm, millis());
+                    HistoryLog::add(event.co2_measurement_ppm, millis());
+                    DisplayPages::set_measurement(event.co2_measurement_ppm, air_quality_level.description);
+                    LedArray::output(air_quality_level.led_indicator);
+                    record_latency(DISPLAY_CONSUMER, event.time_stamp_us);
+                }
+            }
+            PageButton::handle_press();
+            NotBlockingTimeHandler::run_background_tasks();
+        }
+    }
+
+    void log_task(void *) {
+        for (;;) {
+            HistoryTransfer::poll(); // the log task owns the serial output, a download blocks only this task
+            LogRecord record; ///< Next processed measurement.
+            if (xQueueReceive(log_queue, &record, HISTORY_POLL_PERIOD_TICKS) != pdPASS) {
+                continue;
+            }
+            const int co2_measurement_ppm = record.measurement.co2_measurement_ppm;
+            const uint8_t air_quality_level_index =
+                    MeasurementInterpreter::get_air_quality_level_index(co2_measurement_ppm);
+            TelemetryController::set_measurement(co2_measurement_ppm, air_quality_level_index);
+            ModbusSlave::set_measurement(co2_measurement_ppm, air_quality_level_index);
+            TelemetryController::send_frame_if_due();
+            record_latency(LOG_CONSUMER, record.measurement.time_stamp_us);
+
+            Log.traceln("%s", LogController::DIVIDING_LINE_STATE);
+            TRACE_LN_d(co2_measurement_ppm);
+            TRACE_LN_u(record.state.last_co2_below_threshold_time_ms);
+            TRACE_LN_d(record.state.warning_counter);
+            TRACE_LN_T(record.state.is_system_muted);
+            TRACE_LN_T(record.is_audio_warning_issued);
+            Log.traceln("%s", LogController::TASK_LATENCIES);
+            for (uint8_t consumer = 0; consumer < NUMBER_OF_CONSUMERS; consumer++) {
+                const Latency latency = get_latency(static_cast<Consumer>(consumer));
+                const unsigned long stack_high_water_mark = uxTaskGetStackHighWaterMark(task_handles[consumer]);
+                ///< Stack (in words) the task never used.
+                Log.traceln("%s: %u us max, %u us average, %u words stack left", pcTaskGetName(task_handles[consumer]),
+                            static_cast<unsigned long>(latency.max_latency_us),
+                            static_cast<unsigned long>(latency.number_of_measurements == 0
+                                                           ? 0
+                                                           : latency.total_latency_us / latency.number_of_measurements),
+                            stack_high_water_mark);
+            }
+            const unsigned long dropped_messages = get_number_of_dropped_messages();
+            TRACE_LN_u(dropped_messages);
+            Log.traceln("%s", LogController::DIVIDING_LINE_STATE);
+        }
+    }
+}
+
+#else
+
+namespace RtosFirmware {
+    void start() {
+    }
+
+    Latency get_latency(Consumer) {
+        return Latency();
+    }
+
+    uint32_t get_number_of_measurements() {
+        return 0;
+    }
+
+    uint32_t get_number_of_dropped_messages() {
+        return 0;
+    }
+}
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file rtos_firmware.h
+ * @brief Header file for the task-based variant of the firmware (FreeRTOS).
+ * @details Built with `-DENABLE_FREERTOS` (environment `megaatmega2560_freertos`, Arduino_FreeRTOS), the work of
+ *          `loop()` is split into four tasks, which communicate through queues:
+ *
+ *          | Task    | Priority | Work                                                                          |
+ *          |:--------|:---------|:------------------------------------------------------------------------------|
+ *          | warning | 3        | Owns the system state: warning decision, audio warning, buttons, warm restart |
+ *          | display | 2        | Display pages, statistics, history, LEDs and the background tasks (rendering) |
+ *          | sensor  | 1        | Reads and filters the CO2 sensor, sends each measurement to the queues        |
+ *          | log     | 1        | State log, latencies, telemetry, Modbus registers and history downloads       |
+ *
+ *          The PWM reading of the sensor is a busy wait of about 2 s, so the sensor task has the lowest priority and
+ *          shares the CPU with the log task (time slicing); the other tasks preempt the reading as soon as a message
+ *          arrives.
+ *          The button interrupts only send an event to the warning task, which is the only task writing the system
+ *          state. The other tasks receive copies of it in the queue messages. For each measurement, the time from the
+ *          reading to its processing by each consumer task (end-to-end latency) is measured.
+ *
+ *          The same code builds against the FreeRTOS POSIX port with the host HAL (see tools/rtos_posix), so the
+ *          latencies and the priority behavior can be measured on Linux. The FreeRTOS scheduler is started after
+ *          `setup()`, by Arduino_FreeRTOS or by the host tool.
+ */
+
+#ifndef RTOS_FIRMWARE_H
+#define RTOS_FIRMWARE_H
+
+#include <Arduino.h>
+
+namespace RtosFirmware {
+    /**
+     * @enum    Consumer
+     * @brief   Tasks consuming the measurements.
+     */
+    enum Consumer : uint8_t {
+        DISPLAY_CONSUMER, ///< Display and LED task.
+        WARNING_CONSUMER, ///< Warning and audio task.
+        LOG_CONSUMER, ///< Logging task.
+        NUMBER_OF_CONSUMERS
+    };
+
+    /**
+     * @struct  Latency
+     * @brief   End-to-end latency of a consumer, from the sensor reading to the processed measurement.
+     */
+    struct Latency {
+        uint32_t max_latency_us; ///< Longest latency in µs.
+        uint32_t total_latency_us; ///< Sum of all latencies in µs (for the average).
+        uint32_t number_of_measurements; ///< Number of processed measurements.
+    };
+
+    /**
+     * @brief   Creates the queues and the tasks, and connects the buttons to the warning task.
+     * @details Has to be called at the end of `setup()`, after the boot sequence. Waits (`wait_ms`) are replaced by
+     *          task delays.
+     */
+    void start();
+
+    /**
+     * @brief   Returns the end-to-end latency of a consumer task.
+     */
+    Latency get_latency(Consumer consumer);
+
+    /**
+     * @brief   Returns the number of valid measurements sent by the sensor task.
+     */
+    uint32_t get_number_of_measurements();
+
+    /**
+     * @brief   Returns the number of messages dropped, because a queue was full.
+     */
+    uint32_t get_number_of_dropped_messages();
+}
+
+#endif //RTOS_FIRMWARE_H
@@ -0,0 +1,62 @@
+/**
+ * @file state_access.cpp
+ * @brief Implementation of the consistent access to the system state shared with the interrupt service routines.
+ */
+
+#include <state_access.h>
+
+namespace StateAccess {
+    volatile uint8_t sequence = 0;
+    volatile uint16_t max_critical_section_cycles = 0; ///< Longest interrupt-disabled window (cycles).
+    volatile unsigned long number_of_writes = 0UL; ///< Number of writes of the system state since start-up.
+
+    void initialize() {
+#ifdef TCNT5
+        // Timer5 is not used otherwise (its PWM pins 44 to 46 are not connected): normal mode, no prescaler.
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            TCCR5A = 0;
+            TCCR5B = _BV(CS50);
+            TCNT5 = 0;
+        }
+#endif
+    }
+
+    AirQualityMeter::State read() {
+        AirQualityMeter::State snapshot; ///< Copy of the state.
+        uint8_t sequence_before_copy; ///< Sequence counter before the copy.
+        do {
+            sequence_before_copy = sequence;
+            __asm__ __volatile__("" ::: "memory"); // copy the state after reading the sequence counter
+            snapshot = AirQualityMeter::state;
+            __asm__ __volatile__("" ::: "memory"); // and before reading it again
+        } while ((sequence_before_copy & 1U) != 0 || sequence != sequence_before_copy);
+        return snapshot;
+    }
+
+    void record_critical_section(const uint16_t cycles) {
+        // Called with disabled interrupts from `write` and from the button interrupt service routines.
+        if (cycles > max_critical_section_cycles) {
+            max_critical_section_cycles = cycles;
+        }
+    }
+
+    void count_write() {
+        number_of_writes++;
+    }
+
+    uint16_t get_max_critical_section_cycles() {
+        uint16_t cycles; ///< Copy of the 16-bit maximum, read with disabled interrupts.
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            cycles = max_critical_section_cycles;
+        }
+        return cycles;
+    }
+
+    unsigned long get_number_of_writes() {
+        unsigned long writes; ///< Copy of the 32-bit counter, read with disabled interrupts.
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            writes = number_of_writes;
+        }
+        return writes;
+    }
+}
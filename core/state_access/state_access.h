@@ -0,0 +1,93 @@
+/**
+ * @file state_access.h
+ * @brief Header file for the consistent access to the system state shared with the interrupt service routines.
+ * @details The system state is written by the button interrupts and by the loop. On the AVR, a 32-bit read takes
+ *          four instructions, so an interrupt between them leaves the reader with a torn value. All accesses to
+ *          `AirQualityMeter::state` therefore go through this module:
+ *           - `write` publishes a change with a sequence lock: the sequence counter is odd while the state is written.
+ *             Interrupts are only disabled for the stores of the change (a few cycles), never for logging or output.
+ *           - `read` returns a snapshot without disabling interrupts. The copy is repeated, if the sequence counter
+ *             changed while copying (an interrupt wrote the state in between).
+ *
+ *          Interrupt service routines can use both functions, they are not interrupted by the loop.
+ *          The length of each interrupt-disabled window is measured in CPU cycles with a free-running hardware timer
+ *          (Timer5 on the Mega 2560, `micros()` on other AVR boards), the maximum is logged with the state. The
+ *          windows are the stores of `write` and the bodies of the button interrupt service routines, which record
+ *          their own length with `record_critical_section` (without the entry and exit of the interrupt).
+ */
+
+#ifndef STATE_ACCESS_H
+#define STATE_ACCESS_H
+
+#include <Arduino.h>
+#include <util/atomic.h>
+#include <state.h>
+
+namespace StateAccess {
+    extern volatile uint8_t sequence; ///< Sequence counter of the state, odd while the state is written.
+
+    /**
+     * @brief   Starts the cycle counter measuring the interrupt-disabled windows.
+     */
+    void initialize();
+
+    /**
+     * @brief   Returns a consistent copy of the system state. Does not disable interrupts.
+     */
+    AirQualityMeter::State read();
+
+    /**
+     * @brief   Returns the current value of the cycle counter (wraps around after 65536 cycles).
+     */
+    inline uint16_t read_cycle_counter() {
+#ifdef TCNT5
+        return TCNT5; // Timer5 runs at the CPU clock (see `initialize`)
+#elif defined(__AVR__)
+        return static_cast<uint16_t>(micros() * clockCyclesPerMicrosecond());
+#else
+        return 0; // the host has no cycle counter
+#endif
+    }
+
+    /**
+     * @brief   Records the length of an interrupt-disabled window (a write or the body of a button interrupt).
+     *          Call with disabled interrupts.
+     * @param   cycles Number of CPU cycles the interrupts were disabled.
+     */
+    void record_critical_section(uint16_t cycles);
+
+    /**
+     * @brief   Counts a write of the system state. Called with disabled interrupts from `write`.
+     */
+    void count_write();
+
+    /**
+     * @brief   Returns the longest interrupt-disabled window since start-up, in CPU cycles.
+     */
+    uint16_t get_max_critical_section_cycles();
+
+    /**
+     * @brief   Returns the number of writes of the system state since start-up.
+     */
+    unsigned long get_number_of_writes();
+
+    /**
+     * @brief   Changes the system state atomically and publishes the change to the readers.
+     * @details Keep the change to plain stores: calculate the values (e.g. `millis()`) before the call and capture
+     *          them, so interrupts are disabled as short as possible.
+     * @param   change Function object called with the state, e.g. `[](AirQualityMeter::State &state) { ... }`.
+     */
+    template<typename Change>
+    void write(const Change &change) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            const uint16_t start_cycles = read_cycle_counter();
+            sequence++;
+            change(AirQualityMeter::state);
+            sequence++;
+            count_write();
+            record_critical_section(static_cast<uint16_t>(read_cycle_counter() - start_cycles));
+        }
+    }
+}
+
+#endif //STATE_ACCESS_H
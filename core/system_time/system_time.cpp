@@ -0,0 +1,99 @@
+/**
+ * @file system_time.cpp
+ * @brief Implementation of the 64-bit uptime.
+ */
+
+#include <system_time.h>
+#include <util/atomic.h>
+#include <not_blocking_time_handler.h>
+#include <ArduinoLog.h>
+#include <log_controller.h>
+
+namespace SystemTime {
+    constexpr unsigned long SECONDS_PER_ROLLOVER = 4294967UL; ///< Whole seconds in one `millis()` period (2^32 ms).
+    constexpr unsigned long MILLISECONDS_PER_ROLLOVER_REMAINDER = 296UL;
+    ///< Milliseconds of one `millis()` period (2^32 ms) in addition to the whole seconds.
+
+    volatile uint16_t rollover_count = 0; ///< Number of `millis()` rollovers since start-up.
+    volatile unsigned long last_millis = 0UL; ///< Value of `millis()` at the last check for a rollover.
+
+    /**
+     * @brief   Counts a rollover, if `millis()` is lower than at the last check. Has to be called with disabled
+     *          interrupts, at least once per 49.7 days.
+     * @param   current_millis Current value of `millis()`.
+     */
+    void count_rollover(unsigned long current_millis);
+
+    /**
+     * @brief   Reads `millis()` and the number of rollovers consistently.
+     * @details Restores the interrupt state afterwards, so it can be called with disabled interrupts.
+     */
+    void read_uptime(uint16_t &rollovers, unsigned long &current_millis);
+
+#ifdef TIMER0_COMPB_vect
+    /**
+     * @brief   Checks for a `millis()` rollover once per Timer0 period (about 1 ms).
+     * @details The Timer0 overflow interrupt is used by the Arduino core for `millis()`, the compare match B interrupt
+     *          of the same timer is free and fires once per period, independent of the value of OCR0B.
+     */
+    ISR(TIMER0_COMPB_vect) {
+        count_rollover(millis());
+    }
+
+    void initialize() {
+        TIMSK0 |= _BV(OCIE0B);
+    }
+#elif defined(__AVR__)
+    /**
+     * @brief   Checks for a `millis()` rollover while the system waits (background task).
+     * @details On the megaAVR 0-series (e.g. Nano Every), `millis()` runs on a TCB timer without a free interrupt.
+     *          The loop waits for the sensor every few seconds, far more often than once per 49.7 days.
+     */
+    void check_rollover() {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            count_rollover(millis());
+        }
+    }
+
+    void initialize() {
+        if (!NotBlockingTimeHandler::register_background_task(check_rollover)) {
+            Log.errorln("%s %s", LogController::BACKGROUND_TASK_NOT_REGISTERED, LogController::SYSTEM_TIME);
+        }
+    }
+#else
+    void initialize() {
+    }
+#endif
+
+    uint64_t get_uptime_ms() {
+        uint16_t rollovers; ///< Number of `millis()` rollovers since start-up.
+        unsigned long current_millis; ///< Current value of `millis()`.
+        read_uptime(rollovers, current_millis);
+        return static_cast<uint64_t>(rollovers) << 32 | current_millis;
+    }
+
+    unsigned long get_uptime_seconds() {
+        uint16_t rollovers; ///< Number of `millis()` rollovers since start-up.
+        unsigned long current_millis; ///< Current value of `millis()`.
+        read_uptime(rollovers, current_millis);
+        // (rollovers * 2^32 + current_millis) / 1000, split into 32-bit operations
+        return rollovers * SECONDS_PER_ROLLOVER + current_millis / MILLISECONDS_PER_SECOND +
+               (rollovers * MILLISECONDS_PER_ROLLOVER_REMAINDER + current_millis % MILLISECONDS_PER_SECOND) /
+               MILLISECONDS_PER_SECOND;
+    }
+
+    void count_rollover(const unsigned long current_millis) {
+        if (current_millis < last_millis) {
+            rollover_count++;
+        }
+        last_millis = current_millis;
+    }
+
+    void read_uptime(uint16_t &rollovers, unsigned long &current_millis) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            current_millis = millis();
+            count_rollover(current_millis); // the interrupt may not have run since the last rollover
+            rollovers = rollover_count;
+        }
+    }
+}
@@ -0,0 +1,206 @@
+/**
+ * @file system_time.h
+ * @brief Header file for the strong-typed system time and the 64-bit uptime.
+ * @details `Duration` and `TimePoint` wrap the `unsigned long` values of `millis()`. Differences of time points are
+ *          calculated modulo 2^32, so elapsed times stay correct across the `millis()` rollover after 49.7 days, as
+ *          long as the compared time points are less than 49.7 days apart. Time points themselves have no `<`
+ *          operator (which would break at the rollover), use `now() - since >= duration` or `is_before` instead.
+ *          All functions are constexpr or inline and compile to the same instructions as the hand-written math.
+ *          The values are stored as `uint32_t` (the `unsigned long` of the AVR), so the arithmetic wraps the same way
+ *          on a host with a 64-bit `unsigned long` (see tools/system_time_check).
+ *
+ *          The 64-bit uptime counts the `millis()` rollovers in an interrupt (Timer0 compare match B, once per ms),
+ *          so it does not overflow in practice.
+ */
+
+#ifndef SYSTEM_TIME_H
+#define SYSTEM_TIME_H
+
+#include <Arduino.h>
+
+namespace SystemTime {
+    constexpr unsigned long MILLISECONDS_PER_SECOND = 1000UL; ///< Number of milliseconds per second.
+    constexpr unsigned long SECONDS_PER_MINUTE = 60UL; ///< Number of seconds per minute.
+    constexpr unsigned long MINUTES_PER_HOUR = 60UL; ///< Number of minutes per hour.
+
+    /**
+     * @class   Duration
+     * @brief   Time span in milliseconds (up to 49.7 days).
+     */
+    class Duration {
+    public:
+        constexpr Duration() : value_ms(0UL) {
+        }
+
+        explicit constexpr Duration(const unsigned long milliseconds) : value_ms(static_cast<uint32_t>(milliseconds)) {
+        }
+
+        constexpr unsigned long to_milliseconds() const {
+            return value_ms;
+        }
+
+        constexpr unsigned long to_seconds() const {
+            return value_ms / MILLISECONDS_PER_SECOND;
+        }
+
+        constexpr Duration operator+(const Duration other) const {
+            return Duration(value_ms + other.value_ms);
+        }
+
+        constexpr Duration operator-(const Duration other) const {
+            return Duration(value_ms - other.value_ms);
+        }
+
+        constexpr Duration operator*(const unsigned long factor) const {
+            return Duration(value_ms * factor);
+        }
+
+        constexpr Duration operator/(const unsigned long divisor) const {
+            return Duration(value_ms / divisor);
+        }
+
+        constexpr bool operator==(const Duration other) const {
+            return value_ms == other.value_ms;
+        }
+
+        constexpr bool operator!=(const Duration other) const {
+            return value_ms != other.value_ms;
+        }
+
+        constexpr bool operator<(const Duration other) const {
+            return value_ms < other.value_ms;
+        }
+
+        constexpr bool operator<=(const Duration other) const {
+            return value_ms <= other.value_ms;
+        }
+
+        constexpr bool operator>(const Duration other) const {
+            return value_ms > other.value_ms;
+        }
+
+        constexpr bool operator>=(const Duration other) const {
+            return value_ms >= other.value_ms;
+        }
+
+    private:
+        uint32_t value_ms; ///< Time span in milliseconds.
+    };
+
+    /**
+     * @class   TimePoint
+     * @brief   Point in time as returned by `millis()` (wraps around after 49.7 days).
+     */
+    class TimePoint {
+    public:
+        constexpr TimePoint() : value_ms(0UL) {
+        }
+
+        explicit constexpr TimePoint(const unsigned long millis_value) : value_ms(static_cast<uint32_t>(millis_value)) {
+        }
+
+        constexpr unsigned long to_millis() const {
+            return value_ms;
+        }
+
+        /**
+         * @brief   Returns the time elapsed since an earlier time point (wrap-safe).
+         */
+        constexpr Duration operator-(const TimePoint earlier) const {
+            return Duration(value_ms - earlier.value_ms);
+        }
+
+        constexpr TimePoint operator+(const Duration duration) const {
+            return TimePoint(value_ms + duration.to_milliseconds());
+        }
+
+        constexpr TimePoint operator-(const Duration duration) const {
+            return TimePoint(value_ms - duration.to_milliseconds());
+        }
+
+        /**
+         * @brief   Returns true, if this time point is before the other one (wrap-safe, if they are less than 24.8 days
+         *          apart).
+         */
+        constexpr bool is_before(const TimePoint other) const {
+            return static_cast<int32_t>(value_ms - other.value_ms) < 0;
+        }
+
+        constexpr bool operator==(const TimePoint other) const {
+            return value_ms == other.value_ms;
+        }
+
+        constexpr bool operator!=(const TimePoint other) const {
+            return value_ms != other.value_ms;
+        }
+
+    private:
+        uint32_t value_ms; ///< Value of `millis()` at this time point.
+    };
+
+    /**
+     * @brief   Returns a duration of the given number of milliseconds.
+     */
+    constexpr Duration milliseconds(const unsigned long value) {
+        return Duration(value);
+    }
+
+    /**
+     * @brief   Returns a duration of the given number of seconds.
+     */
+    constexpr Duration seconds(const unsigned long value) {
+        return Duration(value * MILLISECONDS_PER_SECOND);
+    }
+
+    /**
+     * @brief   Returns a duration of the given number of minutes.
+     */
+    constexpr Duration minutes(const unsigned long value) {
+        return Duration(value * SECONDS_PER_MINUTE * MILLISECONDS_PER_SECOND);
+    }
+
+    /**
+     * @brief   Returns a duration of the given number of hours.
+     */
+    constexpr Duration hours(const unsigned long value) {
+        return Duration(value * MINUTES_PER_HOUR * SECONDS_PER_MINUTE * MILLISECONDS_PER_SECOND);
+    }
+
+    /**
+     * @brief   Returns the current time point.
+     */
+    inline TimePoint now() {
+        return TimePoint(millis());
+    }
+
+    /**
+     * @brief   Returns the time elapsed since the given time point.
+     */
+    inline Duration elapsed_since(const TimePoint time_point) {
+        return now() - time_point;
+    }
+
+    /**
+     * @brief   Returns true, if at least the given duration has elapsed since the given time point.
+     */
+    inline bool has_elapsed(const TimePoint since, const Duration duration) {
+        return elapsed_since(since) >= duration;
+    }
+
+    /**
+     * @brief   Starts counting the `millis()` rollovers for the 64-bit uptime (enables the Timer0 compare interrupt).
+     */
+    void initialize();
+
+    /**
+     * @brief   Returns the time since start-up in milliseconds, without rollover.
+     */
+    uint64_t get_uptime_ms();
+
+    /**
+     * @brief   Returns the time since start-up in seconds (calculated without 64-bit division).
+     */
+    unsigned long get_uptime_seconds();
+}
+
+#endif //SYSTEM_TIME_H
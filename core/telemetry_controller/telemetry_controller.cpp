@@ -0,0 +1,155 @@
+/**
+ * @file telemetry_controller.cpp
+ * @brief Implementation of the binary telemetry output.
+ */
+
+#include <telemetry_controller.h>
+#include <frame_codec.h>
+#include <state_access.h>
+#include <co2_sensor_controller.h>
+#include <measurement_filter.h>
+#include <memory_monitor.h>
+#include <warm_restart.h>
+#include <boot_timeline.h>
+#include <ventilation_estimator.h>
+
+#ifndef TELEMETRY_INTERVAL_MS
+#define TELEMETRY_INTERVAL_MS 10000UL
+#endif
+
+namespace TelemetryController {
+    /**
+     * @brief   Writes the frame payload and its checksum into the given buffer.
+     * @param   frame Buffer of `FRAME_SIZE` bytes.
+     */
+    void build_frame(uint8_t *frame);
+
+    /**
+     * @brief   Writes a 16 bit value in little-endian byte order.
+     * @return  Position after the written value.
+     */
+    uint8_t write_uint16(uint8_t *buffer, uint8_t position, uint16_t value);
+
+    /**
+     * @brief   Writes a 32 bit value in little-endian byte order.
+     * @return  Position after the written value.
+     */
+    uint8_t write_uint32(uint8_t *buffer, uint8_t position, uint32_t value);
+
+    /**
+     * @brief   Limits a counter to the range of a 16 bit field.
+     */
+    uint16_t saturate_uint16(unsigned long value);
+
+#ifdef ENABLE_TELEMETRY
+    constexpr bool IS_TELEMETRY_ENABLED = true; ///< Telemetry frames are sent.
+#else
+    constexpr bool IS_TELEMETRY_ENABLED = false; ///< Telemetry frames are not sent.
+#endif
+    constexpr unsigned long INTERVAL_MS = TELEMETRY_INTERVAL_MS; ///< Time between two telemetry frames.
+    constexpr uint8_t PAYLOAD_SIZE = 55; ///< Size of the frame without checksum.
+    constexpr uint8_t FRAME_SIZE = PAYLOAD_SIZE + sizeof(uint16_t); ///< Size of the frame including checksum.
+    constexpr uint8_t MUTED_FLAG = 0x01; ///< Flag set, if the system is muted.
+    constexpr uint8_t WARM_RESTART_FLAG = 0x02; ///< Flag set, if the system resumed from a warm restart.
+
+    uint16_t sequence_number = 0; ///< Sequence number of the next frame.
+    bool is_first_frame_sent = false; ///< True, once the first frame is sent (the sequence number wraps).
+    unsigned long last_frame_time_stamp_ms = 0UL; ///< Time (in ms) the last frame was sent.
+    int co2_measurement_ppm = -1; ///< Latest CO2 value in ppm.
+    uint8_t air_quality_level_index = NO_AIR_QUALITY_LEVEL; ///< Latest air quality level index.
+    unsigned long last_loop_start_time_stamp_ms = 0UL; ///< Time (in ms) the last loop iteration started.
+    unsigned long last_loop_duration_ms = 0UL; ///< Duration of the last complete loop iteration.
+    unsigned long max_loop_duration_ms = 0UL; ///< Longest loop iteration since start-up.
+
+    void mark_loop_start() {
+        const unsigned long current_time_ms = millis();
+        if (last_loop_start_time_stamp_ms != 0UL) {
+            last_loop_duration_ms = current_time_ms - last_loop_start_time_stamp_ms;
+            if (last_loop_duration_ms > max_loop_duration_ms) {
+                max_loop_duration_ms = last_loop_duration_ms;
+            }
+        }
+        last_loop_start_time_stamp_ms = current_time_ms;
+    }
+
+    void set_measurement(const int current_co2_measurement_ppm, const uint8_t current_air_quality_level_index) {
+        co2_measurement_ppm = current_co2_measurement_ppm;
+        air_quality_level_index = current_air_quality_level_index;
+    }
+
+    void set_measurement_not_valid() {
+        co2_measurement_ppm = Co2SensorController::MEASUREMENT_NOT_VALID_ERROR;
+        air_quality_level_index = NO_AIR_QUALITY_LEVEL;
+    }
+
+    void send_frame_if_due() {
+        if (!IS_TELEMETRY_ENABLED) {
+            return;
+        }
+        const unsigned long current_time_ms = millis();
+        if (is_first_frame_sent && current_time_ms - last_frame_time_stamp_ms < INTERVAL_MS) {
+            return;
+        }
+        last_frame_time_stamp_ms = current_time_ms;
+
+        uint8_t frame[FRAME_SIZE]; ///< Frame with payload and checksum.
+        build_frame(frame);
+        uint8_t encoded_frame[FrameCodec::get_max_encoded_size(FRAME_SIZE)]; ///< COBS encoded frame.
+        const size_t encoded_frame_size = FrameCodec::cobs_encode(frame, FRAME_SIZE, encoded_frame);
+
+        Serial.write(FrameCodec::FRAME_DELIMITER); // terminate any partial log line for the receiver
+        Serial.write(encoded_frame, encoded_frame_size);
+        Serial.write(FrameCodec::FRAME_DELIMITER);
+        sequence_number++;
+        is_first_frame_sent = true;
+    }
+
+    void build_frame(uint8_t *frame) {
+        const AirQualityMeter::State state = StateAccess::read(); ///< Consistent copy of the system state.
+        const Co2SensorController::SensorHealth health = Co2SensorController::get_sensor_health(0);
+        ///< Health counters and PWM timing gauges of the first sensor.
+        uint8_t position = 0; ///< Position of the next field in the frame.
+        frame[position++] = FRAME_VERSION;
+        position = write_uint16(frame, position, sequence_number);
+        position = write_uint32(frame, position, millis());
+        position = write_uint16(frame, position, static_cast<uint16_t>(co2_measurement_ppm));
+        frame[position++] = air_quality_level_index;
+        frame[position++] = static_cast<uint8_t>(state.warning_counter);
+        frame[position++] = static_cast<uint8_t>((state.is_system_muted ? MUTED_FLAG : 0) |
+                                                 (WarmRestart::is_warm_restart() ? WARM_RESTART_FLAG : 0));
+        position = write_uint16(frame, position, saturate_uint16(Co2SensorController::get_invalid_measurement_count()));
+        position = write_uint16(frame, position, saturate_uint16(MeasurementFilter::get_rejected_measurement_count()));
+        position = write_uint16(frame, position, saturate_uint16(last_loop_duration_ms));
+        position = write_uint16(frame, position, saturate_uint16(max_loop_duration_ms));
+        position = write_uint16(frame, position, MemoryMonitor::get_stack_high_water_mark_bytes());
+        position = write_uint16(frame, position, MemoryMonitor::get_unused_memory_bytes());
+        position = write_uint16(frame, position, MemoryMonitor::get_free_memory_bytes());
+        position = write_uint16(frame, position,
+                                MemoryMonitor::get_data_size_bytes() + MemoryMonitor::get_bss_size_bytes());
+        position = write_uint32(frame, position, BootTimeline::get_time_to_first_reading_ms());
+        position = write_uint32(frame, position, health.number_of_readings);
+        position = write_uint16(frame, position, saturate_uint16(health.number_of_missing_readings));
+        frame[position++] = health.max_consecutive_faulty_readings;
+        position = write_uint32(frame, position, health.pwm_period_us);
+        position = write_uint16(frame, position, static_cast<uint16_t>(health.pwm_duty_drift_ppm));
+        position = write_uint32(frame, position, health.time_since_last_valid_reading_ms);
+        position = write_uint32(frame, position, Co2SensorController::get_preheating_duration_ms());
+        position = write_uint16(frame, position, VentilationEstimator::get_air_changes_per_hour_centi());
+        write_uint16(frame, position, FrameCodec::crc16(frame, PAYLOAD_SIZE));
+    }
+
+    uint8_t write_uint16(uint8_t *buffer, uint8_t position, const uint16_t value) {
+        buffer[position++] = static_cast<uint8_t>(value);
+        buffer[position++] = static_cast<uint8_t>(value >> 8);
+        return position;
+    }
+
+    uint8_t write_uint32(uint8_t *buffer, uint8_t position, const uint32_t value) {
+        position = write_uint16(buffer, position, static_cast<uint16_t>(value));
+        return write_uint16(buffer, position, static_cast<uint16_t>(value >> 16));
+    }
+
+    uint16_t saturate_uint16(const unsigned long value) {
+        return value > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(value);
+    }
+}
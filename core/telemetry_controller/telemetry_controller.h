@@ -0,0 +1,80 @@
+/**
+ * @file telemetry_controller.h
+ * @brief Header file for the binary telemetry output.
+ * @details The telemetry controller periodically sends a fixed-layout binary frame with the current measurement,
+ *          system state, error counters and loop timing over the serial interface. Frames are protected with a
+ *          CRC16 and COBS encoded, so a gateway can parse them without scraping the human-readable log.
+ *
+ *          Frame layout (version 5, all values little-endian, before COBS encoding):
+ *          | Offset | Size | Field                                          |
+ *          |:-------|:-----|:-----------------------------------------------|
+ *          | 0      | 1    | Frame version                                  |
+ *          | 1      | 2    | Sequence number                                |
+ *          | 3      | 4    | Uptime in ms                                   |
+ *          | 7      | 2    | CO2 value in ppm (signed, -1 if not valid)     |
+ *          | 9      | 1    | Air quality level index (0xFF if not valid)    |
+ *          | 10     | 1    | Warning counter                                |
+ *          | 11     | 1    | Flags (bit 0: muted, bit 1: warm restart)      |
+ *          | 12     | 2    | Invalid sensor readings (saturating)           |
+ *          | 14     | 2    | Readings rejected as outliers (saturating)     |
+ *          | 16     | 2    | Duration of the last loop iteration in ms      |
+ *          | 18     | 2    | Longest loop iteration since start-up in ms    |
+ *          | 20     | 2    | Stack high-water mark in bytes                 |
+ *          | 22     | 2    | SRAM never used by stack or heap in bytes      |
+ *          | 24     | 2    | Current gap between heap and stack in bytes    |
+ *          | 26     | 2    | Static SRAM (`.data` + `.bss`) in bytes        |
+ *          | 28     | 4    | Time to first reading in ms (0 if none yet)    |
+ *          | 32     | 4    | Readings of the first sensor since start-up    |
+ *          | 36     | 2    | Readings without PWM pulse or UART response    |
+ *          | 38     | 1    | Most faulty readings in a row (retries)        |
+ *          | 39     | 4    | PWM cycle period in µs (0 if not measured yet) |
+ *          | 43     | 2    | PWM duty drift in ppm (signed)                 |
+ *          | 45     | 4    | Time since the last valid reading in ms        |
+ *          | 49     | 4    | Preheating duration in ms (0 if none)          |
+ *          | 53     | 2    | Air changes per hour x 100 (0xFFFF if none)    |
+ *          | 55     | 2    | CRC16/CCITT-FALSE of bytes 0-54                |
+ *
+ *          The sensor health fields (offset 32 to 48) are those of the first registered sensor, the time since the
+ *          last valid reading is 0xFFFFFFFF, if it has not delivered a valid reading yet. The invalid sensor readings
+ *          (offset 12) include the readings without pulse or response. The air changes per hour are those of the last
+ *          measured CO2 decay (see `VentilationEstimator`).
+ *
+ *          On the wire, each frame is sent as `0x00 <COBS encoded frame> 0x00`.
+ */
+
+#ifndef TELEMETRY_CONTROLLER_H
+#define TELEMETRY_CONTROLLER_H
+
+#include <Arduino.h>
+
+namespace TelemetryController {
+    constexpr uint8_t FRAME_VERSION = 5; ///< Version of the frame layout.
+    constexpr uint8_t NO_AIR_QUALITY_LEVEL = 0xFF; ///< Level index sent, if there is no valid measurement.
+
+    /**
+     * @brief   Marks the start of a loop iteration to measure the loop timing.
+     * @details Must be called once at the beginning of each `loop()` iteration.
+     */
+    void mark_loop_start();
+
+    /**
+     * @brief   Stores the current measurement to be sent with the next frame.
+     * @param   co2_measurement_ppm The current (filtered) CO2 value in ppm.
+     * @param   air_quality_level_index Index of the current air quality level in `AirQuality::AIR_QUALITY_LEVELS`.
+     */
+    void set_measurement(int co2_measurement_ppm, uint8_t air_quality_level_index);
+
+    /**
+     * @brief   Marks the current measurement as not valid.
+     */
+    void set_measurement_not_valid();
+
+    /**
+     * @brief   Sends a telemetry frame, if the telemetry interval has passed.
+     * @details Does nothing, unless the firmware is built with `-DENABLE_TELEMETRY`. The interval can be configured
+     *          with `-DTELEMETRY_INTERVAL_MS=<ms>`.
+     */
+    void send_frame_if_due();
+}
+
+#endif //TELEMETRY_CONTROLLER_H
@@ -0,0 +1,94 @@
+/**
+ * @file text_formatter.cpp
+ * @brief Implementation of the printf-free text formatting.
+ */
+
+#include <text_formatter.h>
+
+namespace TextFormatter {
+    /**
+     * @brief   Writes a single character, if there is space for it and the null terminator.
+     * @return  Position after the character.
+     */
+    char *write_character(char *position, const char *end, char character);
+
+    constexpr uint8_t MAX_DIGITS = 3 * sizeof(unsigned long);
+    ///< Upper bound for the number of decimal digits of an unsigned long.
+    constexpr uint8_t DECIMAL_BASE = 10; ///< Base of the decimal notation.
+
+    // Division constants
+    constexpr unsigned long MSECS_PER_SEC = 1000UL; ///< Number of milliseconds per second.
+    constexpr uint16_t SECS_PER_MIN = 60; ///< Number of seconds per minute (16 bit for fast divisions on AVR).
+    constexpr unsigned long SECS_PER_HOUR = 3600UL; ///< Number of seconds per hour.
+    constexpr unsigned long SECS_PER_DAY = 86400UL; ///< Number of seconds per day.
+
+    char *write_string(char *position, const char *end, const char *string) {
+        while (*string != '\0' && position + 1 < end) {
+            *position++ = *string++;
+        }
+        if (position < end) {
+            *position = '\0';
+        }
+        return position;
+    }
+
+    char *write_unsigned(char *position, const char *end, unsigned long value, const uint8_t min_width,
+                         const char padding) {
+        char digits[MAX_DIGITS]; ///< Digits of the value in reverse order.
+        uint8_t number_of_digits = 0;
+        // 32 bit divisions are expensive on AVR, so they are only used as long as the value does not fit 16 bits.
+        while (value > UINT16_MAX) {
+            digits[number_of_digits++] = static_cast<char>('0' + value % DECIMAL_BASE);
+            value /= DECIMAL_BASE;
+        }
+        uint16_t short_value = static_cast<uint16_t>(value); ///< Remaining value, which fits 16 bits.
+        do {
+            digits[number_of_digits++] = static_cast<char>('0' + short_value % DECIMAL_BASE);
+            short_value /= DECIMAL_BASE;
+        } while (short_value != 0);
+
+        for (uint8_t width = number_of_digits; width < min_width; width++) {
+            position = write_character(position, end, padding);
+        }
+        while (number_of_digits > 0) {
+            position = write_character(position, end, digits[--number_of_digits]);
+        }
+        if (position < end) {
+            *position = '\0';
+        }
+        return position;
+    }
+
+    char *write_signed(char *position, const char *end, const long value) {
+        if (value < 0) {
+            position = write_character(position, end, '-');
+            return write_unsigned(position, end, 0UL - static_cast<unsigned long>(value));
+        }
+        return write_unsigned(position, end, static_cast<unsigned long>(value));
+    }
+
+    void write_timestamp(char *buffer, const unsigned long time_ms) {
+        const unsigned long secs = time_ms / MSECS_PER_SEC; ///< Total seconds elapsed since the program started.
+        const unsigned long seconds_of_day = secs % SECS_PER_DAY; ///< Seconds elapsed since midnight.
+        const uint16_t seconds_of_hour = static_cast<uint16_t>(seconds_of_day % SECS_PER_HOUR);
+        ///< Seconds elapsed since the start of the current hour.
+
+        const char *end = buffer + TIMESTAMP_BUFFER_SIZE; ///< End of the timestamp buffer.
+        char *position = write_character(buffer, end, '[');
+        position = write_unsigned(position, end, seconds_of_day / SECS_PER_HOUR, 2);
+        position = write_character(position, end, ':');
+        position = write_unsigned(position, end, seconds_of_hour / SECS_PER_MIN, 2);
+        position = write_character(position, end, ':');
+        position = write_unsigned(position, end, seconds_of_hour % SECS_PER_MIN, 2);
+        position = write_character(position, end, '.');
+        position = write_unsigned(position, end, time_ms % MSECS_PER_SEC, 3);
+        write_string(position, end, "] ");
+    }
+
+    char *write_character(char *position, const char *end, const char character) {
+        if (position + 1 < end) {
+            *position++ = character;
+        }
+        return position;
+    }
+}
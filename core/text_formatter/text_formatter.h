@@ -0,0 +1,133 @@
+/**
+ * @file text_formatter.h
+ * @brief Header file for the printf-free text formatting.
+ * @details Small replacement for the few `sprintf`/`snprintf` use cases of the firmware. Using the printf family
+ *          links `vfprintf` (about 1.5 KB of flash on AVR) and parses the format string at run time on every call.
+ *          The functions in this module write integers, strings and timestamps directly into a caller-provided
+ *          buffer, and constant strings are concatenated at compile time.
+ *
+ *          All `write_*` functions take the current write position and the end of the buffer (one past the last
+ *          byte), never write past the end, always terminate the text with `'\0'` and return the position of the
+ *          terminating `'\0'`, so calls can be chained:
+ *          @code
+ *          char *position = TextFormatter::write_string(buffer, buffer + sizeof(buffer), "CO2: ");
+ *          position = TextFormatter::write_signed(position, buffer + sizeof(buffer), co2_measurement_ppm);
+ *          @endcode
+ */
+
+#ifndef TEXT_FORMATTER_H
+#define TEXT_FORMATTER_H
+
+#include <Arduino.h>
+
+namespace TextFormatter {
+    constexpr size_t TIMESTAMP_BUFFER_SIZE = sizeof("[hh:mm:ss.mmm] ");
+    ///< Required size for a buffer to store a timestamp (including null terminator).
+
+    /**
+     * @struct  ConstantString
+     * @brief   Null-terminated string created at compile time.
+     * @tparam  SIZE Size of the string including the null terminator.
+     */
+    template<size_t SIZE>
+    struct ConstantString {
+        char characters[SIZE]; ///< Characters of the string including the null terminator.
+
+        /**
+         * @brief   Returns the string as C string.
+         */
+        constexpr const char *c_str() const {
+            return characters;
+        }
+    };
+
+    /**
+     * @struct  IndexSequence
+     * @brief   Compile-time sequence of indices (`std::index_sequence` is not available in C++11 and on AVR).
+     */
+    template<size_t... INDICES>
+    struct IndexSequence {
+    };
+
+    /**
+     * @struct  MakeIndexSequence
+     * @brief   Creates the `IndexSequence` 0 ... COUNT - 1 as member type `type`.
+     */
+    template<size_t COUNT, size_t... INDICES>
+    struct MakeIndexSequence : MakeIndexSequence<COUNT - 1, COUNT - 1, INDICES...> {
+    };
+
+    template<size_t... INDICES>
+    struct MakeIndexSequence<0, INDICES...> {
+        using type = IndexSequence<INDICES...>;
+    };
+
+    /**
+     * @brief   Returns the character at the given index of the concatenation `string_1 separator string_2`.
+     */
+    template<size_t SIZE_1, size_t SIZE_2>
+    constexpr char get_concatenated_character(const char (&string_1)[SIZE_1], const char separator,
+                                              const char (&string_2)[SIZE_2], const size_t index) {
+        return index < SIZE_1 - 1 ? string_1[index] : index == SIZE_1 - 1 ? separator : string_2[index - SIZE_1];
+    }
+
+    /**
+     * @brief   Creates the concatenation from the characters at the given indices.
+     */
+    template<size_t SIZE_1, size_t SIZE_2, size_t... INDICES>
+    constexpr ConstantString<SIZE_1 + SIZE_2> concatenate(const char (&string_1)[SIZE_1], const char separator,
+                                                          const char (&string_2)[SIZE_2],
+                                                          IndexSequence<INDICES...>) {
+        return {{get_concatenated_character(string_1, separator, string_2, INDICES)...}};
+    }
+
+    /**
+     * @brief   Concatenates two constant strings with a separator at compile time.
+     * @details Example: `constexpr auto MESSAGE = TextFormatter::concatenate("MHZ 19B", ' ', "Initializing");`
+     * @return  The string `string_1 separator string_2`.
+     */
+    template<size_t SIZE_1, size_t SIZE_2>
+    constexpr ConstantString<SIZE_1 + SIZE_2> concatenate(const char (&string_1)[SIZE_1], const char separator,
+                                                          const char (&string_2)[SIZE_2]) {
+        return concatenate(string_1, separator, string_2, typename MakeIndexSequence<SIZE_1 + SIZE_2>::type());
+    }
+
+    /**
+     * @brief   Writes a string.
+     * @param   position Write position in the buffer.
+     * @param   end End of the buffer (one past the last byte).
+     * @param   string The string to write.
+     * @return  Position of the terminating '\0'.
+     */
+    char *write_string(char *position, const char *end, const char *string);
+
+    /**
+     * @brief   Writes an unsigned integer in decimal notation.
+     * @param   position Write position in the buffer.
+     * @param   end End of the buffer (one past the last byte).
+     * @param   value The value to write.
+     * @param   min_width Minimum number of characters, shorter values are padded on the left.
+     * @param   padding Character used for padding (e.g. '0' or ' ').
+     * @return  Position of the terminating '\0'.
+     */
+    char *write_unsigned(char *position, const char *end, unsigned long value, uint8_t min_width = 0,
+                         char padding = '0');
+
+    /**
+     * @brief   Writes a signed integer in decimal notation (with a leading '-' for negative values).
+     * @param   position Write position in the buffer.
+     * @param   end End of the buffer (one past the last byte).
+     * @param   value The value to write.
+     * @return  Position of the terminating '\0'.
+     */
+    char *write_signed(char *position, const char *end, long value);
+
+    /**
+     * @brief   Writes the time of day of a time since start-up as `[hh:mm:ss.mmm] `.
+     * @param   buffer Buffer of at least `TIMESTAMP_BUFFER_SIZE` bytes.
+     * @param   time_ms Time since start-up in ms.
+     */
+    void write_timestamp(char *buffer, unsigned long time_ms);
+}
+
+#endif //TEXT_FORMATTER_H
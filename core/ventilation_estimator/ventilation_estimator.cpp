@@ -0,0 +1,146 @@
+/**
+ * @file ventilation_estimator.cpp
+ * @brief Implementation of the online estimation of the air exchange rate from CO2 decay curves.
+ */
+
+#include <ventilation_estimator.h>
+
+namespace VentilationEstimator {
+    /**
+     * @brief   Starts a decay episode at the given time.
+     */
+    void start_episode(unsigned long time_stamp_ms);
+
+    /**
+     * @brief   Ends the decay episode, the next one starts after a drop below the given (smoothed) value.
+     */
+    void end_episode(int smoothed_co2_ppm);
+
+    /**
+     * @brief   Fits the decay rate to the readings of the episode and sets it as estimate, if the decay is clear.
+     * @param   elapsed_s Time since the start of the episode in s.
+     */
+    void update_estimate(uint16_t elapsed_s);
+
+    /**
+     * @brief   Returns log2 of the value in fixed point with `LOG2_FRACTION_BITS` fraction bits.
+     * @param   value Value greater than 0.
+     */
+    uint16_t log2_fixed(uint16_t value);
+
+    constexpr uint8_t LOG2_FRACTION_BITS = 6; ///< Resolution of log2 (1/64, i.e. about 1 % of the excess).
+    constexpr uint8_t LOG2_TABLE_BITS = 4; ///< Bits of the mantissa used as index into the table.
+    constexpr uint8_t LOG2_TABLE[(1U << LOG2_TABLE_BITS) + 1] = {
+        0, 6, 11, 16, 21, 25, 29, 34, 37, 41, 45, 48, 52, 55, 58, 61, 64
+    }; ///< log2(1 + i / 16) in 1/64, interpolated linearly in between (error below 0.5 %).
+    constexpr int64_t RATE_FACTOR = 3899; ///< 0.01 changes per hour per 1/64 log2 per s: 100 * 3600 s * ln(2) / 64.
+    constexpr int64_t MIN_DECAY_LOG2 = 21; ///< Fitted decay of an estimate: log2(5 / 4) in 1/64.
+    constexpr int64_t MAX_RATE = NO_RATE - 1; ///< Highest rate in 0.01 changes per hour.
+    constexpr long SMOOTHING_FACTOR = 4L; ///< Weight of the smoothed value against a new reading (1/4 per reading).
+    constexpr long SMOOTHING_SCALE = 16L; ///< Fixed-point scale of the smoothed value.
+
+    uint16_t air_changes_per_hour_centi = NO_RATE; ///< Rate of the last measured decay.
+    bool has_readings = false; ///< True, after the first reading.
+    long smoothed_co2_x16 = 0L; ///< Exponentially smoothed reading in 1/16 ppm, for the start and end of episodes.
+    int peak_ppm = 0; ///< Highest smoothed value since the last episode.
+    bool is_decaying = false; ///< True, during a decay episode.
+    unsigned long episode_start_time_ms = 0UL; ///< Time (in ms) of the first reading of the episode.
+    int minimum_ppm = 0; ///< Lowest smoothed value of the episode.
+    uint16_t number_of_samples = 0; ///< Readings of the episode.
+    uint32_t sum_t = 0; ///< Sum of the times (in s since the start of the episode).
+    uint32_t sum_t_squared = 0; ///< Sum of the squared times.
+    uint32_t sum_log2 = 0; ///< Sum of log2 of the excess.
+    uint32_t sum_t_log2 = 0; ///< Sum of the products of time and log2 of the excess.
+
+    void add(const int co2_measurement_ppm, const unsigned long time_stamp_ms) {
+        // The start and the end of an episode are detected on the smoothed value, so single noisy readings neither
+        // start nor end one; the fit itself averages the noise of the readings.
+        if (!has_readings) {
+            has_readings = true;
+            smoothed_co2_x16 = co2_measurement_ppm * SMOOTHING_SCALE;
+        }
+        smoothed_co2_x16 += (co2_measurement_ppm * SMOOTHING_SCALE - smoothed_co2_x16) / SMOOTHING_FACTOR;
+        const int smoothed_co2_ppm = static_cast<int>(smoothed_co2_x16 / SMOOTHING_SCALE);
+        const int excess_ppm = co2_measurement_ppm - OUTDOOR_CO2_PPM;
+        if (!is_decaying) {
+            if (smoothed_co2_ppm > peak_ppm) {
+                peak_ppm = smoothed_co2_ppm;
+            }
+            if (smoothed_co2_ppm > peak_ppm - START_DROP_PPM || excess_ppm < MIN_START_EXCESS_PPM) {
+                return;
+            }
+            start_episode(time_stamp_ms);
+        }
+        const unsigned long elapsed_s = (time_stamp_ms - episode_start_time_ms) / 1000UL;
+        if (smoothed_co2_ppm > minimum_ppm + END_RISE_PPM || excess_ppm < MIN_EXCESS_PPM ||
+            elapsed_s > MAX_EPISODE_DURATION_S || number_of_samples == MAX_NUMBER_OF_SAMPLES) {
+            end_episode(smoothed_co2_ppm);
+            return;
+        }
+        if (smoothed_co2_ppm < minimum_ppm) {
+            minimum_ppm = smoothed_co2_ppm;
+        }
+        const uint16_t t = static_cast<uint16_t>(elapsed_s);
+        const uint16_t log2_excess = log2_fixed(static_cast<uint16_t>(excess_ppm));
+        number_of_samples++;
+        sum_t += t;
+        sum_t_squared += static_cast<uint32_t>(t) * t;
+        sum_log2 += log2_excess;
+        sum_t_log2 += static_cast<uint32_t>(t) * log2_excess;
+        if (t >= MIN_EPISODE_DURATION_S && number_of_samples >= MIN_NUMBER_OF_SAMPLES) {
+            update_estimate(t);
+        }
+    }
+
+    uint16_t get_air_changes_per_hour_centi() {
+        return air_changes_per_hour_centi;
+    }
+
+    bool is_decay_in_progress() {
+        return is_decaying;
+    }
+
+    void start_episode(const unsigned long time_stamp_ms) {
+        is_decaying = true;
+        episode_start_time_ms = time_stamp_ms;
+        minimum_ppm = peak_ppm;
+        number_of_samples = 0;
+        sum_t = 0;
+        sum_t_squared = 0;
+        sum_log2 = 0;
+        sum_t_log2 = 0;
+    }
+
+    void end_episode(const int smoothed_co2_ppm) {
+        is_decaying = false;
+        peak_ppm = smoothed_co2_ppm;
+    }
+
+    void update_estimate(const uint16_t elapsed_s) {
+        const int64_t n = number_of_samples;
+        const int64_t covariance = n * sum_t_log2 - static_cast<int64_t>(sum_t) * sum_log2;
+        ///< n^2 times the covariance of time and log2 of the excess (negative while the excess decays).
+        const int64_t variance = n * sum_t_squared - static_cast<int64_t>(sum_t) * sum_t;
+        ///< n^2 times the variance of the time.
+        // The slope is covariance / variance (1/64 log2 per s), the fitted decay over the episode is slope * elapsed.
+        if (variance <= 0 || -covariance * elapsed_s < MIN_DECAY_LOG2 * variance) {
+            return;
+        }
+        const int64_t rate = (-covariance * RATE_FACTOR + variance / 2) / variance;
+        air_changes_per_hour_centi = static_cast<uint16_t>(rate > MAX_RATE ? MAX_RATE : rate);
+    }
+
+    uint16_t log2_fixed(uint16_t value) {
+        uint8_t exponent = 15; ///< Position of the highest set bit.
+        while ((value & 0x8000U) == 0) {
+            value <<= 1;
+            exponent--;
+        }
+        constexpr uint8_t REMAINDER_BITS = 15 - LOG2_TABLE_BITS; ///< Mantissa bits below the table index.
+        const uint8_t index = static_cast<uint8_t>(value >> REMAINDER_BITS & ((1U << LOG2_TABLE_BITS) - 1U));
+        const uint16_t remainder = value & ((1U << REMAINDER_BITS) - 1U);
+        const uint8_t step = LOG2_TABLE[index + 1] - LOG2_TABLE[index]; ///< Difference to the next table entry.
+        return static_cast<uint16_t>((exponent << LOG2_FRACTION_BITS) + LOG2_TABLE[index] +
+                                     (static_cast<uint32_t>(step) * remainder >> REMAINDER_BITS));
+    }
+}
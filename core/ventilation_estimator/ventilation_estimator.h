@@ -0,0 +1,60 @@
+/**
+ * @file ventilation_estimator.h
+ * @brief Header file for the online estimation of the air exchange rate from CO2 decay curves.
+ * @details While a room is ventilated (e.g. a window is open) and no more CO2 is added, the excess of the CO2 value
+ *          over the outdoor value decays exponentially: `C(t) - C_out = (C(0) - C_out) * e^(-n * t)`. The decay rate
+ *          `n` is the air exchange rate of the room in air changes per hour. The estimator works on the stream of
+ *          readings:
+ *           - A decay episode starts, when the smoothed reading (exponential moving average over about four readings,
+ *             so single noisy readings do not count) is `START_DROP_PPM` below its highest value since the last
+ *             episode, with an excess of at least `MIN_START_EXCESS_PPM`.
+ *           - Each reading of the episode is added to a least-squares fit of log2 of the excess over the time. The fit
+ *             only keeps five sums (fixed memory, integer math); log2 is interpolated from a table of 17 bytes.
+ *           - The episode ends, when the smoothed reading rises `END_RISE_PPM` above its lowest value (window
+ *             closed, people came in), the excess falls below `MIN_EXCESS_PPM` (the outdoor value is not known
+ *             exactly), or after `MAX_EPISODE_DURATION_S`.
+ *           - After `MIN_EPISODE_DURATION_S`, the fitted rate becomes the current estimate with each reading, if the
+ *             fitted excess has fallen by at least a fifth.
+ *
+ *          The outdoor value is the fresh-air reference of the automatic baseline calibration of the MH-Z19B (400 ppm).
+ *          A reading costs a table lookup, a few additions and two 16-bit multiplications; the rate itself is divided
+ *          out (64 bit) only once the episode is long enough.
+ */
+
+#ifndef VENTILATION_ESTIMATOR_H
+#define VENTILATION_ESTIMATOR_H
+
+#include <Arduino.h>
+
+namespace VentilationEstimator {
+    constexpr int OUTDOOR_CO2_PPM = 400; ///< CO2 value of the outdoor air (ABC reference of the sensor).
+    constexpr int START_DROP_PPM = 50; ///< Drop below the highest smoothed reading, that starts an episode.
+    constexpr int END_RISE_PPM = 50; ///< Rise above the lowest smoothed reading of the episode, that ends it.
+    constexpr int MIN_START_EXCESS_PPM = 300; ///< Smallest excess over the outdoor value, that starts an episode.
+    constexpr int MIN_EXCESS_PPM = 150; ///< Smallest excess over the outdoor value, that is fitted.
+    constexpr uint16_t MIN_EPISODE_DURATION_S = 300; ///< Shortest episode, that gives an estimate (5 minutes).
+    constexpr uint16_t MAX_EPISODE_DURATION_S = 1800; ///< Longest episode (30 minutes), a new one starts after it.
+    constexpr uint16_t MIN_NUMBER_OF_SAMPLES = 20; ///< Fewest readings of an episode, that give an estimate.
+    constexpr uint16_t MAX_NUMBER_OF_SAMPLES = 1024; ///< Most readings of an episode (the sums fit in 32 bit).
+    constexpr uint16_t NO_RATE = 0xFFFF; ///< Returned, if no decay has been measured yet.
+
+    /**
+     * @brief   Adds a reading to the estimation.
+     * @param   co2_measurement_ppm The (filtered) CO2 value in ppm.
+     * @param   time_stamp_ms Time (in ms) of the reading.
+     */
+    void add(int co2_measurement_ppm, unsigned long time_stamp_ms);
+
+    /**
+     * @brief   Returns the air exchange rate of the last measured decay.
+     * @return  The rate in 0.01 air changes per hour, or `NO_RATE`.
+     */
+    uint16_t get_air_changes_per_hour_centi();
+
+    /**
+     * @brief   Returns true, while a decay episode is measured.
+     */
+    bool is_decay_in_progress();
+}
+
+#endif //VENTILATION_ESTIMATOR_H
@@ -0,0 +1,133 @@
+/**
+ * @file warm_restart.cpp
+ * @brief Implementation of the warm restart after a watchdog, brown-out or external reset.
+ */
+
+#include <warm_restart.h>
+#include <state_access.h>
+#include <watchdog.h>
+#include <frame_codec.h>
+
+namespace WarmRestart {
+    constexpr uint16_t MAGIC = 0xA3C1; ///< Marks the snapshot as written by this firmware.
+    constexpr uint8_t VERSION = 1; ///< Layout version of the snapshot, increment on every change of `Snapshot`.
+    constexpr unsigned long STABLE_RUN_TIME_MS = 60000UL;
+    ///< Run time (in ms) after which the system is considered stable, and the warm restart counter is cleared.
+
+    /**
+     * @struct  Snapshot
+     * @brief   System state kept over a reset.
+     */
+    struct Snapshot {
+        uint16_t magic; ///< Has to be `MAGIC`.
+        uint8_t version; ///< Has to be `VERSION`.
+        uint8_t consecutive_warm_restarts; ///< Number of warm restarts without a stable run in between.
+        unsigned long time_since_co2_below_threshold_ms;
+        ///< Time (in ms) between the last time CO2 was below the threshold and the snapshot.
+        int warning_counter; ///< Number of warnings issued in the current exceedance.
+        bool is_system_muted; ///< True, if the system is muted.
+        bool is_sensor_warm; ///< True, if the sensor was preheated.
+        uint8_t next_measurement_index; ///< Position of the next reading in `measurements_ppm`.
+        uint8_t number_of_measurements; ///< Number of valid readings in `measurements_ppm`.
+        int measurements_ppm[NUMBER_OF_MEASUREMENTS]; ///< Recent readings (ring buffer).
+        uint16_t crc; ///< CRC16 of all fields above.
+    };
+
+    Snapshot snapshot __attribute__((section(".noinit"))); ///< Snapshot, not initialized at start-up.
+    bool is_restored = false; ///< True, if the state was restored at start-up.
+
+    /**
+     * @brief   Calculates the CRC16 of the snapshot (without the CRC field).
+     */
+    uint16_t calculate_crc();
+
+    /**
+     * @brief   Returns true, if the snapshot was written by this firmware and is not corrupted.
+     */
+    bool is_snapshot_valid();
+
+    /**
+     * @brief   Returns true, if the reset cause allows a warm restart (the supply voltage stayed on).
+     */
+    bool is_reset_cause_warm();
+
+    /**
+     * @brief   Clears the snapshot (no readings, sensor not warm).
+     */
+    void invalidate();
+
+    bool restore() {
+        if (!is_reset_cause_warm() || !is_snapshot_valid() || !snapshot.is_sensor_warm ||
+            snapshot.consecutive_warm_restarts >= MAX_CONSECUTIVE_WARM_RESTARTS) {
+            invalidate();
+            return false;
+        }
+        const unsigned long last_co2_below_threshold_time_ms = millis() - snapshot.time_since_co2_below_threshold_ms;
+        StateAccess::write([last_co2_below_threshold_time_ms](AirQualityMeter::State &state) {
+            state.last_co2_below_threshold_time_ms = last_co2_below_threshold_time_ms;
+            state.warning_counter = snapshot.warning_counter;
+            state.is_system_muted = snapshot.is_system_muted;
+        });
+        snapshot.consecutive_warm_restarts++;
+        snapshot.crc = calculate_crc();
+        is_restored = true;
+        return true;
+    }
+
+    bool is_warm_restart() {
+        return is_restored;
+    }
+
+    uint8_t get_number_of_measurements() {
+        return snapshot.number_of_measurements;
+    }
+
+    int get_measurement_ppm(const uint8_t index) {
+        const uint8_t oldest_index = static_cast<uint8_t>(
+            (snapshot.next_measurement_index + NUMBER_OF_MEASUREMENTS - snapshot.number_of_measurements) %
+            NUMBER_OF_MEASUREMENTS); ///< Position of the oldest reading in the ring buffer.
+        return snapshot.measurements_ppm[(oldest_index + index) % NUMBER_OF_MEASUREMENTS];
+    }
+
+    void save(const int co2_measurement_ppm) {
+        const AirQualityMeter::State state = StateAccess::read();
+        const unsigned long current_time_ms = millis();
+        snapshot.time_since_co2_below_threshold_ms = current_time_ms - state.last_co2_below_threshold_time_ms;
+        snapshot.warning_counter = state.warning_counter;
+        snapshot.is_system_muted = state.is_system_muted;
+        snapshot.is_sensor_warm = true; // readings are only taken after the preheating
+        snapshot.measurements_ppm[snapshot.next_measurement_index] = co2_measurement_ppm;
+        snapshot.next_measurement_index = (snapshot.next_measurement_index + 1) % NUMBER_OF_MEASUREMENTS;
+        if (snapshot.number_of_measurements < NUMBER_OF_MEASUREMENTS) {
+            snapshot.number_of_measurements++;
+        }
+        if (current_time_ms >= STABLE_RUN_TIME_MS) {
+            snapshot.consecutive_warm_restarts = 0;
+        }
+        snapshot.crc = calculate_crc();
+    }
+
+    uint16_t calculate_crc() {
+        return FrameCodec::crc16(reinterpret_cast<const uint8_t *>(&snapshot), offsetof(Snapshot, crc));
+    }
+
+    bool is_snapshot_valid() {
+        return snapshot.magic == MAGIC && snapshot.version == VERSION &&
+               snapshot.number_of_measurements <= NUMBER_OF_MEASUREMENTS &&
+               snapshot.next_measurement_index < NUMBER_OF_MEASUREMENTS && snapshot.crc == calculate_crc();
+    }
+
+    bool is_reset_cause_warm() {
+        const Watchdog::ResetCause reset_cause = Watchdog::get_reset_cause();
+        ///< Cause of the last reset, `POWER_ON` whenever the power-on flag is set (even with the brown-out flag).
+        return reset_cause == Watchdog::WATCHDOG || reset_cause == Watchdog::BROWN_OUT ||
+               reset_cause == Watchdog::EXTERNAL;
+    }
+
+    void invalidate() {
+        memset(&snapshot, 0, sizeof(snapshot));
+        snapshot.magic = MAGIC;
+        snapshot.version = VERSION;
+        snapshot.crc = calculate_crc();
+    }
+}
@@ -0,0 +1,58 @@
+/**
+ * @file warm_restart.h
+ * @brief Header file for the warm restart after a watchdog, brown-out or external reset.
+ * @details A snapshot of the system state, the last readings and the sensor status is kept in a `.noinit` SRAM section,
+ *          which survives every reset except a power-on. It is protected by a magic number and a CRC16. If the MCU is
+ *          reset while the supply voltage stays on, the MH-Z19B keeps running and is still warm, so the system can skip
+ *          the welcome message and the 3 minutes of preheating and resume monitoring immediately, with the warning
+ *          timers and the mute state intact.
+ *
+ *          Times are stored as durations relative to the time of the snapshot, because `millis()` restarts at 0.
+ *          To break a reset loop (e.g. caused by a corrupt state), a warm restart is only done
+ *          `MAX_CONSECUTIVE_WARM_RESTARTS` times in a row without a stable run in between.
+ */
+
+#ifndef WARM_RESTART_H
+#define WARM_RESTART_H
+
+#include <Arduino.h>
+
+namespace WarmRestart {
+    constexpr uint8_t NUMBER_OF_MEASUREMENTS = 8; ///< Number of recent readings kept in the snapshot.
+    constexpr uint8_t MAX_CONSECUTIVE_WARM_RESTARTS = 3;
+    ///< Number of warm restarts in a row, after which a cold start (with preheating) is forced.
+
+    /**
+     * @brief   Restores the system state from the snapshot, if a warm restart is possible.
+     * @details A warm restart is possible after a watchdog, brown-out or external reset, if the snapshot is valid and
+     *          the sensor was warm. Otherwise the snapshot is invalidated. Has to be called once at the very beginning
+     *          of the setup, before any module writes to the state.
+     * @return  True, if the state was restored and the sensor is warm.
+     */
+    bool restore();
+
+    /**
+     * @brief   Returns true, if the state was restored from the snapshot at start-up.
+     */
+    bool is_warm_restart();
+
+    /**
+     * @brief   Returns the number of restored readings (0 after a cold start).
+     */
+    uint8_t get_number_of_measurements();
+
+    /**
+     * @brief   Returns a restored reading.
+     * @param   index Index of the reading, 0 is the oldest, `get_number_of_measurements() - 1` the latest one.
+     * @return  The reading in ppm.
+     */
+    int get_measurement_ppm(uint8_t index);
+
+    /**
+     * @brief   Adds a reading to the snapshot and updates the stored state. Call it once per valid reading.
+     * @param   co2_measurement_ppm Filtered reading in ppm.
+     */
+    void save(int co2_measurement_ppm);
+}
+
+#endif //WARM_RESTART_H
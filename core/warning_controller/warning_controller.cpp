@@ -11,32 +11,45 @@
 #include <Arduino.h>
 #include <warning_controller.h>
 #include <thresholds.h>
-#include <state.h>
+#include <state_access.h>
 
 namespace WarningController {
-    bool is_audio_warning_to_be_issued(const unsigned long time_since_co2_level_not_acceptable_ms) {
-        return time_since_co2_level_not_acceptable_ms > WarningThresholds::MAX_TIME_ABOVE_CO2_THRESHOLD_MS;
+    bool is_audio_warning_to_be_issued(const SystemTime::Duration time_since_co2_level_not_acceptable,
+                                       const Policy &policy) {
+        return time_since_co2_level_not_acceptable > policy.max_time_above_co2_threshold;
     }
 
     void reset() {
-        noInterrupts(); ///< prevent interrupts while writing on system state
-        AirQualityMeter::state.last_co2_below_threshold_time_ms = millis();
-        AirQualityMeter::state.warning_counter = 0;
-        interrupts();
+        const unsigned long current_time_ms = millis();
+        StateAccess::write([current_time_ms](AirQualityMeter::State &state) {
+            reset_state(state, current_time_ms);
+        });
     }
 
     void update_for_co2_level_not_acceptable() {
-        AirQualityMeter::state.warning_counter++;
-        if (AirQualityMeter::state.warning_counter >= WarningThresholds::MAX_CONSECUTIVE_WARNINGS) {
-            noInterrupts(); ///< prevent interrupts while writing on system state
-            AirQualityMeter::state.last_co2_below_threshold_time_ms = millis();
-            AirQualityMeter::state.warning_counter = 0;
-            interrupts();
+        const unsigned long current_time_ms = millis();
+        // Read-modify-write in one window, so a press of the acknowledge button in between is not overwritten.
+        StateAccess::write([current_time_ms](AirQualityMeter::State &state) {
+            update_state_for_co2_level_not_acceptable(state, current_time_ms);
+        });
+    }
+
+    void reset_state(AirQualityMeter::State &state, const unsigned long current_time_ms) {
+        state.last_co2_below_threshold_time_ms = current_time_ms;
+        state.warning_counter = 0;
+    }
+
+    void update_state_for_co2_level_not_acceptable(AirQualityMeter::State &state, const unsigned long current_time_ms,
+                                                   const Policy &policy) {
+        const int warning_counter = state.warning_counter + 1;
+        if (warning_counter >= policy.max_consecutive_warnings) {
+            reset_state(state, current_time_ms);
             return;
         }
         // Wait until the next audio warning to prevent uninterrupted audio output.
-        AirQualityMeter::state.last_co2_below_threshold_time_ms =
-                AirQualityMeter::state.last_co2_below_threshold_time_ms +
-                WarningThresholds::WAITING_PERIOD_BETWEEN_WARNINGS_MS;
+        state.last_co2_below_threshold_time_ms =
+                (SystemTime::TimePoint(state.last_co2_below_threshold_time_ms) +
+                 policy.waiting_period_between_warnings).to_millis();
+        state.warning_counter = warning_counter;
     }
 }
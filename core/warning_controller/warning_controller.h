@@ -10,19 +10,41 @@
 #ifndef WARNING_CONTROLLER_H
 #define WARNING_CONTROLLER_H
 
+#include <system_time.h>
+#include <thresholds.h>
+#include <state.h>
+
 namespace WarningController {
+    /**
+     * @struct  Policy
+     * @brief   Parameters of the warning logic.
+     * @details The firmware uses `DEFAULT_POLICY` (the constants in thresholds.h). Host tools pass other policies to
+     *          the state transitions below, to evaluate them against recorded data.
+     */
+    struct Policy {
+        SystemTime::Duration max_time_above_co2_threshold; ///< Time above the threshold until the first warning.
+        SystemTime::Duration waiting_period_between_warnings; ///< Time between two warnings.
+        int max_consecutive_warnings; ///< Warnings after which the warning state is reset.
+    };
+
+    constexpr Policy DEFAULT_POLICY = {
+        WarningThresholds::MAX_TIME_ABOVE_CO2_THRESHOLD,
+        WarningThresholds::WAITING_PERIOD_BETWEEN_WARNINGS,
+        WarningThresholds::MAX_CONSECUTIVE_WARNINGS
+    }; ///< Policy of the firmware.
+
     /**
      * @brief Determines if an audio warning should be issued.
      *
      * @details This function evaluates whether an audio alert is necessary
      * based on the time elapsed since CO2 levels have been unacceptable.
      *
-     * @param time_since_co2_level_not_acceptable_ms Time in milliseconds that CO2
-     *                                              levels have been above the
-     *                                              acceptable threshold.
+     * @param time_since_co2_level_not_acceptable Time that CO2 levels have been above the acceptable threshold.
+     * @param policy Parameters of the warning logic.
      * @return `true` if an audio warning should be issued, `false` otherwise.
      */
-    bool is_audio_warning_to_be_issued(unsigned long time_since_co2_level_not_acceptable_ms);
+    bool is_audio_warning_to_be_issued(SystemTime::Duration time_since_co2_level_not_acceptable,
+                                       const Policy &policy = DEFAULT_POLICY);
 
     /**
      * @brief Resets the audio warning state variables.
@@ -39,6 +61,22 @@ namespace WarningController {
      * @param current_time_ms Current time in milliseconds (used for timing warnings and resets).
      */
     void update_for_co2_level_not_acceptable();
+
+    /**
+     * @brief Resets the warning state (state transition of `reset`).
+     * @param state The state to update.
+     * @param current_time_ms Current time in milliseconds.
+     */
+    void reset_state(AirQualityMeter::State &state, unsigned long current_time_ms);
+
+    /**
+     * @brief Updates the warning state after a warning (state transition of `update_for_co2_level_not_acceptable`).
+     * @param state The state to update.
+     * @param current_time_ms Current time in milliseconds.
+     * @param policy Parameters of the warning logic.
+     */
+    void update_state_for_co2_level_not_acceptable(AirQualityMeter::State &state, unsigned long current_time_ms,
+                                                   const Policy &policy = DEFAULT_POLICY);
 }
 
 #endif //WARNING_CONTROLLER_H
@@ -0,0 +1,124 @@
+/**
+ * @file watchdog.cpp
+ * @brief Implementation of the hardware watchdog and the detection of the reset cause.
+ */
+
+#include <avr/wdt.h>
+#include <watchdog.h>
+#include <not_blocking_time_handler.h>
+#include <ArduinoLog.h>
+#include <log_controller.h>
+
+namespace Watchdog {
+    constexpr uint8_t TIMEOUT = WDTO_8S; ///< Watchdog timeout (longest possible on all supported boards).
+
+#ifdef RSTCTRL_RSTFR
+    // megaAVR 0-series (e.g. Nano Every): reset flags in the reset controller.
+    constexpr uint8_t WATCHDOG_RESET_FLAG = RSTCTRL_WDRF_bm; ///< Reset flag of a watchdog reset.
+    constexpr uint8_t BROWN_OUT_RESET_FLAG = RSTCTRL_BORF_bm; ///< Reset flag of a brown-out reset.
+    constexpr uint8_t EXTERNAL_RESET_FLAG = RSTCTRL_EXTRF_bm; ///< Reset flag of an external reset.
+    constexpr uint8_t POWER_ON_RESET_FLAG = RSTCTRL_PORF_bm; ///< Reset flag of a power-on reset.
+#elif defined(__AVR__)
+    constexpr uint8_t WATCHDOG_RESET_FLAG = _BV(WDRF); ///< Reset flag of a watchdog reset.
+    constexpr uint8_t BROWN_OUT_RESET_FLAG = _BV(BORF); ///< Reset flag of a brown-out reset.
+    constexpr uint8_t EXTERNAL_RESET_FLAG = _BV(EXTRF); ///< Reset flag of an external reset.
+    constexpr uint8_t POWER_ON_RESET_FLAG = _BV(PORF); ///< Reset flag of a power-on reset.
+#endif
+
+    uint8_t reset_flags __attribute__((section(".noinit"))); ///< Reset flags (MCUSR or RSTCTRL.RSTFR) at start-up.
+    unsigned long last_feed_time_ms = 0UL; ///< Time (in ms) when the background task fed the watchdog last.
+
+    /**
+     * @brief   Feeds the watchdog as long as the time advances (background task).
+     */
+    void feed_if_time_advances();
+
+#ifdef __AVR__
+    /**
+     * @brief   Stores and clears the reset flags, and disables the watchdog.
+     * @details Runs in the `.init3` section, before the static variables are initialized. The watchdog stays enabled
+     *          after a watchdog reset (with the shortest timeout), so it has to be disabled before the (slow)
+     *          initialization. Optiboot clears MCUSR and passes its value in r2, which is used if MCUSR is empty.
+     *          The megaAVR 0-series has no bootloader, its flags are cleared by writing ones.
+     */
+    void capture_reset_flags() __attribute__((naked, used, section(".init3")));
+
+    void capture_reset_flags() {
+#ifdef RSTCTRL_RSTFR
+        reset_flags = RSTCTRL_RSTFR;
+        RSTCTRL_RSTFR = reset_flags;
+#else
+        reset_flags = MCUSR;
+        if (reset_flags == 0) {
+            __asm__ volatile("mov %0, r2\n" : "=r"(reset_flags));
+        }
+        MCUSR = 0;
+#endif
+        wdt_disable();
+    }
+#endif
+
+    void initialize() {
+        last_feed_time_ms = millis();
+        if (!NotBlockingTimeHandler::register_background_task(feed_if_time_advances)) {
+            // Without the feed during the waits, the watchdog would reset the MCU in the first long wait.
+            Log.errorln("%s %s", LogController::BACKGROUND_TASK_NOT_REGISTERED, LogController::WATCHDOG);
+            return;
+        }
+#if defined(ENABLE_FREERTOS) && defined(__AVR__)
+        // Arduino_FreeRTOS uses the watchdog interrupt as its tick, a reset timeout would replace it.
+#else
+        wdt_enable(TIMEOUT);
+#endif
+    }
+
+    void feed() {
+        wdt_reset();
+    }
+
+    ResetCause get_reset_cause() {
+#ifdef __AVR__
+        // Several flags can be set at once. A power-on is reported first: a cold start often sets the brown-out flag
+        // too (the supply voltage ramps up), and must never be mistaken for a warm restart. Otherwise the most
+        // specific flag is reported.
+        if (reset_flags & POWER_ON_RESET_FLAG) {
+            return POWER_ON;
+        }
+        if (reset_flags & WATCHDOG_RESET_FLAG) {
+            return WATCHDOG;
+        }
+        if (reset_flags & BROWN_OUT_RESET_FLAG) {
+            return BROWN_OUT;
+        }
+        if (reset_flags & EXTERNAL_RESET_FLAG) {
+            return EXTERNAL;
+        }
+        return UNKNOWN;
+#else
+        return POWER_ON;
+#endif
+    }
+
+    const char *get_reset_cause_name() {
+        switch (get_reset_cause()) {
+            case POWER_ON:
+                return "power-on";
+            case EXTERNAL:
+                return "external";
+            case BROWN_OUT:
+                return "brown-out";
+            case WATCHDOG:
+                return "watchdog";
+            default:
+                return "unknown";
+        }
+    }
+
+    void feed_if_time_advances() {
+        const unsigned long current_time_ms = millis();
+        if (current_time_ms != last_feed_time_ms) {
+            last_feed_time_ms = current_time_ms;
+            wdt_reset();
+        }
+    }
+}
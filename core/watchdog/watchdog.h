@@ -0,0 +1,55 @@
+/**
+ * @file watchdog.h
+ * @brief Header file for the hardware watchdog and the detection of the reset cause.
+ * @details The watchdog resets the MCU if the system hangs, e.g. in an endless loop with disabled interrupts or in an
+ *          interrupt service routine waiting for a time that never passes (`millis()` does not advance in an ISR).
+ *          The cause of the last reset is read from the MCU status register at start-up, before the bootloader's
+ *          value is lost, so a warm restart after a watchdog, brown-out or external reset can be told apart from a
+ *          power-on (see `WarmRestart`).
+ */
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <Arduino.h>
+
+namespace Watchdog {
+    /**
+     * @enum    ResetCause
+     * @brief   Cause of the last reset of the MCU.
+     */
+    enum ResetCause : uint8_t {
+        POWER_ON, ///< Power-on reset, i.e. the supply voltage was switched on.
+        EXTERNAL, ///< External reset via the reset pin (reset button, or the serial port was opened).
+        BROWN_OUT, ///< The supply voltage dropped below the brown-out level.
+        WATCHDOG, ///< The watchdog was not fed in time.
+        UNKNOWN ///< No reset flag was set (e.g. a jump to the reset vector).
+    };
+
+    /**
+     * @brief   Enables the watchdog with a timeout of 8 seconds.
+     * @details Registers a background task that feeds the watchdog while the system waits, but only as long as
+     *          `millis()` advances. A wait that never ends (e.g. in an ISR) therefore still resets the MCU.
+     *          Should be called early in the setup, the preheating of the sensor is covered by the background task.
+     */
+    void initialize();
+
+    /**
+     * @brief   Resets the watchdog timer. Has to be called at least every 8 seconds, e.g. once per loop.
+     */
+    void feed();
+
+    /**
+     * @brief   Returns the cause of the last reset.
+     * @details If several reset flags are set, a power-on wins: a cold start often sets the brown-out flag as well,
+     *          while the supply voltage ramps up.
+     */
+    ResetCause get_reset_cause();
+
+    /**
+     * @brief   Returns a short name of the cause of the last reset (for logging).
+     */
+    const char *get_reset_cause_name();
+}
+
+#endif //WATCHDOG_H
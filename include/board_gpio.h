@@ -0,0 +1,208 @@
+/**
+ * @file board_gpio.h
+ * @brief Compile-time resolved GPIO pins of the board profiles.
+ * @details A pin is a type that carries its Arduino pin number, its port and its bit. On the AVR, the port registers
+ *          are selected at compile time, so `write` and `read` compile to single `sbi`, `cbi` or `sbis` instructions
+ *          instead of the table lookups of `digitalWrite` and `digitalRead`. Ports outside of the bit-addressable I/O
+ *          space (ports H to L of the ATmega2560) are written with disabled interrupts, like `digitalWrite` does.
+ *          On the host, the Arduino API of the host HAL is used, so the simulated pin levels stay observable.
+ *
+ *          Usage: `using LedPin = BoardGpio::Pin<13, BoardGpio::Port::B, 5>; LedPin::set_output(); LedPin::write(true);`
+ */
+
+#ifndef BOARD_GPIO_H
+#define BOARD_GPIO_H
+
+#include <Arduino.h>
+#include <util/atomic.h>
+
+namespace BoardGpio {
+    /**
+     * @enum    Port
+     * @brief   GPIO ports of the AVR microcontrollers (there is no port I).
+     */
+    enum class Port : uint8_t { A, B, C, D, E, F, G, H, J, K, L };
+
+#ifdef __AVR__
+    /**
+     * @struct  PortRegisters
+     * @brief   Direction, output and input register of a port, specialized for the ports of the target MCU.
+     */
+    template<Port PORT>
+    struct PortRegisters;
+
+#ifdef VPORTA
+    // megaAVR 0-series (e.g. Nano Every): the virtual ports are mapped to the bit-addressable I/O space.
+#define BOARD_GPIO_PORT(letter) \
+    template<> \
+    struct PortRegisters<Port::letter> { \
+        static volatile uint8_t &direction() { return VPORT##letter.DIR; } \
+        static volatile uint8_t &output() { return VPORT##letter.OUT; } \
+        static volatile uint8_t &input() { return VPORT##letter.IN; } \
+    };
+#else
+    // Classic AVR (e.g. ATmega328P, ATmega2560).
+#define BOARD_GPIO_PORT(letter) \
+    template<> \
+    struct PortRegisters<Port::letter> { \
+        static volatile uint8_t &direction() { return DDR##letter; } \
+        static volatile uint8_t &output() { return PORT##letter; } \
+        static volatile uint8_t &input() { return PIN##letter; } \
+    };
+#endif
+
+#ifdef PORTA
+    BOARD_GPIO_PORT(A)
+#endif
+#ifdef PORTB
+    BOARD_GPIO_PORT(B)
+#endif
+#ifdef PORTC
+    BOARD_GPIO_PORT(C)
+#endif
+#ifdef PORTD
+    BOARD_GPIO_PORT(D)
+#endif
+#ifdef PORTE
+    BOARD_GPIO_PORT(E)
+#endif
+#ifdef PORTF
+    BOARD_GPIO_PORT(F)
+#endif
+#ifdef PORTG
+    BOARD_GPIO_PORT(G)
+#endif
+#ifdef PORTH
+    BOARD_GPIO_PORT(H)
+#endif
+#ifdef PORTJ
+    BOARD_GPIO_PORT(J)
+#endif
+#ifdef PORTK
+    BOARD_GPIO_PORT(K)
+#endif
+#ifdef PORTL
+    BOARD_GPIO_PORT(L)
+#endif
+#undef BOARD_GPIO_PORT
+
+    /**
+     * @brief   Returns true, if the register supports the single-cycle bit instructions (`sbi`, `cbi`), so a bit can
+     *          be changed without disabling interrupts. Folded to a constant by the compiler.
+     */
+    inline bool is_bit_addressable(volatile uint8_t &io_register) {
+        return reinterpret_cast<uintptr_t>(&io_register) < __SFR_OFFSET + 0x20;
+    }
+
+    /**
+     * @brief   Sets or clears a bit of a register, atomically if the register is not bit-addressable.
+     */
+    inline void write_bit(volatile uint8_t &io_register, const uint8_t mask, const bool is_set) {
+        if (is_bit_addressable(io_register)) {
+            if (is_set) {
+                io_register |= mask;
+            } else {
+                io_register &= static_cast<uint8_t>(~mask);
+            }
+            return;
+        }
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            if (is_set) {
+                io_register |= mask;
+            } else {
+                io_register &= static_cast<uint8_t>(~mask);
+            }
+        }
+    }
+#endif
+
+    /**
+     * @struct  Pin
+     * @brief   A digital pin resolved at compile time.
+     * @tparam  ARDUINO_PIN Arduino pin number (used by libraries and on the host).
+     * @tparam  PORT Port of the pin.
+     * @tparam  BIT Bit of the pin in the port.
+     */
+    template<uint8_t ARDUINO_PIN, Port PORT, uint8_t BIT>
+    struct Pin {
+        static constexpr uint8_t NUMBER = ARDUINO_PIN; ///< Arduino pin number.
+        static constexpr bool IS_CONNECTED = true; ///< True, if the signal is wired on this board.
+
+#ifdef __AVR__
+        static constexpr uint8_t MASK = static_cast<uint8_t>(1U << BIT); ///< Bit mask of the pin in the port.
+
+        static void set_output() {
+            write_bit(PortRegisters<PORT>::direction(), MASK, true);
+        }
+
+        static void set_input() {
+            write_bit(PortRegisters<PORT>::direction(), MASK, false);
+            write_bit(PortRegisters<PORT>::output(), MASK, false); // no pull-up, as `pinMode(pin, INPUT)`
+        }
+
+        static void write(const bool is_high) {
+            write_bit(PortRegisters<PORT>::output(), MASK, is_high);
+        }
+
+        static bool read() {
+            return (PortRegisters<PORT>::input() & MASK) != 0;
+        }
+#else
+        static void set_output() {
+            pinMode(ARDUINO_PIN, OUTPUT);
+        }
+
+        static void set_input() {
+            pinMode(ARDUINO_PIN, INPUT);
+        }
+
+        static void write(const bool is_high) {
+            digitalWrite(ARDUINO_PIN, is_high ? HIGH : LOW);
+        }
+
+        static bool read() {
+            return digitalRead(ARDUINO_PIN) == HIGH;
+        }
+#endif
+    };
+
+    /**
+     * @struct  InterruptPin
+     * @brief   A digital pin with an external interrupt, the interrupt number is resolved at compile time.
+     */
+    template<uint8_t ARDUINO_PIN, Port PORT, uint8_t BIT>
+    struct InterruptPin : Pin<ARDUINO_PIN, PORT, BIT> {
+        static constexpr int INTERRUPT = digitalPinToInterrupt(ARDUINO_PIN); ///< Number for `attachInterrupt`.
+        static_assert(INTERRUPT >= 0, "The pin has no external interrupt on this board.");
+
+        static void attach_interrupt(void (*interrupt_service_routine)(), const int mode) {
+            attachInterrupt(static_cast<uint8_t>(INTERRUPT), interrupt_service_routine, mode);
+        }
+    };
+
+    /**
+     * @struct  UnconnectedPin
+     * @brief   Placeholder of a signal that is not wired on a board. All operations do nothing.
+     */
+    struct UnconnectedPin {
+        static constexpr bool IS_CONNECTED = false; ///< True, if the signal is wired on this board.
+
+        static void set_output() {
+        }
+
+        static void set_input() {
+        }
+
+        static void write(bool) {
+        }
+
+        static bool read() {
+            return false;
+        }
+
+        static void attach_interrupt(void (*)(), int) {
+        }
+    };
+}
+
+#endif //BOARD_GPIO_H
@@ -0,0 +1,66 @@
+/**
+ * @file board_mega2560.h
+ * @brief Board profile of the Arduino Mega 2560 (reference board, see the wiring diagram).
+ */
+
+#ifndef BOARD_MEGA2560_H
+#define BOARD_MEGA2560_H
+
+#include <board_gpio.h>
+
+namespace AcknowledgeButton {
+    // Pin configuration for the Acknowledge Button
+    using ButtonPin = BoardGpio::InterruptPin<2, BoardGpio::Port::E, 4>; ///< Interrupt functionality (INT4_vect)
+}
+
+namespace MuteButton {
+    using ButtonPin = BoardGpio::InterruptPin<3, BoardGpio::Port::E, 5>; ///< Interrupt functionality (INT5_vect)
+}
+
+namespace PageButton {
+    using ButtonPin = BoardGpio::InterruptPin<20, BoardGpio::Port::D, 1>; ///< Interrupt functionality (INT1_vect)
+}
+
+namespace Co2SensorController {
+    // Pin configuration for the CO2 Sensor: MH-Z19B Infrared CO2 Sensor Module.
+    constexpr uint8_t PWM_PIN = 4; ///< PWM pin for CO2 sensor
+    // Pins of further sensors are added here and registered in `co2_sensor_controller.cpp`.
+}
+
+namespace DisplayController {
+    // Pin configuration for the Display: LCD1602 Module (with pin header)
+    constexpr uint8_t RS_PIN = 7; ///< LCD Register Select pin
+    constexpr uint8_t EN_PIN = 8; ///< LCD Enable pin
+    constexpr uint8_t D4_PIN = 9; ///< LCD Data pin 4
+    constexpr uint8_t D5_PIN = 10; ///< LCD Data pin 5
+    constexpr uint8_t D6_PIN = 11; ///< LCD Data pin 6
+    constexpr uint8_t D7_PIN = 12; ///< LCD Data pin 7
+}
+
+namespace AudioController {
+    // Pin configuration for the MP3 Module: Gravity UART MP3 Voice Module
+    constexpr uint8_t MP3_T = 14; ///< MP3 Modul Transmit
+    constexpr uint8_t MP3_R = 15; ///< MP3 Modul Receive
+}
+
+namespace LedArray {
+    // Pin configuration for the LEDs
+    using Green1Pin = BoardGpio::Pin<22, BoardGpio::Port::A, 0>; ///< LED to indicate high air quality
+    using Green2Pin = BoardGpio::Pin<24, BoardGpio::Port::A, 2>; ///< LED to indicate high or medium air quality
+    using Yellow1Pin = BoardGpio::Pin<26, BoardGpio::Port::A, 4>; ///< LED to indicate medium or moderate air quality
+    using Yellow2Pin = BoardGpio::Pin<28, BoardGpio::Port::A, 6>; ///< LED to indicate moderate air quality
+    using Red1Pin = BoardGpio::Pin<30, BoardGpio::Port::C, 7>; ///< LED to indicate moderate or poor air quality
+    using Red2Pin = BoardGpio::Pin<32, BoardGpio::Port::C, 5>; ///< LED to indicate poor air quality
+}
+
+namespace MuteIndicator {
+    // Pin configuration for the Mute indicator LED
+    using BluePin = BoardGpio::Pin<34, BoardGpio::Port::C, 3>; ///< LED to indicate the System is muted
+}
+
+namespace ModbusSlave {
+    // Pin configuration for the RS-485 transceiver of the Modbus slave on USART1 (pin 18 TX1, pin 19 RX1)
+    using DriverEnablePin = BoardGpio::Pin<6, BoardGpio::Port::H, 3>; ///< Driver enable (DE and /RE tied together)
+}
+
+#endif //BOARD_MEGA2560_H
@@ -0,0 +1,67 @@
+/**
+ * @file board_nano_every.h
+ * @brief Board profile of the Arduino Nano Every (ATmega4809).
+ * @details The display, the sensor, the MP3 module and the acknowledge and mute buttons use the same pin numbers as on
+ *          the Mega 2560. The LEDs are moved to the remaining pins. Every pin has an external interrupt, so the page
+ *          button is connected to pin 20 (A6), as on the Mega 2560.
+ */
+
+#ifndef BOARD_NANO_EVERY_H
+#define BOARD_NANO_EVERY_H
+
+#include <board_gpio.h>
+
+namespace AcknowledgeButton {
+    // Pin configuration for the Acknowledge Button
+    using ButtonPin = BoardGpio::InterruptPin<2, BoardGpio::Port::A, 0>; ///< Interrupt functionality (PORTA_PORT_vect)
+}
+
+namespace MuteButton {
+    using ButtonPin = BoardGpio::InterruptPin<3, BoardGpio::Port::F, 5>; ///< Interrupt functionality (PORTF_PORT_vect)
+}
+
+namespace PageButton {
+    using ButtonPin = BoardGpio::InterruptPin<20, BoardGpio::Port::D, 4>; ///< Interrupt functionality (A6, PORTD_PORT_vect)
+}
+
+namespace Co2SensorController {
+    // Pin configuration for the CO2 Sensor: MH-Z19B Infrared CO2 Sensor Module.
+    constexpr uint8_t PWM_PIN = 4; ///< PWM pin for CO2 sensor
+}
+
+namespace DisplayController {
+    // Pin configuration for the Display: LCD1602 Module (with pin header)
+    constexpr uint8_t RS_PIN = 7; ///< LCD Register Select pin
+    constexpr uint8_t EN_PIN = 8; ///< LCD Enable pin
+    constexpr uint8_t D4_PIN = 9; ///< LCD Data pin 4
+    constexpr uint8_t D5_PIN = 10; ///< LCD Data pin 5
+    constexpr uint8_t D6_PIN = 11; ///< LCD Data pin 6
+    constexpr uint8_t D7_PIN = 12; ///< LCD Data pin 7
+}
+
+namespace AudioController {
+    // Pin configuration for the MP3 Module: Gravity UART MP3 Voice Module
+    constexpr uint8_t MP3_T = 14; ///< MP3 Modul Transmit (A0)
+    constexpr uint8_t MP3_R = 15; ///< MP3 Modul Receive (A1)
+}
+
+namespace LedArray {
+    // Pin configuration for the LEDs
+    using Green1Pin = BoardGpio::Pin<5, BoardGpio::Port::B, 2>; ///< LED to indicate high air quality
+    using Green2Pin = BoardGpio::Pin<6, BoardGpio::Port::F, 4>; ///< LED to indicate high or medium air quality
+    using Yellow1Pin = BoardGpio::Pin<13, BoardGpio::Port::E, 2>; ///< LED to indicate medium or moderate air quality
+    using Yellow2Pin = BoardGpio::Pin<16, BoardGpio::Port::D, 1>; ///< LED to indicate moderate air quality (A2)
+    using Red1Pin = BoardGpio::Pin<17, BoardGpio::Port::D, 0>; ///< LED to indicate moderate or poor air quality (A3)
+    using Red2Pin = BoardGpio::Pin<18, BoardGpio::Port::F, 2>; ///< LED to indicate poor air quality (A4)
+}
+
+namespace MuteIndicator {
+    // Pin configuration for the Mute indicator LED
+    using BluePin = BoardGpio::Pin<19, BoardGpio::Port::F, 3>; ///< LED to indicate the System is muted (A5)
+}
+
+namespace ModbusSlave {
+    using DriverEnablePin = BoardGpio::UnconnectedPin; ///< The Modbus slave is only implemented for the ATmega2560
+}
+
+#endif //BOARD_NANO_EVERY_H
@@ -3,13 +3,33 @@
    * @brief LED indicator states for air quality and error patterns.
    *
    * @details This file defines the mapping of LED states to air quality categories or
-   * sensor errors.
+   * sensor errors, and the keyframe animations played by the LED array (acknowledgement, sensor error).
    */
 
 #ifndef LED_PATTERNS_H
 #define LED_PATTERNS_H
 
+#include <stdint.h>
+
 namespace LedPattern {
+    /**
+     * @enum    Led
+     * @brief   LEDs driven by the LED array (the six air quality LEDs and the mute LED).
+     */
+    enum Led : uint8_t {
+        GREEN_LED_1,
+        GREEN_LED_2,
+        YELLOW_LED_1,
+        YELLOW_LED_2,
+        RED_LED_1,
+        RED_LED_2,
+        MUTE_LED,
+        NUMBER_OF_LEDS
+    };
+
+    constexpr uint8_t MAX_BRIGHTNESS = 255; ///< Brightness of a fully lit LED (perceived brightness, gamma corrected).
+    constexpr uint8_t AIR_QUALITY_LEDS = 0x3F; ///< Mask of the six air quality LEDs (bit = `Led`).
+
     /**
      * @struct  Pattern
      * @brief   Represents the state of LED indicators used to display air quality levels.
@@ -25,6 +45,28 @@ namespace LedPattern {
         bool is_red_led_1_on; ///< Indicates if the first red LED is ON (true) or OFF (false).
         bool is_red_led_2_on; ///< Indicates if the second red LED is ON (true) or OFF (false).
     };
+
+    /**
+     * @struct  Keyframe
+     * @brief   Brightness of each LED, shown for a time.
+     */
+    struct Keyframe {
+        uint8_t brightness[NUMBER_OF_LEDS]; ///< Brightness of each LED (0 to `MAX_BRIGHTNESS`).
+        uint16_t duration_ms; ///< Time the keyframe is shown (rounded down to 10 ms, at least 10 ms).
+    };
+
+    /**
+     * @struct  Animation
+     * @brief   Sequence of keyframes played in the background by the LED array.
+     * @details The animation only drives the LEDs in its mask, the other LEDs keep showing the pattern and the mute
+     *          state.
+     */
+    struct Animation {
+        const Keyframe *keyframes; ///< Keyframes in playing order.
+        uint8_t number_of_keyframes; ///< Number of keyframes.
+        uint8_t led_mask; ///< LEDs driven by the animation (bit = `Led`).
+        bool is_looped; ///< True, if the animation restarts after the last keyframe (until stopped).
+    };
 }
 
 namespace LedAirQualityPattern {
@@ -47,20 +89,34 @@ namespace LedAirQualityPattern {
 }
 
 namespace LedInfoPattern {
-    constexpr LedPattern::Pattern INFO_PATTERN_SEQUENCE[] = {
-        {true, false,false,false,false,false},
-        {false, true, false, false, false, false},
-        {false, false, true, false, false, false},
-        {false, false, false, true, false, false},
-        {false, false, false, false, true, false},
-        {false, false, false, false, false, true}
-    }; ///< Sequence of LED patterns to show consecutively.
+    constexpr LedPattern::Keyframe ACKNOWLEDGE_KEYFRAMES[] = {
+        {{255, 0, 0, 0, 0, 0, 0}, 100},
+        {{128, 255, 0, 0, 0, 0, 0}, 100},
+        {{64, 128, 255, 0, 0, 0, 0}, 100},
+        {{0, 64, 128, 255, 0, 0, 0}, 100},
+        {{0, 0, 64, 128, 255, 0, 0}, 100},
+        {{0, 0, 0, 64, 128, 255, 0}, 100},
+        {{0, 0, 0, 0, 64, 128, 0}, 100},
+        {{0, 0, 0, 0, 0, 64, 0}, 100}
+    }; ///< Light running from the first green to the second red LED, with a fading trail.
+
+    constexpr LedPattern::Animation ACKNOWLEDGE = {
+        ACKNOWLEDGE_KEYFRAMES, sizeof(ACKNOWLEDGE_KEYFRAMES) / sizeof(ACKNOWLEDGE_KEYFRAMES[0]),
+        LedPattern::AIR_QUALITY_LEDS, false
+    }; ///< Played once, when the acknowledge button is pressed.
 }
 
 namespace LedErrorPatterns {
-    // LED patterns to represent errors.
+    // LED animations to represent errors.
+
+    constexpr LedPattern::Keyframe SENSOR_ERROR_KEYFRAMES[] = {
+        {{255, 255, 255, 255, 255, 255, 0}, 500},
+        {{0, 0, 0, 0, 0, 0, 0}, 500}
+    }; ///< All air quality LEDs blinking at 1 Hz.
 
-    constexpr LedPattern::Pattern SENSOR_ERROR_MEASUREMENT_NOT_VALID = {true, true, true, true, true, true};
-    ///< LED error pattern to represent, that the measurement is not valid.
+    constexpr LedPattern::Animation SENSOR_ERROR_MEASUREMENT_NOT_VALID = {
+        SENSOR_ERROR_KEYFRAMES, sizeof(SENSOR_ERROR_KEYFRAMES) / sizeof(SENSOR_ERROR_KEYFRAMES[0]),
+        LedPattern::AIR_QUALITY_LEDS, true
+    }; ///< LED error animation to represent, that the measurement is not valid (until the next valid measurement).
 }
 #endif //LED_PATTERNS_H
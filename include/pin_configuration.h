@@ -1,6 +1,15 @@
 /**
  * @file pin_configuration.h
- * @brief This file contains the pin configuration for the Arduino Mega 2560.
+ * @brief This file selects the pin configuration (board profile) of the target board.
+ * @details The profile is selected by the MCU of the PlatformIO environment:
+ *           - ATmega2560: Arduino Mega 2560 (board_mega2560.h), also used by the host tools.
+ *           - ATmega4809: Arduino Nano Every (board_nano_every.h).
+ *
+ *          A profile maps each signal to its Arduino pin number and, for the pins driven by the firmware itself, to a
+ *          `BoardGpio` pin type with its port and bit, so these pins are accessed without runtime lookups.
+ *
+ *          The Uno and the Nano (ATmega328P) are not supported: the static SRAM of the firmware alone exceeds their
+ *          2 KB.
  */
 
 #ifndef PIN_CONFIGURATION_H
@@ -8,50 +17,12 @@
 
 #include <Arduino.h>
 
-namespace AcknowledgeButton {
-    // Pin configuration for the Acknowledge Button
-    constexpr uint8_t DIGITAL_PIN = 2; ///< Interrupt functionality (Int0)
-}
-
-namespace MuteButton {
-    constexpr uint8_t DIGITAL_PIN = 3; ///< Interrupt functionality (Int1)
-}
-
-namespace Co2SensorController {
-    // Pin configuration for the CO2 Sensor: MH-Z19B Infrared CO2 Sensor Module.
-    constexpr uint8_t PWM_PIN = 4; ///< PWM pin for CO2 sensor
-}
-
-namespace DisplayController {
-    // Pin configuration for the Display: LCD1602 Module (with pin header)
-    constexpr uint8_t RS_PIN = 7; ///< LCD Register Select pin
-    constexpr uint8_t EN_PIN = 8; ///< LCD Enable pin
-    constexpr uint8_t D4_PIN = 9; ///< LCD Data pin 4
-    constexpr uint8_t D5_PIN = 10; ///< LCD Data pin 5
-    constexpr uint8_t D6_PIN = 11; ///< LCD Data pin 6
-    constexpr uint8_t D7_PIN = 12; ///< LCD Data pin 7
-}
-
-
-namespace AudioController {
-    // Pin configuration for the MP3 Module: Gravity UART MP3 Voice Module
-    constexpr uint8_t MP3_T = 14; ///< MP3 Modul Transmit
-    constexpr uint8_t MP3_R = 15; ///< MP3 Modul Receive
-}
-
-namespace LedArray {
-    // Pin configuration for the LEDs
-    constexpr uint8_t GREEN_1_PIN = 22; ///< LED to indicate high air quality
-    constexpr uint8_t GREEN_2_PIN = 24; ///< LED to indicate high or medium air quality
-    constexpr uint8_t YELLOW_1_PIN = 26; ///< LED to indicate medium or moderate air quality
-    constexpr uint8_t YELLOW_2_PIN = 28; ///< LED to indicate moderate air quality
-    constexpr uint8_t RED_1_PIN = 30; ///< LED to indicate moderate or poor air quality
-    constexpr uint8_t RED_2_PIN = 32; ///< LED to indicate poor air quality
-}
-
-namespace MuteIndicator {
-    // Pin configuration for the Mute indicator LED
-    constexpr uint8_t BLUE_PIN = 34; ///< LED to indicate the System is muted
-}
+#if defined(__AVR_ATmega2560__) || !defined(__AVR__)
+#include <board_mega2560.h>
+#elif defined(__AVR_ATmega4809__)
+#include <board_nano_every.h>
+#else
+#error "No board profile for this MCU, add one to pin_configuration.h."
+#endif
 
 #endif //PIN_CONFIGURATION_H
@@ -4,7 +4,8 @@
    *
    * @details This file contains the `State` structure used to track time-dependent and
    * warning-related system metrics, along with a global state instance to be shared
-   * across the application.
+   * across the application. The state is shared with the interrupt service routines, read and write it
+   * only through `StateAccess` (see state_access.h), which keeps the accesses consistent.
    */
 
 #ifndef STATE_H
@@ -13,10 +14,10 @@
 
 namespace AirQualityMeter {
     struct State {
-        volatile unsigned long last_co2_below_threshold_time_ms; ///< Last time (in ms) when CO2 was below threshold.
-        volatile int warning_counter; ///< Counter tracking the number of warnings triggered.
-        volatile unsigned long last_co2_sensor_used_time_stamp_ms; ///< Last time (in ms) the CO2 sensor was activated.
-        volatile bool is_system_muted; ///< True if the system is muted.
+        unsigned long last_co2_below_threshold_time_ms; ///< Last time (in ms) when CO2 was below threshold.
+        int warning_counter; ///< Counter tracking the number of warnings triggered.
+        unsigned long last_co2_sensor_used_time_stamp_ms; ///< Last time (in ms) the CO2 sensor was activated.
+        bool is_system_muted; ///< True if the system is muted.
     };
 
     extern State state; ///< Global state instance to manage runtime metrics and warnings.
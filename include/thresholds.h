@@ -9,6 +9,8 @@
 #ifndef THRESHOLDS_H
 #define THRESHOLDS_H
 
+#include <system_time.h>
+
 namespace CO2Thresholds {
     constexpr int HIGH_QUALITY_PPM = 800;
     ///< Upper CO2 threshold (less than or equal to) for high indoor air quality (IDA 1 DIN EN 13779)
@@ -35,10 +37,10 @@ namespace CO2Thresholds {
 namespace WarningThresholds {
     constexpr int MAX_CONSECUTIVE_WARNINGS = 5; ///< Max consecutive audio warnings before auto reset
 
-    constexpr unsigned int WAITING_PERIOD_BETWEEN_WARNINGS_MS = 10000; ///< Time period between two warnings (milliseconds)
+    constexpr SystemTime::Duration WAITING_PERIOD_BETWEEN_WARNINGS = SystemTime::seconds(10);
+    ///< Time period between two warnings.
 
-    constexpr unsigned int MAX_TIME_ABOVE_CO2_THRESHOLD_MS = 60000;
-    ///< The maximum duration (in milliseconds) for CO2 levels to remain above the threshold
-    ///< before triggering a warning.
+    constexpr SystemTime::Duration MAX_TIME_ABOVE_CO2_THRESHOLD = SystemTime::seconds(60);
+    ///< The maximum duration for CO2 levels to remain above the threshold before triggering a warning.
 }
 #endif //THRESHOLDS_H
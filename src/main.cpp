@@ -12,80 +12,119 @@
 #include <ArduinoLog.h>
 #include <log_controller.h>
 #include <state.h>
-#include <acknowledge_button.h>
-#include <mute_button.h>
-#include <mute_indicator.h>
+#include <state_access.h>
 #include <co2_sensor_controller.h>
 #include <led_array.h>
-#include <display_controller.h>
-#include <display_row_formatter.h>
+#include <display_pages.h>
 #include <air_quality.h>
 #include <measurement_interpreter.h>
+#include <measurement_filter.h>
+#include <measurement_statistics.h>
+#include <ventilation_estimator.h>
+#include <history_log.h>
+#include <history_transfer.h>
 #include <audio_controller.h>
 #include <warning_controller.h>
+#include <acknowledge_button.h>
+#include <mute_button.h>
+#include <page_button.h>
 #include <co2_level_time_tracker.h>
+#include <telemetry_controller.h>
+#include <modbus_slave.h>
+#include <watchdog.h>
+#include <warm_restart.h>
+#include <boot_sequence.h>
+#include <boot_timeline.h>
+#include <rtos_firmware.h>
 
 namespace AirQualityMeter {
     State state = {0, 0, 0, false}; ///< Holds the system's current state variables.
     constexpr uint8_t LOG_LEVEL = LOG_LEVEL_VERBOSE; ///< Default log level for the air quality meter system.
 }
 
+/**
+ * @brief   Shows the readings restored after a warm restart on the display pages (history) and the LED array.
+ */
+void show_restored_measurements() {
+    for (uint8_t i = 0; i < WarmRestart::get_number_of_measurements(); i++) {
+        const int co2_measurement_ppm = WarmRestart::get_measurement_ppm(i);
+        const AirQuality::Level air_quality_level = MeasurementInterpreter::get_air_quality_level(co2_measurement_ppm);
+        DisplayPages::set_measurement(co2_measurement_ppm, air_quality_level.description);
+        LedArray::output(air_quality_level.led_indicator);
+    }
+}
+
 /**
  * @brief   Sets up and initializes all system components.
  *
  * @details This function is executed once during system startup to initialize all required controllers and hardware modules.
  *          It performs the following actions:
- *           - Initializes the logging controller with the system's log level, logs a welcome message, and registers its own initialization.
- *           - Initializes the display controller and logs its successful setup.
- *           - Initializes the LED array hardware and logs its successful setup.
- *           - Initializes the CO2 sensor controller and logs its successful setup.
- *           - Initializes the audio controller and logs its successful setup.
- *           - Sets up the acknowledge button and logs its successful initialization.
- *           - Logs a message indicating that the system is ready after all components are successfully initialized.
+ *           - Restores the system state from the snapshot, if the sensor kept running during the reset (warm restart).
+ *           - Runs the boot sequence: initializes the logging controller (logs a welcome message and the reset cause),
+ *             the watchdog, the history log, the display controller (shows the welcome message), the CO2 sensor
+ *             controller (waits for the sensor warm-up), the LED array, the audio controller, the mute indicator, the
+ *             buttons and the display pages. Each module is initialized as soon as the modules it depends on are ready, so the independent
+ *             modules are set up during the sensor warm-up. After a warm restart, the welcome message and the sensor
+ *             warm-up are skipped.
+ *           - After a warm restart, shows the restored readings on the display pages and the LED array at once.
+ *           - Logs the boot timeline, starts the Modbus slave (if enabled) and logs a message indicating that the
+ *             system is ready.
  */
 void setup() {
-    LogController::initialize(AirQualityMeter::LOG_LEVEL);
-    LogController::log_welcome_message();
-    LogController::log_initialization(LogController::LOG_CONTROLLER);
-
-    DisplayController::initialize();
-    LogController::log_initialization(LogController::DISPLAY_CONTROLLER);
-
-    LedArray::initialize();
-    LogController::log_initialization(LogController::LED_ARRAY);
-
-    Co2SensorController::initialize();
-    LogController::log_initialization(LogController::SENSOR_CONTROLLER);
-
-    AudioController::initialize();
-    LogController::log_initialization(LogController::AUDIO_CONTROLLER);
-
-    MuteIndicator::initialize();
-    LogController::log_initialization(LogController::MUTE_INDICATOR);
+    const bool is_warm_restart = WarmRestart::restore();
 
-    AcknowledgeButton::initialize();
-    LogController::log_initialization(LogController::ACKNOWLEDGE_BUTTON);
+    BootSequence::run(AirQualityMeter::LOG_LEVEL, is_warm_restart);
 
-    MuteButton::initialize();
-    LogController::log_initialization(LogController::MUTE_BUTTON);
-
-    AirQualityMeter::state.last_co2_below_threshold_time_ms = millis();
+    if (is_warm_restart) {
+        show_restored_measurements();
+    } else {
+        const unsigned long current_time_ms = millis();
+        StateAccess::write([current_time_ms](AirQualityMeter::State &state) {
+            state.last_co2_below_threshold_time_ms = current_time_ms;
+        });
+    }
     LogController::log_current_state();
+    LogController::log_boot_timeline();
+    ModbusSlave::initialize();
 
     Log.noticeln(LogController::SYSTEM_READY);
+#ifdef ENABLE_FREERTOS
+    RtosFirmware::start();
+#endif
+}
+
+#ifdef ENABLE_FREERTOS
+/**
+ * @brief   Runs in the idle task of FreeRTOS, the work of the main loop is done by the tasks (see rtos_firmware.h).
+ */
+void loop() {
 }
+#else
 
 /**
  * @brief   Executes the main operational loop for the system.
  *
  * @details This function manages the continuous monitoring and response cycle performed by the system. It executes during
  *          runtime to gather sensor data, interpret the measurements, and update outputs accordingly. The actions include:
+ *           - Feeding the watchdog.
+ *           - Measuring the loop timing and sending a telemetry frame, if due.
+ *           - Serving a history download, if a host requested one on the serial link.
+ *           - Handling the button presses accepted by the interrupt service routines since the last iteration
+ *             (acknowledge animation, mute indicator and logging, which are kept out of the interrupts).
  *           - Logging the start of the loop iteration.
  *           - Retrieving the current system timestamp and logging it.
  *           - Obtaining the CO2 measurement in parts per million (ppm) from the sensor and checking for errors (disconnection or invalid measurement).
+ *           - Skipping the rest of the iteration, if the reading was faulty while a sensor is still valid (no new
+ *             sample for the filter, the statistics and the history).
+ *           - Recording the time to the first valid reading (once).
+ *           - Filtering the measurement to reject single outliers (spikes).
  *           - Determining the air quality level corresponding to the CO2 measurement and logging its description.
- *           - Formatting the CO2 data into a display row for output to the system's display controller.
- *           - Updating the visual interface with CO2 measurement data and air quality information.
+ *           - Adding the measurement to the statistics of the last hour (average, minimum, maximum, trend), to the
+ *             estimation of the air exchange rate (CO2 decay) and to the long-term history in the EEPROM.
+ *           - Updating the Modbus register table with the measurement, the system state and the statistics.
+ *           - Saving the measurement and the system state in the snapshot for a warm restart.
+ *           - Updating the display pages with CO2 measurement data and air quality information; the pages are
+ *             rendered incrementally while the system waits for the next measurement.
  *           - Activating the corresponding LED indicators based on the detected air quality level.
  *           - Checking if the air quality is within acceptable limits and resetting the warning state if conditions are safe.
  *           - Calculating the elapsed time since the air quality level was deemed unacceptable.
@@ -94,25 +133,49 @@ void setup() {
  *           - Logging the end of the main loop iteration.
  */
 void loop() {
+    Watchdog::feed();
+    TelemetryController::mark_loop_start();
+    TelemetryController::send_frame_if_due();
+    HistoryTransfer::poll();
+    AcknowledgeButton::handle_press();
+    MuteButton::handle_press();
+    PageButton::handle_press();
     LogController::log_loop_start();
 
-    const int current_co2_measurement_ppm = Co2SensorController::get_measurement_in_ppm();
-    TRACE_LN_d(current_co2_measurement_ppm);
+    const int raw_co2_measurement_ppm = Co2SensorController::get_measurement_in_ppm();
+    TRACE_LN_d(raw_co2_measurement_ppm);
 
     if (
-        current_co2_measurement_ppm == Co2SensorController::MEASUREMENT_NOT_VALID_ERROR
+        raw_co2_measurement_ppm == Co2SensorController::MEASUREMENT_NOT_VALID_ERROR
     ) {
+        MeasurementFilter::reset();
+        TelemetryController::set_measurement_not_valid();
+        ModbusSlave::set_measurement_not_valid();
+        return;
+    }
+    if (raw_co2_measurement_ppm == Co2SensorController::NO_NEW_MEASUREMENT) {
+        LogController::log_loop_end();
         return;
     }
+    if (BootTimeline::mark_first_reading()) {
+        LogController::log_time_to_first_reading();
+    }
+    const int current_co2_measurement_ppm = MeasurementFilter::filter(raw_co2_measurement_ppm, millis());
+    TRACE_LN_d(current_co2_measurement_ppm);
     const AirQuality::Level current_air_quality_level = MeasurementInterpreter::get_air_quality_level(
         current_co2_measurement_ppm);
     TRACE_LN_s(current_air_quality_level.description);
+    const uint8_t current_air_quality_level_index = MeasurementInterpreter::get_air_quality_level_index(
+        current_co2_measurement_ppm);
+    TelemetryController::set_measurement(current_co2_measurement_ppm, current_air_quality_level_index);
 
-    char co2_display_row[DisplayRowFormatter::BUFFER_SIZE];
-    DisplayRowFormatter::set_co2_display_row(co2_display_row, current_co2_measurement_ppm);
-    TRACE_LN_s(co2_display_row);
+    MeasurementStatistics::add(current_co2_measurement_ppm, millis());
+    VentilationEstimator::add(current_co2_measurement_ppm, millis());
+    HistoryLog::add(current_co2_measurement_ppm, millis());
+    ModbusSlave::set_measurement(current_co2_measurement_ppm, current_air_quality_level_index);
+    WarmRestart::save(current_co2_measurement_ppm);
 
-    DisplayController::output(co2_display_row, current_air_quality_level.description);
+    DisplayPages::set_measurement(current_co2_measurement_ppm, current_air_quality_level.description);
     Log.verboseln(LogController::DISPLAY_UPDATED);
 
     LedArray::output(current_air_quality_level.led_indicator);
@@ -126,16 +189,17 @@ void loop() {
         LogController::log_loop_end();
         return;
     }
-    const unsigned long time_since_co2_level_not_acceptable_ms =
-            Co2LevelTimeTracker::get_time_since_co2_level_not_acceptable_ms();
-    TRACE_LN_u(time_since_co2_level_not_acceptable_ms);
+    const SystemTime::Duration time_since_co2_level_not_acceptable =
+            Co2LevelTimeTracker::get_time_since_co2_level_not_acceptable();
+    TRACE_LN_u(time_since_co2_level_not_acceptable.to_milliseconds());
 
     const bool is_audio_warning_to_be_issued = WarningController::is_audio_warning_to_be_issued(
-        time_since_co2_level_not_acceptable_ms);
+        time_since_co2_level_not_acceptable);
     TRACE_LN_T(is_audio_warning_to_be_issued);
-    TRACE_LN_T(AirQualityMeter::state.is_system_muted);
+    const bool is_system_muted = StateAccess::read().is_system_muted;
+    TRACE_LN_T(is_system_muted);
 
-    if (is_audio_warning_to_be_issued && !AirQualityMeter::state.is_system_muted) {
+    if (is_audio_warning_to_be_issued && !is_system_muted) {
         AudioController::issue_warning();
         Log.verboseln(LogController::AUDIO_WARNING_ISSUED);
 
@@ -144,3 +208,4 @@ void loop() {
     }
     Log.noticeln(LogController::LOOP_END);
 }
+#endif
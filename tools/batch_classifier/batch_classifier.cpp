@@ -0,0 +1,166 @@
+/**
+ * @file batch_classifier.cpp
+ * @brief Scalar, SSE2 and AVX2 implementations of the batch classification.
+ * @details The vector implementations are compiled with the `target` attribute, so the tools do not need to be built
+ *          with `-mavx2` and still run on CPUs without AVX2.
+ */
+
+#include "batch_classifier.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAS_X86_VECTOR_EXTENSIONS
+#endif
+
+namespace BatchClassifier {
+    constexpr uint8_t NUMBER_OF_THRESHOLDS = MeasurementInterpreter::NUMBER_OF_LEVELS - 1;
+    ///< Thresholds compared per reading.
+    constexpr const char *NAMES[NUMBER_OF_IMPLEMENTATIONS] = {"scalar", "sse2", "avx2"}; ///< Names of the implementations.
+
+    /**
+     * @brief   Classifies the readings one by one with the firmware function.
+     */
+    void classify_scalar(const int *co2_measurements_ppm, uint8_t *level_indices, size_t count,
+                         const MeasurementInterpreter::Thresholds &thresholds);
+
+#ifdef HAS_X86_VECTOR_EXTENSIONS
+    /**
+     * @brief   Classifies 16 readings per step with SSE2, the rest with `classify_scalar`.
+     */
+    __attribute__((target("sse2")))
+    void classify_sse2(const int *co2_measurements_ppm, uint8_t *level_indices, size_t count,
+                       const MeasurementInterpreter::Thresholds &thresholds);
+
+    /**
+     * @brief   Returns the level indices of 4 readings (number of thresholds below each reading).
+     */
+    __attribute__((target("sse2")))
+    inline __m128i count_thresholds_below(const __m128i co2_measurements_ppm, const __m128i *thresholds) {
+        __m128i level_indices = _mm_setzero_si128();
+        for (uint8_t i = 0; i < NUMBER_OF_THRESHOLDS; i++) {
+            level_indices = _mm_sub_epi32(level_indices, _mm_cmpgt_epi32(co2_measurements_ppm, thresholds[i]));
+        }
+        return level_indices;
+    }
+
+    /**
+     * @brief   Classifies 32 readings per step with AVX2, the rest with `classify_scalar`.
+     */
+    __attribute__((target("avx2")))
+    void classify_avx2(const int *co2_measurements_ppm, uint8_t *level_indices, size_t count,
+                       const MeasurementInterpreter::Thresholds &thresholds);
+
+    /**
+     * @brief   Returns the level indices of 8 readings (number of thresholds below each reading).
+     */
+    __attribute__((target("avx2")))
+    inline __m256i count_thresholds_below(const __m256i co2_measurements_ppm, const __m256i *thresholds) {
+        __m256i level_indices = _mm256_setzero_si256();
+        for (uint8_t i = 0; i < NUMBER_OF_THRESHOLDS; i++) {
+            level_indices = _mm256_sub_epi32(level_indices, _mm256_cmpgt_epi32(co2_measurements_ppm, thresholds[i]));
+        }
+        return level_indices;
+    }
+#endif
+
+    const char *get_name(const Implementation implementation) {
+        return implementation < NUMBER_OF_IMPLEMENTATIONS ? NAMES[implementation] : "unknown";
+    }
+
+    bool is_supported(const Implementation implementation) {
+        switch (implementation) {
+            case SCALAR:
+                return true;
+#ifdef HAS_X86_VECTOR_EXTENSIONS
+            case SSE2:
+                return __builtin_cpu_supports("sse2");
+            case AVX2:
+                return __builtin_cpu_supports("avx2");
+#endif
+            default:
+                return false;
+        }
+    }
+
+    Implementation get_best_implementation() {
+        static const Implementation best_implementation = is_supported(AVX2)
+                                                              ? AVX2
+                                                              : is_supported(SSE2)
+                                                                    ? SSE2
+                                                                    : SCALAR; ///< Determined on the first call.
+        return best_implementation;
+    }
+
+    void classify(const int *co2_measurements_ppm, uint8_t *level_indices, const size_t count,
+                  const MeasurementInterpreter::Thresholds &thresholds) {
+        classify(get_best_implementation(), co2_measurements_ppm, level_indices, count, thresholds);
+    }
+
+    void classify(const Implementation implementation, const int *co2_measurements_ppm, uint8_t *level_indices,
+                  const size_t count, const MeasurementInterpreter::Thresholds &thresholds) {
+#ifdef HAS_X86_VECTOR_EXTENSIONS
+        if (implementation == AVX2 && is_supported(AVX2)) {
+            classify_avx2(co2_measurements_ppm, level_indices, count, thresholds);
+            return;
+        }
+        if (implementation == SSE2 && is_supported(SSE2)) {
+            classify_sse2(co2_measurements_ppm, level_indices, count, thresholds);
+            return;
+        }
+#endif
+        classify_scalar(co2_measurements_ppm, level_indices, count, thresholds);
+    }
+
+    void classify_scalar(const int *co2_measurements_ppm, uint8_t *level_indices, const size_t count,
+                         const MeasurementInterpreter::Thresholds &thresholds) {
+        for (size_t i = 0; i < count; i++) {
+            level_indices[i] = MeasurementInterpreter::get_air_quality_level_index(co2_measurements_ppm[i], thresholds);
+        }
+    }
+
+#ifdef HAS_X86_VECTOR_EXTENSIONS
+    void classify_sse2(const int *co2_measurements_ppm, uint8_t *level_indices, const size_t count,
+                       const MeasurementInterpreter::Thresholds &thresholds) {
+        constexpr size_t READINGS_PER_STEP = 16; ///< Four vectors of 4 readings, packed into one vector of bytes.
+        __m128i threshold_vectors[NUMBER_OF_THRESHOLDS];
+        for (uint8_t i = 0; i < NUMBER_OF_THRESHOLDS; i++) {
+            threshold_vectors[i] = _mm_set1_epi32(thresholds.upper_threshold_ppm[i]);
+        }
+        size_t i = 0;
+        for (; i + READINGS_PER_STEP <= count; i += READINGS_PER_STEP) {
+            const __m128i *input = reinterpret_cast<const __m128i *>(co2_measurements_ppm + i);
+            const __m128i a = count_thresholds_below(_mm_loadu_si128(input), threshold_vectors);
+            const __m128i b = count_thresholds_below(_mm_loadu_si128(input + 1), threshold_vectors);
+            const __m128i c = count_thresholds_below(_mm_loadu_si128(input + 2), threshold_vectors);
+            const __m128i d = count_thresholds_below(_mm_loadu_si128(input + 3), threshold_vectors);
+            // The indices fit into a byte, the saturating packs keep the order of the readings.
+            const __m128i bytes = _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(level_indices + i), bytes);
+        }
+        classify_scalar(co2_measurements_ppm + i, level_indices + i, count - i, thresholds);
+    }
+
+    void classify_avx2(const int *co2_measurements_ppm, uint8_t *level_indices, const size_t count,
+                       const MeasurementInterpreter::Thresholds &thresholds) {
+        constexpr size_t READINGS_PER_STEP = 32; ///< Four vectors of 8 readings, packed into one vector of bytes.
+        __m256i threshold_vectors[NUMBER_OF_THRESHOLDS];
+        for (uint8_t i = 0; i < NUMBER_OF_THRESHOLDS; i++) {
+            threshold_vectors[i] = _mm256_set1_epi32(thresholds.upper_threshold_ppm[i]);
+        }
+        const __m256i lane_order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        ///< The packs work per 128-bit lane, this restores the order of the groups of 4 readings.
+        size_t i = 0;
+        for (; i + READINGS_PER_STEP <= count; i += READINGS_PER_STEP) {
+            const __m256i *input = reinterpret_cast<const __m256i *>(co2_measurements_ppm + i);
+            const __m256i a = count_thresholds_below(_mm256_loadu_si256(input), threshold_vectors);
+            const __m256i b = count_thresholds_below(_mm256_loadu_si256(input + 1), threshold_vectors);
+            const __m256i c = count_thresholds_below(_mm256_loadu_si256(input + 2), threshold_vectors);
+            const __m256i d = count_thresholds_below(_mm256_loadu_si256(input + 3), threshold_vectors);
+            const __m256i bytes = _mm256_packs_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(level_indices + i),
+                                _mm256_permutevar8x32_epi32(bytes, lane_order));
+        }
+        classify_scalar(co2_measurements_ppm + i, level_indices + i, count - i, thresholds);
+    }
+#endif
+}
@@ -0,0 +1,64 @@
+/**
+ * @file batch_classifier.h
+ * @brief Vectorized classification of arrays of CO2 readings into air quality levels (host tools).
+ * @details Gives the same level index as `MeasurementInterpreter::get_air_quality_level_index` for every reading: the
+ *          index of the first level whose upper threshold is not exceeded, which for ascending thresholds is the number
+ *          of thresholds below the reading. The vector implementations count the thresholds with one compare per
+ *          threshold and lane (8 readings per AVX2 compare, 4 per SSE2 compare). The implementation is chosen at run
+ *          time from the features of the CPU, the scalar implementation (the firmware function itself) is used on
+ *          other architectures and for the remaining readings of an array.
+ */
+
+#ifndef BATCH_CLASSIFIER_H
+#define BATCH_CLASSIFIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <measurement_interpreter.h>
+
+namespace BatchClassifier {
+    /**
+     * @enum    Implementation
+     * @brief   Implementations of the batch classification.
+     */
+    enum Implementation : uint8_t {
+        SCALAR, ///< `MeasurementInterpreter::get_air_quality_level_index` per reading.
+        SSE2, ///< 16 readings per step with 128-bit compares (x86).
+        AVX2, ///< 32 readings per step with 256-bit compares (x86).
+        NUMBER_OF_IMPLEMENTATIONS
+    };
+
+    /**
+     * @brief   Returns the name of an implementation.
+     */
+    const char *get_name(Implementation implementation);
+
+    /**
+     * @brief   Returns true, if the implementation can run on this CPU.
+     */
+    bool is_supported(Implementation implementation);
+
+    /**
+     * @brief   Returns the fastest implementation supported by this CPU.
+     */
+    Implementation get_best_implementation();
+
+    /**
+     * @brief   Classifies an array of CO2 readings with the fastest supported implementation.
+     *
+     * @param   co2_measurements_ppm The CO2 readings in ppm.
+     * @param   level_indices Output: the index of the level of each reading in `AirQuality::AIR_QUALITY_LEVELS`.
+     * @param   count The number of readings.
+     * @param   thresholds The upper thresholds of the levels (ascending, as required by the firmware).
+     */
+    void classify(const int *co2_measurements_ppm, uint8_t *level_indices, size_t count,
+                  const MeasurementInterpreter::Thresholds &thresholds = MeasurementInterpreter::DEFAULT_THRESHOLDS);
+
+    /**
+     * @brief   Classifies an array of CO2 readings with the given implementation (the scalar one, if not supported).
+     */
+    void classify(Implementation implementation, const int *co2_measurements_ppm, uint8_t *level_indices, size_t count,
+                  const MeasurementInterpreter::Thresholds &thresholds = MeasurementInterpreter::DEFAULT_THRESHOLDS);
+}
+
+#endif //BATCH_CLASSIFIER_H
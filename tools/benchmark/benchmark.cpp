@@ -0,0 +1,372 @@
+/**
+ * @file    benchmark.cpp
+ * @brief   Host micro-benchmarks for the core modules of the Air Quality Meter.
+ * @details Runs the unmodified firmware modules on the host HAL and reports the time per operation and the number of
+ *          heap allocations per operation. The results can be stored as a baseline and compared against it, so
+ *          performance regressions in the shared logic are detected without flashing a board.
+ *
+ *          Usage: program [--baseline <file>] [--write-baseline <file>] [--tolerance <percent>] [--filter <text>]
+ *
+ *          Exits with a non-zero status, if a benchmark is slower than the baseline by more than the tolerance
+ *          (default: 25 %) or allocates more often than the baseline, or if the batch classification differs from the
+ *          firmware.
+ */
+
+#include <Arduino.h>
+#include <host_hal.h>
+#include <air_quality.h>
+#include <measurement_interpreter.h>
+#include <display_row_formatter.h>
+#include <warning_controller.h>
+#include <button_debouncer.h>
+#include <state_access.h>
+#include <display_controller.h>
+#include <display_pages.h>
+#include <batch_classifier.h>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+void setup(); ///< Firmware set-up (src/main.cpp).
+void loop(); ///< Firmware main loop (src/main.cpp).
+
+namespace LogController {
+    void print_timestamp(Print *_log_output); ///< Internal function of log_controller.cpp.
+}
+
+namespace Benchmark {
+    /**
+     * @struct  Case
+     * @brief   A benchmark: a function running the measured operation a given number of times.
+     */
+    struct Case {
+        const char *name; ///< Name of the benchmark (used in the baseline file).
+        void (*run)(unsigned long iterations); ///< Runs the operation `iterations` times.
+    };
+
+    /**
+     * @struct  Result
+     * @brief   Measured or stored result of a benchmark.
+     */
+    struct Result {
+        std::string name; ///< Name of the benchmark.
+        double nanoseconds_per_operation; ///< Host time per operation.
+        double allocations_per_operation; ///< Heap allocations per operation.
+    };
+
+    /**
+     * @class   NullPrint
+     * @brief   Print implementation that discards all output.
+     */
+    class NullPrint : public Print {
+    public:
+        size_t write(uint8_t) override { return 1; }
+        size_t write(const uint8_t *, const size_t size) override { return size; }
+    };
+
+    /**
+     * @brief   Prevents the compiler from optimizing away a computed value.
+     */
+    template<typename T>
+    void keep(const T &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @brief   Measures a benchmark.
+     * @details The number of iterations is doubled until a run takes at least `MIN_RUN_TIME`. The fastest of
+     *          `REPETITIONS` runs is reported.
+     */
+    Result measure(const Case &benchmark);
+
+    /**
+     * @brief   Returns true, if all supported batch classifiers give the level of the firmware for every reading from
+     *          `MIN_VERIFIED_PPM` to `MAX_VERIFIED_PPM` and for the extreme values of `int`.
+     */
+    bool is_batch_classification_identical();
+
+    /**
+     * @brief   Reads a baseline file (`<name> <ns/op> <allocations/op>` per line).
+     */
+    std::vector<Result> read_baseline(const char *path);
+
+    /**
+     * @brief   Writes the results as baseline file.
+     */
+    bool write_baseline(const char *path, const std::vector<Result> &results);
+
+    constexpr auto MIN_RUN_TIME = std::chrono::milliseconds(100); ///< Minimum duration of a measured run.
+    constexpr int REPETITIONS = 3; ///< Number of measured runs per benchmark.
+    constexpr double DEFAULT_TOLERANCE_PERCENT = 25.0; ///< Allowed slowdown compared to the baseline.
+    constexpr size_t BATCH_SIZE = 4096; ///< Readings per call of the batch classification.
+    constexpr int MIN_VERIFIED_PPM = -1000; ///< Lowest reading compared with the firmware.
+    constexpr int MAX_VERIFIED_PPM = 70000; ///< Highest reading compared with the firmware.
+
+    unsigned long allocation_count = 0; ///< Number of heap allocations (counted by the global operator new).
+    NullPrint null_output; ///< Output for the log benchmarks.
+    int batch_co2_measurements_ppm[BATCH_SIZE]; ///< Input of the batch classification benchmarks.
+    uint8_t batch_level_indices[BATCH_SIZE]; ///< Output of the batch classification benchmarks.
+
+    void run_air_quality_level(const unsigned long iterations) {
+        for (unsigned long i = 0; i < iterations; i++) {
+            const int co2_measurement_ppm = 400 + static_cast<int>(i % 1600);
+            keep(MeasurementInterpreter::get_air_quality_level(co2_measurement_ppm));
+        }
+    }
+
+    template<BatchClassifier::Implementation IMPLEMENTATION>
+    void run_batch_classifier(const unsigned long iterations) {
+        if (batch_co2_measurements_ppm[BATCH_SIZE - 1] == 0) {
+            for (size_t i = 0; i < BATCH_SIZE; i++) {
+                batch_co2_measurements_ppm[i] = 400 + static_cast<int>(i * 97 % 1600);
+            }
+        }
+        for (unsigned long i = 0; i < iterations; i += BATCH_SIZE) {
+            const size_t count = iterations - i < BATCH_SIZE ? iterations - i : BATCH_SIZE;
+            BatchClassifier::classify(IMPLEMENTATION, batch_co2_measurements_ppm, batch_level_indices, count);
+            keep(batch_level_indices);
+        }
+    }
+
+    void run_co2_display_row(const unsigned long iterations) {
+        char co2_display_row[DisplayRowFormatter::BUFFER_SIZE];
+        for (unsigned long i = 0; i < iterations; i++) {
+            DisplayRowFormatter::set_co2_display_row(co2_display_row, 400 + static_cast<int>(i % 4600));
+            keep(co2_display_row);
+        }
+    }
+
+    void run_print_timestamp(const unsigned long iterations) {
+        for (unsigned long i = 0; i < iterations; i++) {
+            HostHal::advance_time_us(1234);
+            LogController::print_timestamp(&null_output);
+        }
+    }
+
+    void run_warning_controller(const unsigned long iterations) {
+        for (unsigned long i = 0; i < iterations; i++) {
+            HostHal::advance_time_us(2000000);
+            if (i % 8 == 0) {
+                WarningController::reset();
+                continue;
+            }
+            if (WarningController::is_audio_warning_to_be_issued(SystemTime::milliseconds(i * 20000UL))) {
+                WarningController::update_for_co2_level_not_acceptable();
+            }
+        }
+    }
+
+    void run_state_access(const unsigned long iterations) {
+        for (unsigned long i = 0; i < iterations; i++) {
+            StateAccess::write([i](AirQualityMeter::State &state) {
+                state.warning_counter = static_cast<int>(i % 4);
+            });
+            keep(StateAccess::read().warning_counter);
+        }
+    }
+
+    void run_button_debouncer(const unsigned long iterations) {
+        SystemTime::TimePoint last_button_press_detected;
+        for (unsigned long i = 0; i < iterations; i++) {
+            HostHal::advance_time_us(37000);
+            keep(ButtonDebouncer::is_button_debounced(last_button_press_detected, i % 2 == 0));
+        }
+    }
+
+    void run_page_switch(const unsigned long iterations) {
+        for (unsigned long i = 0; i < iterations; i++) {
+            DisplayPages::request_next_page();
+            DisplayPages::update();
+            DisplayController::render();
+        }
+    }
+
+    void run_loop(const unsigned long iterations) {
+        for (unsigned long i = 0; i < iterations; i++) {
+            HostHal::set_co2_ppm(400 + static_cast<int>(i * 97 % 1400));
+            loop();
+        }
+    }
+
+    const Case CASES[] = {
+        {"measurement_interpreter.get_air_quality_level", run_air_quality_level},
+        {"batch_classifier.scalar", run_batch_classifier<BatchClassifier::SCALAR>},
+        {"batch_classifier.sse2", run_batch_classifier<BatchClassifier::SSE2>},
+        {"batch_classifier.avx2", run_batch_classifier<BatchClassifier::AVX2>},
+        {"display_row_formatter.set_co2_display_row", run_co2_display_row},
+        {"log_controller.print_timestamp", run_print_timestamp},
+        {"warning_controller.cycle", run_warning_controller},
+        {"state_access.write_read", run_state_access},
+        {"button_debouncer.is_button_debounced", run_button_debouncer},
+        {"display_pages.page_switch_render", run_page_switch},
+        {"main.loop", run_loop},
+    }; ///< All benchmarks.
+
+    Result measure(const Case &benchmark) {
+        Result result{benchmark.name, 0.0, 0.0};
+        unsigned long iterations = 1;
+        for (int repetition = 0; repetition < REPETITIONS;) {
+            const unsigned long allocations_before = allocation_count;
+            const auto start = std::chrono::steady_clock::now();
+            benchmark.run(iterations);
+            const auto duration = std::chrono::steady_clock::now() - start;
+            if (duration < MIN_RUN_TIME) {
+                iterations *= 2;
+                continue;
+            }
+            const double nanoseconds_per_operation =
+                    static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()) /
+                    static_cast<double>(iterations);
+            if (repetition == 0 || nanoseconds_per_operation < result.nanoseconds_per_operation) {
+                result.nanoseconds_per_operation = nanoseconds_per_operation;
+            }
+            result.allocations_per_operation =
+                    static_cast<double>(allocation_count - allocations_before) / static_cast<double>(iterations);
+            repetition++;
+        }
+        return result;
+    }
+
+    bool is_batch_classification_identical() {
+        std::vector<int> co2_measurements_ppm = {INT_MIN, INT_MIN + 1, INT_MAX - 1, INT_MAX};
+        for (int co2_measurement_ppm = MIN_VERIFIED_PPM; co2_measurement_ppm <= MAX_VERIFIED_PPM;
+             co2_measurement_ppm++) {
+            co2_measurements_ppm.push_back(co2_measurement_ppm);
+        }
+        std::vector<uint8_t> level_indices(co2_measurements_ppm.size());
+        for (uint8_t implementation = 0; implementation < BatchClassifier::NUMBER_OF_IMPLEMENTATIONS;
+             implementation++) {
+            if (!BatchClassifier::is_supported(static_cast<BatchClassifier::Implementation>(implementation))) {
+                continue;
+            }
+            // Odd start and length, so the unaligned loads and the scalar remainder are covered as well.
+            BatchClassifier::classify(static_cast<BatchClassifier::Implementation>(implementation),
+                                      co2_measurements_ppm.data() + 1, level_indices.data() + 1,
+                                      co2_measurements_ppm.size() - 1);
+            BatchClassifier::classify(static_cast<BatchClassifier::Implementation>(implementation),
+                                      co2_measurements_ppm.data(), level_indices.data(), 1);
+            for (size_t i = 0; i < co2_measurements_ppm.size(); i++) {
+                // The descriptions are not unique (two moderate levels), the thresholds are.
+                const AirQuality::Level level = MeasurementInterpreter::get_air_quality_level(co2_measurements_ppm[i]);
+                if (level_indices[i] >= MeasurementInterpreter::NUMBER_OF_LEVELS ||
+                    AirQuality::AIR_QUALITY_LEVELS[level_indices[i]].upper_threshold_ppm != level.upper_threshold_ppm) {
+                    std::printf("batch_classifier.%s: level %u for %d ppm, firmware: %s (up to %d ppm)\n",
+                                BatchClassifier::get_name(static_cast<BatchClassifier::Implementation>(implementation)),
+                                level_indices[i], co2_measurements_ppm[i], level.description,
+                                level.upper_threshold_ppm);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::vector<Result> read_baseline(const char *path) {
+        std::vector<Result> baseline;
+        std::ifstream file(path);
+        for (std::string line; std::getline(file, line);) {
+            std::istringstream fields(line);
+            Result result;
+            if (line.empty() || line[0] == '#' ||
+                !(fields >> result.name >> result.nanoseconds_per_operation >> result.allocations_per_operation)) {
+                continue;
+            }
+            baseline.push_back(result);
+        }
+        return baseline;
+    }
+
+    bool write_baseline(const char *path, const std::vector<Result> &results) {
+        std::ofstream file(path);
+        file << "# name ns/op allocations/op\n";
+        for (const Result &result: results) {
+            file << result.name << ' ' << result.nanoseconds_per_operation << ' '
+                    << result.allocations_per_operation << '\n';
+        }
+        return static_cast<bool>(file);
+    }
+}
+
+void *operator new(const size_t size) {
+    Benchmark::allocation_count++;
+    if (void *memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    std::free(memory);
+}
+
+int main(const int argc, char **argv) {
+    const char *baseline_path = nullptr;
+    const char *new_baseline_path = nullptr;
+    const char *filter = "";
+    double tolerance_percent = Benchmark::DEFAULT_TOLERANCE_PERCENT;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--baseline")) {
+            baseline_path = argv[i + 1];
+        } else if (!std::strcmp(argv[i], "--write-baseline")) {
+            new_baseline_path = argv[i + 1];
+        } else if (!std::strcmp(argv[i], "--tolerance")) {
+            tolerance_percent = std::atof(argv[i + 1]);
+        } else if (!std::strcmp(argv[i], "--filter")) {
+            filter = argv[i + 1];
+        }
+    }
+
+    setup(); // the simulated loop() needs an initialized system
+
+    if (!Benchmark::is_batch_classification_identical()) {
+        return EXIT_FAILURE;
+    }
+    std::printf("batch classification: %s, identical to the firmware\n",
+                BatchClassifier::get_name(BatchClassifier::get_best_implementation()));
+
+    const std::vector<Benchmark::Result> baseline =
+            baseline_path ? Benchmark::read_baseline(baseline_path) : std::vector<Benchmark::Result>();
+    std::vector<Benchmark::Result> results;
+    bool is_regression = false;
+    std::printf("%-48s %14s %12s %14s\n", "benchmark", "ns/op", "allocs/op", "vs. baseline");
+    for (const Benchmark::Case &benchmark: Benchmark::CASES) {
+        if (!std::strstr(benchmark.name, filter)) {
+            continue;
+        }
+        const Benchmark::Result result = Benchmark::measure(benchmark);
+        results.push_back(result);
+
+        char comparison[32] = "-";
+        for (const Benchmark::Result &reference: baseline) {
+            if (reference.name != result.name) {
+                continue;
+            }
+            const double change_percent =
+                    (result.nanoseconds_per_operation / reference.nanoseconds_per_operation - 1.0) * 100.0;
+            const bool is_slower = change_percent > tolerance_percent;
+            const bool is_allocating_more = result.allocations_per_operation > reference.allocations_per_operation;
+            is_regression |= is_slower || is_allocating_more;
+            std::snprintf(comparison, sizeof(comparison), "%+.1f %%%s", change_percent,
+                          is_slower || is_allocating_more ? " FAIL" : "");
+        }
+        std::printf("%-48s %14.2f %12.2f %14s\n", result.name.c_str(), result.nanoseconds_per_operation,
+                    result.allocations_per_operation, comparison);
+    }
+
+    if (new_baseline_path && !Benchmark::write_baseline(new_baseline_path, results)) {
+        std::perror(new_baseline_path);
+        return EXIT_FAILURE;
+    }
+    return is_regression ? EXIT_FAILURE : EXIT_SUCCESS;
+}
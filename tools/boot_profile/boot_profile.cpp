@@ -0,0 +1,116 @@
+/**
+ * @file    boot_profile.cpp
+ * @brief   Host boot profile of the Air Quality Meter.
+ * @details Runs a cold start of the unmodified firmware on the host HAL (the simulated sensor preheats for 3 minutes)
+ *          until the first valid reading, and prints the boot timeline and the time-to-first-reading. The simulated
+ *          time only advances when the firmware waits, so the result is deterministic and can be compared against a
+ *          baseline to track the time-to-first-reading across releases.
+ *
+ *          Usage: program [--baseline <file>] [--write-baseline <file>]
+ *
+ *          Exits with a non-zero status, if the time-to-first-reading is longer than in the baseline.
+ */
+
+#include <Arduino.h>
+#include <host_hal.h>
+#include <boot_timeline.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+void setup(); ///< Firmware set-up (src/main.cpp).
+void loop(); ///< Firmware main loop (src/main.cpp).
+
+namespace BootProfile {
+    constexpr uint64_t SENSOR_PREHEATING_TIME_US = 180000000ULL; ///< Preheating time of the simulated sensor.
+    constexpr int CO2_PPM = 800; ///< Reading of the simulated sensor.
+    constexpr int MAX_NUMBER_OF_LOOPS = 10; ///< Number of loop iterations after which the profile is aborted.
+    constexpr char METRIC_NAME[] = "time_to_first_reading_ms"; ///< Name of the metric in the baseline file.
+    constexpr double MICROSECONDS_PER_MILLISECOND = 1000.0; ///< Conversion factor for the timeline.
+
+    /**
+     * @brief   Ends the preheating of the simulated sensor after `SENSOR_PREHEATING_TIME_US` (time hook).
+     */
+    void update_sensor(uint64_t time_us);
+
+    /**
+     * @brief   Reads the time-to-first-reading from a baseline file.
+     * @return  The time in ms, or 0 if the file contains no value.
+     */
+    unsigned long read_baseline(const char *path);
+
+    /**
+     * @brief   Writes the time-to-first-reading as baseline file.
+     */
+    bool write_baseline(const char *path, unsigned long time_to_first_reading_ms);
+
+    void update_sensor(const uint64_t time_us) {
+        if (time_us >= SENSOR_PREHEATING_TIME_US) {
+            HostHal::set_sensor_preheating(false);
+        }
+    }
+
+    unsigned long read_baseline(const char *path) {
+        std::ifstream file(path);
+        for (std::string name; file >> name;) {
+            unsigned long value = 0;
+            if (name == METRIC_NAME && file >> value) {
+                return value;
+            }
+        }
+        return 0;
+    }
+
+    bool write_baseline(const char *path, const unsigned long time_to_first_reading_ms) {
+        std::ofstream file(path);
+        file << "# name value\n";
+        file << METRIC_NAME << ' ' << time_to_first_reading_ms << '\n';
+        return static_cast<bool>(file);
+    }
+}
+
+int main(const int argc, char **argv) {
+    const char *baseline_path = nullptr;
+    const char *new_baseline_path = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--baseline")) {
+            baseline_path = argv[i + 1];
+        } else if (!std::strcmp(argv[i], "--write-baseline")) {
+            new_baseline_path = argv[i + 1];
+        }
+    }
+
+    HostHal::set_co2_ppm(BootProfile::CO2_PPM);
+    HostHal::set_sensor_preheating(true);
+    HostHal::set_time_hook(BootProfile::update_sensor);
+    setup();
+    for (int i = 0; i < BootProfile::MAX_NUMBER_OF_LOOPS && BootTimeline::get_time_to_first_reading_ms() == 0; i++) {
+        loop();
+    }
+
+    std::printf("%-24s %12s %14s\n", "phase", "start [ms]", "duration [ms]");
+    for (uint8_t i = 0; i < BootTimeline::get_number_of_phases(); i++) {
+        std::printf("%-24s %12.3f %14.3f\n", BootTimeline::get_phase_name(i),
+                    BootTimeline::get_phase_start_time_us(i) / BootProfile::MICROSECONDS_PER_MILLISECOND,
+                    BootTimeline::get_phase_duration_us(i) / BootProfile::MICROSECONDS_PER_MILLISECOND);
+    }
+    const unsigned long time_to_first_reading_ms = BootTimeline::get_time_to_first_reading_ms();
+    if (time_to_first_reading_ms == 0) {
+        std::printf("no valid reading after %d loop iterations\n", BootProfile::MAX_NUMBER_OF_LOOPS);
+        return EXIT_FAILURE;
+    }
+
+    const unsigned long baseline_ms = baseline_path ? BootProfile::read_baseline(baseline_path) : 0;
+    std::printf("%s: %lu", BootProfile::METRIC_NAME, time_to_first_reading_ms);
+    if (baseline_ms != 0) {
+        std::printf(" (baseline: %lu)", baseline_ms);
+    }
+    std::printf("\n");
+    if (new_baseline_path && !BootProfile::write_baseline(new_baseline_path, time_to_first_reading_ms)) {
+        std::printf("could not write baseline %s\n", new_baseline_path);
+        return EXIT_FAILURE;
+    }
+    return baseline_ms != 0 && time_to_first_reading_ms > baseline_ms ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,422 @@
+/**
+ * @file    fault_injection.cpp
+ * @brief   Host fault injection of the Air Quality Meter.
+ * @details Runs the unmodified firmware on the host HAL and injects one fault after another while the main loop runs:
+ *          a sensor without PWM pulse, readings outside the valid range, a chattering (stuck-high) acknowledge or mute
+ *          button, a stalled MP3 module, a slowly draining serial link and jumps of the clock. For each scenario, the
+ *          time to recovery after the fault is removed, the longest loop iteration, the longest time without a
+ *          watchdog reset and the longest interrupt service routine are printed.
+ *
+ *          The serial links run at their real speed (9600 baud), so logging takes as long as on the device. The
+ *          simulated time only advances when the firmware waits, reads the sensor or writes to a serial link, so the
+ *          results are deterministic and can be compared against a baseline.
+ *
+ *          Usage: program [--baseline <file>] [--write-baseline <file>]
+ *
+ *          Exits with a non-zero status, if a scenario does not recover, or a metric is worse than in the baseline. A
+ *          scenario, in which the watchdog would have reset the MCU, has not recovered: the reset interrupts the
+ *          firmware, so the measured recovery would not have happened. The metrics of a scenario, that did not
+ *          recover, are not written to a new baseline.
+ */
+
+#include <Arduino.h>
+#include <host_hal.h>
+#include <pin_configuration.h>
+#include <state_access.h>
+#include <boot_timeline.h>
+#include <co2_sensor_controller.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+
+void setup(); ///< Firmware set-up (src/main.cpp).
+void loop(); ///< Firmware main loop (src/main.cpp).
+
+namespace FaultInjection {
+    /**
+     * @enum    Recovery
+     * @brief   Criterion for the recovery from a fault.
+     */
+    enum Recovery : uint8_t {
+        VALID_LOOP, ///< First loop iteration after the removal, with a valid reading and at most the nominal duration.
+        BUTTON_PRESS ///< First press of the button, that is accepted after the removal.
+    };
+
+    /**
+     * @struct  Scenario
+     * @brief   A fault: how it is injected and removed, and when the firmware has recovered from it.
+     */
+    struct Scenario {
+        const char *name; ///< Name of the scenario (used in the baseline file).
+        void (*inject)(); ///< Injects the fault.
+        void (*remove)(); ///< Removes the fault.
+        uint64_t fault_duration_us; ///< Time from the injection to the removal.
+        Recovery recovery; ///< Criterion for the recovery.
+        uint8_t button_pin; ///< Button pressed to check the recovery (`BUTTON_PRESS`).
+    };
+
+    /**
+     * @struct  Result
+     * @brief   Measured result of a scenario (from the injection until the recovery).
+     */
+    struct Result {
+        bool is_recovered; ///< True, if the firmware recovered within `MAX_NUMBER_OF_LOOPS` without watchdog reset.
+        uint64_t time_to_recovery_us; ///< Time from the removal of the fault until the recovery.
+        uint64_t max_loop_duration_us; ///< Longest loop iteration.
+        uint64_t max_watchdog_gap_us; ///< Longest time without a watchdog reset.
+        uint64_t max_isr_duration_us; ///< Longest interrupt service routine of a button.
+    };
+
+    constexpr uint32_t SERIAL_BYTE_TIME_US = 1042; ///< Transmission time of one byte at 9600 baud (log and MP3).
+    constexpr uint32_t DRAINING_SERIAL_BYTE_TIME_US = 3 * SERIAL_BYTE_TIME_US;
+    ///< Time to send one byte to a receiver, that drains the serial link 3 times slower.
+    constexpr uint32_t STALLED_MP3_BYTE_TIME_US = 250000; ///< Time a write to the stalled MP3 module blocks per byte.
+    constexpr int CO2_PPM = 800; ///< Reading of the simulated sensor (acceptable air quality).
+    constexpr int HIGH_CO2_PPM = 2000; ///< Reading, that causes audio warnings after a minute.
+    constexpr int OUT_OF_RANGE_CO2_PPM = 6000; ///< Reading outside the valid range.
+    constexpr int NO_PULSE = -1; ///< Reading of a sensor, that sends no PWM pulse.
+    constexpr uint64_t SECOND_US = 1000000ULL; ///< Microseconds per second.
+    constexpr uint64_t INJECTION_DELAY_US = SECOND_US;
+    ///< Time from the start of the scenario (end of a loop iteration) to the injection, i.e. during the next wait.
+    constexpr uint64_t BUTTON_CHATTER_PERIOD_US = 20000ULL;
+    ///< Time between two rising edges of a stuck-high button with a bouncing contact.
+    constexpr uint64_t BUTTON_PRESS_PERIOD_US = 50000ULL; ///< Time between two presses to check the recovery.
+    constexpr uint64_t WATCHDOG_TIMEOUT_US = 8 * SECOND_US; ///< Timeout of the watchdog (see watchdog.cpp).
+    constexpr int64_t FORWARD_CLOCK_JUMP_US = 3600 * static_cast<int64_t>(SECOND_US); ///< Forward clock jump.
+    constexpr int64_t BACKWARD_CLOCK_JUMP_US = -10 * static_cast<int64_t>(SECOND_US); ///< Backward clock jump.
+    constexpr int NUMBER_OF_SETTLING_LOOPS = 5; ///< Loop iterations to measure the nominal loop duration.
+    constexpr int MAX_NUMBER_OF_LOOPS = 200; ///< Loop iterations after which a scenario is aborted.
+    constexpr uint8_t NO_PIN = 0xFF; ///< No button pin.
+    constexpr double MICROSECONDS_PER_MILLISECOND = 1000.0; ///< Conversion factor for the report.
+    constexpr uint8_t NUMBER_OF_METRICS = 4; ///< Metrics per scenario in the baseline file.
+    constexpr const char *METRIC_NAMES[NUMBER_OF_METRICS] = {
+        "recovery_ms", "max_loop_ms", "max_watchdog_gap_ms", "max_isr_ms"
+    }; ///< Names of the metrics in the baseline file (after the scenario name and a dot).
+
+    uint64_t nominal_loop_duration_us = 0; ///< Longest loop iteration without fault.
+    const Scenario *scenario = nullptr; ///< Running scenario.
+    Result result = {}; ///< Result of the running scenario.
+    uint64_t injection_time_us = 0; ///< Time the fault of the running scenario is injected.
+    uint64_t removal_time_us = 0; ///< Time the fault was removed, 0 if not yet.
+    bool is_fault_injected = false; ///< True, after the fault of the running scenario was injected.
+    uint8_t stuck_button_pin = NO_PIN; ///< Pin of the chattering button, `NO_PIN` if none.
+    uint64_t next_chatter_time_us = 0; ///< Time of the next rising edge of the chattering button.
+    uint64_t next_press_time_us = 0; ///< Time of the next press to check the recovery.
+    uint64_t press_accepted_time_us = 0; ///< Time the first press after the removal was accepted, 0 if not yet.
+    uint64_t clock_jump_time_us = 0; ///< Time (after the jump) the clock jumped in the running scenario.
+    int64_t clock_jump_us = 0; ///< Clock jump in the running scenario.
+    bool is_in_time_hook = false; ///< True, while the time hook runs (the time advances during a button ISR).
+
+    /**
+     * @brief   Injects and removes the fault of the running scenario, presses the buttons and tracks the watchdog
+     *          (time hook).
+     */
+    void update(uint64_t time_us);
+
+    /**
+     * @brief   Updates the longest time without a watchdog reset (a clock jump does not count as time passed).
+     */
+    void track_watchdog(uint64_t time_us);
+
+    /**
+     * @brief   Calls the interrupt service routine of a button and measures its duration.
+     * @return  True, if the press was accepted (the system state was written, i.e. not debounced).
+     */
+    bool press_button(uint8_t pin);
+
+    /**
+     * @brief   Lets the clock of the simulated MCU jump.
+     */
+    void jump_clock(int64_t jump_us);
+
+    /**
+     * @brief   Runs the main loop until the recovery from the fault of the scenario.
+     */
+    Result run(const Scenario &scenario_to_run);
+
+    /**
+     * @brief   Checks the recovery criterion of the running scenario at the end of a loop iteration.
+     * @return  The time of the recovery, or 0 if the firmware has not recovered yet.
+     */
+    uint64_t get_recovery_time_us(uint64_t loop_duration_us);
+
+    /**
+     * @brief   Reads the metrics of a baseline file.
+     */
+    std::map<std::string, unsigned long> read_baseline(const char *path);
+
+    /**
+     * @brief   Writes the metrics of each scenario as baseline file.
+     */
+    bool write_baseline(const char *path, const std::map<std::string, unsigned long> &metrics);
+
+    void inject_no_pulse() { HostHal::set_co2_ppm(NO_PULSE); }
+    void inject_out_of_range() { HostHal::set_co2_ppm(OUT_OF_RANGE_CO2_PPM); }
+    void remove_invalid_reading() { HostHal::set_co2_ppm(CO2_PPM); }
+    void inject_stuck_acknowledge_button() { stuck_button_pin = AcknowledgeButton::ButtonPin::NUMBER; }
+    void inject_stuck_mute_button() { stuck_button_pin = MuteButton::ButtonPin::NUMBER; }
+    void remove_stuck_button() { stuck_button_pin = NO_PIN; }
+
+    void inject_stalled_mp3() {
+        HostHal::set_co2_ppm(HIGH_CO2_PPM);
+        HostHal::set_software_serial_byte_time_us(STALLED_MP3_BYTE_TIME_US);
+    }
+
+    void remove_stalled_mp3() {
+        HostHal::set_co2_ppm(CO2_PPM);
+        HostHal::set_software_serial_byte_time_us(SERIAL_BYTE_TIME_US);
+    }
+
+    void inject_draining_serial() { HostHal::set_serial_byte_time_us(DRAINING_SERIAL_BYTE_TIME_US); }
+    void remove_draining_serial() { HostHal::set_serial_byte_time_us(SERIAL_BYTE_TIME_US); }
+    void inject_forward_clock_jump() { jump_clock(FORWARD_CLOCK_JUMP_US); }
+    void inject_backward_clock_jump() { jump_clock(BACKWARD_CLOCK_JUMP_US); }
+    void remove_nothing() {}
+
+    constexpr Scenario SCENARIOS[] = {
+        {"pwm_no_pulse", inject_no_pulse, remove_invalid_reading, 20 * SECOND_US, VALID_LOOP, NO_PIN},
+        {"pwm_out_of_range", inject_out_of_range, remove_invalid_reading, 20 * SECOND_US, VALID_LOOP, NO_PIN},
+        {"stalled_mp3_uart", inject_stalled_mp3, remove_stalled_mp3, 120 * SECOND_US, VALID_LOOP, NO_PIN},
+        {"serial_backpressure", inject_draining_serial, remove_draining_serial, 20 * SECOND_US, VALID_LOOP, NO_PIN},
+        {"clock_jump_forward", inject_forward_clock_jump, remove_nothing, 0, VALID_LOOP, NO_PIN},
+        {"clock_jump_backward", inject_backward_clock_jump, remove_nothing, 0, VALID_LOOP, NO_PIN},
+        {
+            "stuck_acknowledge_button", inject_stuck_acknowledge_button, remove_stuck_button, 10 * SECOND_US,
+            BUTTON_PRESS, AcknowledgeButton::ButtonPin::NUMBER
+        },
+        {
+            "stuck_mute_button", inject_stuck_mute_button, remove_stuck_button, 10 * SECOND_US, BUTTON_PRESS,
+            MuteButton::ButtonPin::NUMBER
+        },
+    }; ///< Scenarios in running order (each one starts from the recovered state of the previous one).
+
+    void update(const uint64_t time_us) {
+        if (scenario == nullptr || is_in_time_hook) {
+            return;
+        }
+        is_in_time_hook = true;
+        track_watchdog(time_us);
+        if (!is_fault_injected && time_us >= injection_time_us) {
+            is_fault_injected = true;
+            next_chatter_time_us = time_us;
+            scenario->inject();
+        }
+        const uint64_t scheduled_removal_time_us = injection_time_us + scenario->fault_duration_us;
+        ///< Time the fault is removed.
+        while (stuck_button_pin != NO_PIN && next_chatter_time_us < scheduled_removal_time_us &&
+               next_chatter_time_us <= HostHal::get_time_us()) {
+            press_button(stuck_button_pin);
+            next_chatter_time_us += BUTTON_CHATTER_PERIOD_US;
+            if (next_chatter_time_us < HostHal::get_time_us()) {
+                // The edges during a long ISR set the interrupt flag once: the next ISR follows at once.
+                next_chatter_time_us = HostHal::get_time_us();
+            }
+        }
+        if (is_fault_injected && removal_time_us == 0 && HostHal::get_time_us() >= scheduled_removal_time_us) {
+            scenario->remove();
+            removal_time_us = HostHal::get_time_us();
+            next_press_time_us = removal_time_us;
+        }
+        while (removal_time_us != 0 && scenario->recovery == BUTTON_PRESS && press_accepted_time_us == 0 &&
+               next_press_time_us <= HostHal::get_time_us()) {
+            if (press_button(scenario->button_pin)) {
+                press_accepted_time_us = next_press_time_us;
+            }
+            next_press_time_us += BUTTON_PRESS_PERIOD_US;
+        }
+        is_in_time_hook = false;
+    }
+
+    void track_watchdog(const uint64_t time_us) {
+        const uint64_t last_reset_time_us = HostHal::get_last_watchdog_reset_time_us();
+        ///< Time of the last reset, on the clock of the simulated MCU.
+        int64_t watchdog_gap_us = static_cast<int64_t>(time_us - last_reset_time_us); ///< Time since the last reset.
+        if (clock_jump_us != 0 && last_reset_time_us < clock_jump_time_us) {
+            watchdog_gap_us -= clock_jump_us; // the watchdog runs on its own oscillator
+        }
+        if (watchdog_gap_us > static_cast<int64_t>(result.max_watchdog_gap_us)) {
+            result.max_watchdog_gap_us = static_cast<uint64_t>(watchdog_gap_us);
+        }
+    }
+
+    bool press_button(const uint8_t pin) {
+        const unsigned long number_of_writes = StateAccess::get_number_of_writes(); ///< Writes before the press.
+        const uint64_t start_time_us = HostHal::get_time_us(); ///< Start of the interrupt service routine.
+        HostHal::set_pin_level(pin, HIGH);
+        HostHal::trigger_interrupt(pin);
+        HostHal::set_pin_level(pin, LOW);
+        const uint64_t isr_duration_us = HostHal::get_time_us() - start_time_us;
+        ///< Duration of the interrupt service routine.
+        if (isr_duration_us > result.max_isr_duration_us) {
+            result.max_isr_duration_us = isr_duration_us;
+        }
+        return StateAccess::get_number_of_writes() != number_of_writes;
+    }
+
+    void jump_clock(const int64_t jump_us) {
+        clock_jump_us = jump_us;
+        HostHal::jump_time_us(jump_us);
+        clock_jump_time_us = HostHal::get_time_us();
+        injection_time_us = clock_jump_time_us; // the removal is scheduled on the new clock
+    }
+
+    uint64_t get_recovery_time_us(const uint64_t loop_duration_us) {
+        if (removal_time_us == 0) {
+            return 0;
+        }
+        if (scenario->recovery == BUTTON_PRESS) {
+            return press_accepted_time_us;
+        }
+        const Co2SensorController::SensorHealth health = Co2SensorController::get_sensor_health(0);
+        ///< Health of the sensor, for the age of the last valid reading.
+        const uint64_t last_valid_reading_age_us =
+                static_cast<uint64_t>(health.time_since_last_valid_reading_ms) * 1000ULL;
+        ///< Age of the last valid reading.
+        const bool is_reading_valid_since_removal = health.time_since_last_valid_reading_ms !=
+                                                    Co2SensorController::NO_VALID_READING &&
+                                                    HostHal::get_time_us() - last_valid_reading_age_us >=
+                                                    removal_time_us;
+        ///< True, if a valid reading was taken after the removal of the fault.
+        if (!is_reading_valid_since_removal || loop_duration_us > nominal_loop_duration_us) {
+            return 0;
+        }
+        return HostHal::get_time_us();
+    }
+
+    Result run(const Scenario &scenario_to_run) {
+        scenario = &scenario_to_run;
+        result = {};
+        injection_time_us = HostHal::get_time_us() + INJECTION_DELAY_US;
+        removal_time_us = 0;
+        is_fault_injected = false;
+        press_accepted_time_us = 0;
+        clock_jump_us = 0;
+        for (int i = 0; i < MAX_NUMBER_OF_LOOPS && !result.is_recovered; i++) {
+            const uint64_t loop_start_time_us = HostHal::get_time_us(); ///< Start of the loop iteration.
+            const int64_t clock_jump_before_loop_us = clock_jump_us; ///< Clock jump before the loop iteration.
+            loop();
+            const uint64_t loop_duration_us = HostHal::get_time_us() - loop_start_time_us -
+                                              static_cast<uint64_t>(clock_jump_us - clock_jump_before_loop_us);
+            ///< Duration of the loop iteration (without a clock jump in between).
+            if (loop_duration_us > result.max_loop_duration_us) {
+                result.max_loop_duration_us = loop_duration_us;
+            }
+            const uint64_t recovery_time_us = get_recovery_time_us(loop_duration_us);
+            ///< Time of the recovery, 0 if not recovered yet.
+            if (recovery_time_us != 0) {
+                result.is_recovered = true;
+                result.time_to_recovery_us = recovery_time_us - removal_time_us;
+            }
+        }
+        if (result.max_watchdog_gap_us >= WATCHDOG_TIMEOUT_US) {
+            result.is_recovered = false; // the watchdog would have reset the MCU
+        }
+        scenario = nullptr;
+        return result;
+    }
+
+    std::map<std::string, unsigned long> read_baseline(const char *path) {
+        std::map<std::string, unsigned long> metrics; ///< Metrics by name.
+        std::ifstream file(path);
+        for (std::string line; std::getline(file, line);) {
+            char name[64];
+            unsigned long value = 0;
+            if (line[0] != '#' && std::sscanf(line.c_str(), "%63s %lu", name, &value) == 2) {
+                metrics[name] = value;
+            }
+        }
+        return metrics;
+    }
+
+    bool write_baseline(const char *path, const std::map<std::string, unsigned long> &metrics) {
+        std::ofstream file(path);
+        file << "# name value\n";
+        for (const auto &metric: metrics) {
+            file << metric.first << ' ' << metric.second << '\n';
+        }
+        return static_cast<bool>(file);
+    }
+}
+
+int main(const int argc, char **argv) {
+    const char *baseline_path = nullptr;
+    const char *new_baseline_path = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--baseline")) {
+            baseline_path = argv[i + 1];
+        } else if (!std::strcmp(argv[i], "--write-baseline")) {
+            new_baseline_path = argv[i + 1];
+        }
+    }
+
+    HostHal::set_co2_ppm(FaultInjection::CO2_PPM);
+    HostHal::set_sensor_preheating(false);
+    HostHal::set_serial_byte_time_us(FaultInjection::SERIAL_BYTE_TIME_US);
+    HostHal::set_software_serial_byte_time_us(FaultInjection::SERIAL_BYTE_TIME_US);
+    HostHal::set_time_hook(FaultInjection::update);
+    setup();
+    for (int i = 0; i < FaultInjection::NUMBER_OF_SETTLING_LOOPS; i++) {
+        const uint64_t loop_start_time_us = HostHal::get_time_us(); ///< Start of the loop iteration.
+        loop();
+        const uint64_t loop_duration_us = HostHal::get_time_us() - loop_start_time_us;
+        ///< Duration of the loop iteration.
+        if (loop_duration_us > FaultInjection::nominal_loop_duration_us) {
+            FaultInjection::nominal_loop_duration_us = loop_duration_us;
+        }
+    }
+    if (BootTimeline::get_time_to_first_reading_ms() == 0) {
+        std::printf("no valid reading after %d loop iterations\n", FaultInjection::NUMBER_OF_SETTLING_LOOPS);
+        return EXIT_FAILURE;
+    }
+    std::printf("nominal loop duration: %.3f ms\n",
+                FaultInjection::nominal_loop_duration_us / FaultInjection::MICROSECONDS_PER_MILLISECOND);
+
+    const std::map<std::string, unsigned long> baseline = baseline_path
+                                                              ? FaultInjection::read_baseline(baseline_path)
+                                                              : std::map<std::string, unsigned long>();
+    std::map<std::string, unsigned long> metrics; ///< Measured metrics for the baseline file.
+    bool is_passed = true; ///< True, if all scenarios recovered without regression.
+    std::printf("%-26s %14s %14s %14s %14s\n", "scenario", "recovery [ms]", "max loop [ms]", "max wdt gap [ms]",
+                "max isr [ms]");
+    for (const FaultInjection::Scenario &scenario: FaultInjection::SCENARIOS) {
+        const FaultInjection::Result result = FaultInjection::run(scenario);
+        const std::string name = scenario.name; ///< Prefix of the metric names.
+        const unsigned long measured_metrics[] = {
+            static_cast<unsigned long>(result.time_to_recovery_us / 1000ULL),
+            static_cast<unsigned long>(result.max_loop_duration_us / 1000ULL),
+            static_cast<unsigned long>(result.max_watchdog_gap_us / 1000ULL),
+            static_cast<unsigned long>(result.max_isr_duration_us / 1000ULL)
+        }; ///< Metrics of the scenario in ms, in the order of `METRIC_NAMES`.
+        bool is_regression = false; ///< True, if a metric is worse than in the baseline.
+        for (uint8_t i = 0; i < FaultInjection::NUMBER_OF_METRICS; i++) {
+            const std::string metric_name = name + '.' + FaultInjection::METRIC_NAMES[i]; ///< Name in the baseline.
+            if (result.is_recovered) {
+                metrics[metric_name] = measured_metrics[i]; // a failed scenario must not become the reference
+            }
+            const auto baseline_metric = baseline.find(metric_name); ///< Metric in the baseline, if any.
+            if (baseline_metric != baseline.end() && measured_metrics[i] > baseline_metric->second) {
+                is_regression = true;
+            }
+        }
+        const char *verdict = !result.is_recovered ? " NOT RECOVERED" : is_regression ? " FAIL" : "";
+        ///< Reason of a failure.
+        if (*verdict) {
+            is_passed = false;
+        }
+        const char *note = result.max_watchdog_gap_us >= FaultInjection::WATCHDOG_TIMEOUT_US ? " (watchdog reset)" : "";
+        ///< Reason, if the watchdog would have reset the MCU.
+        std::printf("%-26s %14.3f %14.3f %16.3f %14.3f%s%s\n", scenario.name,
+                    result.time_to_recovery_us / FaultInjection::MICROSECONDS_PER_MILLISECOND,
+                    result.max_loop_duration_us / FaultInjection::MICROSECONDS_PER_MILLISECOND,
+                    result.max_watchdog_gap_us / FaultInjection::MICROSECONDS_PER_MILLISECOND,
+                    result.max_isr_duration_us / FaultInjection::MICROSECONDS_PER_MILLISECOND, verdict, note);
+    }
+    if (new_baseline_path && !FaultInjection::write_baseline(new_baseline_path, metrics)) {
+        std::printf("could not write baseline %s\n", new_baseline_path);
+        return EXIT_FAILURE;
+    }
+    return is_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,361 @@
+/**
+ * @file    history_archive.cpp
+ * @brief   Converts the exported history of a meter into the columnar history format and scans history files.
+ * @details `pack` extracts one sample per valid reading (the `current_co2_measurement_ppm` trace line) with its
+ *          air quality level and the events logged until the next reading from text logs (as captured from the serial
+ *          port) or stores of the log ingester, and writes them as history file (see history_format.h).
+ *          `scan` prints the samples of a time range from the memory-mapped file, `info` describes a file.
+ *
+ *          Usage: history_archive pack [--start-time <s>] <archive> <log file | store directory>...
+ *                 history_archive scan [--from <ms>] [--to <ms>] [--min-ppm <n>] [--events <mask>] [--count] <archive>
+ *                 history_archive info <archive>
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <vector>
+#include <measurement_interpreter.h>
+#include "history_reader.h"
+#include "history_writer.h"
+#include "log_line_parser.h"
+
+namespace HistoryArchive {
+    /**
+     * @struct  Extractor
+     * @brief   Turns a stream of log records into samples.
+     */
+    struct Extractor {
+        HistoryWriter::Writer writer; ///< The history file being written.
+        HistoryFormat::Sample sample; ///< Sample of the current reading (written with the next reading).
+        bool has_sample; ///< True, if `sample` holds a reading.
+        uint8_t pending_events; ///< Events logged before the first reading of a session.
+        int64_t start_time_ms; ///< Added to the times of text logs.
+        int64_t time_offset_ms; ///< Unwraps the time of day of text logs (days and restarts).
+        int64_t last_device_time_ms; ///< Time of day of the previous text log line, -1 before the first one.
+        uint64_t number_of_samples; ///< Samples written.
+        uint64_t input_size; ///< Bytes read from the inputs.
+    };
+
+    /**
+     * @brief   Creates the archive and appends the samples of all inputs.
+     * @return  EXIT_SUCCESS or EXIT_FAILURE.
+     */
+    int pack(int argc, char **argv);
+
+    /**
+     * @brief   Prints the samples of the archive matching the query.
+     * @return  EXIT_SUCCESS or EXIT_FAILURE.
+     */
+    int scan(int argc, char **argv);
+
+    /**
+     * @brief   Prints the blocks and sizes of the archive.
+     * @return  EXIT_SUCCESS or EXIT_FAILURE.
+     */
+    int info(int argc, char **argv);
+
+    /**
+     * @brief   Reads a text log (one log line per line).
+     * @return  true on success, false otherwise.
+     */
+    bool read_log_file(Extractor &extractor, const std::string &path);
+
+    /**
+     * @brief   Reads the rows of a log ingester store.
+     * @return  true on success, false otherwise.
+     */
+    bool read_store(Extractor &extractor, const std::string &directory);
+
+    /**
+     * @brief   Adds a log record: a reading starts a new sample, messages are added as events.
+     * @param   extractor The extractor.
+     * @param   time_ms Time of the record.
+     * @param   key The message or the variable name.
+     * @param   has_number True, if the record is a variable with numeric value.
+     * @param   number The value of the variable.
+     * @return  true on success, false if writing the previous sample failed.
+     */
+    bool add_record(Extractor &extractor, int64_t time_ms, std::string_view key, bool has_number, int64_t number);
+
+    /**
+     * @brief   Reads a whole column file of fixed-size values.
+     * @return  true on success, false otherwise.
+     */
+    template<typename T>
+    bool read_column(const std::string &path, std::vector<T> &values);
+
+    constexpr char CO2_KEY[] = "current_co2_measurement_ppm"; ///< Variable of the filtered reading in the log.
+    constexpr int64_t NO_NUMERIC_VALUE = INT64_MIN; ///< Value of rows without a number in a store (`ColumnStore`).
+    constexpr int64_t MILLISECONDS_PER_DAY = 24LL * 3600LL * 1000LL; ///< Period of the time of day of text logs.
+    constexpr int64_t MIN_MIDNIGHT_JUMP_MS = 23LL * 3600LL * 1000LL;
+    ///< A smaller jump back in the time of day of a text log is a restart (the time starts again at 0).
+
+    /**
+     * @struct  EventMessage
+     * @brief   Log message of an event (see `LogController`).
+     */
+    struct EventMessage {
+        std::string_view prefix; ///< Start of the message.
+        HistoryFormat::Event event; ///< The event.
+    };
+
+    constexpr EventMessage EVENT_MESSAGES[] = {
+        {"Audio warning issued", HistoryFormat::AUDIO_WARNING},
+        {"Acknowledge button pressed", HistoryFormat::ACKNOWLEDGE_BUTTON},
+        {"Mute button pressed", HistoryFormat::MUTE_BUTTON},
+        {"System ready", HistoryFormat::RESTART},
+        {"Measurement rejected as outlier", HistoryFormat::MEASUREMENT_REJECTED}
+    }; ///< Messages recorded in the event column.
+
+    constexpr char USAGE[] =
+            "Usage: history_archive pack [--start-time <s>] <archive> <log file | store directory>...\n"
+            "       history_archive scan [--from <ms>] [--to <ms>] [--min-ppm <n>] [--events <mask>] [--count] "
+            "<archive>\n"
+            "       history_archive info <archive>\n";
+
+    int pack(const int argc, char **argv) {
+        Extractor extractor = {};
+        extractor.last_device_time_ms = -1;
+        std::vector<std::string> paths;
+        for (int i = 0; i < argc; i++) {
+            if (!std::strcmp(argv[i], "--start-time") && i + 1 < argc) {
+                extractor.start_time_ms = std::strtoll(argv[++i], nullptr, 10) * 1000LL;
+            } else {
+                paths.emplace_back(argv[i]);
+            }
+        }
+        if (paths.size() < 2) {
+            std::fputs(USAGE, stderr);
+            return EXIT_FAILURE;
+        }
+        if (!HistoryWriter::open(extractor.writer, paths[0])) {
+            std::perror(paths[0].c_str());
+            return EXIT_FAILURE;
+        }
+        for (size_t i = 1; i < paths.size(); i++) {
+            struct stat status = {};
+            const bool is_directory = stat(paths[i].c_str(), &status) == 0 && S_ISDIR(status.st_mode);
+            if (!(is_directory ? read_store(extractor, paths[i]) : read_log_file(extractor, paths[i]))) {
+                std::fprintf(stderr, "could not read %s\n", paths[i].c_str());
+                HistoryWriter::close(extractor.writer);
+                return EXIT_FAILURE;
+            }
+        }
+        if ((extractor.has_sample && !HistoryWriter::append(extractor.writer, extractor.sample)) ||
+            !HistoryWriter::close(extractor.writer)) {
+            std::perror(paths[0].c_str());
+            return EXIT_FAILURE;
+        }
+        extractor.number_of_samples += extractor.has_sample;
+        const uint64_t output_size = extractor.writer.offset;
+        std::printf("samples: %llu, blocks: %zu, input: %llu bytes, archive: %llu bytes (%.2f bytes per sample, "
+                    "%.3f %% of the input)\n",
+                    static_cast<unsigned long long>(extractor.number_of_samples), extractor.writer.blocks.size(),
+                    static_cast<unsigned long long>(extractor.input_size),
+                    static_cast<unsigned long long>(output_size),
+                    extractor.number_of_samples
+                        ? static_cast<double>(output_size) / static_cast<double>(extractor.number_of_samples)
+                        : 0.0,
+                    extractor.input_size
+                        ? 100.0 * static_cast<double>(output_size) / static_cast<double>(extractor.input_size)
+                        : 0.0);
+        return EXIT_SUCCESS;
+    }
+
+    int scan(const int argc, char **argv) {
+        HistoryReader::Query query;
+        bool is_count_only = false;
+        const char *path = nullptr;
+        for (int i = 0; i < argc; i++) {
+            const bool has_value = i + 1 < argc;
+            if (!std::strcmp(argv[i], "--from") && has_value) {
+                query.from_ms = std::strtoll(argv[++i], nullptr, 10);
+            } else if (!std::strcmp(argv[i], "--to") && has_value) {
+                query.to_ms = std::strtoll(argv[++i], nullptr, 10);
+            } else if (!std::strcmp(argv[i], "--min-ppm") && has_value) {
+                query.min_co2_ppm = static_cast<int32_t>(std::strtol(argv[++i], nullptr, 10));
+            } else if (!std::strcmp(argv[i], "--events") && has_value) {
+                query.event_mask = static_cast<uint8_t>(std::strtoul(argv[++i], nullptr, 0));
+            } else if (!std::strcmp(argv[i], "--count")) {
+                is_count_only = true;
+            } else {
+                path = argv[i];
+            }
+        }
+        HistoryReader::Archive archive;
+        if (!path || !HistoryReader::open(archive, path)) {
+            std::fputs(path ? "not a valid history file\n" : USAGE, stderr);
+            return EXIT_FAILURE;
+        }
+        if (!is_count_only) {
+            std::printf("time_ms,co2_ppm,level_index,events\n");
+        }
+        HistoryReader::ScanStatistics statistics;
+        const bool is_read = HistoryReader::scan(archive, query, [is_count_only](const HistoryFormat::Sample &sample) {
+            if (!is_count_only) {
+                std::printf("%lld,%d,%u,%u\n", static_cast<long long>(sample.time_ms), sample.co2_ppm,
+                            sample.level_index, sample.events);
+            }
+        }, statistics);
+        std::fprintf(stderr, "samples: %llu, decoded blocks: %u, skipped blocks: %u, blocks in the file: %u\n",
+                     static_cast<unsigned long long>(statistics.matching_samples), statistics.decoded_blocks,
+                     statistics.skipped_blocks, archive.number_of_blocks);
+        HistoryReader::close(archive);
+        if (!is_read) {
+            std::fputs("corrupt block\n", stderr);
+        }
+        return is_read ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    int info(const int argc, char **argv) {
+        HistoryReader::Archive archive;
+        if (argc != 1 || !HistoryReader::open(archive, argv[0])) {
+            std::fputs(argc != 1 ? USAGE : "not a valid history file\n", stderr);
+            return EXIT_FAILURE;
+        }
+        uint64_t number_of_samples = 0;
+        uint64_t column_sizes[4] = {}; ///< Bytes of the time, CO2, level and event columns.
+        std::printf("%8s %8s %20s %20s %8s %8s %6s %6s\n", "block", "samples", "first time [ms]", "last time [ms]",
+                    "min ppm", "max ppm", "levels", "events");
+        for (uint32_t block = 0; block < archive.number_of_blocks; block++) {
+            const HistoryFormat::BlockIndex &index = archive.blocks[block];
+            number_of_samples += index.number_of_rows;
+            column_sizes[0] += index.time_size;
+            column_sizes[1] += index.co2_size;
+            column_sizes[2] += index.level_size;
+            column_sizes[3] += index.event_size;
+            std::printf("%8u %8u %20lld %20lld %8d %8d   0x%02x   0x%02x\n", block, index.number_of_rows,
+                        static_cast<long long>(index.first_time_ms), static_cast<long long>(index.last_time_ms),
+                        index.min_co2_ppm, index.max_co2_ppm, index.level_mask, index.event_mask);
+        }
+        std::printf("samples: %llu, file: %zu bytes, columns: time %llu, co2 %llu, level %llu, events %llu bytes\n",
+                    static_cast<unsigned long long>(number_of_samples), archive.size,
+                    static_cast<unsigned long long>(column_sizes[0]), static_cast<unsigned long long>(column_sizes[1]),
+                    static_cast<unsigned long long>(column_sizes[2]),
+                    static_cast<unsigned long long>(column_sizes[3]));
+        HistoryReader::close(archive);
+        return EXIT_SUCCESS;
+    }
+
+    bool read_log_file(Extractor &extractor, const std::string &path) {
+        std::ifstream file(path);
+        if (!file) {
+            return false;
+        }
+        for (std::string line; std::getline(file, line);) {
+            extractor.input_size += line.size() + 1;
+            LogLineParser::Record record;
+            if (!LogLineParser::parse(line, record)) {
+                continue;
+            }
+            const int64_t device_time_ms = record.device_time_ms;
+            if (device_time_ms < extractor.last_device_time_ms) {
+                // The time of day wraps at midnight, a restart starts it at 0 again (the gap is not known).
+                extractor.time_offset_ms += extractor.last_device_time_ms - device_time_ms >= MIN_MIDNIGHT_JUMP_MS
+                                                ? MILLISECONDS_PER_DAY
+                                                : extractor.last_device_time_ms - device_time_ms;
+            }
+            extractor.last_device_time_ms = device_time_ms;
+            int64_t number = 0;
+            const bool has_number = record.is_variable && LogLineParser::parse_number(record.value, number);
+            if (!add_record(extractor, extractor.start_time_ms + extractor.time_offset_ms + device_time_ms, record.key,
+                            has_number, number)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool read_store(Extractor &extractor, const std::string &directory) {
+        std::vector<std::string> keys;
+        std::ifstream keys_file(directory + "/keys.txt");
+        for (std::string key; std::getline(keys_file, key);) {
+            keys.push_back(key);
+        }
+        std::vector<uint64_t> host_time_us; ///< Column `host_time_us.u64`.
+        std::vector<uint32_t> key_id; ///< Column `key_id.u32`.
+        std::vector<int64_t> value; ///< Column `value.i64`.
+        if (!read_column(directory + "/host_time_us.u64", host_time_us) ||
+            !read_column(directory + "/key_id.u32", key_id) || !read_column(directory + "/value.i64", value)) {
+            return false;
+        }
+        const size_t number_of_rows = std::min(host_time_us.size(), std::min(key_id.size(), value.size()));
+        ///< Rows completely written in all columns.
+        extractor.input_size += number_of_rows * (sizeof(uint64_t) + sizeof(uint32_t) + sizeof(int64_t));
+        for (size_t row = 0; row < number_of_rows; row++) {
+            if (key_id[row] >= keys.size()) {
+                continue;
+            }
+            if (!add_record(extractor, static_cast<int64_t>(host_time_us[row] / 1000ULL), keys[key_id[row]],
+                            value[row] != NO_NUMERIC_VALUE, value[row])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool add_record(Extractor &extractor, const int64_t time_ms, const std::string_view key, const bool has_number,
+                    const int64_t number) {
+        if (has_number && key == CO2_KEY) {
+            if (extractor.has_sample) {
+                if (!HistoryWriter::append(extractor.writer, extractor.sample)) {
+                    return false;
+                }
+                extractor.number_of_samples++;
+            }
+            const int co2_ppm = static_cast<int>(number);
+            extractor.sample = {
+                time_ms, co2_ppm, MeasurementInterpreter::get_air_quality_level_index(co2_ppm),
+                extractor.pending_events
+            };
+            extractor.has_sample = true;
+            extractor.pending_events = 0;
+            return true;
+        }
+        // The messages of a store may have a number too (e.g. the rejected value), so they are matched regardless.
+        for (const EventMessage &message: EVENT_MESSAGES) {
+            if (key.substr(0, message.prefix.size()) != message.prefix) {
+                continue;
+            }
+            // A restart belongs to the next reading, the other events to the reading before them.
+            if (message.event == HistoryFormat::RESTART || !extractor.has_sample) {
+                extractor.pending_events |= message.event;
+            } else {
+                extractor.sample.events |= message.event;
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    bool read_column(const std::string &path, std::vector<T> &values) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        values.resize(static_cast<size_t>(file.tellg()) / sizeof(T));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char *>(values.data()), values.size() * sizeof(T)));
+    }
+}
+
+int main(const int argc, char **argv) {
+    const std::string command = argc > 1 ? argv[1] : "";
+    if (command == "pack") {
+        return HistoryArchive::pack(argc - 2, argv + 2);
+    }
+    if (command == "scan") {
+        return HistoryArchive::scan(argc - 2, argv + 2);
+    }
+    if (command == "info") {
+        return HistoryArchive::info(argc - 2, argv + 2);
+    }
+    std::fputs(HistoryArchive::USAGE, stderr);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file history_format.cpp
+ * @brief Encoding and decoding of the columns of a history block.
+ */
+
+#include "history_format.h"
+
+namespace HistoryFormat {
+    /**
+     * @brief   Appends the runs of a byte column (value byte, varint run length).
+     */
+    template<typename Field>
+    void write_runs(std::vector<uint8_t> &output, const Sample *samples, size_t count, Field field);
+
+    /**
+     * @brief   Reads the runs of a byte column into the samples.
+     * @return  true if the runs cover exactly all samples, false otherwise.
+     */
+    template<typename Field>
+    bool read_runs(const uint8_t *position, const uint8_t *end, std::vector<Sample> &samples, Field field);
+
+    constexpr uint8_t VARINT_PAYLOAD_BITS = 7; ///< Payload bits per varint byte.
+    constexpr uint8_t VARINT_CONTINUATION = 0x80; ///< Set in all but the last byte of a varint.
+    constexpr uint8_t MAX_VARINT_SIZE = 10; ///< Bytes of the longest 64-bit varint.
+
+    void write_varint(std::vector<uint8_t> &output, uint64_t value) {
+        while (value >= VARINT_CONTINUATION) {
+            output.push_back(static_cast<uint8_t>(value) | VARINT_CONTINUATION);
+            value >>= VARINT_PAYLOAD_BITS;
+        }
+        output.push_back(static_cast<uint8_t>(value));
+    }
+
+    const uint8_t *read_varint(const uint8_t *position, const uint8_t *end, uint64_t &value) {
+        value = 0;
+        for (uint8_t i = 0; i < MAX_VARINT_SIZE && position < end; i++) {
+            const uint8_t byte = *position++;
+            value |= static_cast<uint64_t>(byte & ~VARINT_CONTINUATION) << (i * VARINT_PAYLOAD_BITS);
+            if (!(byte & VARINT_CONTINUATION)) {
+                return position;
+            }
+        }
+        return nullptr;
+    }
+
+    void encode_block(const Sample *samples, const size_t count, std::vector<uint8_t> &block, BlockIndex &index) {
+        index = {};
+        index.number_of_rows = static_cast<uint32_t>(count);
+        index.first_time_ms = samples[0].time_ms;
+        index.last_time_ms = samples[count - 1].time_ms;
+        index.min_co2_ppm = samples[0].co2_ppm;
+        index.max_co2_ppm = samples[0].co2_ppm;
+        block.clear();
+
+        int64_t previous_delta_ms = 0;
+        for (size_t i = 1; i < count; i++) {
+            const int64_t delta_ms = samples[i].time_ms - samples[i - 1].time_ms;
+            write_varint(block, zigzag_encode(delta_ms - previous_delta_ms));
+            previous_delta_ms = delta_ms;
+        }
+        index.time_size = static_cast<uint32_t>(block.size());
+
+        int32_t previous_co2_ppm = 0;
+        for (size_t i = 0; i < count; i++) {
+            write_varint(block, zigzag_encode(static_cast<int64_t>(samples[i].co2_ppm) - previous_co2_ppm));
+            previous_co2_ppm = samples[i].co2_ppm;
+            index.min_co2_ppm = samples[i].co2_ppm < index.min_co2_ppm ? samples[i].co2_ppm : index.min_co2_ppm;
+            index.max_co2_ppm = samples[i].co2_ppm > index.max_co2_ppm ? samples[i].co2_ppm : index.max_co2_ppm;
+            if (samples[i].level_index < 8) {
+                index.level_mask |= static_cast<uint8_t>(1U << samples[i].level_index);
+            }
+            index.event_mask |= samples[i].events;
+        }
+        index.co2_size = static_cast<uint32_t>(block.size()) - index.time_size;
+
+        write_runs(block, samples, count, [](const Sample &sample) { return sample.level_index; });
+        index.level_size = static_cast<uint32_t>(block.size()) - index.time_size - index.co2_size;
+        write_runs(block, samples, count, [](const Sample &sample) { return sample.events; });
+        index.event_size = static_cast<uint32_t>(block.size()) - index.time_size - index.co2_size - index.level_size;
+    }
+
+    bool decode_block(const uint8_t *block, const BlockIndex &index, std::vector<Sample> &samples) {
+        samples.assign(index.number_of_rows, Sample());
+        if (samples.empty()) {
+            return true;
+        }
+        const uint8_t *position = block;
+        const uint8_t *end = block + index.time_size;
+        int64_t delta_ms = 0;
+        samples[0].time_ms = index.first_time_ms;
+        for (size_t i = 1; i < samples.size(); i++) {
+            uint64_t code = 0;
+            if (!(position = read_varint(position, end, code))) {
+                return false;
+            }
+            delta_ms += zigzag_decode(code);
+            samples[i].time_ms = samples[i - 1].time_ms + delta_ms;
+        }
+        if (position != end) {
+            return false;
+        }
+
+        end += index.co2_size;
+        int64_t co2_ppm = 0;
+        for (Sample &sample: samples) {
+            uint64_t code = 0;
+            if (!(position = read_varint(position, end, code))) {
+                return false;
+            }
+            co2_ppm += zigzag_decode(code);
+            sample.co2_ppm = static_cast<int32_t>(co2_ppm);
+        }
+        if (position != end) {
+            return false;
+        }
+
+        const uint8_t *level_end = end + index.level_size;
+        return read_runs(end, level_end, samples, [](Sample &sample) -> uint8_t & { return sample.level_index; }) &&
+               read_runs(level_end, level_end + index.event_size, samples,
+                         [](Sample &sample) -> uint8_t & { return sample.events; });
+    }
+
+    template<typename Field>
+    void write_runs(std::vector<uint8_t> &output, const Sample *samples, const size_t count, Field field) {
+        for (size_t start = 0; start < count;) {
+            size_t end = start + 1;
+            while (end < count && field(samples[end]) == field(samples[start])) {
+                end++;
+            }
+            output.push_back(field(samples[start]));
+            write_varint(output, end - start);
+            start = end;
+        }
+    }
+
+    template<typename Field>
+    bool read_runs(const uint8_t *position, const uint8_t *end, std::vector<Sample> &samples, Field field) {
+        size_t row = 0;
+        while (position < end) {
+            const uint8_t value = *position++;
+            uint64_t length = 0;
+            if (!(position = read_varint(position, end, length)) || length == 0 || length > samples.size() - row) {
+                return false;
+            }
+            for (const size_t run_end = row + length; row < run_end; row++) {
+                field(samples[row]) = value;
+            }
+        }
+        return row == samples.size();
+    }
+}
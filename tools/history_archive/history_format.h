@@ -0,0 +1,151 @@
+/**
+ * @file history_format.h
+ * @brief Block-structured columnar file format for the exported history of a meter.
+ * @details All values are little-endian. A file consists of
+ *          | Part    | Content                                                                         |
+ *          |:--------|:--------------------------------------------------------------------------------|
+ *          | Header  | `Header` (16 bytes)                                                             |
+ *          | Blocks  | Up to `ROWS_PER_BLOCK` samples each, as four encoded columns (see below)        |
+ *          | Padding | Zero bytes up to the next multiple of 8                                         |
+ *          | Footer  | One `BlockIndex` (64 bytes) per block, ordered by time                          |
+ *          | Trailer | `Trailer` (16 bytes): position of the footer and number of blocks               |
+ *          The columns of a block follow each other in this order:
+ *          | Column | Encoding                                                                                |
+ *          |:-------|:----------------------------------------------------------------------------------------|
+ *          | Time   | Zigzag varint of the delta of the deltas, from the second row on (the first time is in the index) |
+ *          | CO2    | Zigzag varint of the delta to the previous row (to 0 for the first row)                 |
+ *          | Level  | Runs: level index byte, varint run length                                               |
+ *          | Events | Runs: `Event` bit mask byte, varint run length                                          |
+ *          The samples are ordered by time, so a reader finds the blocks of a time range by a binary search in the
+ *          footer and skips all other blocks. The minimum and maximum CO2 values and the levels and events of a block
+ *          are in its index entry as well, so blocks can be skipped by value without decoding them.
+ */
+
+#ifndef HISTORY_FORMAT_H
+#define HISTORY_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace HistoryFormat {
+    constexpr char FILE_MAGIC[4] = {'A', 'Q', 'M', 'H'}; ///< Start of the header.
+    constexpr char TRAILER_MAGIC[4] = {'A', 'Q', 'M', 'I'}; ///< End of the trailer.
+    constexpr uint16_t VERSION = 1; ///< Version of the format.
+    constexpr uint32_t ROWS_PER_BLOCK = 4096; ///< Samples per block (the last block may have fewer).
+    constexpr uint8_t NO_LEVEL = 0xFF; ///< Level index of a sample without known level.
+
+    /**
+     * @enum    Event
+     * @brief   Events logged between a sample and the next one (bits of the event column).
+     */
+    enum Event : uint8_t {
+        AUDIO_WARNING = 0x01, ///< An audio warning was issued.
+        ACKNOWLEDGE_BUTTON = 0x02, ///< The acknowledge button was pressed.
+        MUTE_BUTTON = 0x04, ///< The mute button was pressed.
+        RESTART = 0x08, ///< The meter was restarted before this sample (first sample of a session).
+        MEASUREMENT_REJECTED = 0x10 ///< A reading was rejected as outlier.
+    };
+
+    /**
+     * @struct  Sample
+     * @brief   A decoded row: one valid reading of the meter.
+     */
+    struct Sample {
+        int64_t time_ms; ///< Time of the reading (ms since the Unix epoch, or since the start of a text log).
+        int32_t co2_ppm; ///< Filtered CO2 reading.
+        uint8_t level_index; ///< Index in `AirQuality::AIR_QUALITY_LEVELS`, `NO_LEVEL` if unknown.
+        uint8_t events; ///< Bit mask of `Event`.
+    };
+
+    /**
+     * @struct  Header
+     * @brief   Start of the file.
+     */
+    struct Header {
+        char magic[4]; ///< `FILE_MAGIC`.
+        uint16_t version; ///< `VERSION`.
+        uint16_t header_size; ///< Size of the header (position of the first block).
+        uint32_t rows_per_block; ///< `ROWS_PER_BLOCK` of the writer.
+        uint32_t reserved; ///< 0.
+    };
+
+    /**
+     * @struct  BlockIndex
+     * @brief   Footer entry of a block: position, column sizes and the value ranges.
+     */
+    struct BlockIndex {
+        uint64_t offset; ///< Position of the block in the file.
+        uint32_t number_of_rows; ///< Samples in the block.
+        uint32_t time_size; ///< Bytes of the time column.
+        uint32_t co2_size; ///< Bytes of the CO2 column.
+        uint32_t level_size; ///< Bytes of the level column.
+        uint32_t event_size; ///< Bytes of the event column.
+        uint32_t reserved; ///< 0.
+        int64_t first_time_ms; ///< Time of the first sample.
+        int64_t last_time_ms; ///< Time of the last sample.
+        int32_t min_co2_ppm; ///< Lowest CO2 reading.
+        int32_t max_co2_ppm; ///< Highest CO2 reading.
+        uint8_t level_mask; ///< Levels in the block (bit = level index).
+        uint8_t event_mask; ///< Events in the block (OR of the event column).
+        uint8_t padding[6]; ///< 0.
+    };
+
+    /**
+     * @struct  Trailer
+     * @brief   End of the file.
+     */
+    struct Trailer {
+        uint64_t footer_offset; ///< Position of the footer.
+        uint32_t number_of_blocks; ///< Entries in the footer.
+        char magic[4]; ///< `TRAILER_MAGIC`.
+    };
+
+    static_assert(sizeof(Header) == 16 && sizeof(BlockIndex) == 64 && sizeof(Trailer) == 16,
+                  "The structures are written as they are and must not contain compiler padding.");
+
+    /**
+     * @brief   Returns the zigzag code of a signed value (small magnitudes give small codes).
+     */
+    inline uint64_t zigzag_encode(const int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    /**
+     * @brief   Returns the signed value of a zigzag code.
+     */
+    inline int64_t zigzag_decode(const uint64_t code) {
+        return static_cast<int64_t>(code >> 1) ^ -static_cast<int64_t>(code & 1);
+    }
+
+    /**
+     * @brief   Appends a value as varint (7 bits per byte, least significant first, high bit = more bytes).
+     */
+    void write_varint(std::vector<uint8_t> &output, uint64_t value);
+
+    /**
+     * @brief   Reads a varint.
+     * @return  The position after the varint, `nullptr` if it is truncated or longer than 10 bytes.
+     */
+    const uint8_t *read_varint(const uint8_t *position, const uint8_t *end, uint64_t &value);
+
+    /**
+     * @brief   Encodes the samples of one block and fills the sizes and value ranges of its index entry.
+     * @param   samples The samples (at least one, ordered by time).
+     * @param   count The number of samples.
+     * @param   block Output: the encoded columns.
+     * @param   index Output: the index entry (without the offset).
+     */
+    void encode_block(const Sample *samples, size_t count, std::vector<uint8_t> &block, BlockIndex &index);
+
+    /**
+     * @brief   Decodes a block.
+     * @param   block The encoded columns (`index.time_size + ... + index.event_size` bytes).
+     * @param   index The index entry of the block.
+     * @param   samples Output: the decoded samples (replaces the content).
+     * @return  true on success, false if the block is corrupt.
+     */
+    bool decode_block(const uint8_t *block, const BlockIndex &index, std::vector<Sample> &samples);
+}
+
+#endif //HISTORY_FORMAT_H
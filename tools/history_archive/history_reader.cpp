@@ -0,0 +1,101 @@
+/**
+ * @file history_reader.cpp
+ * @brief Implementation of the memory-mapped history file reader.
+ */
+
+#include "history_reader.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace HistoryReader {
+    /**
+     * @brief   Returns true, if the footer is consistent with the file (blocks inside the file, ordered by time).
+     */
+    bool is_footer_valid(const Archive &archive, uint64_t footer_offset);
+
+    bool open(Archive &archive, const std::string &path) {
+        archive = {};
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            return false;
+        }
+        struct stat status = {};
+        const bool has_size = fstat(file, &status) == 0 &&
+                              static_cast<size_t>(status.st_size) >=
+                              sizeof(HistoryFormat::Header) + sizeof(HistoryFormat::Trailer);
+        void *mapping = has_size
+                            ? mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0)
+                            : MAP_FAILED;
+        ::close(file); // the mapping keeps the file open
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        archive.data = static_cast<const uint8_t *>(mapping);
+        archive.size = static_cast<size_t>(status.st_size);
+
+        HistoryFormat::Header header;
+        HistoryFormat::Trailer trailer;
+        std::memcpy(&header, archive.data, sizeof(header));
+        std::memcpy(&trailer, archive.data + archive.size - sizeof(trailer), sizeof(trailer));
+        if (std::memcmp(header.magic, HistoryFormat::FILE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != HistoryFormat::VERSION ||
+            std::memcmp(trailer.magic, HistoryFormat::TRAILER_MAGIC, sizeof(trailer.magic)) != 0 ||
+            trailer.footer_offset % alignof(HistoryFormat::BlockIndex) != 0 ||
+            trailer.footer_offset + static_cast<uint64_t>(trailer.number_of_blocks) *
+            sizeof(HistoryFormat::BlockIndex) + sizeof(trailer) != archive.size) {
+            close(archive);
+            return false;
+        }
+        archive.blocks = reinterpret_cast<const HistoryFormat::BlockIndex *>(archive.data + trailer.footer_offset);
+        archive.number_of_blocks = trailer.number_of_blocks;
+        if (!is_footer_valid(archive, trailer.footer_offset)) {
+            close(archive);
+            return false;
+        }
+        madvise(mapping, archive.size, MADV_RANDOM); // blocks are read selectively, no read-ahead of skipped blocks
+        return true;
+    }
+
+    void close(Archive &archive) {
+        if (archive.data) {
+            munmap(const_cast<uint8_t *>(archive.data), archive.size);
+        }
+        archive = {};
+    }
+
+    uint32_t find_block(const Archive &archive, const int64_t time_ms) {
+        uint32_t first = 0;
+        uint32_t last = archive.number_of_blocks;
+        while (first < last) {
+            const uint32_t middle = first + (last - first) / 2;
+            if (archive.blocks[middle].last_time_ms < time_ms) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        return first;
+    }
+
+    bool read_block(const Archive &archive, const uint32_t block, std::vector<HistoryFormat::Sample> &samples) {
+        const HistoryFormat::BlockIndex &index = archive.blocks[block];
+        return HistoryFormat::decode_block(archive.data + index.offset, index, samples);
+    }
+
+    bool is_footer_valid(const Archive &archive, const uint64_t footer_offset) {
+        for (uint32_t block = 0; block < archive.number_of_blocks; block++) {
+            const HistoryFormat::BlockIndex &index = archive.blocks[block];
+            const uint64_t size = static_cast<uint64_t>(index.time_size) + index.co2_size + index.level_size +
+                                  index.event_size;
+            if (index.offset < sizeof(HistoryFormat::Header) || index.offset + size > footer_offset ||
+                index.number_of_rows == 0 || index.first_time_ms > index.last_time_ms ||
+                (block > 0 && index.first_time_ms < archive.blocks[block - 1].last_time_ms)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
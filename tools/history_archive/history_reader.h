@@ -0,0 +1,109 @@
+/**
+ * @file history_reader.h
+ * @brief Memory-mapped reader of history files (see history_format.h).
+ * @details The file is mapped read-only, the footer is used in place. A scan looks up the first block of the time range
+ *          by a binary search in the footer and decodes only the blocks that overlap the range and pass the value
+ *          filter, all other blocks are not touched (so their pages are never read from disk).
+ */
+
+#ifndef HISTORY_READER_H
+#define HISTORY_READER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "history_format.h"
+
+namespace HistoryReader {
+    /**
+     * @struct  Archive
+     * @brief   Mapped history file.
+     */
+    struct Archive {
+        const uint8_t *data; ///< Start of the mapping, `nullptr` if not open.
+        size_t size; ///< Size of the file.
+        const HistoryFormat::BlockIndex *blocks; ///< Footer (in the mapping).
+        uint32_t number_of_blocks; ///< Entries in the footer.
+    };
+
+    /**
+     * @struct  Query
+     * @brief   Samples to scan.
+     */
+    struct Query {
+        int64_t from_ms = INT64_MIN; ///< First time of the range (inclusive).
+        int64_t to_ms = INT64_MAX; ///< Last time of the range (inclusive).
+        int32_t min_co2_ppm = INT32_MIN; ///< Only samples with at least this CO2 value.
+        uint8_t event_mask = 0; ///< Only samples with one of these events (0 = all samples).
+    };
+
+    /**
+     * @struct  ScanStatistics
+     * @brief   Work done by a scan.
+     */
+    struct ScanStatistics {
+        uint32_t decoded_blocks; ///< Blocks decoded.
+        uint32_t skipped_blocks; ///< Blocks in the time range skipped by their index entry.
+        uint64_t matching_samples; ///< Samples passed to the visitor.
+    };
+
+    /**
+     * @brief   Maps a history file and validates its header, trailer and footer.
+     * @return  true on success, false otherwise.
+     */
+    bool open(Archive &archive, const std::string &path);
+
+    /**
+     * @brief   Unmaps the file.
+     */
+    void close(Archive &archive);
+
+    /**
+     * @brief   Returns the first block whose last sample is not older than the given time (`number_of_blocks` if none).
+     */
+    uint32_t find_block(const Archive &archive, int64_t time_ms);
+
+    /**
+     * @brief   Decodes a block.
+     * @return  true on success, false if the block is corrupt.
+     */
+    bool read_block(const Archive &archive, uint32_t block, std::vector<HistoryFormat::Sample> &samples);
+
+    /**
+     * @brief   Calls the visitor with every sample matching the query, in time order.
+     * @param   archive The open archive.
+     * @param   query The samples to scan.
+     * @param   visit Called as `visit(const HistoryFormat::Sample &)`.
+     * @param   statistics Output: the work done.
+     * @return  true on success, false if a block is corrupt.
+     */
+    template<typename Visitor>
+    bool scan(const Archive &archive, const Query &query, Visitor visit, ScanStatistics &statistics) {
+        statistics = {};
+        std::vector<HistoryFormat::Sample> samples;
+        for (uint32_t block = find_block(archive, query.from_ms);
+             block < archive.number_of_blocks && archive.blocks[block].first_time_ms <= query.to_ms; block++) {
+            const HistoryFormat::BlockIndex &index = archive.blocks[block];
+            if (index.max_co2_ppm < query.min_co2_ppm ||
+                (query.event_mask != 0 && (index.event_mask & query.event_mask) == 0)) {
+                statistics.skipped_blocks++;
+                continue;
+            }
+            if (!read_block(archive, block, samples)) {
+                return false;
+            }
+            statistics.decoded_blocks++;
+            for (const HistoryFormat::Sample &sample: samples) {
+                if (sample.time_ms >= query.from_ms && sample.time_ms <= query.to_ms &&
+                    sample.co2_ppm >= query.min_co2_ppm &&
+                    (query.event_mask == 0 || (sample.events & query.event_mask) != 0)) {
+                    statistics.matching_samples++;
+                    visit(sample);
+                }
+            }
+        }
+        return true;
+    }
+}
+
+#endif //HISTORY_READER_H
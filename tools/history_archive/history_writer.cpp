@@ -0,0 +1,85 @@
+/**
+ * @file history_writer.cpp
+ * @brief Implementation of the sequential history file writer.
+ */
+
+#include "history_writer.h"
+#include <cstring>
+
+namespace HistoryWriter {
+    /**
+     * @brief   Writes bytes to the file and advances the offset.
+     * @return  true on success, false otherwise.
+     */
+    bool write(Writer &writer, const void *data, size_t size);
+
+    /**
+     * @brief   Encodes and writes the buffered samples as one block.
+     * @return  true on success, false otherwise.
+     */
+    bool write_block(Writer &writer);
+
+    constexpr size_t FOOTER_ALIGNMENT = 8; ///< The footer starts at a multiple of 8, so it can be read in place.
+
+    bool open(Writer &writer, const std::string &path) {
+        writer.file = std::fopen(path.c_str(), "wb");
+        writer.offset = 0;
+        writer.samples.clear();
+        writer.samples.reserve(HistoryFormat::ROWS_PER_BLOCK);
+        writer.blocks.clear();
+        if (!writer.file) {
+            return false;
+        }
+        HistoryFormat::Header header = {};
+        std::memcpy(header.magic, HistoryFormat::FILE_MAGIC, sizeof(header.magic));
+        header.version = HistoryFormat::VERSION;
+        header.header_size = sizeof(header);
+        header.rows_per_block = HistoryFormat::ROWS_PER_BLOCK;
+        return write(writer, &header, sizeof(header));
+    }
+
+    bool append(Writer &writer, const HistoryFormat::Sample &sample) {
+        const bool is_ordered = writer.samples.empty()
+                                    ? writer.blocks.empty() || sample.time_ms >= writer.blocks.back().last_time_ms
+                                    : sample.time_ms >= writer.samples.back().time_ms;
+        if (!is_ordered) {
+            return false;
+        }
+        writer.samples.push_back(sample);
+        return writer.samples.size() < HistoryFormat::ROWS_PER_BLOCK || write_block(writer);
+    }
+
+    bool close(Writer &writer) {
+        bool is_written = writer.samples.empty() || write_block(writer);
+        const uint8_t padding[FOOTER_ALIGNMENT] = {};
+        is_written = is_written && write(writer, padding, (FOOTER_ALIGNMENT - writer.offset % FOOTER_ALIGNMENT) %
+                                                          FOOTER_ALIGNMENT);
+        HistoryFormat::Trailer trailer = {};
+        trailer.footer_offset = writer.offset;
+        trailer.number_of_blocks = static_cast<uint32_t>(writer.blocks.size());
+        std::memcpy(trailer.magic, HistoryFormat::TRAILER_MAGIC, sizeof(trailer.magic));
+        is_written = is_written &&
+                     write(writer, writer.blocks.data(), writer.blocks.size() * sizeof(HistoryFormat::BlockIndex)) &&
+                     write(writer, &trailer, sizeof(trailer));
+        const bool is_closed = std::fclose(writer.file) == 0;
+        writer.file = nullptr;
+        return is_written && is_closed;
+    }
+
+    bool write(Writer &writer, const void *data, const size_t size) {
+        if (size != 0 && std::fwrite(data, 1, size, writer.file) != size) {
+            return false;
+        }
+        writer.offset += size;
+        return true;
+    }
+
+    bool write_block(Writer &writer) {
+        HistoryFormat::BlockIndex index;
+        HistoryFormat::encode_block(writer.samples.data(), writer.samples.size(), writer.block, index);
+        index.offset = writer.offset;
+        writer.samples.clear();
+        writer.blocks.push_back(index);
+        return write(writer, writer.block.data(), writer.block.size());
+    }
+}
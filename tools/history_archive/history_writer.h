@@ -0,0 +1,48 @@
+/**
+ * @file history_writer.h
+ * @brief Sequential writer of history files (see history_format.h).
+ * @details The samples are buffered until a block is full, then the block is encoded and written. The footer is written
+ *          when the writer is closed, so a file is only readable after `close`.
+ */
+
+#ifndef HISTORY_WRITER_H
+#define HISTORY_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "history_format.h"
+
+namespace HistoryWriter {
+    /**
+     * @struct  Writer
+     * @brief   Open history file with its buffered samples and the index of the written blocks.
+     */
+    struct Writer {
+        std::FILE *file; ///< The file being written.
+        uint64_t offset; ///< Bytes written so far.
+        std::vector<HistoryFormat::Sample> samples; ///< Samples of the block being filled.
+        std::vector<HistoryFormat::BlockIndex> blocks; ///< Index entries of the written blocks.
+        std::vector<uint8_t> block; ///< Encoding buffer (reused for every block).
+    };
+
+    /**
+     * @brief   Creates a history file and writes its header.
+     * @return  true on success, false otherwise (errno is set).
+     */
+    bool open(Writer &writer, const std::string &path);
+
+    /**
+     * @brief   Appends a sample. The sample is written with the next full block or `close`.
+     * @return  true on success, false if the sample is older than the previous one or writing a block failed.
+     */
+    bool append(Writer &writer, const HistoryFormat::Sample &sample);
+
+    /**
+     * @brief   Writes the buffered samples, the footer and the trailer and closes the file.
+     * @return  true on success, false otherwise.
+     */
+    bool close(Writer &writer);
+}
+
+#endif //HISTORY_WRITER_H
@@ -0,0 +1,204 @@
+/**
+ * @file    history_device.cpp
+ * @brief   Stand-in of a meter on a pseudo terminal, for the history download.
+ * @details Runs the unmodified firmware on the host HAL: first in simulated time, until the history log in the
+ *          simulated EEPROM holds the given number of hours, then in real time with `Serial` connected to a pseudo
+ *          terminal. The path of the terminal is printed, a host client (e.g. tools/history_download) can open it like
+ *          the USB serial port of the meter. The log output, the baud rate switches and the byte times of the serial
+ *          link behave as on the device; bytes sent by the firmware can be corrupted at random to exercise the
+ *          retransmission.
+ *
+ *          Usage: program [--prefill-hours <h>] [--corruption-rate <fraction>] [--link <path>] [--seed <n>]
+ *
+ *          Runs until it is terminated.
+ */
+
+#include <Arduino.h>
+#include <host_hal.h>
+#include <history_log.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+
+void setup(); ///< Firmware set-up (src/main.cpp).
+void loop(); ///< Firmware main loop (src/main.cpp).
+
+namespace HistoryDevice {
+    constexpr double DEFAULT_PREFILL_HOURS = 72.0; ///< Default history before the pseudo terminal is opened.
+    constexpr uint32_t PWM_CYCLE_US = 1004000; ///< Cycle period of the simulated MH-Z19B.
+    constexpr uint32_t BITS_PER_BYTE = 10; ///< Start bit, 8 data bits and stop bit (8N1).
+    constexpr uint64_t MICROSECONDS_PER_SECOND = 1000000ULL; ///< Conversion factor for the times.
+    constexpr uint64_t NANOSECONDS_PER_MICROSECOND = 1000ULL; ///< Conversion factor for the real time.
+    constexpr uint64_t MICROSECONDS_PER_HOUR = 3600ULL * MICROSECONDS_PER_SECOND; ///< Conversion factor for the times.
+    constexpr double HOURS_PER_DAY = 24.0; ///< Period of the simulated room occupancy.
+    constexpr double OUTDOOR_CO2_PPM = 450.0; ///< CO2 value of the empty room.
+    constexpr double OCCUPIED_CO2_PPM = 1100.0; ///< Rise of the CO2 value at the peak of the occupancy.
+    constexpr double NOISE_CO2_PPM = 15.0; ///< Standard deviation of the sensor noise.
+    constexpr size_t READ_BUFFER_SIZE = 256; ///< Bytes read from the pseudo terminal at once.
+
+    double prefill_hours = DEFAULT_PREFILL_HOURS; ///< History written before the pseudo terminal is opened.
+    double corruption_rate = 0.0; ///< Probability, that a sent byte is corrupted.
+    std::mt19937 random_generator; ///< Source of the sensor noise and the corruptions.
+    int master = -1; ///< Master side of the pseudo terminal, -1 while the history is filled.
+    uint64_t real_start_time_us = 0; ///< Real time when the pseudo terminal was opened.
+    uint64_t simulated_start_time_us = 0; ///< Simulated time when the pseudo terminal was opened.
+
+    /**
+     * @brief   Returns a reading of a room, that is occupied in the afternoon of each simulated day.
+     */
+    int read_co2(uint32_t *duration_us);
+
+    /**
+     * @brief   Sends the bytes written by the firmware to the pseudo terminal, with the byte time of the baud rate.
+     */
+    void send(const uint8_t *data, size_t size);
+
+    /**
+     * @brief   Waits until the real time reaches the simulated time (time hook), passing received bytes to `Serial`.
+     */
+    void wait_for_real_time(uint64_t time_us);
+
+    /**
+     * @brief   Opens the pseudo terminal in raw mode.
+     * @return  Path of the terminal, or an empty string on failure.
+     */
+    std::string open_terminal();
+
+    /**
+     * @brief   Returns the real time in µs.
+     */
+    uint64_t read_real_time_us();
+
+    int read_co2(uint32_t *duration_us) {
+        *duration_us = PWM_CYCLE_US;
+        const double hour_of_day = std::fmod(static_cast<double>(HostHal::get_time_us()) / MICROSECONDS_PER_HOUR,
+                                             HOURS_PER_DAY);
+        const double occupancy = std::max(0.0, std::sin((hour_of_day - 8.0) / 10.0 * M_PI));
+        ///< Share of the peak occupancy: none at night, most at 13:00.
+        std::normal_distribution<double> noise(0.0, NOISE_CO2_PPM);
+        return static_cast<int>(OUTDOOR_CO2_PPM + OCCUPIED_CO2_PPM * occupancy + noise(random_generator));
+    }
+
+    void send(const uint8_t *data, const size_t size) {
+        const unsigned long baud_rate = HostHal::get_serial_baud_rate();
+        if (baud_rate != 0) {
+            HostHal::set_serial_byte_time_us(
+                static_cast<uint32_t>(BITS_PER_BYTE * MICROSECONDS_PER_SECOND / baud_rate));
+        }
+        if (master < 0) {
+            return;
+        }
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+        for (size_t i = 0; i < size; i++) {
+            uint8_t character = data[i];
+            if (corruption_rate > 0.0 && chance(random_generator) < corruption_rate) {
+                character ^= static_cast<uint8_t>(1U << (random_generator() % 8));
+            }
+            if (write(master, &character, 1) != 1 && errno != EAGAIN) {
+                std::perror("write");
+            } // a full buffer drops the byte, as a UART without receiver
+        }
+    }
+
+    void wait_for_real_time(const uint64_t time_us) {
+        for (;;) {
+            uint8_t buffer[READ_BUFFER_SIZE]; ///< Bytes sent by the host.
+            const ssize_t size = read(master, buffer, sizeof(buffer));
+            if (size > 0) {
+                HostHal::push_serial_input(buffer, static_cast<size_t>(size));
+            }
+            const uint64_t real_time_us = simulated_start_time_us + (read_real_time_us() - real_start_time_us);
+            if (real_time_us >= time_us) {
+                return;
+            }
+            pollfd descriptor = {master, POLLIN, 0}; ///< Wakes up when the host sends.
+            poll(&descriptor, 1, static_cast<int>((time_us - real_time_us) / 1000));
+        }
+    }
+
+    std::string open_terminal() {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            return "";
+        }
+        const std::string path = ptsname(master);
+        // Raw mode on the slave side, so the line discipline does not echo or translate the bytes. The slave stays
+        // open, so the terminal survives the (re)connections of the host.
+        const int slave = open(path.c_str(), O_RDWR | O_NOCTTY);
+        termios settings = {};
+        if (slave < 0 || tcgetattr(slave, &settings) != 0) {
+            return "";
+        }
+        cfmakeraw(&settings);
+        tcsetattr(slave, TCSANOW, &settings);
+        fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+        return path;
+    }
+
+    uint64_t read_real_time_us() {
+        timespec now; ///< Current real time.
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * MICROSECONDS_PER_SECOND +
+               static_cast<uint64_t>(now.tv_nsec) / NANOSECONDS_PER_MICROSECOND;
+    }
+}
+
+int main(const int argc, char **argv) {
+    const char *link_path = nullptr; ///< Symbolic link to the pseudo terminal (optional).
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--prefill-hours")) {
+            HistoryDevice::prefill_hours = std::strtod(argv[i + 1], nullptr);
+        } else if (!std::strcmp(argv[i], "--corruption-rate")) {
+            HistoryDevice::corruption_rate = std::strtod(argv[i + 1], nullptr);
+        } else if (!std::strcmp(argv[i], "--link")) {
+            link_path = argv[i + 1];
+        } else if (!std::strcmp(argv[i], "--seed")) {
+            HistoryDevice::random_generator.seed(static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10)));
+        } else {
+            std::fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+    HostHal::set_sensor_preheating(false);
+    HostHal::set_co2_reader(HistoryDevice::read_co2);
+    HostHal::set_serial_sink(HistoryDevice::send);
+    setup();
+    const uint64_t prefill_end_time_us = HostHal::get_time_us() +
+                                         static_cast<uint64_t>(HistoryDevice::prefill_hours *
+                                                               HistoryDevice::MICROSECONDS_PER_HOUR);
+    while (HostHal::get_time_us() < prefill_end_time_us) {
+        loop();
+    }
+
+    const std::string path = HistoryDevice::open_terminal();
+    if (path.empty()) {
+        std::perror("pseudo terminal");
+        return EXIT_FAILURE;
+    }
+    if (link_path) {
+        unlink(link_path);
+        if (symlink(path.c_str(), link_path) != 0) {
+            std::perror(link_path);
+            return EXIT_FAILURE;
+        }
+    }
+    std::printf("%s: %u records (sequence %u to %u)\n", path.c_str(), HistoryLog::get_number_of_records(),
+                HistoryLog::get_oldest_sequence(), static_cast<uint16_t>(HistoryLog::get_next_sequence() - 1));
+    std::fflush(stdout);
+    HistoryDevice::real_start_time_us = HistoryDevice::read_real_time_us();
+    HistoryDevice::simulated_start_time_us = HostHal::get_time_us();
+    HostHal::set_time_hook(HistoryDevice::wait_for_real_time);
+    for (;;) {
+        loop();
+    }
+}
@@ -0,0 +1,400 @@
+/**
+ * @file    history_download.cpp
+ * @brief   Host client of the bulk history download (see core/history_transfer/history_transfer.h).
+ * @details Requests the history of a meter over its serial port, switches to the negotiated baud rate, acknowledges the
+ *          data frames and appends the records to a CSV file (`time_s,co2_ppm,sequence`, readable by
+ *          tools/policy_sweep). Each frame is written and flushed before it is acknowledged, so after an interruption
+ *          the download is resumed after the last stored record with `--resume`.
+ *
+ *          The device has no real-time clock: the time of a record is calculated from the reception time of the accept
+ *          frame, the age of the newest record and the record interval.
+ *
+ *          Usage: program [--baud <rate>] [--output <file>] [--resume] [--timeout <s>] <serial port>
+ *
+ *          Exits with a non-zero status, if the device does not answer or the transfer is not complete.
+ */
+
+#include <Arduino.h>
+#include <frame_codec.h>
+#include <history_log.h>
+#include <history_transfer.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <fstream>
+#include <poll.h>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+namespace HistoryDownload {
+    /**
+     * @struct  Options
+     * @brief   Command line options.
+     */
+    struct Options {
+        std::string port; ///< Path of the serial port.
+        std::string output = "history.csv"; ///< CSV file of the records.
+        unsigned long baud_rate = 115200UL; ///< Baud rate of the transfer.
+        bool is_resume = false; ///< True, to continue after the last record in the output file.
+        double timeout_s = 30.0; ///< Time the device has to answer the request (one loop iteration of the firmware).
+    };
+
+    /**
+     * @struct  Link
+     * @brief   Open serial port with the bytes of the frame being received.
+     */
+    struct Link {
+        int file = -1; ///< File descriptor of the port.
+        std::vector<uint8_t> frame; ///< Encoded bytes received since the last delimiter.
+        unsigned long number_of_bad_frames = 0; ///< Frames with a wrong checksum or encoding (since the last reset).
+    };
+
+    /**
+     * @struct  Accept
+     * @brief   Fields of the accept frame.
+     */
+    struct Accept {
+        uint32_t baud_rate; ///< Baud rate of the transfer.
+        uint16_t first_sequence; ///< Sequence number of the first record sent.
+        uint16_t number_of_records; ///< Number of records sent.
+        uint32_t time_since_newest_record_ms; ///< Age of the newest record.
+        uint32_t record_interval_ms; ///< Time between two records.
+    };
+
+    /**
+     * @brief   Opens the serial port in raw mode at 9600 baud.
+     * @return  true on success, false otherwise (errno is set).
+     */
+    bool open_link(Link &link, const std::string &port);
+
+    /**
+     * @brief   Waits until all bytes are sent and switches the baud rate.
+     * @return  true on success, false if the baud rate is not supported by the port.
+     */
+    bool set_baud_rate(Link &link, unsigned long baud_rate);
+
+    /**
+     * @brief   Sends a frame (the checksum is appended).
+     */
+    void send_frame(Link &link, std::vector<uint8_t> payload);
+
+    /**
+     * @brief   Receives the next frame with a valid checksum.
+     * @param   link The port.
+     * @param   payload Output: the payload without checksum.
+     * @param   timeout_ms Longest time to wait.
+     * @return  true if a frame was received, false on timeout.
+     */
+    bool receive_frame(Link &link, std::vector<uint8_t> &payload, int timeout_ms);
+
+    /**
+     * @brief   Sends the acknowledgement of the records before the given sequence number.
+     */
+    void send_ack(Link &link, uint16_t next_sequence);
+
+    /**
+     * @brief   Reads the sequence number of the last record in an existing output file.
+     * @return  true if the file contains a record.
+     */
+    bool read_last_sequence(const std::string &path, uint16_t &sequence);
+
+    /**
+     * @brief   Returns the current time in s since the Unix epoch.
+     */
+    double read_wall_clock_s();
+
+    /**
+     * @brief   Returns the current monotonic time in ms.
+     */
+    uint64_t read_monotonic_time_ms();
+
+    /**
+     * @brief   Reads a 16 bit value in little-endian byte order.
+     */
+    uint16_t read_uint16(const std::vector<uint8_t> &buffer, size_t position);
+
+    /**
+     * @brief   Reads a 32 bit value in little-endian byte order.
+     */
+    uint32_t read_uint32(const std::vector<uint8_t> &buffer, size_t position);
+
+    constexpr unsigned long LOG_BAUD_RATE = 9600UL; ///< Baud rate of the log output (before the transfer).
+    constexpr size_t ACCEPT_SIZE = 18; ///< Payload size of an accept frame.
+    constexpr size_t DATA_HEADER_SIZE = 4; ///< Payload size of a data frame without records.
+    constexpr size_t END_SIZE = 3; ///< Payload size of an end frame.
+    constexpr size_t CHECKSUM_SIZE = sizeof(uint16_t); ///< Size of the CRC16 at the end of each frame.
+    constexpr size_t MAX_FRAME_LENGTH = 256; ///< Longer byte sequences (log lines) are dropped.
+    constexpr int REQUEST_INTERVAL_MS = 1000; ///< Time between two requests, until the device answers.
+    constexpr int ACK_INTERVAL_MS = 100; ///< Time without a frame, after which the acknowledgement is repeated.
+    constexpr int MAX_SILENT_INTERVALS = 30; ///< Intervals without a valid frame, after which the device is gone.
+    constexpr int END_TIMEOUT_MS = 500; ///< Time to wait for the end frame after the last record.
+    constexpr double MILLISECONDS_PER_SECOND = 1000.0; ///< Conversion factor for the times.
+
+    bool open_link(Link &link, const std::string &port) {
+        link.file = open(port.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (link.file < 0) {
+            return false;
+        }
+        termios settings = {};
+        if (tcgetattr(link.file, &settings) != 0) {
+            return false;
+        }
+        cfmakeraw(&settings);
+        settings.c_cflag |= CLOCAL | CREAD;
+        settings.c_cc[VMIN] = 0;
+        settings.c_cc[VTIME] = 0;
+        cfsetspeed(&settings, B9600);
+        tcflush(link.file, TCIOFLUSH);
+        return tcsetattr(link.file, TCSANOW, &settings) == 0;
+    }
+
+    bool set_baud_rate(Link &link, const unsigned long baud_rate) {
+        speed_t speed;
+        switch (baud_rate) {
+            case 9600UL: speed = B9600;
+                break;
+            case 19200UL: speed = B19200;
+                break;
+            case 38400UL: speed = B38400;
+                break;
+            case 57600UL: speed = B57600;
+                break;
+            case 115200UL: speed = B115200;
+                break;
+            default:
+                return false;
+        }
+        termios settings = {};
+        tcdrain(link.file);
+        if (tcgetattr(link.file, &settings) != 0) {
+            return false;
+        }
+        cfsetspeed(&settings, speed);
+        link.frame.clear();
+        return tcsetattr(link.file, TCSANOW, &settings) == 0;
+    }
+
+    void send_frame(Link &link, std::vector<uint8_t> payload) {
+        const uint16_t crc = FrameCodec::crc16(payload.data(), payload.size());
+        payload.push_back(static_cast<uint8_t>(crc));
+        payload.push_back(static_cast<uint8_t>(crc >> 8));
+        std::vector<uint8_t> frame(FrameCodec::get_max_encoded_size(payload.size()) + 2);
+        frame[0] = FrameCodec::FRAME_DELIMITER;
+        const size_t size = FrameCodec::cobs_encode(payload.data(), payload.size(), frame.data() + 1);
+        frame[size + 1] = FrameCodec::FRAME_DELIMITER;
+        if (write(link.file, frame.data(), size + 2) != static_cast<ssize_t>(size + 2)) {
+            std::perror("write");
+        }
+    }
+
+    bool receive_frame(Link &link, std::vector<uint8_t> &payload, const int timeout_ms) {
+        const uint64_t deadline_ms = read_monotonic_time_ms() + static_cast<uint64_t>(timeout_ms);
+        for (;;) {
+            uint8_t character;
+            while (read(link.file, &character, 1) == 1) {
+                if (character != FrameCodec::FRAME_DELIMITER) {
+                    if (link.frame.size() <= MAX_FRAME_LENGTH) {
+                        link.frame.push_back(character);
+                    }
+                    continue;
+                }
+                if (link.frame.empty()) {
+                    continue; // the delimiter in front of a frame
+                }
+                payload.resize(link.frame.size());
+                const size_t size = link.frame.size() <= MAX_FRAME_LENGTH
+                                        ? FrameCodec::cobs_decode(link.frame.data(), link.frame.size(), payload.data())
+                                        : 0;
+                link.frame.clear();
+                if (size > CHECKSUM_SIZE &&
+                    FrameCodec::crc16(payload.data(), size - CHECKSUM_SIZE) ==
+                    read_uint16(payload, size - CHECKSUM_SIZE)) {
+                    payload.resize(size - CHECKSUM_SIZE);
+                    return true;
+                }
+                link.number_of_bad_frames++;
+            }
+            const uint64_t time_ms = read_monotonic_time_ms();
+            if (time_ms >= deadline_ms) {
+                return false;
+            }
+            pollfd descriptor = {link.file, POLLIN, 0}; ///< Wakes up when bytes arrive.
+            poll(&descriptor, 1, static_cast<int>(deadline_ms - time_ms));
+        }
+    }
+
+    void send_ack(Link &link, const uint16_t next_sequence) {
+        send_frame(link, {
+                       HistoryTransfer::ACK, static_cast<uint8_t>(next_sequence),
+                       static_cast<uint8_t>(next_sequence >> 8)
+                   });
+    }
+
+    bool read_last_sequence(const std::string &path, uint16_t &sequence) {
+        std::ifstream file(path);
+        bool has_record = false;
+        for (std::string line; std::getline(file, line);) {
+            double time_s = 0.0;
+            unsigned int co2_ppm = 0;
+            unsigned int line_sequence = 0;
+            if (std::sscanf(line.c_str(), "%lf,%u,%u", &time_s, &co2_ppm, &line_sequence) == 3) {
+                sequence = static_cast<uint16_t>(line_sequence);
+                has_record = true;
+            }
+        }
+        return has_record;
+    }
+
+    double read_wall_clock_s() {
+        timespec now; ///< Current time.
+        clock_gettime(CLOCK_REALTIME, &now);
+        return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+    }
+
+    uint64_t read_monotonic_time_ms() {
+        timespec now; ///< Current time.
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000ULL + static_cast<uint64_t>(now.tv_nsec) / 1000000ULL;
+    }
+
+    uint16_t read_uint16(const std::vector<uint8_t> &buffer, const size_t position) {
+        return static_cast<uint16_t>(buffer[position] | buffer[position + 1] << 8);
+    }
+
+    uint32_t read_uint32(const std::vector<uint8_t> &buffer, const size_t position) {
+        return read_uint16(buffer, position) | static_cast<uint32_t>(read_uint16(buffer, position + 2)) << 16;
+    }
+}
+
+int main(const int argc, char **argv) {
+    using namespace HistoryDownload;
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--resume")) {
+            options.is_resume = true;
+        } else if (i + 1 < argc && !std::strcmp(argv[i], "--baud")) {
+            options.baud_rate = std::strtoul(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && !std::strcmp(argv[i], "--output")) {
+            options.output = argv[++i];
+        } else if (i + 1 < argc && !std::strcmp(argv[i], "--timeout")) {
+            options.timeout_s = std::strtod(argv[++i], nullptr);
+        } else if (argv[i][0] != '-' && options.port.empty()) {
+            options.port = argv[i];
+        } else {
+            options.port.clear();
+            break;
+        }
+    }
+    if (options.port.empty()) {
+        std::fprintf(stderr, "usage: %s [--baud <rate>] [--output <file>] [--resume] [--timeout <s>] <serial port>\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+    uint16_t last_sequence = 0; ///< Sequence number of the last stored record.
+    const bool is_resumed = options.is_resume && read_last_sequence(options.output, last_sequence);
+    const uint16_t requested_sequence = is_resumed ? static_cast<uint16_t>(last_sequence + 1) : 0;
+
+    Link link;
+    if (!open_link(link, options.port)) {
+        std::perror(options.port.c_str());
+        return EXIT_FAILURE;
+    }
+    const std::vector<uint8_t> request = {
+        HistoryTransfer::REQUEST,
+        static_cast<uint8_t>(options.baud_rate), static_cast<uint8_t>(options.baud_rate >> 8),
+        static_cast<uint8_t>(options.baud_rate >> 16), static_cast<uint8_t>(options.baud_rate >> 24),
+        static_cast<uint8_t>(requested_sequence), static_cast<uint8_t>(requested_sequence >> 8),
+        static_cast<uint8_t>(is_resumed ? HistoryTransfer::RESUME_FLAG : 0)
+    }; ///< Request frame (without checksum).
+    std::vector<uint8_t> payload; ///< Last received frame.
+    Accept accept = {};
+    bool is_accepted = false;
+    const uint64_t request_deadline_ms = read_monotonic_time_ms() +
+                                         static_cast<uint64_t>(options.timeout_s * MILLISECONDS_PER_SECOND);
+    while (!is_accepted && read_monotonic_time_ms() < request_deadline_ms) {
+        send_frame(link, request);
+        const uint64_t retry_time_ms = read_monotonic_time_ms() + REQUEST_INTERVAL_MS;
+        while (!is_accepted && read_monotonic_time_ms() < retry_time_ms) {
+            is_accepted = receive_frame(link, payload, REQUEST_INTERVAL_MS) && payload.size() == ACCEPT_SIZE &&
+                          payload[0] == HistoryTransfer::ACCEPT;
+        }
+    }
+    if (!is_accepted) {
+        std::fprintf(stderr, "%s: no answer to the request\n", options.port.c_str());
+        return EXIT_FAILURE;
+    }
+    const double accept_time_s = read_wall_clock_s(); ///< Reception time of the accept frame.
+    accept.baud_rate = read_uint32(payload, 1);
+    accept.first_sequence = read_uint16(payload, 5);
+    accept.number_of_records = read_uint16(payload, 7);
+    accept.time_since_newest_record_ms = read_uint32(payload, 9);
+    accept.record_interval_ms = read_uint32(payload, 13);
+    if (!set_baud_rate(link, accept.baud_rate)) {
+        std::fprintf(stderr, "%s: baud rate %lu not supported\n", options.port.c_str(),
+                     static_cast<unsigned long>(accept.baud_rate));
+        return EXIT_FAILURE;
+    }
+    if (is_resumed && accept.first_sequence != requested_sequence) {
+        std::fprintf(stderr, "records %u to %u were overwritten on the device, continuing with the oldest one\n",
+                     requested_sequence, static_cast<uint16_t>(accept.first_sequence - 1));
+    }
+
+    std::FILE *output = std::fopen(options.output.c_str(), is_resumed ? "a" : "w");
+    if (!output) {
+        std::perror(options.output.c_str());
+        return EXIT_FAILURE;
+    }
+    if (!is_resumed) {
+        std::fprintf(output, "time_s,co2_ppm,sequence\n");
+    }
+    const uint16_t end = accept.first_sequence + accept.number_of_records; ///< Sequence number after the last record.
+    const double newest_record_time_s = accept_time_s - accept.time_since_newest_record_ms / MILLISECONDS_PER_SECOND;
+    uint16_t next_sequence = accept.first_sequence; ///< Next record expected.
+    bool is_ended = false; ///< True, after the end frame was received.
+    link.number_of_bad_frames = 0;
+    send_ack(link, next_sequence); // tells the device that the new baud rate works
+    for (int silent_intervals = 0; !is_ended && silent_intervals < MAX_SILENT_INTERVALS;) {
+        if (!receive_frame(link, payload, next_sequence == end ? END_TIMEOUT_MS : ACK_INTERVAL_MS)) {
+            if (next_sequence == end) {
+                break; // all records are stored, the end frame was lost
+            }
+            silent_intervals++;
+            send_ack(link, next_sequence);
+            continue;
+        }
+        silent_intervals = 0;
+        if (payload[0] == HistoryTransfer::END && payload.size() == END_SIZE) {
+            is_ended = true;
+        } else if (payload[0] == HistoryTransfer::DATA && payload.size() >= DATA_HEADER_SIZE &&
+                   payload.size() == DATA_HEADER_SIZE + payload[3] * sizeof(uint16_t)) {
+            if (read_uint16(payload, 1) == next_sequence) {
+                for (uint8_t i = 0; i < payload[3]; i++, next_sequence++) {
+                    const uint16_t co2_ppm = read_uint16(payload, DATA_HEADER_SIZE + i * sizeof(uint16_t));
+                    if (co2_ppm == HistoryLog::NO_VALUE) {
+                        continue; // overwritten during the transfer
+                    }
+                    const uint16_t age = static_cast<uint16_t>(end - 1 - next_sequence); ///< Records after this one.
+                    std::fprintf(output, "%.3f,%u,%u\n",
+                                 newest_record_time_s - age * (accept.record_interval_ms / MILLISECONDS_PER_SECOND),
+                                 co2_ppm, next_sequence);
+                }
+                std::fflush(output); // stored before it is acknowledged, so a resume does not skip it
+            }
+            send_ack(link, next_sequence);
+        }
+    }
+    std::fclose(output);
+    set_baud_rate(link, LOG_BAUD_RATE);
+    close(link.file);
+
+    const unsigned int received_records = static_cast<uint16_t>(next_sequence - accept.first_sequence);
+    std::fprintf(stderr, "%u of %u records received (sequence %u to %u), %lu damaged frames dropped%s\n",
+                 received_records, accept.number_of_records, accept.first_sequence,
+                 static_cast<uint16_t>(next_sequence - 1), link.number_of_bad_frames,
+                 next_sequence == end ? "" : ", incomplete (continue with --resume)");
+    return next_sequence == end ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file Arduino.h
+ * @brief Host implementation of the subset of the Arduino core API used by the firmware.
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define DEC 10
+#define HEX 16
+#define BIN 2
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t *>(address))
+#define digitalPinToInterrupt(pin) \
+    ((pin) == 2 ? 4 : (pin) == 3 ? 5 : (pin) == 18 ? 3 : (pin) == 19 ? 2 : (pin) == 20 ? 1 : (pin) == 21 ? 0 : -1)
+
+class __FlashStringHelper;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout = 1000000UL);
+unsigned long pulseInLong(uint8_t pin, uint8_t state, unsigned long timeout = 1000000UL);
+void attachInterrupt(uint8_t interrupt_number, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interrupt_number);
+void noInterrupts();
+void interrupts();
+
+/**
+ * @class   Print
+ * @brief   Base class for all character outputs (subset of the Arduino `Print` class).
+ */
+class Print {
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t character) = 0;
+
+    virtual size_t write(const uint8_t *buffer, size_t size);
+
+    size_t write(const char *text) { return text ? write(reinterpret_cast<const uint8_t *>(text), strlen(text)) : 0; }
+    size_t write(const char *buffer, size_t size) { return write(reinterpret_cast<const uint8_t *>(buffer), size); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const __FlashStringHelper *text) { return write(reinterpret_cast<const char *>(text)); }
+    size_t print(const char *text) { return write(text); }
+    size_t print(char character) { return write(static_cast<uint8_t>(character)); }
+    size_t print(unsigned char value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(int value, int base = DEC) { return print(static_cast<long>(value), base); }
+    size_t print(unsigned int value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template<typename T>
+    size_t println(T value) { return print(value) + println(); }
+    template<typename T>
+    size_t println(T value, int format) { return print(value, format) + println(); }
+};
+
+/**
+ * @class   Stream
+ * @brief   Base class for character inputs and outputs.
+ */
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+/**
+ * @class   HardwareSerial
+ * @brief   Host implementation of the hardware serial port (output is passed to the serial sink of the host HAL).
+ */
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud_rate);
+    void end() {}
+    size_t write(uint8_t character) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    int availableForWrite() override { return 63; }
+    explicit operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif //ARDUINO_H
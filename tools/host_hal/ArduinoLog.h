@@ -0,0 +1,69 @@
+/**
+ * @file ArduinoLog.h
+ * @brief Host implementation of the ArduinoLog library API used by the firmware.
+ * @details Supports the same log levels, prefix/suffix callbacks and format specifiers as the original library
+ *          (https://github.com/thijse/Arduino-Log). With `DISABLE_LOGGING` defined, all log calls are empty.
+ */
+
+#ifndef ARDUINO_LOG_H
+#define ARDUINO_LOG_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+#define LOG_LEVEL_SILENT  0
+#define LOG_LEVEL_FATAL   1
+#define LOG_LEVEL_ERROR   2
+#define LOG_LEVEL_WARNING 3
+#define LOG_LEVEL_INFO    4
+#define LOG_LEVEL_NOTICE  4
+#define LOG_LEVEL_TRACE   5
+#define LOG_LEVEL_VERBOSE 6
+
+typedef void (*printfunction)(Print *, int);
+
+/**
+ * @class   Logging
+ * @brief   Logger with levels and printf-like format specifiers.
+ */
+class Logging {
+public:
+    void begin(int level, Print *output, bool show_level = true);
+    void setLevel(int level) { _level = level; }
+    int getLevel() const { return _level; }
+    void setShowLevel(bool show_level) { _show_level = show_level; }
+    void setPrefix(printfunction prefix) { _prefix = prefix; }
+    void setSuffix(printfunction suffix) { _suffix = suffix; }
+
+#define LOGGING_LEVEL_METHODS(name, level) \
+    template<class T, typename... Args> void name(T message, Args... args) { \
+        print_level(level, false, message, args...); \
+    } \
+    template<class T, typename... Args> void name##ln(T message, Args... args) { \
+        print_level(level, true, message, args...); \
+    }
+
+    LOGGING_LEVEL_METHODS(fatal, LOG_LEVEL_FATAL)
+    LOGGING_LEVEL_METHODS(error, LOG_LEVEL_ERROR)
+    LOGGING_LEVEL_METHODS(warning, LOG_LEVEL_WARNING)
+    LOGGING_LEVEL_METHODS(notice, LOG_LEVEL_NOTICE)
+    LOGGING_LEVEL_METHODS(info, LOG_LEVEL_INFO)
+    LOGGING_LEVEL_METHODS(trace, LOG_LEVEL_TRACE)
+    LOGGING_LEVEL_METHODS(verbose, LOG_LEVEL_VERBOSE)
+#undef LOGGING_LEVEL_METHODS
+
+private:
+    void print_level(int level, bool is_new_line, const char *format, ...);
+    void print_format(const char *format, va_list *args);
+    void print_specifier(char specifier, va_list *args);
+
+    int _level = LOG_LEVEL_SILENT;
+    bool _show_level = true;
+    Print *_output = nullptr;
+    printfunction _prefix = nullptr;
+    printfunction _suffix = nullptr;
+};
+
+extern Logging Log;
+
+#endif //ARDUINO_LOG_H
@@ -0,0 +1,27 @@
+/**
+ * @file LiquidCrystal.h
+ * @brief Host implementation of the LiquidCrystal library API, backed by a simulated 16x2 HD44780 display.
+ */
+
+#ifndef LIQUID_CRYSTAL_H
+#define LIQUID_CRYSTAL_H
+
+#include <Arduino.h>
+
+class LiquidCrystal : public Print {
+public:
+    LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3);
+
+    void begin(uint8_t columns, uint8_t rows);
+    void clear();
+    void home();
+    void setCursor(uint8_t column, uint8_t row);
+    void createChar(uint8_t location, uint8_t character_map[]);
+    void command(uint8_t value);
+    void display() {}
+    void noDisplay() {}
+    size_t write(uint8_t character) override;
+    using Print::write;
+};
+
+#endif //LIQUID_CRYSTAL_H
@@ -0,0 +1,38 @@
+/**
+ * @file MHZ.h
+ * @brief Host implementation of the MH-Z CO2 sensor library API, backed by the host HAL sensor simulation.
+ */
+
+#ifndef MHZ_H
+#define MHZ_H
+
+#include <Arduino.h>
+
+class MHZ {
+public:
+    static const uint8_t MHZ14A = 14;
+    static const uint8_t MHZ14B = 15;
+    static const uint8_t MHZ19B = 19;
+    static const uint8_t MHZ19C = 20;
+    static const int STATUS_NO_RESPONSE = -2;
+    static const int STATUS_CHECKSUM_MISMATCH = -3;
+    static const int STATUS_INCOMPLETE = -4;
+    static const int STATUS_NOT_READY = -5;
+
+    MHZ(uint8_t pwm_pin, uint8_t type);
+    MHZ(Stream *serial, uint8_t pwm_pin, uint8_t type);
+    MHZ(uint8_t rx_pin, uint8_t tx_pin, uint8_t pwm_pin, uint8_t type);
+
+    bool isPreHeating();
+    bool isReady();
+    int readCO2PWM();
+    int readCO2UART();
+    void setDebug(bool) {}
+    void setAutoCalibrate(bool) {}
+    void setRange(int) {}
+
+private:
+    uint8_t _pwm_pin;
+};
+
+#endif //MHZ_H
@@ -0,0 +1,24 @@
+/**
+ * @file SoftwareSerial.h
+ * @brief Host implementation of the SoftwareSerial library API (writes block for the configured byte time).
+ */
+
+#ifndef SOFTWARE_SERIAL_H
+#define SOFTWARE_SERIAL_H
+
+#include <Arduino.h>
+
+class SoftwareSerial : public Stream {
+public:
+    SoftwareSerial(uint8_t receive_pin, uint8_t transmit_pin, bool inverse_logic = false);
+
+    void begin(long baud_rate);
+    bool listen() { return true; }
+    size_t write(uint8_t character) override;
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+#endif //SOFTWARE_SERIAL_H
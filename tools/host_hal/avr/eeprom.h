@@ -0,0 +1,17 @@
+/**
+ * @file eeprom.h
+ * @brief Host implementation of the AVR EEPROM API: 4 KiB (ATmega2560) in host memory, erased (0xFF) at start-up.
+ */
+
+#ifndef AVR_EEPROM_H
+#define AVR_EEPROM_H
+
+#include <stddef.h>
+
+#define E2END 0x0FFF
+
+void eeprom_read_block(void *destination, const void *source, size_t size);
+
+void eeprom_update_block(const void *source, void *destination, size_t size);
+
+#endif //AVR_EEPROM_H
@@ -0,0 +1,15 @@
+/**
+ * @file interrupt.h
+ * @brief Host implementation of the AVR interrupt API. Interrupt vectors become plain functions.
+ */
+
+#ifndef AVR_INTERRUPT_H
+#define AVR_INTERRUPT_H
+
+#include <Arduino.h>
+
+#define ISR(vector, ...) extern "C" void vector()
+#define cli() noInterrupts()
+#define sei() interrupts()
+
+#endif //AVR_INTERRUPT_H
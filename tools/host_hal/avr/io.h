@@ -0,0 +1,11 @@
+/**
+ * @file io.h
+ * @brief Host placeholder for the AVR register definitions.
+ */
+
+#ifndef AVR_IO_H
+#define AVR_IO_H
+
+#include <stdint.h>
+
+#endif //AVR_IO_H
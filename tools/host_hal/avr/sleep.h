@@ -0,0 +1,18 @@
+/**
+ * @file sleep.h
+ * @brief Host implementation of the AVR sleep API: sleeping advances the simulated time to the next Timer0 overflow.
+ */
+
+#ifndef AVR_SLEEP_H
+#define AVR_SLEEP_H
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_DOWN 2
+
+void set_sleep_mode(int mode);
+void sleep_enable();
+void sleep_disable();
+void sleep_cpu();
+void sleep_mode();
+
+#endif //AVR_SLEEP_H
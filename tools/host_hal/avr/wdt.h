@@ -0,0 +1,20 @@
+/**
+ * @file wdt.h
+ * @brief Host implementation of the AVR watchdog API: the watchdog never expires on the host, its resets are recorded
+ *        (see `HostHal::get_last_watchdog_reset_time_us`).
+ */
+
+#ifndef AVR_WDT_H
+#define AVR_WDT_H
+
+#define WDTO_8S 9
+
+inline void wdt_enable(int) {
+}
+
+void wdt_reset();
+
+inline void wdt_disable() {
+}
+
+#endif //AVR_WDT_H
@@ -0,0 +1,545 @@
+/**
+ * @file host_hal.cpp
+ * @brief Implementation of the host hardware abstraction layer.
+ */
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <LiquidCrystal.h>
+#include <MHZ.h>
+#include <SoftwareSerial.h>
+#include <avr/eeprom.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <host_hal.h>
+#include <cstring>
+#include <deque>
+
+namespace HostHal {
+    constexpr uint8_t DISPLAY_COLUMNS = 16; ///< Columns of the simulated display.
+    constexpr uint8_t DISPLAY_ROWS = 2; ///< Rows of the simulated display.
+    constexpr uint32_t PWM_CYCLE_US = 1004000UL; ///< Duration of one PWM cycle of the MH-Z19B.
+    constexpr uint32_t PWM_MARGIN_US = 2000UL; ///< Minimum high and low time of a PWM cycle of the MH-Z19B.
+    constexpr uint32_t PWM_RANGE_PPM = 5000UL; ///< CO2 value of a pulse over the whole PWM cycle.
+
+    uint64_t time_us = 0; ///< Simulated time since start-up.
+    void (*time_hook)(uint64_t) = nullptr; ///< Called whenever the time advances.
+    int co2_ppm = 600; ///< Fixed sensor reading.
+    int (*co2_reader)(uint32_t *) = nullptr; ///< Scripted sensor readings.
+    bool is_sensor_preheating = false; ///< Preheating state of the simulated sensor.
+    uint64_t last_watchdog_reset_time_us = 0; ///< Time of the last watchdog reset.
+    uint64_t next_pwm_rising_edge_us = 0; ///< Start of the next PWM pulse of the simulated sensor, 0 before the first.
+    uint8_t pin_levels[NUMBER_OF_PINS] = {}; ///< Levels of the digital pins.
+    void (*interrupt_routines[NUMBER_OF_INTERRUPTS])() = {}; ///< Attached interrupt service routines.
+    bool is_interrupt_enabled = true; ///< Global interrupt flag.
+    void (*serial_sink)(const uint8_t *, size_t) = nullptr; ///< Receiver of the `Serial` output.
+    uint32_t serial_byte_time_us = 0; ///< Time to transmit one byte on `Serial`.
+    std::deque<uint8_t> serial_input; ///< Bytes received on `Serial`, not yet read by the firmware.
+    unsigned long serial_baud_rate = 0UL; ///< Baud rate of the last `Serial.begin()`.
+    uint8_t eeprom[E2END + 1]; ///< Simulated EEPROM.
+    bool is_eeprom_erased = false; ///< True, once the simulated EEPROM is erased (on its first use).
+    uint32_t software_serial_byte_time_us = 0; ///< Time a `SoftwareSerial` write blocks per byte.
+    char display[DISPLAY_ROWS][DISPLAY_COLUMNS + 1] = {}; ///< Characters shown on the simulated display.
+    uint8_t cursor_column = 0; ///< Cursor column of the simulated display.
+    uint8_t cursor_row = 0; ///< Cursor row of the simulated display.
+    unsigned long display_write_count = 0; ///< Number of character writes to the simulated display.
+    unsigned long display_bus_write_count = 0; ///< Number of all bus writes to the simulated display.
+    uint8_t display_glyphs[8][8] = {}; ///< CGRAM of the simulated display.
+    int cgram_address = -1; ///< Current CGRAM address, -1 if the DDRAM (display) is selected.
+
+    void set_time_us(const uint64_t new_time_us) {
+        time_us = new_time_us;
+    }
+
+    void jump_time_us(const int64_t jump_us) {
+        time_us = static_cast<uint64_t>(static_cast<int64_t>(time_us) + jump_us);
+        if (next_pwm_rising_edge_us != 0) {
+            next_pwm_rising_edge_us = static_cast<uint64_t>(static_cast<int64_t>(next_pwm_rising_edge_us) + jump_us);
+        }
+    }
+
+    uint64_t get_time_us() {
+        return time_us;
+    }
+
+    void advance_time_us(const uint64_t duration_us) {
+        time_us += duration_us;
+        if (time_hook) {
+            time_hook(time_us);
+        }
+    }
+
+    void set_time_hook(void (*hook)(uint64_t)) {
+        time_hook = hook;
+    }
+
+    void set_co2_ppm(const int new_co2_ppm) {
+        co2_ppm = new_co2_ppm;
+    }
+
+    void set_co2_reader(int (*reader)(uint32_t *)) {
+        co2_reader = reader;
+    }
+
+    void set_sensor_preheating(const bool is_preheating) {
+        is_sensor_preheating = is_preheating;
+    }
+
+    uint64_t get_last_watchdog_reset_time_us() {
+        return last_watchdog_reset_time_us;
+    }
+
+    uint8_t get_pin_level(const uint8_t pin) {
+        return pin < NUMBER_OF_PINS ? pin_levels[pin] : LOW;
+    }
+
+    void set_pin_level(const uint8_t pin, const uint8_t level) {
+        if (pin < NUMBER_OF_PINS) {
+            pin_levels[pin] = level;
+        }
+    }
+
+    bool trigger_interrupt(const uint8_t pin) {
+        const int interrupt_number = digitalPinToInterrupt(pin);
+        if (interrupt_number < 0 || !interrupt_routines[interrupt_number]) {
+            return false;
+        }
+        // Interrupts are disabled while an interrupt service routine runs, as on the AVR.
+        const bool was_enabled = is_interrupt_enabled;
+        is_interrupt_enabled = false;
+        interrupt_routines[interrupt_number]();
+        is_interrupt_enabled = was_enabled;
+        return true;
+    }
+
+    bool are_interrupts_enabled() {
+        return is_interrupt_enabled;
+    }
+
+    void set_serial_sink(void (*sink)(const uint8_t *, size_t)) {
+        serial_sink = sink;
+    }
+
+    void set_serial_byte_time_us(const uint32_t byte_time_us) {
+        serial_byte_time_us = byte_time_us;
+    }
+
+    void push_serial_input(const uint8_t *data, const size_t size) {
+        serial_input.insert(serial_input.end(), data, data + size);
+    }
+
+    unsigned long get_serial_baud_rate() {
+        return serial_baud_rate;
+    }
+
+    /**
+     * @brief   Erases the simulated EEPROM (all bytes 0xFF, as a new MCU) on its first use.
+     */
+    void erase_eeprom_once() {
+        if (!is_eeprom_erased) {
+            std::memset(eeprom, 0xFF, sizeof(eeprom));
+            is_eeprom_erased = true;
+        }
+    }
+
+    void set_software_serial_byte_time_us(const uint32_t byte_time_us) {
+        software_serial_byte_time_us = byte_time_us;
+    }
+
+    const char *get_display_row(const uint8_t row) {
+        return display[row < DISPLAY_ROWS ? row : 0];
+    }
+
+    unsigned long get_display_write_count() {
+        return display_write_count;
+    }
+
+    unsigned long get_display_bus_write_count() {
+        return display_bus_write_count;
+    }
+
+    const uint8_t *get_display_glyph(const uint8_t slot) {
+        return display_glyphs[slot % 8];
+    }
+
+    /**
+     * @brief   Fills the simulated display with spaces.
+     */
+    void clear_display() {
+        for (auto &row: display) {
+            memset(row, ' ', DISPLAY_COLUMNS);
+            row[DISPLAY_COLUMNS] = '\0';
+        }
+        cursor_column = 0;
+        cursor_row = 0;
+    }
+}
+
+// Arduino core
+
+HardwareSerial Serial;
+Logging Log;
+
+unsigned long millis() {
+    return static_cast<unsigned long>(static_cast<uint32_t>(HostHal::time_us / 1000ULL));
+}
+
+unsigned long micros() {
+    return static_cast<unsigned long>(static_cast<uint32_t>(HostHal::time_us));
+}
+
+void delay(const unsigned long ms) {
+    HostHal::advance_time_us(static_cast<uint64_t>(ms) * 1000ULL);
+}
+
+void delayMicroseconds(const unsigned int us) {
+    HostHal::advance_time_us(us);
+}
+
+void pinMode(uint8_t, uint8_t) {
+}
+
+void digitalWrite(const uint8_t pin, const uint8_t value) {
+    HostHal::set_pin_level(pin, value ? HIGH : LOW);
+}
+
+int digitalRead(const uint8_t pin) {
+    return HostHal::get_pin_level(pin);
+}
+
+unsigned long pulseIn(uint8_t, const uint8_t state, unsigned long) {
+    // Simulates a 400 ppm reading on a 1004 ms PWM cycle (5000 ppm range).
+    HostHal::advance_time_us(HostHal::PWM_CYCLE_US);
+    return state == HIGH ? 82000UL : 922000UL;
+}
+
+unsigned long pulseInLong(uint8_t, uint8_t, const unsigned long timeout) {
+    // Simulates the PWM output of the MH-Z19B (only the HIGH pulse): the pulses start on a grid of PWM cycles, and the
+    // first pulse ends one cycle after the first call.
+    uint32_t period_us = HostHal::PWM_CYCLE_US;
+    const int reading_ppm = HostHal::co2_reader ? HostHal::co2_reader(&period_us) : HostHal::co2_ppm;
+    if (reading_ppm < 0) {
+        HostHal::advance_time_us(timeout);
+        return 0UL;
+    }
+    const uint64_t high_time_us = HostHal::PWM_MARGIN_US + static_cast<uint64_t>(reading_ppm) *
+                                  (period_us - 2 * HostHal::PWM_MARGIN_US) / HostHal::PWM_RANGE_PPM;
+    if (HostHal::next_pwm_rising_edge_us == 0) {
+        HostHal::next_pwm_rising_edge_us = HostHal::time_us + period_us - high_time_us;
+    }
+    while (HostHal::next_pwm_rising_edge_us < HostHal::time_us) {
+        HostHal::next_pwm_rising_edge_us += period_us;
+    }
+    HostHal::advance_time_us(HostHal::next_pwm_rising_edge_us + high_time_us - HostHal::time_us);
+    HostHal::next_pwm_rising_edge_us += period_us;
+    return static_cast<unsigned long>(high_time_us);
+}
+
+void attachInterrupt(const uint8_t interrupt_number, void (*isr)(), int) {
+    if (interrupt_number < HostHal::NUMBER_OF_INTERRUPTS) {
+        HostHal::interrupt_routines[interrupt_number] = isr;
+    }
+}
+
+void detachInterrupt(const uint8_t interrupt_number) {
+    if (interrupt_number < HostHal::NUMBER_OF_INTERRUPTS) {
+        HostHal::interrupt_routines[interrupt_number] = nullptr;
+    }
+}
+
+void noInterrupts() {
+    HostHal::is_interrupt_enabled = false;
+}
+
+void interrupts() {
+    HostHal::is_interrupt_enabled = true;
+}
+
+size_t Print::write(const uint8_t *buffer, const size_t size) {
+    size_t written = 0;
+    while (written < size && write(buffer[written])) {
+        written++;
+    }
+    return written;
+}
+
+size_t Print::print(const long value, const int base) {
+    if (value < 0 && base == DEC) {
+        return print('-') + print(static_cast<unsigned long>(-value), base);
+    }
+    return print(static_cast<unsigned long>(value), base);
+}
+
+size_t Print::print(unsigned long value, const int base) {
+    char digits[sizeof(unsigned long) * 8 + 1];
+    char *digit = digits + sizeof(digits) - 1;
+    *digit = '\0';
+    do {
+        const unsigned long remainder = value % static_cast<unsigned long>(base);
+        *--digit = static_cast<char>(remainder < 10 ? '0' + remainder : 'A' + remainder - 10);
+        value /= static_cast<unsigned long>(base);
+    } while (value);
+    return write(digit);
+}
+
+size_t Print::print(const double value, const int digits) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return write(text);
+}
+
+void HardwareSerial::begin(const unsigned long baud_rate) {
+    HostHal::serial_baud_rate = baud_rate;
+}
+
+size_t HardwareSerial::write(const uint8_t character) {
+    return write(&character, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, const size_t size) {
+    if (HostHal::serial_sink) {
+        HostHal::serial_sink(buffer, size);
+    }
+    if (HostHal::serial_byte_time_us) {
+        HostHal::advance_time_us(static_cast<uint64_t>(HostHal::serial_byte_time_us) * size);
+    }
+    return size;
+}
+
+int HardwareSerial::available() {
+    return static_cast<int>(HostHal::serial_input.size());
+}
+
+int HardwareSerial::read() {
+    if (HostHal::serial_input.empty()) {
+        return -1;
+    }
+    const uint8_t character = HostHal::serial_input.front();
+    HostHal::serial_input.pop_front();
+    return character;
+}
+
+int HardwareSerial::peek() {
+    return HostHal::serial_input.empty() ? -1 : HostHal::serial_input.front();
+}
+
+// AVR EEPROM
+
+void eeprom_read_block(void *destination, const void *source, const size_t size) {
+    HostHal::erase_eeprom_once();
+    std::memcpy(destination, HostHal::eeprom + reinterpret_cast<uintptr_t>(source), size);
+}
+
+void eeprom_update_block(const void *source, void *destination, const size_t size) {
+    HostHal::erase_eeprom_once();
+    std::memcpy(HostHal::eeprom + reinterpret_cast<uintptr_t>(destination), source, size);
+}
+
+// AVR watchdog
+
+void wdt_reset() {
+    HostHal::last_watchdog_reset_time_us = HostHal::time_us;
+}
+
+// AVR sleep
+
+void set_sleep_mode(int) {
+}
+
+void sleep_enable() {
+}
+
+void sleep_disable() {
+}
+
+void sleep_cpu() {
+    // The MCU sleeps until the next Timer0 overflow.
+    const uint64_t period_us = HostHal::SLEEP_WAKE_UP_PERIOD_US;
+    HostHal::advance_time_us(period_us - HostHal::time_us % period_us);
+}
+
+void sleep_mode() {
+    sleep_cpu();
+}
+
+// ArduinoLog
+
+void Logging::begin(const int level, Print *output, const bool show_level) {
+    _level = level;
+    _output = output;
+    _show_level = show_level;
+}
+
+void Logging::print_level(const int level, const bool is_new_line, const char *format, ...) {
+#ifndef DISABLE_LOGGING
+    if (level > _level || !_output) {
+        return;
+    }
+    if (_prefix) {
+        _prefix(_output, level);
+    }
+    if (_show_level) {
+        _output->print("?FEWITV"[level]);
+        _output->print(": ");
+    }
+    va_list args;
+    va_start(args, format);
+    print_format(format, &args);
+    va_end(args);
+    if (_suffix) {
+        _suffix(_output, level);
+    }
+    if (is_new_line) {
+        _output->print("\n");
+    }
+#endif
+}
+
+void Logging::print_format(const char *format, va_list *args) {
+    for (; *format; format++) {
+        if (*format != '%') {
+            _output->print(*format);
+            continue;
+        }
+        if (!*++format) {
+            return;
+        }
+        print_specifier(*format, args);
+    }
+}
+
+void Logging::print_specifier(const char specifier, va_list *args) {
+    switch (specifier) {
+        case '%': _output->print('%');
+            break;
+        case 's':
+        case 'S': _output->print(va_arg(*args, const char *));
+            break;
+        case 'd':
+        case 'i': _output->print(va_arg(*args, int), DEC);
+            break;
+        case 'D':
+        case 'F': _output->print(va_arg(*args, double));
+            break;
+        case 'x': _output->print(va_arg(*args, int), HEX);
+            break;
+        case 'X': _output->print("0x");
+            _output->print(va_arg(*args, int), HEX);
+            break;
+        case 'b': _output->print(va_arg(*args, int), BIN);
+            break;
+        case 'B': _output->print("0b");
+            _output->print(va_arg(*args, int), BIN);
+            break;
+        case 'l': _output->print(va_arg(*args, long), DEC);
+            break;
+        case 'u': _output->print(va_arg(*args, unsigned long), DEC);
+            break;
+        case 'c':
+        case 'C': _output->print(static_cast<char>(va_arg(*args, int)));
+            break;
+        case 't': _output->print(va_arg(*args, int) ? 'T' : 'F');
+            break;
+        case 'T': _output->print(va_arg(*args, int) ? "true" : "false");
+            break;
+        default: _output->print('?');
+    }
+}
+
+// Libraries
+
+MHZ::MHZ(const uint8_t pwm_pin, uint8_t) : _pwm_pin(pwm_pin) {
+}
+
+MHZ::MHZ(Stream *, const uint8_t pwm_pin, uint8_t) : _pwm_pin(pwm_pin) {
+}
+
+MHZ::MHZ(uint8_t, uint8_t, const uint8_t pwm_pin, uint8_t) : _pwm_pin(pwm_pin) {
+}
+
+bool MHZ::isPreHeating() {
+    return HostHal::is_sensor_preheating;
+}
+
+bool MHZ::isReady() {
+    return !HostHal::is_sensor_preheating;
+}
+
+int MHZ::readCO2PWM() {
+    uint32_t duration_us = HostHal::PWM_CYCLE_US;
+    const int reading_ppm = HostHal::co2_reader ? HostHal::co2_reader(&duration_us) : HostHal::co2_ppm;
+    HostHal::advance_time_us(duration_us);
+    return reading_ppm;
+}
+
+int MHZ::readCO2UART() {
+    return readCO2PWM();
+}
+
+LiquidCrystal::LiquidCrystal(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t) {
+    HostHal::clear_display();
+}
+
+void LiquidCrystal::begin(uint8_t, uint8_t) {
+    HostHal::clear_display();
+}
+
+void LiquidCrystal::clear() {
+    HostHal::clear_display();
+}
+
+void LiquidCrystal::home() {
+    HostHal::display_bus_write_count++;
+    HostHal::cgram_address = -1;
+    HostHal::cursor_column = 0;
+    HostHal::cursor_row = 0;
+}
+
+void LiquidCrystal::setCursor(const uint8_t column, const uint8_t row) {
+    HostHal::display_bus_write_count++;
+    HostHal::cgram_address = -1;
+    HostHal::cursor_column = column;
+    HostHal::cursor_row = row < HostHal::DISPLAY_ROWS ? row : HostHal::DISPLAY_ROWS - 1;
+}
+
+void LiquidCrystal::createChar(uint8_t location, uint8_t character_map[]) {
+    command(0x40 | (location & 0x07) << 3);
+    for (uint8_t row = 0; row < 8; row++) {
+        write(character_map[row]);
+    }
+}
+
+void LiquidCrystal::command(const uint8_t value) {
+    HostHal::display_bus_write_count++;
+    if (value & 0x80) { // set DDRAM address
+        HostHal::cgram_address = -1;
+    } else if (value & 0x40) { // set CGRAM address
+        HostHal::cgram_address = value & 0x3F;
+    }
+}
+
+size_t LiquidCrystal::write(const uint8_t character) {
+    HostHal::display_bus_write_count++;
+    if (HostHal::cgram_address >= 0) {
+        HostHal::display_glyphs[HostHal::cgram_address / 8][HostHal::cgram_address % 8] = character;
+        HostHal::cgram_address = (HostHal::cgram_address + 1) & 0x3F;
+        return 1;
+    }
+    HostHal::display_write_count++;
+    if (HostHal::cursor_column < HostHal::DISPLAY_COLUMNS) {
+        HostHal::display[HostHal::cursor_row][HostHal::cursor_column] = static_cast<char>(character);
+    }
+    HostHal::cursor_column++;
+    return 1;
+}
+
+SoftwareSerial::SoftwareSerial(uint8_t, uint8_t, bool) {
+}
+
+void SoftwareSerial::begin(long) {
+}
+
+size_t SoftwareSerial::write(uint8_t) {
+    HostHal::advance_time_us(HostHal::software_serial_byte_time_us);
+    return 1;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file host_hal.h
+ * @brief Control interface of the host hardware abstraction layer (HAL).
+ * @details The host HAL provides the Arduino, AVR and library APIs used by the firmware, so the unmodified `core/`
+ *          modules and `src/main.cpp` can be compiled and run on a PC. Time is simulated: it only advances when the
+ *          firmware waits (`delay`, idle sleep) or when a host tool advances it. This makes runs deterministic and
+ *          independent of the speed of the host.
+ */
+
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace HostHal {
+    constexpr uint8_t NUMBER_OF_PINS = 70; ///< Number of digital pins (Arduino Mega 2560).
+    constexpr uint8_t NUMBER_OF_INTERRUPTS = 8; ///< Number of external interrupts.
+    constexpr uint32_t SLEEP_WAKE_UP_PERIOD_US = 1024; ///< Period of the Timer0 overflow that ends idle sleep.
+
+    /**
+     * @brief   Sets the simulated time since start-up in microseconds.
+     */
+    void set_time_us(uint64_t time_us);
+
+    /**
+     * @brief   Moves the clock of the MCU by `jump_us` (a glitch of `millis()`/`micros()`).
+     * @details The simulated sensor runs on its own clock, so its PWM pulses keep their place in real time.
+     */
+    void jump_time_us(int64_t jump_us);
+
+    /**
+     * @brief   Returns the simulated time since start-up in microseconds.
+     */
+    uint64_t get_time_us();
+
+    /**
+     * @brief   Advances the simulated time.
+     */
+    void advance_time_us(uint64_t duration_us);
+
+    /**
+     * @brief   Sets a function, that is called whenever the simulated time advances (e.g. to inject events).
+     */
+    void set_time_hook(void (*hook)(uint64_t time_us));
+
+    /**
+     * @brief   Sets the CO2 value returned by the simulated MH-Z19B sensor.
+     */
+    void set_co2_ppm(int co2_ppm);
+
+    /**
+     * @brief   Sets a function, that is called for each sensor reading instead of returning the fixed value.
+     * @details The function returns the reading in ppm and the PWM cycle period (in µs) of the sensor, which a PWM
+     *          reading takes at most (a UART reading takes exactly that long). The pulse of a PWM reading is scaled with
+     *          the returned period, so a period other than 1004 ms simulates a drifting sensor clock. A negative
+     *          reading simulates a sensor, that sends no PWM pulse (the reading times out).
+     */
+    void set_co2_reader(int (*reader)(uint32_t *duration_us));
+
+    /**
+     * @brief   Sets whether the simulated sensor is still preheating.
+     */
+    void set_sensor_preheating(bool is_preheating);
+
+    /**
+     * @brief   Returns the simulated time (in µs) of the last watchdog reset (`wdt_reset`), 0 if none yet.
+     */
+    uint64_t get_last_watchdog_reset_time_us();
+
+    /**
+     * @brief   Returns the level last written to a digital pin.
+     */
+    uint8_t get_pin_level(uint8_t pin);
+
+    /**
+     * @brief   Sets the input level of a digital pin.
+     */
+    void set_pin_level(uint8_t pin, uint8_t level);
+
+    /**
+     * @brief   Calls the interrupt service routine attached to the interrupt of the given pin, if any.
+     * @return  true if a routine was attached and called.
+     */
+    bool trigger_interrupt(uint8_t pin);
+
+    /**
+     * @brief   Returns whether interrupts are currently enabled.
+     */
+    bool are_interrupts_enabled();
+
+    /**
+     * @brief   Sets a function that receives all bytes written to `Serial` (default: bytes are discarded).
+     */
+    void set_serial_sink(void (*sink)(const uint8_t *data, size_t size));
+
+    /**
+     * @brief   Sets the time (in µs) to transmit one byte on `Serial`, added to the simulated time on each write.
+     */
+    void set_serial_byte_time_us(uint32_t byte_time_us);
+
+    /**
+     * @brief   Adds bytes to the input of `Serial` (read by the firmware with `Serial.read()`).
+     */
+    void push_serial_input(const uint8_t *data, size_t size);
+
+    /**
+     * @brief   Returns the baud rate of the last `Serial.begin()` (0 before the first call).
+     */
+    unsigned long get_serial_baud_rate();
+
+    /**
+     * @brief   Sets the time (in µs) a write to a `SoftwareSerial` (MP3 module) blocks per byte.
+     */
+    void set_software_serial_byte_time_us(uint32_t byte_time_us);
+
+    /**
+     * @brief   Returns the text currently shown in the given row of the simulated LCD (16 characters).
+     */
+    const char *get_display_row(uint8_t row);
+
+    /**
+     * @brief   Returns the number of character writes to the simulated LCD since start-up.
+     */
+    unsigned long get_display_write_count();
+
+    /**
+     * @brief   Returns the number of bus writes to the simulated LCD (characters, commands and glyph rows).
+     */
+    unsigned long get_display_bus_write_count();
+
+    /**
+     * @brief   Returns the pixel rows of a custom glyph (CGRAM slot 0-7) of the simulated LCD.
+     */
+    const uint8_t *get_display_glyph(uint8_t slot);
+}
+
+#endif //HOST_HAL_H
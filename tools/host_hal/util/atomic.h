@@ -0,0 +1,28 @@
+/**
+ * @file atomic.h
+ * @brief Host implementation of the AVR atomic block macros.
+ */
+
+#ifndef UTIL_ATOMIC_H
+#define UTIL_ATOMIC_H
+
+#include <Arduino.h>
+#include <host_hal.h>
+
+namespace HostHal {
+    /**
+     * @brief   Disables interrupts for the lifetime of the object and restores the previous state afterwards.
+     */
+    struct AtomicBlock {
+        bool was_enabled = are_interrupts_enabled();
+        bool is_done = false;
+        AtomicBlock() { noInterrupts(); }
+        ~AtomicBlock() { if (was_enabled) interrupts(); }
+    };
+}
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_FORCEON 1
+#define ATOMIC_BLOCK(type) for (HostHal::AtomicBlock _atomic_block; !_atomic_block.is_done; _atomic_block.is_done = true)
+
+#endif //UTIL_ATOMIC_H
@@ -0,0 +1,168 @@
+/**
+ * @file column_store.cpp
+ * @brief Implementation of the columnar on-disk store.
+ */
+
+#include "column_store.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ColumnStore {
+    /**
+     * @brief   Returns the id of a message/variable name, adding it to the dictionary if it is new.
+     */
+    uint32_t get_key_id(Store &store, std::string_view key);
+
+    /**
+     * @brief   Writes the whole buffer to a file, retrying on partial writes.
+     * @return  true on success, false otherwise.
+     */
+    bool write_all(int file, const void *data, size_t size);
+
+    /**
+     * @brief   Writes the buffered values of a column and clears the buffer.
+     */
+    template<typename T>
+    bool write_column(const int file, std::vector<T> &values) {
+        const bool is_written = write_all(file, values.data(), values.size() * sizeof(T));
+        values.clear();
+        return is_written;
+    }
+
+    constexpr const char *FILE_NAMES[NUMBER_OF_COLUMNS] = {
+        "host_time_us.u64",
+        "device_time_ms.u32",
+        "level.u8",
+        "key_id.u32",
+        "value.i64",
+        "text_end.u64",
+        "text.bin",
+        "keys.txt"
+    }; ///< File names of the columns, in the order of `Column`.
+
+    bool open(Store &store, const std::string &directory) {
+        store.directory = directory;
+        for (int &file: store.files) {
+            file = -1;
+        }
+        if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+        for (uint8_t column = 0; column < NUMBER_OF_COLUMNS; column++) {
+            const std::string path = directory + "/" + FILE_NAMES[column];
+            store.files[column] = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (store.files[column] < 0) {
+                close(store);
+                return false;
+            }
+        }
+
+        // Load the existing dictionary, so the key ids stay stable when the ingester is restarted.
+        std::string dictionary;
+        char chunk[4096];
+        ssize_t size;
+        while ((size = pread(store.files[KEYS], chunk, sizeof(chunk), static_cast<off_t>(dictionary.size()))) > 0) {
+            dictionary.append(chunk, static_cast<size_t>(size));
+        }
+        size_t line_start = 0;
+        for (size_t line_end; (line_end = dictionary.find('\n', line_start)) != std::string::npos;
+             line_start = line_end + 1) {
+            store.keys.emplace_back(dictionary, line_start, line_end - line_start);
+            store.key_ids.emplace(store.keys.back(), static_cast<uint32_t>(store.keys.size() - 1));
+        }
+        struct stat text_status{};
+        store.text_size = fstat(store.files[TEXT], &text_status) == 0 ? static_cast<uint64_t>(text_status.st_size) : 0;
+
+        store.host_time_us.reserve(ROWS_PER_BLOCK);
+        store.device_time_ms.reserve(ROWS_PER_BLOCK);
+        store.level.reserve(ROWS_PER_BLOCK);
+        store.key_id.reserve(ROWS_PER_BLOCK);
+        store.value.reserve(ROWS_PER_BLOCK);
+        store.text_end.reserve(ROWS_PER_BLOCK);
+        return true;
+    }
+
+    bool is_open(const Store &store) {
+        return store.files[KEYS] >= 0; // the dictionary is opened last
+    }
+
+    bool append(Store &store, const uint64_t host_time_us, const LogLineParser::Record &record) {
+        int64_t numeric_value = NO_NUMERIC_VALUE;
+        if (!record.value.empty() && !LogLineParser::parse_number(record.value, numeric_value)) {
+            numeric_value = NO_NUMERIC_VALUE;
+            store.text.append(record.value);
+            store.text_size += record.value.size();
+        }
+        store.host_time_us.push_back(host_time_us);
+        store.device_time_ms.push_back(record.device_time_ms);
+        store.level.push_back(static_cast<uint8_t>(record.level));
+        store.key_id.push_back(get_key_id(store, record.key));
+        store.value.push_back(numeric_value);
+        store.text_end.push_back(store.text_size);
+        if (store.host_time_us.size() >= ROWS_PER_BLOCK) {
+            return flush(store);
+        }
+        return true;
+    }
+
+    bool flush(Store &store) {
+        bool is_flushed = write_all(store.files[KEYS], store.new_keys.data(), store.new_keys.size());
+        store.new_keys.clear();
+        is_flushed &= write_all(store.files[TEXT], store.text.data(), store.text.size());
+        store.text.clear();
+        is_flushed &= write_column(store.files[HOST_TIME], store.host_time_us);
+        is_flushed &= write_column(store.files[DEVICE_TIME], store.device_time_ms);
+        is_flushed &= write_column(store.files[LEVEL], store.level);
+        is_flushed &= write_column(store.files[KEY_ID], store.key_id);
+        is_flushed &= write_column(store.files[VALUE], store.value);
+        is_flushed &= write_column(store.files[TEXT_END], store.text_end);
+        return is_flushed;
+    }
+
+    size_t get_buffered_rows(const Store &store) {
+        return store.host_time_us.size();
+    }
+
+    void close(Store &store) {
+        if (is_open(store)) {
+            flush(store);
+        }
+        for (int &file: store.files) {
+            if (file >= 0) {
+                ::close(file);
+                file = -1;
+            }
+        }
+    }
+
+    uint32_t get_key_id(Store &store, const std::string_view key) {
+        const auto existing_key = store.key_ids.find(key);
+        if (existing_key != store.key_ids.end()) {
+            return existing_key->second;
+        }
+        store.keys.emplace_back(key);
+        const auto key_id = static_cast<uint32_t>(store.keys.size() - 1);
+        store.key_ids.emplace(store.keys.back(), key_id);
+        store.new_keys.append(key);
+        store.new_keys.push_back('\n');
+        return key_id;
+    }
+
+    bool write_all(const int file, const void *data, size_t size) {
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        while (size > 0) {
+            const ssize_t written = write(file, bytes, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file column_store.h
+ * @brief Columnar on-disk store for parsed log records of one device.
+ * @details Each column is an append-only file of fixed-size little-endian values in the device directory:
+ *          | File                 | Type   | Content                                                        |
+ *          |:---------------------|:-------|:---------------------------------------------------------------|
+ *          | `host_time_us.u64`   | uint64 | Reception time on the host (µs since the Unix epoch)           |
+ *          | `device_time_ms.u32` | uint32 | Time of day on the device in ms                                |
+ *          | `level.u8`           | uint8  | `LogLineParser::Level`                                         |
+ *          | `key_id.u32`         | uint32 | Line number of the message/variable name in `keys.txt`         |
+ *          | `value.i64`          | int64  | Numeric value, `INT64_MIN` if there is none                    |
+ *          | `text_end.u64`       | uint64 | End offset of the non-numeric value in `text.bin`              |
+ *          | `text.bin`           | bytes  | Concatenated non-numeric values                                |
+ *          | `keys.txt`           | text   | Dictionary of messages and variable names (one per line)       |
+ *          The value is the variable value, or the rest of a message from its first number (see `LogLineParser`).
+ *          Row `n` of all columns belongs to the same log line. Rows are buffered and written in blocks.
+ */
+
+#ifndef COLUMN_STORE_H
+#define COLUMN_STORE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "log_line_parser.h"
+
+namespace ColumnStore {
+    constexpr size_t ROWS_PER_BLOCK = 4096; ///< Number of buffered rows written at once.
+    constexpr int64_t NO_NUMERIC_VALUE = INT64_MIN; ///< Stored in `value.i64`, if the value is not numeric.
+
+    /**
+     * @enum    Column
+     * @brief   Columns (files) of the store.
+     */
+    enum Column : uint8_t {
+        HOST_TIME,
+        DEVICE_TIME,
+        LEVEL,
+        KEY_ID,
+        VALUE,
+        TEXT_END,
+        TEXT,
+        KEYS,
+        NUMBER_OF_COLUMNS
+    };
+
+    /**
+     * @struct  Store
+     * @brief   Open store of one device with its buffered rows.
+     */
+    struct Store {
+        std::string directory; ///< Directory of the column files.
+        int files[NUMBER_OF_COLUMNS]; ///< File descriptors of the column files.
+        std::vector<uint64_t> host_time_us; ///< Buffered rows of `host_time_us.u64`.
+        std::vector<uint32_t> device_time_ms; ///< Buffered rows of `device_time_ms.u32`.
+        std::vector<uint8_t> level; ///< Buffered rows of `level.u8`.
+        std::vector<uint32_t> key_id; ///< Buffered rows of `key_id.u32`.
+        std::vector<int64_t> value; ///< Buffered rows of `value.i64`.
+        std::vector<uint64_t> text_end; ///< Buffered rows of `text_end.u64`.
+        std::string text; ///< Buffered bytes of `text.bin`.
+        std::string new_keys; ///< Buffered lines of `keys.txt`.
+        uint64_t text_size; ///< Total size of `text.bin` including the buffered bytes.
+        std::deque<std::string> keys; ///< Owner of the dictionary strings (stable addresses).
+        std::unordered_map<std::string_view, uint32_t> key_ids; ///< Dictionary lookup (views into `keys`).
+    };
+
+    /**
+     * @brief   Opens (or creates) the store in the given directory and loads its dictionary.
+     * @param   store The store to open.
+     * @param   directory Directory of the column files. It is created if it does not exist.
+     * @return  true on success, false otherwise (errno is set).
+     */
+    bool open(Store &store, const std::string &directory);
+
+    /**
+     * @brief   Returns true, if the store has been opened successfully and not closed since.
+     */
+    bool is_open(const Store &store);
+
+    /**
+     * @brief   Appends a parsed log record. The record is written with the next full block or `flush`.
+     * @param   store The open store.
+     * @param   host_time_us Reception time on the host.
+     * @param   record The parsed record. Its views are copied, if needed.
+     * @return  true on success, false if writing a full block failed.
+     */
+    bool append(Store &store, uint64_t host_time_us, const LogLineParser::Record &record);
+
+    /**
+     * @brief   Writes all buffered rows to the column files.
+     * @return  true on success, false otherwise.
+     */
+    bool flush(Store &store);
+
+    /**
+     * @brief   Returns the number of buffered rows, that are lost if the next write of the column files fails.
+     */
+    size_t get_buffered_rows(const Store &store);
+
+    /**
+     * @brief   Flushes and closes the store.
+     */
+    void close(Store &store);
+}
+
+#endif //COLUMN_STORE_H
@@ -0,0 +1,160 @@
+/**
+ * @file device_pipeline.cpp
+ * @brief Implementation of the per-device ingestion pipeline.
+ */
+
+#include "device_pipeline.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace DevicePipeline {
+    /**
+     * @brief   Opens the serial port and configures raw mode with the baud rate of the device.
+     */
+    bool open_port(Device &device);
+
+    /**
+     * @brief   Parses and stores all complete lines in the buffer and keeps the incomplete rest.
+     */
+    void process_lines(Device &device, uint64_t host_time_us);
+
+    /**
+     * @brief   Writes the buffered rows of the store and counts them as failed, if writing fails.
+     */
+    void flush_store(Device &device);
+
+    bool open(Device &device, const std::string &output_directory) {
+        device.file = -1;
+        device.buffer_fill = 0;
+        device.is_line_discarded = false;
+        if (!ColumnStore::open(device.store, output_directory + "/" + get_store_name(device.path))) {
+            return false;
+        }
+        return open_port(device);
+    }
+
+    bool reopen(Device &device) {
+        if (!ColumnStore::is_open(device.store) && !ColumnStore::open(device.store, device.store.directory)) {
+            return false;
+        }
+        if (!open_port(device)) {
+            return false;
+        }
+        add(device.statistics.reconnects, 1);
+        return true;
+    }
+
+    bool read_available(Device &device, const uint64_t host_time_us) {
+        while (true) {
+            const ssize_t size = read(device.file, device.buffer + device.buffer_fill,
+                                      READ_BUFFER_SIZE - device.buffer_fill);
+            if (size > 0) {
+                add(device.statistics.bytes, static_cast<uint64_t>(size));
+                device.buffer_fill += static_cast<size_t>(size);
+                process_lines(device, host_time_us);
+                continue;
+            }
+            if (size < 0 && errno == EINTR) {
+                continue;
+            }
+            if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return true;
+            }
+            // End of file or error (e.g. EIO after the other side of a pty was closed).
+            ::close(device.file);
+            device.file = -1;
+            device.buffer_fill = 0;
+            return false;
+        }
+    }
+
+    void close(Device &device) {
+        if (device.file >= 0) {
+            ::close(device.file);
+            device.file = -1;
+        }
+        if (ColumnStore::is_open(device.store)) {
+            flush_store(device);
+        }
+        ColumnStore::close(device.store);
+    }
+
+    std::string get_store_name(const std::string &path) {
+        std::string name;
+        for (const char character: path) {
+            if (character == '/') {
+                if (!name.empty()) {
+                    name.push_back('_');
+                }
+                continue;
+            }
+            name.push_back(character == '.' && name.empty() ? '_' : character);
+        }
+        return name.empty() ? "device" : name;
+    }
+
+    bool open_port(Device &device) {
+        device.file = ::open(device.path.c_str(), O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (device.file < 0) {
+            return false;
+        }
+        termios attributes{};
+        if (tcgetattr(device.file, &attributes) == 0) { // not a terminal (e.g. a FIFO): keep as it is
+            cfmakeraw(&attributes);
+            attributes.c_cflag |= CLOCAL | CREAD;
+            cfsetispeed(&attributes, device.baud_rate);
+            cfsetospeed(&attributes, device.baud_rate);
+            tcsetattr(device.file, TCSANOW, &attributes);
+        }
+        device.buffer_fill = 0;
+        device.is_line_discarded = false;
+        return true;
+    }
+
+    void process_lines(Device &device, const uint64_t host_time_us) {
+        const char *line_start = device.buffer;
+        const char *const buffer_end = device.buffer + device.buffer_fill;
+        const char *line_end;
+        while ((line_end = static_cast<const char *>(memchr(line_start, '\n', buffer_end - line_start))) != nullptr) {
+            if (device.is_line_discarded) {
+                device.is_line_discarded = false;
+            } else {
+                LogLineParser::Record record{};
+                const std::string_view line(line_start, static_cast<size_t>(line_end - line_start));
+                if (LogLineParser::parse(line, record)) {
+                    // The append writes the block, if it is full: the whole block is lost, if writing fails.
+                    const size_t block_rows = ColumnStore::get_buffered_rows(device.store) + 1;
+                    if (!ColumnStore::append(device.store, host_time_us, record)) {
+                        add(device.statistics.failed_rows, block_rows);
+                    }
+                    add(device.statistics.lines, 1);
+                } else if (!line.empty() && line != "\r") {
+                    add(device.statistics.invalid_lines, 1);
+                }
+            }
+            line_start = line_end + 1;
+        }
+
+        const size_t rest_size = static_cast<size_t>(buffer_end - line_start);
+        if (rest_size == READ_BUFFER_SIZE) {
+            // The buffer is full without a line break: skip the line up to its end.
+            add(device.statistics.overlong_lines, 1);
+            device.is_line_discarded = true;
+            device.buffer_fill = 0;
+            return;
+        }
+        if (rest_size > 0 && line_start != device.buffer) {
+            memmove(device.buffer, line_start, rest_size);
+        }
+        device.buffer_fill = rest_size;
+    }
+
+    void flush_store(Device &device) {
+        const size_t buffered_rows = ColumnStore::get_buffered_rows(device.store);
+        if (!ColumnStore::flush(device.store)) {
+            add(device.statistics.failed_rows, buffered_rows);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * @file device_pipeline.h
+ * @brief Per-device ingestion pipeline: serial port -> line framing -> parser -> column store.
+ * @details Each device owns a fixed read buffer. Bytes are read directly into the buffer, complete lines are
+ *          parsed in place and appended to the column store of the device. Only an incomplete line at the end of
+ *          the buffer is moved to its beginning before the next read.
+ */
+
+#ifndef DEVICE_PIPELINE_H
+#define DEVICE_PIPELINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <termios.h>
+#include "column_store.h"
+
+namespace DevicePipeline {
+    constexpr size_t READ_BUFFER_SIZE = 16384; ///< Size of the read buffer of each device.
+
+    /**
+     * @struct  Statistics
+     * @brief   Counters of a device pipeline.
+     * @details Only written by the worker that owns the device, but may be read by other threads.
+     */
+    struct Statistics {
+        std::atomic<uint64_t> bytes{0}; ///< Number of bytes read.
+        std::atomic<uint64_t> lines{0}; ///< Number of valid lines passed to the store.
+        std::atomic<uint64_t> invalid_lines{0}; ///< Number of lines without a valid log prefix (skipped).
+        std::atomic<uint64_t> overlong_lines{0}; ///< Number of lines longer than the read buffer (skipped).
+        std::atomic<uint64_t> failed_rows{0}; ///< Number of valid lines lost, as writing the store failed.
+        std::atomic<uint64_t> reconnects{0}; ///< Number of times the device was reopened.
+    };
+
+    /**
+     * @brief   Adds to a counter, that is written by a single thread only (no atomic read-modify-write needed).
+     */
+    inline void add(std::atomic<uint64_t> &counter, const uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @struct  Device
+     * @brief   State of one device pipeline.
+     */
+    struct Device {
+        std::string path; ///< Path of the serial port or pty.
+        int file; ///< File descriptor, -1 if the device is not open.
+        speed_t baud_rate; ///< Baud rate configured for serial ports.
+        size_t buffer_fill; ///< Number of bytes in `buffer`.
+        bool is_line_discarded; ///< True while the rest of an overlong line is skipped.
+        ColumnStore::Store store; ///< Column store of the device.
+        Statistics statistics; ///< Counters of the pipeline.
+        char buffer[READ_BUFFER_SIZE]; ///< Read buffer.
+    };
+
+    /**
+     * @brief   Opens the device in non-blocking raw mode and its column store.
+     * @param   device The device with `path` and `baud_rate` set.
+     * @param   output_directory Directory in which the store directory of the device is created.
+     * @return  true on success, false otherwise.
+     */
+    bool open(Device &device, const std::string &output_directory);
+
+    /**
+     * @brief   Reopens the serial port after it was closed (e.g. after a hang-up), and the column store, if it could
+     *          not be opened before.
+     * @return  true on success, false otherwise.
+     */
+    bool reopen(Device &device);
+
+    /**
+     * @brief   Reads all available bytes and stores all complete lines.
+     * @param   device The open device.
+     * @param   host_time_us Reception time stored with the lines.
+     * @return  false if the device was hung up or failed and has been closed, true otherwise.
+     */
+    bool read_available(Device &device, uint64_t host_time_us);
+
+    /**
+     * @brief   Closes the serial port and flushes and closes the store.
+     * @details The rows lost, if the flush fails, are counted in the statistics.
+     */
+    void close(Device &device);
+
+    /**
+     * @brief   Converts a device path to the name of its store directory (e.g. `/dev/ttyUSB0` -> `dev_ttyUSB0`).
+     */
+    std::string get_store_name(const std::string &path);
+}
+
+#endif //DEVICE_PIPELINE_H
@@ -0,0 +1,264 @@
+/**
+ * @file    log_ingester.cpp
+ * @brief   Gateway daemon that ingests the serial logs of many Air Quality Meters.
+ * @details Reads the log output of any number of meters from serial ports (or pty stand-ins) and stores every
+ *          parsed line in a columnar store per device (see `column_store.h`).
+ *          The devices are distributed over worker threads. Each worker owns its devices exclusively and waits for
+ *          data with its own epoll instance, so there is no shared state between workers and throughput scales with
+ *          the number of cores.
+ *
+ *          Usage: log_ingester --output <directory> [--threads <n>] [--baud <rate>] [--devices <file>] [device...]
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+#include "device_pipeline.h"
+
+namespace LogIngester {
+    /**
+     * @struct  Configuration
+     * @brief   Command line options.
+     */
+    struct Configuration {
+        std::string output_directory; ///< Directory for the device stores.
+        unsigned int number_of_threads = 1; ///< Number of worker threads.
+        speed_t baud_rate = B9600; ///< Baud rate of the serial ports (`LogController::SERIAL_BAUD_RATE`).
+        std::vector<std::string> device_paths; ///< Serial ports or ptys to read.
+    };
+
+    /**
+     * @struct  Worker
+     * @brief   A worker thread with its devices and epoll instance.
+     */
+    struct Worker {
+        int epoll; ///< epoll instance of the worker.
+        std::chrono::steady_clock::time_point next_reconnect; ///< Earliest time to reopen disconnected devices.
+        std::vector<std::unique_ptr<DevicePipeline::Device>> devices; ///< Devices owned by the worker.
+    };
+
+    /**
+     * @brief   Parses the command line options.
+     * @return  true if the options are valid, false otherwise.
+     */
+    bool parse_arguments(int argc, char **argv, Configuration &configuration);
+
+    /**
+     * @brief   Maps a numeric baud rate to its termios constant.
+     * @return  The termios constant, or B0 if the rate is not supported.
+     */
+    speed_t get_baud_rate_constant(unsigned long baud_rate);
+
+    /**
+     * @brief   Runs the event loop of a worker until a stop is requested.
+     */
+    void run_worker(Worker &worker);
+
+    /**
+     * @brief   Adds an open device to the epoll instance of its worker.
+     */
+    void watch_device(const Worker &worker, DevicePipeline::Device &device);
+
+    /**
+     * @brief   Prints the sums of the counters of all devices.
+     */
+    void print_statistics(const std::vector<Worker> &workers);
+
+    /**
+     * @brief   Returns the current wall clock time in microseconds since the Unix epoch.
+     */
+    uint64_t get_host_time_us();
+
+    /**
+     * @brief   Requests all workers to stop (signal handler).
+     */
+    void request_stop(int signal_number);
+
+    constexpr int MAX_EVENTS = 64; ///< Maximum number of events handled per epoll_wait call.
+    constexpr int EPOLL_TIMEOUT_MS = 1000; ///< Maximum time to wait for events.
+    constexpr auto RECONNECT_INTERVAL = std::chrono::seconds(1); ///< Time between two reconnection attempts.
+    constexpr auto STATISTICS_INTERVAL = std::chrono::seconds(10); ///< Time between two statistics outputs.
+    constexpr char USAGE[] =
+            "Usage: log_ingester --output <directory> [--threads <n>] [--baud <rate>] [--devices <file>] [device...]\n";
+
+    std::atomic<bool> is_stop_requested(false); ///< Set by SIGINT/SIGTERM.
+
+    bool parse_arguments(const int argc, char **argv, Configuration &configuration) {
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const bool has_value = i + 1 < argc;
+            if (argument == "--output" && has_value) {
+                configuration.output_directory = argv[++i];
+            } else if (argument == "--threads" && has_value) {
+                configuration.number_of_threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (argument == "--baud" && has_value) {
+                configuration.baud_rate = get_baud_rate_constant(std::strtoul(argv[++i], nullptr, 10));
+            } else if (argument == "--devices" && has_value) {
+                std::ifstream device_list(argv[++i]);
+                for (std::string path; std::getline(device_list, path);) {
+                    if (!path.empty() && path[0] != '#') {
+                        configuration.device_paths.push_back(path);
+                    }
+                }
+            } else if (argument.rfind("--", 0) == 0) {
+                return false;
+            } else {
+                configuration.device_paths.push_back(argument);
+            }
+        }
+        if (configuration.number_of_threads == 0) {
+            configuration.number_of_threads = std::thread::hardware_concurrency();
+        }
+        return !configuration.output_directory.empty() && !configuration.device_paths.empty() &&
+               configuration.baud_rate != B0 && configuration.number_of_threads > 0;
+    }
+
+    speed_t get_baud_rate_constant(const unsigned long baud_rate) {
+        switch (baud_rate) {
+            case 9600: return B9600;
+            case 19200: return B19200;
+            case 38400: return B38400;
+            case 57600: return B57600;
+            case 115200: return B115200;
+            case 230400: return B230400;
+            case 460800: return B460800;
+            case 500000: return B500000;
+            case 1000000: return B1000000;
+            default: return B0;
+        }
+    }
+
+    void run_worker(Worker &worker) {
+        epoll_event events[MAX_EVENTS];
+        while (!is_stop_requested.load(std::memory_order_relaxed)) {
+            const int number_of_events = epoll_wait(worker.epoll, events, MAX_EVENTS, EPOLL_TIMEOUT_MS);
+            if (number_of_events < 0 && errno != EINTR) {
+                std::perror("epoll_wait");
+                break;
+            }
+            const uint64_t host_time_us = get_host_time_us(); ///< One timestamp per batch of events.
+            for (int i = 0; i < number_of_events; i++) {
+                auto &device = *static_cast<DevicePipeline::Device *>(events[i].data.ptr);
+                if (!DevicePipeline::read_available(device, host_time_us)) {
+                    std::fprintf(stderr, "%s: disconnected\n", device.path.c_str());
+                }
+            }
+            if (std::chrono::steady_clock::now() < worker.next_reconnect) {
+                continue;
+            }
+            worker.next_reconnect = std::chrono::steady_clock::now() + RECONNECT_INTERVAL;
+            for (auto &device: worker.devices) {
+                if (device->file < 0 && DevicePipeline::reopen(*device)) {
+                    std::fprintf(stderr, "%s: reconnected\n", device->path.c_str());
+                    watch_device(worker, *device);
+                }
+            }
+        }
+        for (auto &device: worker.devices) {
+            DevicePipeline::close(*device);
+        }
+    }
+
+    void watch_device(const Worker &worker, DevicePipeline::Device &device) {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.ptr = &device;
+        if (epoll_ctl(worker.epoll, EPOLL_CTL_ADD, device.file, &event) != 0) {
+            std::perror(device.path.c_str());
+        }
+    }
+
+    void print_statistics(const std::vector<Worker> &workers) {
+        size_t devices = 0;
+        uint64_t bytes = 0, lines = 0, invalid_lines = 0, failed_rows = 0;
+        for (const auto &worker: workers) {
+            for (const auto &device: worker.devices) {
+                devices++;
+                bytes += device->statistics.bytes;
+                lines += device->statistics.lines;
+                invalid_lines += device->statistics.invalid_lines;
+                failed_rows += device->statistics.failed_rows;
+            }
+        }
+        std::fprintf(stderr, "devices: %zu, bytes: %llu, lines: %llu, invalid lines: %llu, failed rows: %llu\n",
+                     devices, static_cast<unsigned long long>(bytes), static_cast<unsigned long long>(lines),
+                     static_cast<unsigned long long>(invalid_lines), static_cast<unsigned long long>(failed_rows));
+    }
+
+    uint64_t get_host_time_us() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    void request_stop(int) {
+        is_stop_requested.store(true);
+    }
+}
+
+int main(int argc, char **argv) {
+    LogIngester::Configuration configuration;
+    if (!LogIngester::parse_arguments(argc, argv, configuration)) {
+        std::fputs(LogIngester::USAGE, stderr);
+        return EXIT_FAILURE;
+    }
+    if (mkdir(configuration.output_directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::perror(configuration.output_directory.c_str());
+        return EXIT_FAILURE;
+    }
+    std::signal(SIGINT, LogIngester::request_stop);
+    std::signal(SIGTERM, LogIngester::request_stop);
+
+    // Distribute the devices round-robin over the workers.
+    std::vector<LogIngester::Worker> workers(configuration.number_of_threads);
+    for (auto &worker: workers) {
+        worker.epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (worker.epoll < 0) {
+            std::perror("epoll_create1");
+            return EXIT_FAILURE;
+        }
+    }
+    for (size_t i = 0; i < configuration.device_paths.size(); i++) {
+        auto &worker = workers[i % workers.size()];
+        auto device = std::make_unique<DevicePipeline::Device>();
+        device->path = configuration.device_paths[i];
+        device->baud_rate = configuration.baud_rate;
+        if (!DevicePipeline::open(*device, configuration.output_directory)) {
+            std::perror(device->path.c_str()); // the store and the port are retried by the worker
+        }
+        if (device->file >= 0) {
+            LogIngester::watch_device(worker, *device);
+        }
+        worker.devices.push_back(std::move(device));
+    }
+
+    std::vector<std::thread> threads;
+    for (auto &worker: workers) {
+        threads.emplace_back(LogIngester::run_worker, std::ref(worker));
+    }
+
+    auto next_statistics = std::chrono::steady_clock::now() + LogIngester::STATISTICS_INTERVAL;
+    while (!LogIngester::is_stop_requested.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        if (std::chrono::steady_clock::now() < next_statistics) {
+            continue;
+        }
+        next_statistics += LogIngester::STATISTICS_INTERVAL;
+        LogIngester::print_statistics(workers);
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    LogIngester::print_statistics(workers); // includes the rows of the last flush
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file log_line_parser.cpp
+ * @brief Implementation of the zero-copy log line parser.
+ */
+
+#include "log_line_parser.h"
+
+namespace LogLineParser {
+    /**
+     * @brief   Parses a fixed number of decimal digits.
+     * @return  The value, or -1 if one of the characters is not a digit.
+     */
+    int parse_digits(std::string_view text, size_t position, size_t number_of_digits);
+
+    /**
+     * @brief   Maps the name printed between the level brackets to a log level.
+     */
+    Level parse_level(std::string_view name);
+
+    /**
+     * @brief   Removes leading and trailing spaces.
+     */
+    std::string_view trim(std::string_view text);
+
+    /**
+     * @brief   Splits a message before its first number (a word starting with a digit or a minus and a digit).
+     */
+    void split_message(std::string_view message, Record &record);
+
+    /**
+     * @brief   Returns true, if the character is a decimal digit.
+     */
+    bool is_digit(char character);
+
+    constexpr std::string_view VARIABLE_PREFIX = "Variable: "; ///< Prefix of the `TRACE_LN_*` lines.
+    constexpr std::string_view VARIABLE_SEPARATOR = " == "; ///< Separator between variable name and value.
+    constexpr size_t TIMESTAMP_LENGTH = 14; ///< Length of `[hh:mm:ss.mmm]`.
+    constexpr uint32_t MSECS_PER_SEC = 1000; ///< Number of milliseconds per second.
+    constexpr uint32_t SECS_PER_MIN = 60; ///< Number of seconds per minute.
+    constexpr uint32_t SECS_PER_HOUR = 3600; ///< Number of seconds per hour.
+
+    bool parse(std::string_view line, Record &record) {
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.size() < TIMESTAMP_LENGTH || line[0] != '[' || line[3] != ':' || line[6] != ':' ||
+            line[9] != '.' || line[13] != ']') {
+            return false;
+        }
+        const int hours = parse_digits(line, 1, 2);
+        const int minutes = parse_digits(line, 4, 2);
+        const int seconds = parse_digits(line, 7, 2);
+        const int milli_seconds = parse_digits(line, 10, 3);
+        if (hours < 0 || minutes < 0 || seconds < 0 || milli_seconds < 0) {
+            return false;
+        }
+        record.device_time_ms = (static_cast<uint32_t>(hours) * SECS_PER_HOUR +
+                                 static_cast<uint32_t>(minutes) * SECS_PER_MIN +
+                                 static_cast<uint32_t>(seconds)) * MSECS_PER_SEC + static_cast<uint32_t>(milli_seconds);
+
+        line.remove_prefix(TIMESTAMP_LENGTH);
+        const size_t level_start = line.find('[');
+        const size_t level_end = line.find(']');
+        if (level_start != 1 || level_end == std::string_view::npos) {
+            return false;
+        }
+        record.level = parse_level(line.substr(level_start + 1, level_end - level_start - 1));
+        const std::string_view message = trim(line.substr(level_end + 1));
+
+        record.is_variable = message.substr(0, VARIABLE_PREFIX.size()) == VARIABLE_PREFIX;
+        if (!record.is_variable) {
+            split_message(message, record);
+            return true;
+        }
+        const std::string_view assignment = message.substr(VARIABLE_PREFIX.size());
+        const size_t separator = assignment.find(VARIABLE_SEPARATOR);
+        if (separator == std::string_view::npos) {
+            record.is_variable = false;
+            split_message(message, record);
+            return true;
+        }
+        record.key = assignment.substr(0, separator);
+        std::string_view value = assignment.substr(separator + VARIABLE_SEPARATOR.size());
+        if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front()) {
+            value = value.substr(1, value.size() - 2);
+        }
+        record.value = value;
+        return true;
+    }
+
+    bool parse_number(const std::string_view value, int64_t &number) {
+        if (value == "true" || value == "t") {
+            number = 1;
+            return true;
+        }
+        if (value == "false" || value == "f") {
+            number = 0;
+            return true;
+        }
+        size_t position = 0;
+        const bool is_negative = !value.empty() && value[0] == '-';
+        if (is_negative || (!value.empty() && value[0] == '+')) {
+            position++;
+        }
+        if (position == value.size() || value.size() - position > 18) {
+            return false;
+        }
+        int64_t result = 0;
+        for (; position < value.size(); position++) {
+            const char digit = value[position];
+            if (digit < '0' || digit > '9') {
+                return false;
+            }
+            result = result * 10 + (digit - '0');
+        }
+        number = is_negative ? -result : result;
+        return true;
+    }
+
+    int parse_digits(const std::string_view text, const size_t position, const size_t number_of_digits) {
+        int value = 0;
+        for (size_t i = position; i < position + number_of_digits; i++) {
+            if (text[i] < '0' || text[i] > '9') {
+                return -1;
+            }
+            value = value * 10 + (text[i] - '0');
+        }
+        return value;
+    }
+
+    Level parse_level(const std::string_view name) {
+        if (name == "SILENT") return Level::SILENT;
+        if (name == "FATAL") return Level::FATAL;
+        if (name == "ERROR") return Level::ERROR;
+        if (name == "WARNING") return Level::WARNING;
+        if (name == "NOTICE") return Level::NOTICE;
+        if (name == "TRACE") return Level::TRACE;
+        if (name == "VERBOSE") return Level::VERBOSE;
+        return Level::UNKNOWN;
+    }
+
+    void split_message(const std::string_view message, Record &record) {
+        for (size_t i = 1; i < message.size(); i++) {
+            const bool is_number = is_digit(message[i]) ||
+                                   (message[i] == '-' && i + 1 < message.size() && is_digit(message[i + 1]));
+            if (is_number && message[i - 1] == ' ') {
+                record.key = trim(message.substr(0, i));
+                record.value = message.substr(i);
+                return;
+            }
+        }
+        record.key = message;
+        record.value = std::string_view();
+    }
+
+    bool is_digit(const char character) {
+        return character >= '0' && character <= '9';
+    }
+
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && text.front() == ' ') {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && text.back() == ' ') {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+}
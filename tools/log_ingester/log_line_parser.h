@@ -0,0 +1,65 @@
+/**
+ * @file log_line_parser.h
+ * @brief Zero-copy parser for the log lines of the Air Quality Meter.
+ * @details Parses lines in the format produced by `LogController::print_prefix`:
+ *          `[hh:mm:ss.mmm] [LEVEL]   <message>` and the trace lines `Variable: <name> == <value>`.
+ *          A message with a number (e.g. `Delay time: 500`) is split like a variable: the text before the first
+ *          number is the key, the rest is the value. So the keys of a store are bounded by the messages of the
+ *          firmware, and not by the values in them.
+ *          All strings of a parsed record are views into the given line, so no memory is allocated.
+ */
+
+#ifndef LOG_LINE_PARSER_H
+#define LOG_LINE_PARSER_H
+
+#include <cstdint>
+#include <string_view>
+
+namespace LogLineParser {
+    /**
+     * @enum    Level
+     * @brief   Log levels as printed by `LogController::print_log_level`.
+     */
+    enum class Level : uint8_t {
+        SILENT,
+        FATAL,
+        ERROR,
+        WARNING,
+        NOTICE,
+        TRACE,
+        VERBOSE,
+        UNKNOWN
+    };
+
+    /**
+     * @struct  Record
+     * @brief   A parsed log line.
+     */
+    struct Record {
+        uint32_t device_time_ms; ///< Time of day on the device (hh:mm:ss.mmm) in milliseconds.
+        Level level; ///< Log level of the line.
+        bool is_variable; ///< True for `Variable: <name> == <value>` trace lines.
+        std::string_view key; ///< The message up to its first number, or the variable name for trace lines.
+        std::string_view value; ///< The variable value without quotes, or the message from its first number.
+    };
+
+    /**
+     * @brief   Parses a single log line (without line break, a trailing carriage return is ignored).
+     * @param   line The line to parse. It must outlive the views in `record`.
+     * @param   record The parsed record.
+     * @return  true if the line has a valid prefix, false otherwise.
+     */
+    bool parse(std::string_view line, Record &record);
+
+    /**
+     * @brief   Converts a variable value to a number.
+     * @details Accepts decimal integers (with optional sign) and the boolean values `true`/`false` and `t`/`f`
+     *          printed by the `TRACE_LN_T`/`TRACE_LN_t` macros.
+     * @param   value The value to convert.
+     * @param   number The converted number.
+     * @return  true if the value is numeric, false otherwise.
+     */
+    bool parse_number(std::string_view value, int64_t &number);
+}
+
+#endif //LOG_LINE_PARSER_H
@@ -0,0 +1,63 @@
+"""
+Static SRAM usage per module.
+
+PlatformIO post-build script (see `extra_scripts` in platformio.ini). After the firmware is linked, the `.data` and
+`.bss` sizes of every object file are read with the size tool of the toolchain and summed up per module (the object
+file name without extension, e.g. `log_controller`). The table shows, which module uses the static SRAM, and is
+printed after every build, next to the totals of the linked firmware.
+
+The totals at run time (including the stack high-water mark) are logged and sent with the telemetry frames by the
+`MemoryMonitor`.
+"""
+
+import os
+import subprocess
+
+Import("env")  # noqa: F821 (provided by PlatformIO)
+
+
+def get_module_name(object_path):
+    name = os.path.basename(object_path)
+    for extension in (".o", ".cpp", ".c", ".S"):
+        if name.endswith(extension):
+            name = name[: -len(extension)]
+    return name
+
+
+def get_object_sizes(size_tool, object_paths):
+    """Returns a list of (object path, data size, bss size) in the Berkeley format of the size tool."""
+    output = subprocess.run([size_tool, "-B"] + object_paths, check=True, capture_output=True, text=True).stdout
+    sizes = []
+    for line in output.splitlines()[1:]:
+        fields = line.split()
+        if len(fields) >= 6:
+            sizes.append((fields[5], int(fields[1]), int(fields[2])))
+    return sizes
+
+
+def report_memory_usage(source, target, env):
+    build_dir = env.subst("$BUILD_DIR")
+    object_paths = []
+    for directory, _, files in os.walk(build_dir):
+        object_paths += [os.path.join(directory, name) for name in files if name.endswith(".o")]
+    if not object_paths:
+        return
+
+    modules = {}
+    for object_path, data_size, bss_size in get_object_sizes(env.subst("$SIZETOOL"), sorted(object_paths)):
+        is_framework = os.path.relpath(object_path, build_dir).startswith("FrameworkArduino")
+        name = "(Arduino core)" if is_framework else get_module_name(object_path)
+        module_data_size, module_bss_size = modules.get(name, (0, 0))
+        modules[name] = (module_data_size + data_size, module_bss_size + bss_size)
+
+    print("Static SRAM usage per module (before linking, in bytes):")
+    print("%-32s %6s %6s %6s" % ("module", ".data", ".bss", "total"))
+    for name, (data_size, bss_size) in sorted(modules.items(), key=lambda item: -sum(item[1])):
+        if data_size + bss_size > 0:
+            print("%-32s %6d %6d %6d" % (name, data_size, bss_size, data_size + bss_size))
+    total_data_size = sum(sizes[0] for sizes in modules.values())
+    total_bss_size = sum(sizes[1] for sizes in modules.values())
+    print("%-32s %6d %6d %6d" % ("sum", total_data_size, total_bss_size, total_data_size + total_bss_size))
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", report_memory_usage)  # noqa: F821
@@ -0,0 +1,489 @@
+/**
+ * @file    modbus_master.cpp
+ * @brief   Simulated Modbus RTU master, polls the firmware's Modbus slave as fast as the bus allows (load test).
+ * @details Runs the unmodified firmware (built with `-DENABLE_MODBUS`) on the host HAL and plays the RS-485 bus, the
+ *          USART and Timer4 of the slave in simulated time: each request byte is passed to the receive handler at the
+ *          end of its stop bit, the frame end handler is called after a silence of t3.5, and the response is taken
+ *          byte by byte at the byte time of the baud rate. Handlers due while the firmware has disabled interrupts run
+ *          when the simulated time advances next with interrupts enabled, as the interrupts on the device.
+ *
+ *          The requests are a random mix of reads of the register table, requests to be answered with an exception,
+ *          requests to other slaves and broadcasts, and corrupted requests (a flipped bit, or a pause longer than t1.5
+ *          inside the frame), which the slave has to drop. The slave checks the pauses itself, from the time between
+ *          the receive handler calls, so some of the valid requests have a pause of 0.5 character times up to t1.5
+ *          before one byte, which the slave has to accept. Each response is checked: CRC, address, function, exception
+ *          code, byte count, the request counters of the slave (registers 12 and 13), the CO2 value and the uptime.
+ *
+ *          Usage: program [--requests <n>] [--pause-ms <ms>] [--timeout-ms <ms>] [--invalid-rate <fraction>]
+ *                         [--foreign-rate <fraction>] [--corruption-rate <fraction>] [--gap-rate <fraction>]
+ *                         [--max-response-ms <ms>] [--seed <n>]
+ *
+ *          Exits with a non-zero code, if a response is wrong, missing or unexpected, or if a response starts later
+ *          than the given time after the end of its request.
+ */
+
+#include <Arduino.h>
+#include <host_hal.h>
+#include <modbus_slave.h>
+#include <pin_configuration.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+void setup(); ///< Firmware set-up (src/main.cpp).
+void loop(); ///< Firmware main loop (src/main.cpp).
+
+namespace ModbusMaster {
+    constexpr unsigned long DEFAULT_NUMBER_OF_REQUESTS = 10000UL; ///< Requests sent by default.
+    constexpr double DEFAULT_TIMEOUT_MS = 50.0; ///< Default wait for a response, before the next request.
+    constexpr double DEFAULT_MAX_RESPONSE_MS = 5.0; ///< Default limit of the response time (end of request to start).
+    constexpr uint64_t MICROSECONDS_PER_SECOND = 1000000ULL; ///< Conversion factor for the times.
+    constexpr double MICROSECONDS_PER_MILLISECOND = 1000.0; ///< Conversion factor for the times.
+    constexpr uint32_t BYTE_TIME_US = ModbusSlave::CHARACTER_TIME_US; ///< Time of one character on the bus.
+    constexpr int MIN_CO2_PPM = 500; ///< Lowest value of the simulated sensor.
+    constexpr int CO2_RAMP_PERIOD_S = 1000; ///< The simulated value rises by 1 ppm/s and drops back after this time.
+    constexpr uint32_t PWM_CYCLE_US = 1004000; ///< Cycle period of the simulated MH-Z19B.
+    constexpr unsigned long MAX_UPTIME_LAG_S = 30UL; ///< Uptime register may lag the simulated time by a loop.
+    constexpr uint16_t CRC16_POLYNOMIAL = 0xA001; ///< Generator polynomial of CRC16/MODBUS (reflected).
+    constexpr uint8_t WRITE_SINGLE_REGISTER = 0x06; ///< Function, that the slave does not support.
+
+    /**
+     * @brief   Expected reaction of the slave to a request.
+     */
+    enum Expectation : uint8_t {
+        EXPECT_REGISTERS, ///< A read response.
+        EXPECT_EXCEPTION, ///< An exception response.
+        EXPECT_SILENCE_FOREIGN, ///< No response, the request is addressed to another slave or is a broadcast.
+        EXPECT_SILENCE_DROPPED ///< No response, the slave drops the corrupted request.
+    };
+
+    /**
+     * @brief   Phase of the bus.
+     */
+    enum Phase : uint8_t {
+        SENDING_REQUEST, ///< The master sends the bytes of the request.
+        WAITING_FOR_SILENCE, ///< t3.5 after the last byte, the slave's timer ends the frame.
+        RECEIVING_RESPONSE, ///< The slave sends the response.
+        WAITING_FOR_TIMEOUT, ///< No response, the master waits for its timeout.
+        PAUSING ///< The master pauses before the next request.
+    };
+
+    /**
+     * @struct  Request
+     * @brief   A request and the expected reaction of the slave.
+     */
+    struct Request {
+        std::vector<uint8_t> frame; ///< Bytes on the bus, including the CRC.
+        size_t pause_before_index; ///< Byte preceded by a pause (0: none).
+        uint32_t pause_us; ///< Silence before the byte, in addition to the character time.
+        Expectation expectation; ///< Expected reaction of the slave.
+        uint8_t function; ///< Function code.
+        uint16_t start_address; ///< First register of a read.
+        uint16_t quantity; ///< Number of registers of a read.
+        uint8_t exception_code; ///< Expected exception code.
+    };
+
+    /**
+     * @struct  Statistics
+     * @brief   Results of the load test.
+     */
+    struct Statistics {
+        unsigned long requests[4]; ///< Requests sent, per expectation.
+        unsigned long paused_requests; ///< Valid requests with a pause of up to t1.5, that the slave has to accept.
+        unsigned long correct_responses; ///< Responses as expected (read and exception responses).
+        unsigned long wrong_responses; ///< Responses with a wrong CRC, header, length or value.
+        unsigned long missing_responses; ///< Expected responses, that did not come before the timeout.
+        unsigned long unexpected_responses; ///< Responses to requests, that are to be ignored or dropped.
+        unsigned long late_responses; ///< Responses, that started later than the limit.
+        uint64_t total_response_start_us; ///< Sum of the times from the end of a request to its response.
+        uint64_t min_response_start_us; ///< Shortest time from the end of a request to its response.
+        uint64_t max_response_start_us; ///< Longest time from the end of a request to its response.
+        uint64_t total_response_end_us; ///< Sum of the times from the end of a request to the end of its response.
+        uint64_t max_response_end_us; ///< Longest time from the end of a request to the end of its response.
+    };
+
+    unsigned long number_of_requests = DEFAULT_NUMBER_OF_REQUESTS; ///< Requests to send.
+    uint64_t pause_us = ModbusSlave::FRAME_SILENCE_US; ///< Pause of the master after a response or timeout.
+    uint64_t timeout_us = static_cast<uint64_t>(DEFAULT_TIMEOUT_MS * MICROSECONDS_PER_MILLISECOND);
+    ///< Wait for a response.
+    uint64_t max_response_start_us = static_cast<uint64_t>(DEFAULT_MAX_RESPONSE_MS * MICROSECONDS_PER_MILLISECOND);
+    ///< Limit of the time from the end of a request to the start of its response.
+    double invalid_rate = 0.05; ///< Share of requests answered with an exception.
+    double foreign_rate = 0.05; ///< Share of requests to other slaves and broadcasts.
+    double corruption_rate = 0.05; ///< Share of corrupted requests.
+    double gap_rate = 0.05; ///< Share of valid requests with a pause of up to t1.5 inside the frame.
+    std::mt19937 random_generator; ///< Source of the request mix.
+
+    Phase phase = PAUSING; ///< Current phase of the bus.
+    uint64_t next_event_time_us = 0; ///< Time of the next bus event.
+    bool is_event_deferred = false; ///< True, if an event was due while interrupts were disabled.
+    Request request; ///< Request on the bus.
+    size_t byte_index = 0; ///< Next byte of the request to send.
+    uint64_t byte_time_us = 0; ///< Time of the last receive handler call, the slave measures the pauses from it.
+    uint64_t request_end_time_us = 0; ///< End of the last stop bit of the request.
+    uint64_t response_start_time_us = 0; ///< Start of the first byte of the response.
+    std::vector<uint8_t> response; ///< Bytes of the response received so far.
+    unsigned long number_of_completed_requests = 0; ///< Requests answered or timed out.
+    uint16_t number_of_answered_requests = 0; ///< Requests the slave has to have answered (register 12).
+    uint16_t number_of_dropped_frames = 0; ///< Frames the slave has to have dropped (register 13).
+    Statistics statistics = {}; ///< Results of the load test.
+
+    /**
+     * @brief   Passes the bus events up to the given time to the slave (time hook).
+     */
+    void run_bus(uint64_t time_us);
+
+    /**
+     * @brief   Handles the bus event at `next_event_time_us`, or at the given time, if it was deferred.
+     */
+    void handle_event(uint64_t time_us);
+
+    /**
+     * @brief   Returns the next random request.
+     */
+    Request create_request();
+
+    /**
+     * @brief   Returns a read request of the given registers.
+     */
+    Request create_read(uint8_t address, uint8_t function, uint16_t start_address, uint16_t quantity);
+
+    /**
+     * @brief   Checks the response (or its absence) against the expectation of the request.
+     * @param   is_timeout True, if the slave did not respond.
+     */
+    void check_response(bool is_timeout);
+
+    /**
+     * @brief   Checks the register values of a read response.
+     * @return  True, if the values are plausible.
+     */
+    bool are_registers_plausible();
+
+    /**
+     * @brief   Computes the CRC16/MODBUS of the given bytes.
+     */
+    uint16_t crc16(const uint8_t *data, size_t size);
+
+    /**
+     * @brief   Returns a rising CO2 value, so the register can be checked against the range of the sensor.
+     */
+    int read_co2(uint32_t *duration_us);
+
+    /**
+     * @brief   Returns true with the given probability.
+     */
+    bool is_chosen(double probability);
+
+    /**
+     * @brief   Prints the results.
+     */
+    void print_statistics();
+
+    void run_bus(const uint64_t time_us) {
+        if (!HostHal::are_interrupts_enabled()) {
+            is_event_deferred = is_event_deferred || next_event_time_us <= time_us;
+            return;
+        }
+        while (number_of_completed_requests < number_of_requests && next_event_time_us <= time_us) {
+            handle_event(is_event_deferred ? time_us : next_event_time_us); // a deferred event runs now
+            is_event_deferred = false;
+        }
+    }
+
+    void handle_event(const uint64_t time_us) {
+        switch (phase) {
+            case PAUSING:
+                request = create_request();
+                byte_index = 0;
+                phase = SENDING_REQUEST;
+                next_event_time_us = time_us + BYTE_TIME_US;
+                break;
+            case SENDING_REQUEST: {
+                ModbusSlave::on_byte_received(request.frame[byte_index++], false,
+                                              static_cast<unsigned long>(time_us - byte_time_us));
+                byte_time_us = time_us;
+                if (byte_index < request.frame.size()) {
+                    next_event_time_us = next_event_time_us + BYTE_TIME_US +
+                                         (byte_index == request.pause_before_index ? request.pause_us : 0);
+                } else {
+                    request_end_time_us = next_event_time_us;
+                    phase = WAITING_FOR_SILENCE;
+                    next_event_time_us = request_end_time_us + ModbusSlave::FRAME_SILENCE_US;
+                }
+                break;
+            }
+            case WAITING_FOR_SILENCE:
+                ModbusSlave::on_frame_silence();
+                response.clear();
+                if (HostHal::get_pin_level(ModbusSlave::DriverEnablePin::NUMBER) == HIGH) {
+                    phase = RECEIVING_RESPONSE;
+                    response_start_time_us = time_us;
+                    next_event_time_us = time_us + BYTE_TIME_US;
+                } else {
+                    phase = WAITING_FOR_TIMEOUT;
+                    next_event_time_us = request_end_time_us + timeout_us;
+                }
+                break;
+            case RECEIVING_RESPONSE: {
+                const int16_t character = ModbusSlave::get_next_byte_to_send();
+                if (character >= 0) {
+                    response.push_back(static_cast<uint8_t>(character));
+                    next_event_time_us = time_us + BYTE_TIME_US;
+                    break;
+                }
+                ModbusSlave::on_transmission_complete();
+                const uint64_t response_start_us = response_start_time_us - request_end_time_us;
+                const uint64_t response_end_us = time_us - request_end_time_us;
+                statistics.total_response_start_us += response_start_us;
+                statistics.min_response_start_us = std::min(statistics.min_response_start_us, response_start_us);
+                statistics.max_response_start_us = std::max(statistics.max_response_start_us, response_start_us);
+                statistics.total_response_end_us += response_end_us;
+                statistics.max_response_end_us = std::max(statistics.max_response_end_us, response_end_us);
+                if (response_start_us > max_response_start_us) {
+                    statistics.late_responses++;
+                }
+                check_response(false);
+                phase = PAUSING;
+                next_event_time_us = time_us + pause_us;
+                break;
+            }
+            case WAITING_FOR_TIMEOUT:
+                check_response(true);
+                phase = PAUSING;
+                next_event_time_us = time_us + pause_us;
+                break;
+        }
+    }
+
+    Request create_request() {
+        const uint16_t number_of_registers = ModbusSlave::NUMBER_OF_REGISTERS;
+        const uint8_t function = random_generator() % 2 ? ModbusSlave::READ_HOLDING_REGISTERS
+                                                        : ModbusSlave::READ_INPUT_REGISTERS;
+        const uint16_t start_address = static_cast<uint16_t>(random_generator() % number_of_registers);
+        const uint16_t quantity = static_cast<uint16_t>(1 + random_generator() % (number_of_registers - start_address));
+        Request next = create_read(ModbusSlave::SLAVE_ADDRESS, function, start_address, quantity);
+
+        if (is_chosen(foreign_rate)) {
+            uint8_t address = 0; ///< Broadcast, or the address of another slave.
+            if (random_generator() % 4 != 0) {
+                do {
+                    address = static_cast<uint8_t>(1 + random_generator() % 247);
+                } while (address == ModbusSlave::SLAVE_ADDRESS);
+            }
+            next = create_read(address, function, start_address, quantity);
+            next.expectation = EXPECT_SILENCE_FOREIGN;
+        } else if (is_chosen(invalid_rate)) {
+            switch (random_generator() % 3) {
+                case 0:
+                    next = create_read(ModbusSlave::SLAVE_ADDRESS, WRITE_SINGLE_REGISTER, start_address, 1);
+                    next.exception_code = ModbusSlave::ILLEGAL_FUNCTION;
+                    break;
+                case 1:
+                    next = create_read(ModbusSlave::SLAVE_ADDRESS, function, start_address,
+                                       static_cast<uint16_t>(number_of_registers - start_address + 1));
+                    next.exception_code = ModbusSlave::ILLEGAL_DATA_ADDRESS;
+                    break;
+                default:
+                    next = create_read(ModbusSlave::SLAVE_ADDRESS, function, start_address, 0);
+                    next.exception_code = ModbusSlave::ILLEGAL_DATA_VALUE;
+                    break;
+            }
+            next.expectation = EXPECT_EXCEPTION;
+        }
+        if (is_chosen(corruption_rate)) {
+            if (random_generator() % 2) {
+                const size_t index = random_generator() % next.frame.size(); ///< Byte with the flipped bit.
+                next.frame[index] ^= static_cast<uint8_t>(1U << random_generator() % 8);
+            } else {
+                next.pause_before_index = 1 + random_generator() % (next.frame.size() - 1);
+                next.pause_us = 2 * ModbusSlave::CHARACTER_SILENCE_US;
+            }
+            next.expectation = EXPECT_SILENCE_DROPPED;
+        } else if (is_chosen(gap_rate)) {
+            next.pause_before_index = 1 + random_generator() % (next.frame.size() - 1);
+            next.pause_us = static_cast<uint32_t>(BYTE_TIME_US / 2 + 1 + random_generator() %
+                                                  (ModbusSlave::CHARACTER_SILENCE_US - BYTE_TIME_US / 2));
+            statistics.paused_requests++;
+        }
+        statistics.requests[next.expectation]++;
+        return next;
+    }
+
+    Request create_read(const uint8_t address, const uint8_t function, const uint16_t start_address,
+                        const uint16_t quantity) {
+        Request read = {
+            {
+                address, function, static_cast<uint8_t>(start_address >> 8), static_cast<uint8_t>(start_address),
+                static_cast<uint8_t>(quantity >> 8), static_cast<uint8_t>(quantity)
+            },
+            0, 0, EXPECT_REGISTERS, function, start_address, quantity, 0
+        };
+        const uint16_t crc = crc16(read.frame.data(), read.frame.size());
+        read.frame.push_back(static_cast<uint8_t>(crc));
+        read.frame.push_back(static_cast<uint8_t>(crc >> 8));
+        return read;
+    }
+
+    void check_response(const bool is_timeout) {
+        number_of_completed_requests++;
+        if (request.expectation == EXPECT_SILENCE_DROPPED) {
+            number_of_dropped_frames++;
+        }
+        if (request.expectation == EXPECT_REGISTERS || request.expectation == EXPECT_EXCEPTION) {
+            number_of_answered_requests++;
+            if (is_timeout) {
+                statistics.missing_responses++;
+                return;
+            }
+        } else {
+            if (!is_timeout) {
+                statistics.unexpected_responses++;
+            }
+            return;
+        }
+        const bool is_exception = request.expectation == EXPECT_EXCEPTION;
+        const size_t expected_size = is_exception ? 5 : 5 + 2 * static_cast<size_t>(request.quantity);
+        const bool is_correct =
+                response.size() == expected_size &&
+                crc16(response.data(), response.size()) == 0 &&
+                response[0] == ModbusSlave::SLAVE_ADDRESS &&
+                (is_exception
+                     ? response[1] == (request.function | ModbusSlave::EXCEPTION_FLAG) &&
+                       response[2] == request.exception_code
+                     : response[1] == request.function && response[2] == 2 * request.quantity &&
+                       are_registers_plausible());
+        if (is_correct) {
+            statistics.correct_responses++;
+        } else {
+            statistics.wrong_responses++;
+        }
+    }
+
+    bool are_registers_plausible() {
+        uint16_t values[ModbusSlave::NUMBER_OF_REGISTERS]; ///< Register values of the response.
+        bool is_read[ModbusSlave::NUMBER_OF_REGISTERS] = {}; ///< True, if the register is in the response.
+        for (uint16_t i = 0; i < request.quantity; i++) {
+            values[request.start_address + i] = static_cast<uint16_t>(response[3 + 2 * i] << 8 | response[4 + 2 * i]);
+            is_read[request.start_address + i] = true;
+        }
+        if (is_read[ModbusSlave::ANSWERED_REQUESTS_REGISTER] &&
+            values[ModbusSlave::ANSWERED_REQUESTS_REGISTER] != static_cast<uint16_t>(number_of_answered_requests)) {
+            return false;
+        }
+        if (is_read[ModbusSlave::DROPPED_FRAMES_REGISTER] &&
+            values[ModbusSlave::DROPPED_FRAMES_REGISTER] != number_of_dropped_frames) {
+            return false;
+        }
+        const uint16_t co2_ppm = values[ModbusSlave::CO2_PPM_REGISTER]; ///< Filtered value, or `NO_VALUE`.
+        if (is_read[ModbusSlave::CO2_PPM_REGISTER] && co2_ppm != ModbusSlave::NO_VALUE &&
+            (co2_ppm < MIN_CO2_PPM || co2_ppm >= MIN_CO2_PPM + CO2_RAMP_PERIOD_S)) {
+            return false;
+        }
+        if (is_read[ModbusSlave::UPTIME_HIGH_REGISTER] && is_read[ModbusSlave::UPTIME_LOW_REGISTER]) {
+            const unsigned long uptime_s =
+                    static_cast<unsigned long>(values[ModbusSlave::UPTIME_HIGH_REGISTER]) << 16 |
+                    values[ModbusSlave::UPTIME_LOW_REGISTER];
+            const unsigned long time_s = static_cast<unsigned long>(HostHal::get_time_us() / MICROSECONDS_PER_SECOND);
+            if (uptime_s > time_s || uptime_s + MAX_UPTIME_LAG_S < time_s) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint16_t crc16(const uint8_t *data, const size_t size) {
+        uint16_t crc = 0xFFFF;
+        for (size_t i = 0; i < size; i++) {
+            crc ^= data[i];
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                crc = crc & 1U ? static_cast<uint16_t>(crc >> 1) ^ CRC16_POLYNOMIAL : crc >> 1;
+            }
+        }
+        return crc;
+    }
+
+    int read_co2(uint32_t *duration_us) {
+        *duration_us = PWM_CYCLE_US;
+        return MIN_CO2_PPM + static_cast<int>(HostHal::get_time_us() / MICROSECONDS_PER_SECOND % CO2_RAMP_PERIOD_S);
+    }
+
+    bool is_chosen(const double probability) {
+        return std::uniform_real_distribution<double>(0.0, 1.0)(random_generator) < probability;
+    }
+
+    void print_statistics() {
+        const unsigned long number_of_responses = statistics.correct_responses + statistics.wrong_responses;
+        const double simulated_time_s = static_cast<double>(HostHal::get_time_us()) / MICROSECONDS_PER_SECOND;
+        std::printf("slave %u at %lu baud (t3.5 = %lu us, t1.5 = %lu us)\n", ModbusSlave::SLAVE_ADDRESS,
+                    ModbusSlave::BAUD_RATE, ModbusSlave::FRAME_SILENCE_US, ModbusSlave::CHARACTER_SILENCE_US);
+        std::printf("requests: %lu (%lu reads, %lu exceptions, %lu to other slaves or broadcast, %lu corrupted)\n",
+                    number_of_completed_requests, statistics.requests[EXPECT_REGISTERS],
+                    statistics.requests[EXPECT_EXCEPTION], statistics.requests[EXPECT_SILENCE_FOREIGN],
+                    statistics.requests[EXPECT_SILENCE_DROPPED]);
+        std::printf("valid requests with a pause of up to t1.5: %lu\n", statistics.paused_requests);
+        std::printf("responses: %lu correct, %lu wrong, %lu missing, %lu unexpected, %lu late\n",
+                    statistics.correct_responses, statistics.wrong_responses, statistics.missing_responses,
+                    statistics.unexpected_responses, statistics.late_responses);
+        if (number_of_responses > 0) {
+            std::printf("response start after request: min %.3f ms, avg %.3f ms, max %.3f ms\n",
+                        statistics.min_response_start_us / MICROSECONDS_PER_MILLISECOND,
+                        statistics.total_response_start_us / MICROSECONDS_PER_MILLISECOND / number_of_responses,
+                        statistics.max_response_start_us / MICROSECONDS_PER_MILLISECOND);
+            std::printf("response end after request: avg %.3f ms, max %.3f ms\n",
+                        statistics.total_response_end_us / MICROSECONDS_PER_MILLISECOND / number_of_responses,
+                        statistics.max_response_end_us / MICROSECONDS_PER_MILLISECOND);
+        }
+        std::printf("simulated time: %.1f s, %.1f requests/s\n", simulated_time_s,
+                    number_of_completed_requests / simulated_time_s);
+    }
+}
+
+int main(const int argc, char **argv) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const double value = std::strtod(argv[i + 1], nullptr);
+        if (!std::strcmp(argv[i], "--requests")) {
+            ModbusMaster::number_of_requests = std::strtoul(argv[i + 1], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--pause-ms")) {
+            ModbusMaster::pause_us = std::max<uint64_t>(
+                static_cast<uint64_t>(value * ModbusMaster::MICROSECONDS_PER_MILLISECOND),
+                ModbusSlave::FRAME_SILENCE_US); // frames are separated by t3.5 at least
+        } else if (!std::strcmp(argv[i], "--timeout-ms")) {
+            ModbusMaster::timeout_us = static_cast<uint64_t>(value * ModbusMaster::MICROSECONDS_PER_MILLISECOND);
+        } else if (!std::strcmp(argv[i], "--invalid-rate")) {
+            ModbusMaster::invalid_rate = value;
+        } else if (!std::strcmp(argv[i], "--foreign-rate")) {
+            ModbusMaster::foreign_rate = value;
+        } else if (!std::strcmp(argv[i], "--corruption-rate")) {
+            ModbusMaster::corruption_rate = value;
+        } else if (!std::strcmp(argv[i], "--gap-rate")) {
+            ModbusMaster::gap_rate = value;
+        } else if (!std::strcmp(argv[i], "--max-response-ms")) {
+            ModbusMaster::max_response_start_us = static_cast<uint64_t>(
+                value * ModbusMaster::MICROSECONDS_PER_MILLISECOND);
+        } else if (!std::strcmp(argv[i], "--seed")) {
+            ModbusMaster::random_generator.seed(static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10)));
+        } else {
+            std::fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+    ModbusMaster::statistics.min_response_start_us = UINT64_MAX;
+    HostHal::set_sensor_preheating(false);
+    HostHal::set_co2_reader(ModbusMaster::read_co2);
+    setup();
+    ModbusMaster::next_event_time_us = HostHal::get_time_us();
+    HostHal::set_time_hook(ModbusMaster::run_bus);
+    while (ModbusMaster::number_of_completed_requests < ModbusMaster::number_of_requests) {
+        loop();
+    }
+    ModbusMaster::print_statistics();
+    const bool is_passed = ModbusMaster::statistics.wrong_responses == 0 &&
+                           ModbusMaster::statistics.missing_responses == 0 &&
+                           ModbusMaster::statistics.unexpected_responses == 0 &&
+                           ModbusMaster::statistics.late_responses == 0;
+    return is_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,496 @@
+/**
+ * @file    policy_sweep.cpp
+ * @brief   Parameter sweep of the air quality thresholds and the warning policy over recorded CO2 data.
+ * @details Evaluates every combination of the given parameter ranges against CO2 datasets, with the unmodified
+ *          `MeasurementInterpreter` and `WarningController` logic of the firmware. The datasets are loaded once and
+ *          shared read-only, the configurations are distributed over worker threads (one per core by default). Each
+ *          worker replays all datasets for one configuration at a time, like the main loop does on the device:
+ *          acceptable air resets the warning state, otherwise a warning is issued as soon as the policy says so. The
+ *          readings of a dataset are classified at once with the vectorized `BatchClassifier`.
+ *
+ *          A dataset is either a directory written by the log ingester (the filtered readings of the
+ *          `current_co2_measurement_ppm` trace lines, timed by their reception on the host) or a CSV file with one
+ *          `<time in s>,<CO2 in ppm>` sample per line. Gaps longer than `--max-gap-s` start a new session (power-on).
+ *
+ *          Usage: policy_sweep [options] <dataset>...
+ *
+ *          Prints one CSV line of metrics per configuration to the standard output.
+ */
+
+#include <air_quality.h>
+#include <measurement_interpreter.h>
+#include <warning_controller.h>
+#include <co2_level_time_tracker.h>
+#include <batch_classifier.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace PolicySweep {
+    /**
+     * @enum    Parameter
+     * @brief   Swept parameters.
+     */
+    enum Parameter : uint8_t {
+        HIGH_QUALITY_PPM,
+        MEDIUM_QUALITY_PPM,
+        LOWER_MODERATE_QUALITY_PPM,
+        UPPER_MODERATE_QUALITY_PPM,
+        MAX_TIME_ABOVE_CO2_THRESHOLD_S,
+        WAITING_PERIOD_BETWEEN_WARNINGS_S,
+        MAX_CONSECUTIVE_WARNINGS,
+        NUMBER_OF_PARAMETERS
+    };
+
+    /**
+     * @struct  Range
+     * @brief   Values of a swept parameter: `first`, `first + step`, ... up to `last`.
+     */
+    struct Range {
+        long first; ///< First value.
+        long last; ///< Last value (inclusive).
+        long step; ///< Step between two values.
+    };
+
+    /**
+     * @struct  Configuration
+     * @brief   Command line options.
+     */
+    struct Configuration {
+        Range ranges[NUMBER_OF_PARAMETERS]; ///< Range of each parameter.
+        unsigned int number_of_threads = 0; ///< Number of worker threads (0 = one per core).
+        uint64_t nuisance_episode_ms = 10 * 60 * 1000ULL; ///< Episodes shorter than this are short exceedances.
+        uint64_t max_gap_ms = 10 * 60 * 1000ULL; ///< Longer gaps between two samples start a new session.
+        std::vector<std::string> dataset_paths; ///< Datasets to replay.
+    };
+
+    /**
+     * @struct  Dataset
+     * @brief   CO2 samples of one meter, ordered by time.
+     */
+    struct Dataset {
+        std::vector<uint64_t> time_ms; ///< Time of each sample (ms since the first sample).
+        std::vector<int> co2_ppm; ///< CO2 value of each sample.
+    };
+
+    /**
+     * @struct  Candidate
+     * @brief   Parameter values of one evaluated configuration.
+     */
+    struct Candidate {
+        long values[NUMBER_OF_PARAMETERS]; ///< Value of each parameter.
+    };
+
+    /**
+     * @struct  Metrics
+     * @brief   Results of a configuration over all datasets.
+     */
+    struct Metrics {
+        uint64_t number_of_warnings; ///< Audio warnings issued.
+        uint64_t number_of_nuisance_warnings; ///< Warnings in episodes shorter than the nuisance limit.
+        uint64_t number_of_episodes; ///< Episodes of not acceptable air.
+        uint64_t number_of_missed_episodes; ///< Episodes at least as long as the nuisance limit, without warning.
+        uint64_t number_of_warned_episodes; ///< Episodes with at least one warning.
+        uint64_t total_time_to_first_warning_ms; ///< Sum over the warned episodes of the time until the first warning.
+        uint64_t max_time_to_first_warning_ms; ///< Longest time in not acceptable air until the first warning.
+        uint64_t poor_air_time_ms; ///< Time in not acceptable air.
+        uint64_t number_of_level_changes; ///< Changes of the shown air quality level (LED pattern).
+    };
+
+    /**
+     * @brief   Parses the command line options.
+     * @return  true if the options are valid, false otherwise.
+     */
+    bool parse_arguments(int argc, char **argv, Configuration &configuration);
+
+    /**
+     * @brief   Parses a range `<first>[:<last>[:<step>]]`.
+     * @return  true if the range is valid, false otherwise.
+     */
+    bool parse_range(const char *text, Range &range);
+
+    /**
+     * @brief   Loads a dataset (log ingester directory or CSV file).
+     * @return  true on success, false otherwise.
+     */
+    bool load_dataset(const std::string &path, Dataset &dataset);
+
+    /**
+     * @brief   Loads the `current_co2_measurement_ppm` readings from the store of the log ingester.
+     * @return  true on success, false otherwise.
+     */
+    bool load_store(const std::string &directory, Dataset &dataset);
+
+    /**
+     * @brief   Loads `<time in s>,<CO2 in ppm>` samples from a CSV file (other lines are skipped).
+     * @return  true on success, false otherwise.
+     */
+    bool load_csv(const std::string &path, Dataset &dataset);
+
+    /**
+     * @brief   Reads a whole column file of fixed-size values.
+     * @return  true on success, false otherwise.
+     */
+    template<typename T>
+    bool read_column(const std::string &path, std::vector<T> &values);
+
+    /**
+     * @brief   Builds all candidate configurations (cartesian product of the ranges, with ascending thresholds).
+     */
+    std::vector<Candidate> build_candidates(const Configuration &configuration);
+
+    /**
+     * @brief   Replays all datasets with the thresholds and the warning policy of a candidate.
+     */
+    Metrics evaluate(const Candidate &candidate, const std::vector<Dataset> &datasets,
+                     const Configuration &configuration);
+
+    /**
+     * @brief   Ends an episode of not acceptable air and adds it to the metrics.
+     */
+    void end_episode(Metrics &metrics, uint64_t duration_ms, uint64_t number_of_warnings,
+                     uint64_t time_to_first_warning_ms, const Configuration &configuration);
+
+    /**
+     * @brief   Prints the CSV header and one line per candidate.
+     */
+    void print_results(const std::vector<Candidate> &candidates, const std::vector<Metrics> &results);
+
+    constexpr char CO2_KEY[] = "current_co2_measurement_ppm"; ///< Variable of the filtered reading in the log.
+    constexpr double MILLISECONDS_PER_SECOND = 1000.0; ///< Conversion factor for the CSV times.
+    constexpr double MILLISECONDS_PER_HOUR = 3600000.0; ///< Conversion factor for the report.
+    constexpr const char *PARAMETER_NAMES[NUMBER_OF_PARAMETERS] = {
+        "high-ppm", "medium-ppm", "lower-moderate-ppm", "poor-ppm", "max-time-above-s", "waiting-period-s",
+        "max-warnings"
+    }; ///< Names of the parameters (command line option without `--`, CSV column with `_` instead of `-`).
+    constexpr char USAGE[] =
+            "Usage: policy_sweep [--<parameter> <first>[:<last>[:<step>]]]... [--threads <n>] [--nuisance-minutes <n>]\n"
+            "                    [--max-gap-s <n>] <dataset>...\n"
+            "Parameters: high-ppm, medium-ppm, lower-moderate-ppm, poor-ppm, max-time-above-s, waiting-period-s,\n"
+            "            max-warnings (default: the values of the firmware)\n";
+
+    bool parse_arguments(const int argc, char **argv, Configuration &configuration) {
+        const MeasurementInterpreter::Thresholds &thresholds = MeasurementInterpreter::DEFAULT_THRESHOLDS;
+        const WarningController::Policy &policy = WarningController::DEFAULT_POLICY;
+        const long defaults[NUMBER_OF_PARAMETERS] = {
+            thresholds.upper_threshold_ppm[0], thresholds.upper_threshold_ppm[1], thresholds.upper_threshold_ppm[2],
+            thresholds.upper_threshold_ppm[3], static_cast<long>(policy.max_time_above_co2_threshold.to_seconds()),
+            static_cast<long>(policy.waiting_period_between_warnings.to_seconds()), policy.max_consecutive_warnings
+        }; ///< Values of the firmware.
+        for (uint8_t parameter = 0; parameter < NUMBER_OF_PARAMETERS; parameter++) {
+            configuration.ranges[parameter] = {defaults[parameter], defaults[parameter], 1};
+        }
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const bool has_value = i + 1 < argc;
+            bool is_parameter = false; ///< True, if the argument is a swept parameter.
+            for (uint8_t parameter = 0; parameter < NUMBER_OF_PARAMETERS && has_value; parameter++) {
+                if (argument == std::string("--") + PARAMETER_NAMES[parameter]) {
+                    if (!parse_range(argv[++i], configuration.ranges[parameter])) {
+                        return false;
+                    }
+                    is_parameter = true;
+                    break;
+                }
+            }
+            if (is_parameter) {
+                continue;
+            }
+            if (argument == "--threads" && has_value) {
+                configuration.number_of_threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (argument == "--nuisance-minutes" && has_value) {
+                configuration.nuisance_episode_ms = std::strtoull(argv[++i], nullptr, 10) * 60 * 1000ULL;
+            } else if (argument == "--max-gap-s" && has_value) {
+                configuration.max_gap_ms = std::strtoull(argv[++i], nullptr, 10) * 1000ULL;
+            } else if (argument.rfind("--", 0) == 0) {
+                return false;
+            } else {
+                configuration.dataset_paths.push_back(argument);
+            }
+        }
+        if (configuration.number_of_threads == 0) {
+            configuration.number_of_threads = std::thread::hardware_concurrency();
+        }
+        return !configuration.dataset_paths.empty() && configuration.number_of_threads > 0;
+    }
+
+    bool parse_range(const char *text, Range &range) {
+        char *end = nullptr;
+        range.first = std::strtol(text, &end, 10);
+        range.last = range.first;
+        range.step = 1;
+        if (*end == ':') {
+            range.last = std::strtol(end + 1, &end, 10);
+        }
+        if (*end == ':') {
+            range.step = std::strtol(end + 1, &end, 10);
+        }
+        return *end == '\0' && range.step > 0 && range.last >= range.first;
+    }
+
+    bool load_dataset(const std::string &path, Dataset &dataset) {
+        struct stat status = {};
+        if (stat(path.c_str(), &status) != 0) {
+            return false;
+        }
+        return S_ISDIR(status.st_mode) ? load_store(path, dataset) : load_csv(path, dataset);
+    }
+
+    bool load_store(const std::string &directory, Dataset &dataset) {
+        std::ifstream keys(directory + "/keys.txt");
+        uint32_t co2_key_id = 0; ///< Line of the CO2 variable in the dictionary.
+        bool has_co2_key = false;
+        for (std::string key; std::getline(keys, key) && !has_co2_key; co2_key_id += has_co2_key ? 0 : 1) {
+            has_co2_key = key == CO2_KEY;
+        }
+        std::vector<uint64_t> host_time_us; ///< Column `host_time_us.u64`.
+        std::vector<uint32_t> key_id; ///< Column `key_id.u32`.
+        std::vector<int64_t> value; ///< Column `value.i64`.
+        if (!has_co2_key || !read_column(directory + "/host_time_us.u64", host_time_us) ||
+            !read_column(directory + "/key_id.u32", key_id) || !read_column(directory + "/value.i64", value)) {
+            return false;
+        }
+        const size_t number_of_rows = std::min(host_time_us.size(), std::min(key_id.size(), value.size()));
+        ///< Rows completely written in all columns.
+        for (size_t row = 0; row < number_of_rows; row++) {
+            if (key_id[row] == co2_key_id && value[row] >= 0 && host_time_us[row] >= host_time_us[0]) {
+                dataset.time_ms.push_back((host_time_us[row] - host_time_us[0]) / 1000ULL);
+                dataset.co2_ppm.push_back(static_cast<int>(value[row]));
+            }
+        }
+        return true;
+    }
+
+    bool load_csv(const std::string &path, Dataset &dataset) {
+        std::ifstream file(path);
+        if (!file) {
+            return false;
+        }
+        double first_time_s = -1.0; ///< Time of the first sample.
+        for (std::string line; std::getline(file, line);) {
+            double time_s = 0.0;
+            int co2_ppm = 0;
+            if (std::sscanf(line.c_str(), "%lf,%d", &time_s, &co2_ppm) != 2) {
+                continue; // header or comment
+            }
+            if (first_time_s < 0.0) {
+                first_time_s = time_s;
+            }
+            if (time_s >= first_time_s) {
+                dataset.time_ms.push_back(static_cast<uint64_t>((time_s - first_time_s) * MILLISECONDS_PER_SECOND));
+                dataset.co2_ppm.push_back(co2_ppm);
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    bool read_column(const std::string &path, std::vector<T> &values) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        values.resize(static_cast<size_t>(file.tellg()) / sizeof(T));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char *>(values.data()), values.size() * sizeof(T)));
+    }
+
+    std::vector<Candidate> build_candidates(const Configuration &configuration) {
+        std::vector<Candidate> candidates;
+        Candidate candidate = {}; ///< Current combination (odometer over the ranges).
+        for (uint8_t parameter = 0; parameter < NUMBER_OF_PARAMETERS; parameter++) {
+            candidate.values[parameter] = configuration.ranges[parameter].first;
+        }
+        while (true) {
+            if (candidate.values[HIGH_QUALITY_PPM] < candidate.values[MEDIUM_QUALITY_PPM] &&
+                candidate.values[MEDIUM_QUALITY_PPM] < candidate.values[LOWER_MODERATE_QUALITY_PPM] &&
+                candidate.values[LOWER_MODERATE_QUALITY_PPM] < candidate.values[UPPER_MODERATE_QUALITY_PPM] &&
+                candidate.values[MAX_CONSECUTIVE_WARNINGS] > 0) {
+                candidates.push_back(candidate);
+            }
+            uint8_t parameter = NUMBER_OF_PARAMETERS; ///< Parameter to advance (the last one fastest).
+            while (parameter > 0) {
+                parameter--;
+                const Range &range = configuration.ranges[parameter];
+                candidate.values[parameter] += range.step;
+                if (candidate.values[parameter] <= range.last) {
+                    break;
+                }
+                candidate.values[parameter] = range.first;
+                if (parameter == 0) {
+                    return candidates;
+                }
+            }
+        }
+    }
+
+    Metrics evaluate(const Candidate &candidate, const std::vector<Dataset> &datasets,
+                     const Configuration &configuration) {
+        const MeasurementInterpreter::Thresholds thresholds = {
+            {
+                static_cast<int>(candidate.values[HIGH_QUALITY_PPM]),
+                static_cast<int>(candidate.values[MEDIUM_QUALITY_PPM]),
+                static_cast<int>(candidate.values[LOWER_MODERATE_QUALITY_PPM]),
+                static_cast<int>(candidate.values[UPPER_MODERATE_QUALITY_PPM])
+            }
+        }; ///< Thresholds of the candidate.
+        const WarningController::Policy policy = {
+            SystemTime::seconds(static_cast<unsigned long>(candidate.values[MAX_TIME_ABOVE_CO2_THRESHOLD_S])),
+            SystemTime::seconds(static_cast<unsigned long>(candidate.values[WAITING_PERIOD_BETWEEN_WARNINGS_S])),
+            static_cast<int>(candidate.values[MAX_CONSECUTIVE_WARNINGS])
+        }; ///< Warning policy of the candidate.
+        Metrics metrics = {};
+        thread_local std::vector<uint8_t> level_indices; ///< Level of each reading of the dataset (per worker).
+        for (const Dataset &dataset: datasets) {
+            level_indices.resize(dataset.co2_ppm.size());
+            BatchClassifier::classify(dataset.co2_ppm.data(), level_indices.data(), dataset.co2_ppm.size(), thresholds);
+            AirQualityMeter::State state = {}; ///< Warning state of the replayed meter.
+            uint8_t shown_level_index = MeasurementInterpreter::NUMBER_OF_LEVELS; ///< Level shown by the LEDs.
+            bool is_in_episode = false; ///< True, while the air is not acceptable.
+            uint64_t episode_start_ms = 0; ///< First sample of the current episode.
+            uint64_t episode_warnings = 0; ///< Warnings in the current episode.
+            uint64_t first_warning_ms = 0; ///< Time of the first warning in the current episode.
+            for (size_t i = 0; i < dataset.time_ms.size(); i++) {
+                const uint64_t time_ms = dataset.time_ms[i];
+                if (i == 0 || time_ms - dataset.time_ms[i - 1] > configuration.max_gap_ms) {
+                    if (is_in_episode) {
+                        end_episode(metrics, dataset.time_ms[i - 1] - episode_start_ms, episode_warnings,
+                                    first_warning_ms - episode_start_ms, configuration);
+                        is_in_episode = false;
+                    }
+                    WarningController::reset_state(state, time_ms); // cold start, see setup()
+                    shown_level_index = MeasurementInterpreter::NUMBER_OF_LEVELS;
+                }
+                const uint8_t level_index = level_indices[i];
+                if (level_index != shown_level_index) {
+                    metrics.number_of_level_changes += shown_level_index != MeasurementInterpreter::NUMBER_OF_LEVELS;
+                    shown_level_index = level_index;
+                }
+                if (AirQuality::AIR_QUALITY_LEVELS[level_index].is_acceptable) {
+                    if (is_in_episode) {
+                        end_episode(metrics, time_ms - episode_start_ms, episode_warnings,
+                                    first_warning_ms - episode_start_ms, configuration);
+                        is_in_episode = false;
+                    }
+                    WarningController::reset_state(state, time_ms);
+                    continue;
+                }
+                if (!is_in_episode) {
+                    is_in_episode = true;
+                    episode_start_ms = time_ms;
+                    episode_warnings = 0;
+                }
+                const SystemTime::Duration time_since_co2_level_not_acceptable =
+                        Co2LevelTimeTracker::get_time_since_co2_level_not_acceptable(
+                            state.last_co2_below_threshold_time_ms, time_ms);
+                if (WarningController::is_audio_warning_to_be_issued(time_since_co2_level_not_acceptable, policy)) {
+                    if (episode_warnings == 0) {
+                        first_warning_ms = time_ms;
+                    }
+                    episode_warnings++;
+                    metrics.number_of_warnings++;
+                    WarningController::update_state_for_co2_level_not_acceptable(state, time_ms, policy);
+                }
+            }
+            if (is_in_episode) {
+                end_episode(metrics, dataset.time_ms.back() - episode_start_ms, episode_warnings,
+                            first_warning_ms - episode_start_ms, configuration);
+            }
+        }
+        return metrics;
+    }
+
+    void end_episode(Metrics &metrics, const uint64_t duration_ms, const uint64_t number_of_warnings,
+                     const uint64_t time_to_first_warning_ms, const Configuration &configuration) {
+        metrics.number_of_episodes++;
+        metrics.poor_air_time_ms += duration_ms;
+        const bool is_short_exceedance = duration_ms < configuration.nuisance_episode_ms;
+        ///< True, if the air was only briefly not acceptable (a warning is a nuisance).
+        if (number_of_warnings == 0) {
+            metrics.number_of_missed_episodes += !is_short_exceedance;
+            return;
+        }
+        if (is_short_exceedance) {
+            metrics.number_of_nuisance_warnings += number_of_warnings;
+        }
+        metrics.number_of_warned_episodes++;
+        metrics.total_time_to_first_warning_ms += time_to_first_warning_ms;
+        if (time_to_first_warning_ms > metrics.max_time_to_first_warning_ms) {
+            metrics.max_time_to_first_warning_ms = time_to_first_warning_ms;
+        }
+    }
+
+    void print_results(const std::vector<Candidate> &candidates, const std::vector<Metrics> &results) {
+        for (const char *name: PARAMETER_NAMES) {
+            for (const char *character = name; *character; character++) {
+                std::putchar(*character == '-' ? '_' : *character);
+            }
+            std::putchar(',');
+        }
+        std::printf("warnings,nuisance_warnings,episodes,missed_episodes,mean_time_to_first_warning_s,"
+                    "max_time_to_first_warning_s,poor_air_hours,level_changes\n");
+        for (size_t i = 0; i < candidates.size(); i++) {
+            for (const long value: candidates[i].values) {
+                std::printf("%ld,", value);
+            }
+            const Metrics &metrics = results[i];
+            const double mean_time_to_first_warning_s =
+                    metrics.number_of_warned_episodes == 0
+                        ? 0.0
+                        : static_cast<double>(metrics.total_time_to_first_warning_ms) /
+                          static_cast<double>(metrics.number_of_warned_episodes) / MILLISECONDS_PER_SECOND;
+            std::printf("%llu,%llu,%llu,%llu,%.1f,%.1f,%.2f,%llu\n",
+                        static_cast<unsigned long long>(metrics.number_of_warnings),
+                        static_cast<unsigned long long>(metrics.number_of_nuisance_warnings),
+                        static_cast<unsigned long long>(metrics.number_of_episodes),
+                        static_cast<unsigned long long>(metrics.number_of_missed_episodes),
+                        mean_time_to_first_warning_s,
+                        static_cast<double>(metrics.max_time_to_first_warning_ms) / MILLISECONDS_PER_SECOND,
+                        static_cast<double>(metrics.poor_air_time_ms) / MILLISECONDS_PER_HOUR,
+                        static_cast<unsigned long long>(metrics.number_of_level_changes));
+        }
+    }
+}
+
+int main(const int argc, char **argv) {
+    PolicySweep::Configuration configuration;
+    if (!PolicySweep::parse_arguments(argc, argv, configuration)) {
+        std::fputs(PolicySweep::USAGE, stderr);
+        return EXIT_FAILURE;
+    }
+    std::vector<PolicySweep::Dataset> datasets(configuration.dataset_paths.size());
+    size_t number_of_samples = 0; ///< Samples of all datasets.
+    for (size_t i = 0; i < datasets.size(); i++) {
+        if (!PolicySweep::load_dataset(configuration.dataset_paths[i], datasets[i])) {
+            std::fprintf(stderr, "could not load dataset %s\n", configuration.dataset_paths[i].c_str());
+            return EXIT_FAILURE;
+        }
+        number_of_samples += datasets[i].time_ms.size();
+    }
+    const std::vector<PolicySweep::Candidate> candidates = PolicySweep::build_candidates(configuration);
+    std::fprintf(stderr, "%zu configurations, %zu datasets, %zu samples, %u threads\n", candidates.size(),
+                 datasets.size(), number_of_samples, configuration.number_of_threads);
+
+    std::vector<PolicySweep::Metrics> results(candidates.size());
+    std::atomic<size_t> next_candidate(0); ///< Index of the next candidate to evaluate.
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < configuration.number_of_threads; i++) {
+        workers.emplace_back([&]() {
+            for (size_t candidate = next_candidate++; candidate < candidates.size(); candidate = next_candidate++) {
+                results[candidate] = PolicySweep::evaluate(candidates[candidate], datasets, configuration);
+            }
+        });
+    }
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+    PolicySweep::print_results(candidates, results);
+    return EXIT_SUCCESS;
+}
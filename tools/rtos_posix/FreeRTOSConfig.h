@@ -0,0 +1,56 @@
+/**
+ * @file FreeRTOSConfig.h
+ * @brief FreeRTOS configuration of the POSIX port for the host run of the FreeRTOS variant (see rtos_posix.cpp).
+ * @details On the AVR, Arduino_FreeRTOS brings its own configuration (watchdog tick, about 15 ms).
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#define configUSE_PREEMPTION 1
+#define configUSE_TIME_SLICING 1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configUSE_IDLE_HOOK 0
+#define configUSE_TICK_HOOK 1 // the tick hook lets the simulated time of the host HAL follow the real time
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 6
+#define configMINIMAL_STACK_SIZE ((unsigned short) 4096) // words; each task runs in a thread with this stack
+#define configMAX_TASK_NAME_LEN 12
+#define configTICK_TYPE_WIDTH_IN_BITS TICK_TYPE_WIDTH_32_BITS
+#define configIDLE_SHOULD_YIELD 1
+#define configUSE_MUTEXES 1
+#define configUSE_RECURSIVE_MUTEXES 1
+#define configUSE_COUNTING_SEMAPHORES 0
+#define configQUEUE_REGISTRY_SIZE 0
+#define configUSE_TIMERS 0
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configSUPPORT_STATIC_ALLOCATION 0
+#define configTOTAL_HEAP_SIZE ((size_t) (256 * 1024)) // not used by heap_3 (malloc)
+#define configCHECK_FOR_STACK_OVERFLOW 0
+#define configUSE_MALLOC_FAILED_HOOK 0
+#define configUSE_TRACE_FACILITY 0
+#define configGENERATE_RUN_TIME_STATS 0
+
+#define INCLUDE_vTaskDelay 1
+#define INCLUDE_vTaskDelete 1
+#define INCLUDE_vTaskSuspend 1 // `portMAX_DELAY` blocks without timeout
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
+#define INCLUDE_xTaskGetSchedulerState 1
+
+#define configASSERT(condition) \
+    if (!(condition)) { \
+        vAssertCalled(__FILE__, __LINE__); \
+    }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * @brief   Reports a failed FreeRTOS assertion and aborts the run.
+ */
+void vAssertCalled(const char *file, unsigned long line);
+#ifdef __cplusplus
+}
+#endif
+
+#endif //FREERTOS_CONFIG_H
@@ -0,0 +1,57 @@
+"""
+FreeRTOS kernel for the POSIX port.
+
+PlatformIO pre-build script of the `rtos_posix` environment (see `extra_scripts` in platformio.ini). The kernel is not
+available as a PlatformIO library for the native platform, so its sources are built from a checkout: the path in the
+environment variable `FREERTOS_KERNEL_PATH`, or a shallow clone of the release `KERNEL_VERSION` in `.pio/`. Only the
+kernel files used by the firmware (tasks, queues, lists), the `malloc` heap and the POSIX port are compiled. The
+configuration is `tools/rtos_posix/FreeRTOSConfig.h`.
+"""
+
+import os
+import subprocess
+
+Import("env")  # noqa: F821 (provided by PlatformIO)
+
+KERNEL_REPOSITORY = "https://github.com/FreeRTOS/FreeRTOS-Kernel.git"
+KERNEL_VERSION = "V11.1.0"
+KERNEL_SOURCES = [
+    "tasks.c",
+    "queue.c",
+    "list.c",
+    "portable/MemMang/heap_3.c",
+    "portable/ThirdParty/GCC/Posix/port.c",
+    "portable/ThirdParty/GCC/Posix/utils/wait_for_event.c",
+]
+
+
+def get_kernel_path(project_dir):
+    kernel_path = os.environ.get("FREERTOS_KERNEL_PATH")
+    if kernel_path:
+        return kernel_path
+    kernel_path = os.path.join(project_dir, ".pio", "FreeRTOS-Kernel")
+    if not os.path.isdir(os.path.join(kernel_path, "include")):
+        subprocess.run(
+            ["git", "clone", "--depth", "1", "--branch", KERNEL_VERSION, KERNEL_REPOSITORY, kernel_path], check=True
+        )
+    return kernel_path
+
+
+project_dir = env.subst("$PROJECT_DIR")  # noqa: F821
+kernel_path = get_kernel_path(project_dir)
+port_path = os.path.join(kernel_path, "portable", "ThirdParty", "GCC", "Posix")
+
+env.Append(  # noqa: F821
+    CPPPATH=[
+        os.path.join(kernel_path, "include"),
+        port_path,
+        os.path.join(port_path, "utils"),
+        os.path.join(project_dir, "tools", "rtos_posix"),
+    ],
+    LIBS=["pthread"],
+)
+env.BuildSources(  # noqa: F821
+    os.path.join("$BUILD_DIR", "FreeRTOS-Kernel"),
+    kernel_path,
+    src_filter=["-<*>"] + ["+<%s>" % source for source in KERNEL_SOURCES],
+)
@@ -0,0 +1,159 @@
+/**
+ * @file    rtos_posix.cpp
+ * @brief   Host run of the FreeRTOS variant of the firmware on the FreeRTOS POSIX port.
+ * @details Runs `setup()` of the unmodified firmware (built with `-DENABLE_FREERTOS`) on the host HAL, starts the
+ *          scheduler and lets the firmware tasks process a number of measurements. A stimulus task presses the
+ *          acknowledge, the mute and the page button in between. Afterward, the end-to-end latency of each consumer task is
+ *          printed.
+ *
+ *          Unlike the other host tools, the simulated time follows the real time once the scheduler runs: the tick
+ *          hook advances it, and a busy wait of the firmware (the PWM reading of the sensor) takes the same real time
+ *          as on the device. So the latencies include the preemption by the higher priority tasks.
+ *
+ *          Usage: program [--measurements <number>]
+ *
+ *          Exits with a non-zero status, if a queue message was dropped or a consumer task missed a measurement.
+ */
+
+#include <Arduino.h>
+#include <host_hal.h>
+#include <pin_configuration.h>
+#include <rtos_firmware.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+void setup(); ///< Firmware set-up (src/main.cpp).
+
+namespace RtosPosix {
+    constexpr uint32_t DEFAULT_NUMBER_OF_MEASUREMENTS = 5; ///< Measurements to process (about 2 s each).
+    constexpr UBaseType_t STIMULUS_TASK_PRIORITY = tskIDLE_PRIORITY + 5; ///< Above the firmware tasks, as a button.
+    constexpr TickType_t BUTTON_PRESS_PERIOD_TICKS = pdMS_TO_TICKS(1500); ///< Time between two button presses.
+    constexpr TickType_t DRAIN_TIME_TICKS = pdMS_TO_TICKS(500);
+    ///< Time given to the consumer tasks to process the last measurement.
+    constexpr uint64_t NANOSECONDS_PER_MICROSECOND = 1000ULL; ///< Conversion factor for the real time.
+    constexpr uint64_t MICROSECONDS_PER_SECOND = 1000000ULL; ///< Conversion factor for the real time.
+    constexpr const char *CONSUMER_NAMES[RtosFirmware::NUMBER_OF_CONSUMERS] = {"display", "warning", "log"};
+    ///< Names of the consumer tasks, in the order of `RtosFirmware::Consumer`.
+
+    uint32_t number_of_measurements = DEFAULT_NUMBER_OF_MEASUREMENTS; ///< Measurements to process.
+    uint64_t real_start_time_us = 0; ///< Real time when the scheduler was started.
+    uint64_t simulated_start_time_us = 0; ///< Simulated time when the scheduler was started.
+    RtosFirmware::Latency latencies[RtosFirmware::NUMBER_OF_CONSUMERS] = {}; ///< Latencies at the end of the run.
+    uint32_t number_of_dropped_messages = 0; ///< Dropped messages at the end of the run.
+    uint32_t number_of_processed_measurements = 0; ///< Measurements sent by the sensor task at the end of the run.
+
+    /**
+     * @brief   Returns the real time in µs.
+     */
+    uint64_t read_real_time_us();
+
+    /**
+     * @brief   Returns the simulated time that corresponds to the current real time.
+     */
+    uint64_t get_real_simulated_time_us();
+
+    /**
+     * @brief   Busy-waits until the real time reaches the simulated time (time hook), as the firmware does on the device.
+     */
+    void wait_for_real_time(uint64_t time_us);
+
+    /**
+     * @brief   Presses the buttons periodically until the measurements are processed, then ends the scheduler.
+     */
+    void stimulus_task(void *);
+
+    /**
+     * @brief   Prints the latencies of the consumer tasks.
+     * @return  True, if no message was dropped and each consumer processed each measurement.
+     */
+    bool print_report();
+
+    uint64_t read_real_time_us() {
+        timespec now; ///< Current real time.
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * MICROSECONDS_PER_SECOND +
+               static_cast<uint64_t>(now.tv_nsec) / NANOSECONDS_PER_MICROSECOND;
+    }
+
+    uint64_t get_real_simulated_time_us() {
+        return simulated_start_time_us + (read_real_time_us() - real_start_time_us);
+    }
+
+    void wait_for_real_time(const uint64_t time_us) {
+        while (get_real_simulated_time_us() < time_us) {
+        }
+    }
+
+    void stimulus_task(void *) {
+        while (RtosFirmware::get_number_of_measurements() < number_of_measurements) {
+            vTaskDelay(BUTTON_PRESS_PERIOD_TICKS);
+            HostHal::trigger_interrupt(AcknowledgeButton::ButtonPin::NUMBER);
+            vTaskDelay(BUTTON_PRESS_PERIOD_TICKS);
+            HostHal::trigger_interrupt(MuteButton::ButtonPin::NUMBER);
+            HostHal::trigger_interrupt(PageButton::ButtonPin::NUMBER);
+        }
+        vTaskDelay(DRAIN_TIME_TICKS);
+        for (uint8_t consumer = 0; consumer < RtosFirmware::NUMBER_OF_CONSUMERS; consumer++) {
+            latencies[consumer] = RtosFirmware::get_latency(static_cast<RtosFirmware::Consumer>(consumer));
+        }
+        number_of_dropped_messages = RtosFirmware::get_number_of_dropped_messages();
+        number_of_processed_measurements = RtosFirmware::get_number_of_measurements();
+        vTaskEndScheduler(); // does not return, `vTaskStartScheduler` returns in `main`
+    }
+
+    bool print_report() {
+        std::printf("%-10s %12s %12s %12s\n", "task", "measurements", "max [us]", "average [us]");
+        bool is_complete = true; ///< True, if each consumer processed each measurement.
+        for (uint8_t consumer = 0; consumer < RtosFirmware::NUMBER_OF_CONSUMERS; consumer++) {
+            const RtosFirmware::Latency &latency = latencies[consumer];
+            std::printf("%-10s %12lu %12lu %12lu\n", CONSUMER_NAMES[consumer],
+                        static_cast<unsigned long>(latency.number_of_measurements),
+                        static_cast<unsigned long>(latency.max_latency_us),
+                        static_cast<unsigned long>(latency.number_of_measurements == 0
+                                                       ? 0
+                                                       : latency.total_latency_us / latency.number_of_measurements));
+            if (latency.number_of_measurements != number_of_processed_measurements) {
+                is_complete = false;
+            }
+        }
+        std::printf("measurements: %lu, dropped messages: %lu\n",
+                    static_cast<unsigned long>(number_of_processed_measurements),
+                    static_cast<unsigned long>(number_of_dropped_messages));
+        return is_complete && number_of_dropped_messages == 0;
+    }
+}
+
+extern "C" void vApplicationTickHook() {
+    const uint64_t time_us = RtosPosix::get_real_simulated_time_us(); ///< Simulated time of the current real time.
+    if (time_us > HostHal::get_time_us()) {
+        HostHal::set_time_us(time_us);
+    }
+}
+
+extern "C" void vAssertCalled(const char *file, const unsigned long line) {
+    std::fprintf(stderr, "FreeRTOS assertion failed: %s:%lu\n", file, line);
+    std::abort();
+}
+
+int main(const int argc, char **argv) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--measurements")) {
+            RtosPosix::number_of_measurements = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        }
+    }
+    HostHal::set_sensor_preheating(false);
+    setup(); // the boot sequence runs in simulated time and ends with RtosFirmware::start()
+
+    xTaskCreate(RtosPosix::stimulus_task, "stimulus", configMINIMAL_STACK_SIZE, nullptr,
+                RtosPosix::STIMULUS_TASK_PRIORITY, nullptr);
+    RtosPosix::real_start_time_us = RtosPosix::read_real_time_us();
+    RtosPosix::simulated_start_time_us = HostHal::get_time_us();
+    HostHal::set_time_hook(RtosPosix::wait_for_real_time);
+    vTaskStartScheduler();
+
+    return RtosPosix::print_report() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file    system_time_check.cpp
+ * @brief   Host check of the wrap-safe system time and the 64-bit uptime.
+ * @details The `unsigned long` of the host has 64 bits, so the firmware would never see a `millis()` rollover there.
+ *          The host HAL returns `millis()` truncated to 32 bits like the AVR core, and this program sets the simulated
+ *          time just before the rollover (after 49.7 days) and checks across it:
+ *           - the time points, durations and comparisons of `SystemTime`,
+ *           - the 64-bit uptime and the uptime in seconds (the rollovers are counted),
+ *           - a `NotBlockingTimeHandler::wait_ms` across the rollover, which has to end in time,
+ *           - that reading the uptime keeps the interrupt state (e.g. called with disabled interrupts).
+ *
+ *          Usage: program
+ *
+ *          Exits with a non-zero status, if a check fails.
+ */
+
+#include <Arduino.h>
+#include <host_hal.h>
+#include <system_time.h>
+#include <not_blocking_time_handler.h>
+#include <cstdio>
+#include <cstdlib>
+
+namespace SystemTimeCheck {
+    constexpr uint64_t MILLIS_PERIOD_MS = 1ULL << 32; ///< Period of the 32-bit `millis()` (49.7 days).
+    constexpr uint64_t MICROSECONDS_PER_MILLISECOND = 1000ULL; ///< Conversion of the simulated time.
+    constexpr unsigned long TIME_BEFORE_ROLLOVER_MS = 1500UL; ///< Start of the checks before the first rollover.
+    constexpr unsigned long STEP_MS = 3000UL; ///< Time passed across the first rollover.
+    constexpr unsigned long WAITING_TIME_MS = 1000UL; ///< Wait across the second rollover.
+    constexpr unsigned long WAIT_START_BEFORE_ROLLOVER_MS = 400UL; ///< Start of the wait before the second rollover.
+    constexpr unsigned long MAX_WAIT_OVERSHOOT_MS = 2UL; ///< Longest time a wait may take longer than requested.
+
+    int number_of_failures = 0; ///< Number of failed checks.
+
+    /**
+     * @brief   Prints the result of a check and counts a failure.
+     */
+    void check(bool is_passed, const char *description);
+
+    /**
+     * @brief   Sets the simulated time in milliseconds since start-up.
+     */
+    void set_time_ms(uint64_t time_ms);
+
+    void check(const bool is_passed, const char *description) {
+        std::printf("%-64s %s\n", description, is_passed ? "ok" : "FAILED");
+        if (!is_passed) {
+            number_of_failures++;
+        }
+    }
+
+    void set_time_ms(const uint64_t time_ms) {
+        HostHal::set_time_us(time_ms * MICROSECONDS_PER_MILLISECOND);
+    }
+}
+
+int main() {
+    using namespace SystemTimeCheck;
+    SystemTime::initialize();
+
+    set_time_ms(MILLIS_PERIOD_MS - TIME_BEFORE_ROLLOVER_MS);
+    const SystemTime::TimePoint start = SystemTime::now(); ///< Time point before the first rollover.
+    check(SystemTime::get_uptime_ms() == MILLIS_PERIOD_MS - TIME_BEFORE_ROLLOVER_MS, "uptime before the rollover");
+
+    HostHal::advance_time_us(STEP_MS * MICROSECONDS_PER_MILLISECOND);
+    const SystemTime::TimePoint after_rollover = SystemTime::now(); ///< Time point after the first rollover.
+    check(after_rollover.to_millis() == STEP_MS - TIME_BEFORE_ROLLOVER_MS, "millis() rolls over to a small value");
+    check(SystemTime::elapsed_since(start) == SystemTime::milliseconds(STEP_MS), "elapsed time across the rollover");
+    check(SystemTime::has_elapsed(start, SystemTime::milliseconds(STEP_MS)) &&
+          !SystemTime::has_elapsed(start, SystemTime::milliseconds(STEP_MS + 1)), "has_elapsed across the rollover");
+    check(start.is_before(after_rollover) && !after_rollover.is_before(start), "is_before across the rollover");
+    check(start + SystemTime::milliseconds(STEP_MS) == after_rollover &&
+          after_rollover - SystemTime::milliseconds(STEP_MS) == start, "time point arithmetic across the rollover");
+    check(SystemTime::get_uptime_ms() == MILLIS_PERIOD_MS + STEP_MS - TIME_BEFORE_ROLLOVER_MS,
+          "uptime after the rollover");
+    check(SystemTime::get_uptime_seconds() ==
+          (MILLIS_PERIOD_MS + STEP_MS - TIME_BEFORE_ROLLOVER_MS) / SystemTime::MILLISECONDS_PER_SECOND,
+          "uptime in seconds after the rollover");
+
+    set_time_ms(2 * MILLIS_PERIOD_MS - WAIT_START_BEFORE_ROLLOVER_MS);
+    const uint64_t wait_start_time_us = HostHal::get_time_us(); ///< Start of the wait before the second rollover.
+    NotBlockingTimeHandler::wait_ms(WAITING_TIME_MS);
+    const uint64_t waited_ms = (HostHal::get_time_us() - wait_start_time_us) / MICROSECONDS_PER_MILLISECOND;
+    ///< Time the wait across the second rollover took.
+    check(waited_ms >= WAITING_TIME_MS && waited_ms <= WAITING_TIME_MS + MAX_WAIT_OVERSHOOT_MS,
+          "wait across the rollover ends in time");
+    check(SystemTime::get_uptime_ms() / MILLIS_PERIOD_MS == 2, "uptime counts the second rollover");
+
+    noInterrupts();
+    SystemTime::get_uptime_ms();
+    const bool are_interrupts_kept_disabled = !HostHal::are_interrupts_enabled();
+    ///< True, if reading the uptime did not enable the interrupts.
+    interrupts();
+    SystemTime::get_uptime_seconds();
+    check(are_interrupts_kept_disabled && HostHal::are_interrupts_enabled(),
+          "reading the uptime keeps the interrupt state");
+
+    return number_of_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}